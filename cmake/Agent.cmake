@@ -104,6 +104,7 @@ add_library(core
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
   fboss/agent/ArpHandler.cpp
+  fboss/agent/DHCPRelayContextCache.cpp
   fboss/agent/DHCPv4Handler.cpp
   fboss/agent/DHCPv6Handler.cpp
   fboss/agent/FibHelpers.cpp
@@ -176,6 +177,7 @@ target_link_libraries(core
   state_utils
   exponential_back_off
   fboss_config_utils
+  function_call_time_reporter
   phy_cpp2
   snapshot_manager
   transceiver_cpp2
@@ -55,6 +55,7 @@ add_executable(bcm_test
   fboss/agent/hw/bcm/tests/BcmStateDeltaTests.cpp
   fboss/agent/hw/bcm/tests/BcmTrunkTests.cpp
   fboss/agent/hw/bcm/tests/BcmTrunkUtils.cpp
+  fboss/agent/hw/bcm/tests/BcmTxPacketPoolTests.cpp
   fboss/agent/hw/bcm/tests/BcmUnitTests.cpp
   fboss/agent/hw/bcm/tests/QsetCmpTests.cpp
   fboss/agent/hw/bcm/tests/HwTestRouteUtils.cpp
@@ -51,6 +51,19 @@ target_link_libraries(hw_fsw_scale_route_add_speed
   Folly::folly
 )
 
+add_library(hw_fsw_scale_route_add_parallel_speed
+  fboss/agent/hw/benchmarks/HwFswScaleRouteAddParallelBenchmark.cpp
+)
+
+target_link_libraries(hw_fsw_scale_route_add_parallel_speed
+  config_factory
+  hw_packet_utils
+  ecmp_helper
+  hw_benchmark_main
+  function_call_time_reporter
+  Folly::folly
+)
+
 add_library(hw_fsw_scale_route_del_speed
   fboss/agent/hw/benchmarks/HwFswScaleRouteDelBenchmark.cpp
 )
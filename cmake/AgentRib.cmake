@@ -18,6 +18,7 @@ target_link_libraries(standalone_rib
   ctrl_cpp2
   label_forwarding_action
   state_utils
+  function_call_time_reporter
   Folly::folly
 )
 
@@ -39,5 +40,6 @@ target_link_libraries(fib_updater
   standalone_rib
   fboss_types
   state
+  function_call_time_reporter
   Folly::folly
 )
@@ -54,6 +54,7 @@ add_library(function_call_time_reporter
 )
 
 target_link_libraries(function_call_time_reporter
+  fb303::fb303
   Folly::folly
 )
 
@@ -71,6 +72,7 @@ add_library(fboss_i2c_lib
   fboss/lib/i2c/PCA9541.cpp
   fboss/lib/i2c/PCA9541.h
   fboss/lib/usb/TransceiverI2CApi.h
+  fboss/lib/usb/TransceiverReadTransaction.h
   fboss/lib/usb/UsbDevice.cpp
   fboss/lib/usb/UsbDevice.h
   fboss/lib/usb/UsbError.h
@@ -24,4 +24,5 @@ target_link_libraries(phy_management_base
   platform_mapping
   fboss_config_utils
   Folly::folly
+  fb303::fb303
 )
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/DHCPRelayContextCache.h"
+
+#include <fb303/ThreadCachedServiceData.h>
+#include <folly/Conv.h>
+#include <folly/logging/xlog.h>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/VlanMap.h"
+
+using facebook::fb303::SUM;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+
+namespace {
+std::string counterKey(facebook::fboss::VlanID vlan, folly::StringPiece name) {
+  return folly::to<std::string>(
+      facebook::fboss::SwitchStats::kCounterPrefix,
+      "vlan.",
+      static_cast<uint16_t>(vlan),
+      ".",
+      name);
+}
+} // namespace
+
+namespace facebook::fboss {
+
+DHCPRelayContext::DHCPRelayContext(
+    const std::shared_ptr<SwitchState>& state,
+    const std::shared_ptr<Vlan>& vlan)
+    : vlanID(vlan->getID()),
+      v4Server(vlan->getDhcpV4Relay()),
+      v4Overrides(vlan->getDhcpV4RelayOverrides()),
+      v4RelaySrc(state->getDhcpV4RelaySrc()),
+      v6Server(vlan->getDhcpV6Relay()),
+      v6Overrides(vlan->getDhcpV6RelayOverrides()),
+      v6RelaySrc(state->getDhcpV6RelaySrc()),
+      v4RelayedKey_(counterKey(vlanID, "dhcpV4.relayed")),
+      v4DroppedKey_(counterKey(vlanID, "dhcpV4.dropped")),
+      v6RelayedKey_(counterKey(vlanID, "dhcpV6.relayed")),
+      v6DroppedKey_(counterKey(vlanID, "dhcpV6.dropped")) {
+  auto intf = state->getInterfaces()->getInterfaceInVlanIf(vlanID);
+  if (!intf) {
+    return;
+  }
+  for (const auto& address : intf->getAddresses()) {
+    if (v4RelaySrc.isZero() && address.first.isV4()) {
+      v4RelaySrc = address.first.asV4();
+    } else if (v6RelaySrc.isZero() && address.first.isV6()) {
+      v6RelaySrc = address.first.asV6();
+    }
+  }
+}
+
+IPAddressV4 DHCPRelayContext::getV4Server(MacAddress client) const {
+  auto it = v4Overrides.find(client);
+  return it == v4Overrides.end() ? v4Server : it->second;
+}
+
+IPAddressV6 DHCPRelayContext::getV6Server(MacAddress client) const {
+  auto it = v6Overrides.find(client);
+  return it == v6Overrides.end() ? v6Server : it->second;
+}
+
+void DHCPRelayContext::relayedV4() const {
+  tcData().addStatValue(v4RelayedKey_, 1, SUM);
+}
+
+void DHCPRelayContext::droppedV4() const {
+  tcData().addStatValue(v4DroppedKey_, 1, SUM);
+}
+
+void DHCPRelayContext::relayedV6() const {
+  tcData().addStatValue(v6RelayedKey_, 1, SUM);
+}
+
+void DHCPRelayContext::droppedV6() const {
+  tcData().addStatValue(v6DroppedKey_, 1, SUM);
+}
+
+DHCPRelayContextCache::DHCPRelayContextCache(SwSwitch* sw)
+    : AutoRegisterStateObserver(sw, "DHCPRelayContextCache"), sw_(sw) {}
+
+void DHCPRelayContextCache::stateUpdated(const StateDelta& delta) {
+  const auto& oldState = delta.oldState();
+  const auto& newState = delta.newState();
+  bool invalidateAll =
+      oldState->getDhcpV4RelaySrc() != newState->getDhcpV4RelaySrc() ||
+      oldState->getDhcpV6RelaySrc() != newState->getDhcpV6RelaySrc();
+
+  // VLANs change on every neighbor and MAC update, only the relay config of
+  // a VLAN and its interface addresses matter here
+  std::vector<VlanID> invalidated;
+  if (!invalidateAll) {
+    for (const auto& vlanDelta : delta.getVlansDelta()) {
+      const auto& oldVlan = vlanDelta.getOld();
+      const auto& newVlan = vlanDelta.getNew();
+      if (!oldVlan || !newVlan ||
+          oldVlan->getDhcpV4Relay() != newVlan->getDhcpV4Relay() ||
+          oldVlan->getDhcpV6Relay() != newVlan->getDhcpV6Relay() ||
+          oldVlan->getDhcpV4RelayOverrides() !=
+              newVlan->getDhcpV4RelayOverrides() ||
+          oldVlan->getDhcpV6RelayOverrides() !=
+              newVlan->getDhcpV6RelayOverrides()) {
+        invalidated.push_back(oldVlan ? oldVlan->getID() : newVlan->getID());
+      }
+    }
+    for (const auto& intfDelta : delta.getIntfsDelta()) {
+      if (const auto& oldIntf = intfDelta.getOld()) {
+        invalidated.push_back(oldIntf->getVlanID());
+      }
+      if (const auto& newIntf = intfDelta.getNew()) {
+        invalidated.push_back(newIntf->getVlanID());
+      }
+    }
+    if (invalidated.empty()) {
+      return;
+    }
+  }
+
+  auto contexts = contexts_.wlock();
+  ++contexts->generation;
+  if (invalidateAll) {
+    contexts->contexts.clear();
+    return;
+  }
+  for (auto vlan : invalidated) {
+    contexts->contexts.erase(vlan);
+  }
+}
+
+std::shared_ptr<const DHCPRelayContext> DHCPRelayContextCache::getContext(
+    VlanID vlanID) {
+  uint64_t generation;
+  {
+    auto contexts = contexts_.rlock();
+    auto it = contexts->contexts.find(vlanID);
+    if (it != contexts->contexts.end()) {
+      return it->second;
+    }
+    generation = contexts->generation;
+  }
+
+  auto state = sw_->getState();
+  auto vlan = state->getVlans()->getVlanIf(vlanID);
+  if (!vlan) {
+    return nullptr;
+  }
+  auto context = std::make_shared<const DHCPRelayContext>(state, vlan);
+  auto contexts = contexts_.wlock();
+  if (contexts->generation == generation) {
+    contexts->contexts.emplace(vlanID, context);
+  }
+  XLOG(DBG4) << "Built DHCP relay context for VLAN " << vlanID;
+  return context;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/MacAddress.h>
+#include <folly/Synchronized.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "fboss/agent/StateObserver.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/types.h"
+
+namespace facebook::fboss {
+
+class SwitchState;
+
+/*
+ * What the DHCP relay needs to know about a VLAN to relay a client's
+ * messages to the server: the server, the overrides for some clients, and
+ * the source address of the relayed messages. Zero addresses mean that it
+ * isn't configured.
+ */
+struct DHCPRelayContext {
+  DHCPRelayContext(
+      const std::shared_ptr<SwitchState>& state,
+      const std::shared_ptr<Vlan>& vlan);
+
+  folly::IPAddressV4 getV4Server(folly::MacAddress client) const;
+  folly::IPAddressV6 getV6Server(folly::MacAddress client) const;
+
+  void relayedV4() const;
+  void droppedV4() const;
+  void relayedV6() const;
+  void droppedV6() const;
+
+  VlanID vlanID;
+  folly::IPAddressV4 v4Server;
+  DhcpV4OverrideMap v4Overrides;
+  // DHCP relay source IP, or the first IPv4 address of the VLAN interface
+  folly::IPAddressV4 v4RelaySrc;
+  folly::IPAddressV6 v6Server;
+  DhcpV6OverrideMap v6Overrides;
+  // DHCPv6 relay source IP, or the first IPv6 address of the VLAN interface
+  folly::IPAddressV6 v6RelaySrc;
+
+ private:
+  // Per VLAN counters of relayed and dropped client messages
+  std::string v4RelayedKey_;
+  std::string v4DroppedKey_;
+  std::string v6RelayedKey_;
+  std::string v6DroppedKey_;
+};
+
+/*
+ * Per VLAN DHCP relay contexts, so that relaying a client message doesn't
+ * have to look up the VLAN, its overrides and interface addresses in the
+ * switch state every time. Contexts are built on first use on the packet RX
+ * threads, and dropped on the update thread when a state delta changes
+ * anything they were built from.
+ */
+class DHCPRelayContextCache : public AutoRegisterStateObserver {
+ public:
+  explicit DHCPRelayContextCache(SwSwitch* sw);
+  ~DHCPRelayContextCache() override {}
+
+  void stateUpdated(const StateDelta& delta) override;
+
+  // The context of vlan, or null if the VLAN doesn't exist
+  std::shared_ptr<const DHCPRelayContext> getContext(VlanID vlan);
+
+  size_t size() const {
+    return contexts_.rlock()->contexts.size();
+  }
+
+ private:
+  struct Contexts {
+    std::unordered_map<VlanID, std::shared_ptr<const DHCPRelayContext>>
+        contexts;
+    // Bumped on every invalidation, so that a context built from a state
+    // older than an invalidation isn't cached
+    uint64_t generation{0};
+  };
+
+  SwSwitch* sw_;
+  folly::Synchronized<Contexts> contexts_;
+};
+
+} // namespace facebook::fboss
@@ -13,7 +13,9 @@
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
+#include <algorithm>
 #include <string>
+#include "fboss/agent/DHCPRelayContextCache.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/RxPacket.h"
@@ -204,47 +206,32 @@ void DHCPv4Handler::processRequest(
     MacAddress srcMac,
     const IPv4Hdr& origIPHdr,
     const DHCPv4Packet& dhcpPacket) {
-  auto dhcpPacketOut(dhcpPacket);
-  auto state = sw->getState();
-  auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
-  if (!vlan) {
+  auto relayContext =
+      sw->getDhcpRelayContextCache()->getContext(pkt->getSrcVlan());
+  if (!relayContext) {
     sw->stats()->dhcpV4DropPkt();
     XLOG(DBG4) << " VLAN  " << pkt->getSrcVlan() << " is no longer present "
                << " dropped dhcp packet received on a port in this VLAN";
     return;
   }
-  auto dhcpServer = vlan->getDhcpV4Relay();
 
   XLOG(DBG4) << "srcMac: " << srcMac.toString();
   // look in the override map, and use relevant destination
-  auto dhcpOverrideMap = vlan->getDhcpV4RelayOverrides();
-  if (dhcpOverrideMap.find(srcMac) != dhcpOverrideMap.end()) {
-    dhcpServer = dhcpOverrideMap[srcMac];
-    XLOG(DBG4) << "dhcpServer: " << dhcpServer;
-  }
+  auto dhcpServer = relayContext->getV4Server(srcMac);
+  XLOG(DBG4) << "dhcpServer: " << dhcpServer;
 
   if (dhcpServer.isZero()) {
     sw->stats()->dhcpV4DropPkt();
-    XLOG(DBG4) << " No relay configured for VLAN : " << vlan->getID()
+    relayContext->droppedV4();
+    XLOG(DBG4) << " No relay configured for VLAN : " << relayContext->vlanID
                << " dropped dhcp packet ";
     return;
   }
 
-  auto switchIp = state->getDhcpV4RelaySrc();
-  if (switchIp.isZero()) {
-    auto vlanInterface =
-        state->getInterfaces()->getInterfaceInVlanIf(pkt->getSrcVlan());
-    auto& addresses = vlanInterface->getAddresses();
-    for (auto address : addresses) {
-      if (address.first.isV4()) {
-        switchIp = address.first.asV4();
-        break;
-      }
-    }
-  }
-
+  auto switchIp = relayContext->v4RelaySrc;
   if (switchIp.isZero()) {
     sw->stats()->dhcpV4DropPkt();
+    relayContext->droppedV4();
     XLOG(ERR) << "Could not find a SVI interface on vlan : "
               << pkt->getSrcVlan() << "DHCP packet dropped ";
     return;
@@ -252,9 +239,11 @@ void DHCPv4Handler::processRequest(
 
   XLOG(DBG4) << " Got switch ip : " << switchIp;
   // Prepare DHCP packet to relay
+  DHCPv4Packet dhcpPacketOut(dhcpPacket);
   if (!addAgentOptions(
           sw, pkt->getSrcPort(), switchIp, dhcpPacket, dhcpPacketOut)) {
     sw->portStats(pkt->getSrcPort())->dhcpV4BadPkt();
+    relayContext->droppedV4();
     XLOG(DBG4) << "Bad DHCP packet, error adding agent options."
                << " DHCP packet dropped";
     return;
@@ -286,6 +275,7 @@ void DHCPv4Handler::processRequest(
       kBootPSPort, kBootPSPort, UDPHeader::size() + dhcpPacketOut.size());
   // Send packet
   sendDHCPPacket(sw, ethHdr, ipHdr, udpHdr, dhcpPacketOut);
+  relayContext->relayedV4();
 }
 
 void DHCPv4Handler::processReply(
@@ -352,6 +342,11 @@ bool DHCPv4Handler::addAgentOptions(
     DHCPv4Packet& dhcpPacketOut) {
   dhcpPacketOut.clearOptions();
   const auto& optionsIn = dhcpPacketIn.options;
+  // Room for the agent option, the end option and the padding up to the
+  // minimum length, so that rewriting the options doesn't reallocate
+  dhcpPacketOut.options.reserve(std::max<size_t>(
+      optionsIn.size() + 4 + relayAddr.byteCount() + 1,
+      DHCPv4Packet::kMinSize - DHCPv4Packet::minSize()));
   auto optIndex = 0;
   bool isDHCP = false;
   bool done = false;
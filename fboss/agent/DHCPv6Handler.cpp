@@ -14,6 +14,7 @@
 #include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
 #include <string>
+#include "fboss/agent/DHCPRelayContextCache.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/RxPacket.h"
@@ -165,38 +166,31 @@ void DHCPv6Handler::processDHCPv6Packet(
     const IPv6Hdr& ipHdr,
     const DHCPv6Packet& dhcpPacket) {
   auto vlanId = pkt->getSrcVlan();
-  auto states = sw->getState();
-  auto vlan = states->getVlans()->getVlanIf(vlanId);
-  if (!vlan) {
+  auto relayContext = sw->getDhcpRelayContextCache()->getContext(vlanId);
+  if (!relayContext) {
     sw->stats()->dhcpV6DropPkt();
     XLOG(DBG2) << "VLAN " << vlanId << " is no longer present"
                << "DHCPv6Packet dropped.";
     return;
   }
 
-  auto dhcp6ServerIp = vlan->getDhcpV6Relay();
-
   // look in the override map, and use relevant destination
   XLOG(DBG4) << "srcMac: " << srcMac.toString();
-  auto dhcpOverrideMap = vlan->getDhcpV6RelayOverrides();
-  for (auto o : dhcpOverrideMap) {
-    if (MacAddress(o.first) == srcMac) {
-      dhcp6ServerIp = o.second;
-      XLOG(DBG4) << "dhcp6ServerIp: " << dhcp6ServerIp;
-      break;
-    }
-  }
+  auto dhcp6ServerIp = relayContext->getV6Server(srcMac);
+  XLOG(DBG4) << "dhcp6ServerIp: " << dhcp6ServerIp;
 
   if (dhcp6ServerIp.isZero()) {
-    XLOG(DBG4) << "No DHCPv6 relay configured for Vlan " << vlan->getID()
+    XLOG(DBG4) << "No DHCPv6 relay configured for Vlan " << vlanId
                << " dropped DHCPv6 packet";
     sw->stats()->dhcpV6DropPkt();
+    relayContext->droppedV6();
     return;
   }
 
-  auto switchIp = states->getDhcpV6RelaySrc();
+  auto switchIp = relayContext->v6RelaySrc;
   if (switchIp.isZero()) {
-    switchIp = getSwitchVlanIPv6(states, vlanId);
+    relayContext->droppedV6();
+    throw FbossError("Cannot find IPv6 address for vlan ", vlanId);
   }
 
   // link address set to unspecified
@@ -235,6 +229,7 @@ void DHCPv6Handler::processDHCPv6Packet(
       DHCPv6Packet::DHCP6_SERVERAGENT_UDPPORT,
       relayFwdPkt.computePacketLength(),
       serializeBody);
+  relayContext->relayedV6();
 }
 
 void DHCPv6Handler::processDHCPv6RelayForward(
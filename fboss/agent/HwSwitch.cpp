@@ -10,6 +10,7 @@
 #include "fboss/agent/HwSwitch.h"
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/TxPacket.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/hw/HwSwitchStats.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
@@ -68,6 +69,18 @@ void HwSwitch::updateStats(SwitchStats* switchStats) {
   }
 }
 
+size_t HwSwitch::sendPacketsOutOfPortAsync(
+    std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> pkts,
+    std::optional<uint8_t> queue) noexcept {
+  size_t numSent = 0;
+  for (auto& [pkt, portID] : pkts) {
+    if (sendPacketOutOfPortAsync(std::move(pkt), portID, queue)) {
+      ++numSent;
+    }
+  }
+  return numSent;
+}
+
 uint32_t HwSwitch::generateDeterministicSeed(LoadBalancerID loadBalancerID) {
   return generateDeterministicSeed(
       loadBalancerID, getPlatform()->getLocalMac());
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace folly {
 struct dynamic;
@@ -199,6 +200,17 @@ class HwSwitch {
       PortID portID,
       std::optional<uint8_t> queue = std::nullopt) noexcept = 0;
 
+  /*
+   * Send a batch of packets, each out of its specified port, on the given
+   * queue. HwSwitch implementations that can hand several packets to the SDK
+   * at once should override this; the default sends them one at a time.
+   *
+   * @return Number of packets successfully sent to HW.
+   */
+  virtual size_t sendPacketsOutOfPortAsync(
+      std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> pkts,
+      std::optional<uint8_t> queue = std::nullopt) noexcept;
+
   /*
    * Send a packet, use switching logic to send it out the correct port(s)
    * for the specified VLAN and destination MAC.
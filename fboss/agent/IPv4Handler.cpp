@@ -134,9 +134,10 @@ void IPv4Handler::handlePacket(
              << static_cast<int>(v4Hdr.protocol);
 
   // Additional data (such as FCS) may be appended after the IP payload
-  auto payload =
-      folly::IOBuf::wrapBuffer(cursor.data(), v4Hdr.length - v4Hdr.size());
-  cursor.reset(payload.get());
+  // Wrapped on the stack, so that there is no allocation per packet
+  folly::IOBuf payload(
+      folly::IOBuf::WRAP_BUFFER, cursor.data(), v4Hdr.length - v4Hdr.size());
+  cursor.reset(&payload);
 
   // retrieve the current switch state
   auto state = sw_->getState();
@@ -141,8 +141,10 @@ void IPv6Handler::handlePacket(
              << " nextHeader: " << static_cast<int>(ipv6.nextHeader);
 
   // Additional data (such as FCS) may be appended after the IP payload
-  auto payload = folly::IOBuf::wrapBuffer(cursor.data(), ipv6.payloadLength);
-  cursor.reset(payload.get());
+  // Wrapped on the stack, so that there is no allocation per packet
+  folly::IOBuf payload(
+      folly::IOBuf::WRAP_BUFFER, cursor.data(), ipv6.payloadLength);
+  cursor.reset(&payload);
 
   // retrieve the current switch state
   auto state = sw_->getState();
@@ -93,6 +93,25 @@ std::shared_ptr<SwitchState> ProgramForwardingAndPartnerState::operator()(
   return nextState;
 }
 
+ProgramForwardingAndPartnerStates::ProgramForwardingAndPartnerStates(
+    std::vector<ProgramForwardingAndPartnerState> updates)
+    : updates_(std::move(updates)) {}
+
+std::shared_ptr<SwitchState> ProgramForwardingAndPartnerStates::operator()(
+    const std::shared_ptr<SwitchState>& state) {
+  std::shared_ptr<SwitchState> nextState(state);
+  bool changed = false;
+  for (auto& update : updates_) {
+    // Members of aggregate ports removed in the meantime are skipped
+    auto updatedState = update(nextState);
+    if (updatedState) {
+      nextState = updatedState;
+      changed = true;
+    }
+  }
+  return changed ? nextState : nullptr;
+}
+
 // Needed for CHECK_* macros to work with PortIDToController::iterator
 std::ostream& operator<<(
     std::ostream& out,
@@ -359,11 +378,8 @@ void LinkAggregationManager::enableForwardingAndSetPartnerState(
     const AggregatePort::PartnerState& partnerState) {
   CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
 
-  auto enableFwdStateFn = ProgramForwardingAndPartnerState(
+  enqueueForwardingAndPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::ENABLED, partnerState);
-
-  sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(enableFwdStateFn));
 }
 
 void LinkAggregationManager::disableForwardingAndSetPartnerState(
@@ -372,11 +388,44 @@ void LinkAggregationManager::disableForwardingAndSetPartnerState(
     const ParticipantInfo& partnerState) {
   CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
 
-  auto disableFwdStateFn = ProgramForwardingAndPartnerState(
+  enqueueForwardingAndPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::DISABLED, partnerState);
+}
+
+void LinkAggregationManager::enqueueForwardingAndPartnerState(
+    PortID portID,
+    AggregatePortID aggPortID,
+    AggregatePort::Forwarding fwdState,
+    const AggregatePort::PartnerState& partnerState) {
+  // Only the latest transition of a member matters
+  pendingForwardingAndPartnerStates_.insert_or_assign(
+      portID,
+      ProgramForwardingAndPartnerState(
+          portID, aggPortID, fwdState, partnerState));
+  if (!forwardingAndPartnerStateFlusher_.isLoopCallbackScheduled()) {
+    sw_->getLacpEvb()->runInLoop(&forwardingAndPartnerStateFlusher_);
+  }
+}
+
+void LinkAggregationManager::programForwardingAndPartnerStates() {
+  CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
+
+  if (pendingForwardingAndPartnerStates_.empty()) {
+    return;
+  }
+  std::vector<ProgramForwardingAndPartnerState> updates;
+  updates.reserve(pendingForwardingAndPartnerStates_.size());
+  for (auto& portAndUpdate : pendingForwardingAndPartnerStates_) {
+    updates.push_back(std::move(portAndUpdate.second));
+  }
+  pendingForwardingAndPartnerStates_.clear();
 
+  auto numUpdates = static_cast<int64_t>(updates.size());
+  XLOG(DBG2) << "Programming forwarding and partner state for " << numUpdates
+             << " aggregate port members";
   sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(disableFwdStateFn));
+      StateUpdateDescriptor(StateUpdateCategory::LACP, numUpdates),
+      ProgramForwardingAndPartnerStates(std::move(updates)));
 }
 
 void LinkAggregationManager::recordLacpTimeout() {
@@ -415,6 +464,11 @@ LinkAggregationManager::~LinkAggregationManager() {
   for (auto controller : portToController_) {
     controller.second->stopMachines();
   }
+  // The flusher refers back to us, make sure it can't run anymore
+  sw_->getLacpEvb()->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+    forwardingAndPartnerStateFlusher_.cancelLoopCallback();
+    pendingForwardingAndPartnerStates_.clear();
+  });
 }
 
 } // namespace facebook::fboss
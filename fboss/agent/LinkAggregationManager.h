@@ -18,6 +18,7 @@
 
 #include <folly/SharedMutex.h>
 #include <folly/io/Cursor.h>
+#include <folly/io/async/EventBase.h>
 
 #include <memory>
 #include <vector>
@@ -68,6 +69,21 @@ class ProgramForwardingAndPartnerState {
   AggregatePort::PartnerState partnerState_;
 };
 
+/*
+ * Applies forwarding and partner state changes for any number of members,
+ * across aggregate ports, in a single state update.
+ */
+class ProgramForwardingAndPartnerStates {
+ public:
+  explicit ProgramForwardingAndPartnerStates(
+      std::vector<ProgramForwardingAndPartnerState> updates);
+  std::shared_ptr<SwitchState> operator()(
+      const std::shared_ptr<SwitchState>& state);
+
+ private:
+  std::vector<ProgramForwardingAndPartnerState> updates_;
+};
+
 class LinkAggregationManager : public AutoRegisterStateObserver,
                                public LacpServicerIf {
  public:
@@ -116,6 +132,33 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
 
+  /*
+   * Forwarding and partner state changes made by the LACP state machines are
+   * queued here and flushed as one state update at the end of the current
+   * LACP EventBase loop iteration, so a burst of member transitions (e.g. on
+   * a linecard flap) doesn't queue one update per member behind other
+   * updates. Only accessed from the LACP EventBase.
+   */
+  void enqueueForwardingAndPartnerState(
+      PortID portID,
+      AggregatePortID aggPortID,
+      AggregatePort::Forwarding fwdState,
+      const AggregatePort::PartnerState& partnerState);
+  void programForwardingAndPartnerStates();
+
+  class ForwardingAndPartnerStateFlusher
+      : public folly::EventBase::LoopCallback {
+   public:
+    explicit ForwardingAndPartnerStateFlusher(LinkAggregationManager* lagMgr)
+        : lagMgr_(lagMgr) {}
+    void runLoopCallback() noexcept override {
+      lagMgr_->programForwardingAndPartnerStates();
+    }
+
+   private:
+    LinkAggregationManager* lagMgr_;
+  };
+
   // Forbidden copy constructor and assignment operator
   LinkAggregationManager(LinkAggregationManager const&) = delete;
   LinkAggregationManager& operator=(LinkAggregationManager const&) = delete;
@@ -129,6 +172,10 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
   PortIDToController portToController_;
   mutable folly::SharedMutexWritePriority controllersLock_;
   SwSwitch* sw_{nullptr};
+
+  boost::container::flat_map<PortID, ProgramForwardingAndPartnerState>
+      pendingForwardingAndPartnerStates_;
+  ForwardingAndPartnerStateFlusher forwardingAndPartnerStateFlusher_{this};
 };
 
 } // namespace facebook::fboss
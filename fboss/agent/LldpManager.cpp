@@ -21,8 +21,10 @@
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/state/DeltaFunctions.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/PortDescriptor.h"
+#include "fboss/agent/state/StateDelta.h"
 
 using folly::ByteRange;
 using folly::MacAddress;
@@ -68,6 +70,7 @@ const MacAddress LldpManager::LLDP_DEST_MAC("01:80:c2:00:00:0e");
 
 LldpManager::LldpManager(SwSwitch* sw)
     : folly::AsyncTimeout(sw->getBackgroundEvb()),
+      AutoRegisterStateObserver(sw, "LldpManager"),
       sw_(sw),
       intervalMsecs_(LLDP_INTERVAL) {}
 
@@ -138,27 +141,86 @@ void LldpManager::handlePacket(
   db_.update(neighbor);
 }
 
+void LldpManager::stateUpdated(const StateDelta& delta) {
+  auto invalidate = [this](PortID port) {
+    auto templates = frameTemplates_.wlock();
+    ++templates->generation;
+    templates->frames.erase(port);
+  };
+  DeltaFunctions::forEachChanged(
+      delta.getPortsDelta(),
+      [&](const std::shared_ptr<Port>& oldPort,
+          const std::shared_ptr<Port>& newPort) {
+        if (oldPort->getName() != newPort->getName() ||
+            oldPort->getDescription() != newPort->getDescription() ||
+            oldPort->getIngressVlan() != newPort->getIngressVlan()) {
+          invalidate(newPort->getID());
+        }
+      },
+      [&](const std::shared_ptr<Port>& /*newPort*/) {},
+      [&](const std::shared_ptr<Port>& oldPort) {
+        invalidate(oldPort->getID());
+      });
+}
+
 void LldpManager::timeoutExpired() noexcept {
   try {
-    sendLldpOnAllPorts();
+    intervalTxTime_ += sendLldpOnPortSlice(nextTxSlice_, LLDP_TX_SLICES);
   } catch (const std::exception& ex) {
-    XLOG(ERR) << "Failed to send LLDP on all ports. Error:"
-              << folly::exceptionStr(ex);
+    XLOG(ERR) << "Failed to send LLDP on port slice " << nextTxSlice_
+              << ". Error:" << folly::exceptionStr(ex);
+  }
+  nextTxSlice_ = (nextTxSlice_ + 1) % LLDP_TX_SLICES;
+  if (nextTxSlice_ == 0) {
+    sw_->stats()->LldpTxIntervalTime(intervalTxTime_.count());
+    intervalTxTime_ = std::chrono::microseconds(0);
   }
-  scheduleTimeout(intervalMsecs_);
+  scheduleTimeout(intervalMsecs_ / static_cast<uint32_t>(LLDP_TX_SLICES));
 }
 
 void LldpManager::sendLldpOnAllPorts() {
-  // send lldp frames through all the ports here.
+  auto elapsed = sendLldpOnPortSlice(0, 1);
+  sw_->stats()->LldpTxIntervalTime(elapsed.count());
+}
+
+std::chrono::microseconds LldpManager::sendLldpOnPortSlice(
+    uint32_t slice,
+    uint32_t numSlices) {
+  auto begin = std::chrono::steady_clock::now();
+  auto hostname = getHostname();
+  if (hostname != templateHostname_) {
+    // System name is part of every frame, drop all of them
+    auto templates = frameTemplates_.wlock();
+    ++templates->generation;
+    templates->frames.clear();
+    templateHostname_ = hostname;
+  }
+
+  // Read before the state, so that frames built from a state older than an
+  // invalidation aren't cached
+  auto generation = frameTemplates_.rlock()->generation;
+  // send lldp frames through all the ports in this slice here.
   std::shared_ptr<SwitchState> state = sw_->getState();
+  std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> pkts;
   for (const auto& port : *state->getPorts()) {
+    // Sliced by PortID rather than position in the port map, so that adding
+    // or removing ports doesn't move other ports to another slice
+    if (static_cast<uint16_t>(port->getID()) % numSlices != slice) {
+      continue;
+    }
     if (port->isPortUp()) {
-      sendLldpInfo(port);
+      pkts.emplace_back(getLldpPkt(port, hostname, generation), port->getID());
     } else {
       XLOG(DBG5) << "Skipping LLDP send as this port is disabled "
                  << port->getID();
     }
   }
+  if (!pkts.empty()) {
+    // these LLDP packets HAVE to exit out of the ports specified here.
+    sw_->sendNetworkControlPacketsAsync(std::move(pkts));
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
 }
 
 uint16_t tlvHeader(uint16_t type, uint16_t length) {
@@ -333,10 +395,7 @@ std::unique_ptr<TxPacket> LldpManager::createLldpPkt(
   return pkt;
 }
 
-void LldpManager::sendLldpInfo(const std::shared_ptr<Port>& port) {
-  MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-  PortID thisPortID = port->getID();
-
+std::string LldpManager::getHostname() const {
   const size_t kMaxLen = 64;
   std::array<char, kMaxLen> hostname;
   if (0 == gethostname(hostname.data(), kMaxLen)) {
@@ -345,25 +404,52 @@ void LldpManager::sendLldpInfo(const std::shared_ptr<Port>& port) {
   } else {
     hostname[0] = '\0';
   }
+  return std::string(hostname.data());
+}
+
+std::unique_ptr<TxPacket> LldpManager::getLldpPkt(
+    const std::shared_ptr<Port>& port,
+    const std::string& hostname,
+    uint64_t generation) {
+  PortID thisPortID = port->getID();
+  {
+    auto templates = frameTemplates_.rlock();
+    auto it = templates->frames.find(thisPortID);
+    if (it != templates->frames.end()) {
+      const auto& frame = it->second;
+      auto pkt = sw_->allocatePacket(frame->length());
+      memcpy(pkt->buf()->writableData(), frame->data(), frame->length());
+      return pkt;
+    }
+  }
 
+  MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
   auto pkt = LldpManager::createLldpPkt(
       sw_,
       cpuMac,
       port->getIngressVlan(),
-      std::string(hostname.data()),
+      hostname,
       port->getName(),
       port->getDescription(),
       TTL_TLV_VALUE,
       SYSTEM_CAPABILITY_ROUTER);
+  // Keep a private copy, the TxPacket buffer is owned by the HwSwitch and
+  // is released once the packet is sent.
+  auto frame =
+      folly::IOBuf::copyBuffer(pkt->buf()->data(), pkt->buf()->length());
+  {
+    auto templates = frameTemplates_.wlock();
+    if (templates->generation == generation) {
+      templates->frames.insert_or_assign(thisPortID, std::move(frame));
+    }
+  }
+  sw_->stats()->LldpTemplateRebuild();
 
-  // this LLDP packet HAS to exit out of the port specified here.
-  sw_->sendNetworkControlPacketAsync(
-      std::move(pkt), PortDescriptor(thisPortID));
-
-  XLOG(DBG4) << "sent LLDP "
-             << " on port " << port->getID() << " with CPU MAC "
+  XLOG(DBG4) << "built LLDP frame "
+             << " for port " << thisPortID << " with CPU MAC "
              << cpuMac.toString() << " port id " << port->getName()
              << " and vlan " << port->getIngressVlan();
+  return pkt;
 }
 
 } // namespace facebook::fboss
@@ -9,10 +9,14 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include <folly/Synchronized.h>
+#include <folly/io/IOBuf.h>
 #include <folly/io/async/AsyncTimeout.h>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 #include "fboss/agent/Platform.h"
+#include "fboss/agent/StateObserver.h"
 #include "fboss/agent/lldp/LinkNeighborDB.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/PortMap.h"
@@ -29,7 +33,8 @@ namespace facebook::fboss {
 class RxPacket;
 class TxPacket;
 
-class LldpManager : private folly::AsyncTimeout {
+class LldpManager : private folly::AsyncTimeout,
+                    public AutoRegisterStateObserver {
   /*
    * LldpManager is the class that manages Lldp support.
    * Responsible for processing received LLDP frames and maintaining the
@@ -38,6 +43,13 @@ class LldpManager : private folly::AsyncTimeout {
    * to inform of this switch's presence to its neighbors. Hence inheriting
    * the AsyncTimeout class for that purpose.
    *
+   * The frame sent on a port only changes when the port name, description or
+   * ingress VLAN (or the system name) changes, so a fully encoded frame is
+   * cached per port and only copied into a fresh TxPacket on every interval.
+   * Cached frames are invalidated from stateUpdated(). Transmission is spread
+   * across LLDP_TX_SLICES timer ticks per interval so that high port count
+   * platforms do not burst all LLDP frames at once.
+   *
    * http://www.ieee802.org/1/files/public/docs2002/lldp-protocol-00.pdf
    */
  public:
@@ -54,7 +66,9 @@ class LldpManager : private folly::AsyncTimeout {
     SYSTEM_CAPABILITY_ROUTER = 1 << 4, // 5th bit for router
     TTL_TLV_LENGTH = 0x2,
     TTL_TLV_VALUE = 120,
-    PDU_END_TLV_LENGTH = 0
+    PDU_END_TLV_LENGTH = 0,
+    // Number of timer ticks a single LLDP_INTERVAL is split into
+    LLDP_TX_SLICES = 8
   };
   explicit LldpManager(SwSwitch* sw);
   ~LldpManager() override;
@@ -106,6 +120,17 @@ class LldpManager : private folly::AsyncTimeout {
   // This function is internal.  It is only public for use in unit tests.
   void sendLldpOnAllPorts();
 
+  void stateUpdated(const StateDelta& delta) override;
+
+  // Number of ports with a cached LLDP frame. Used in unit tests.
+  size_t getNumFrameTemplates() const {
+    return frameTemplates_.rlock()->frames.size();
+  }
+  bool hasFrameTemplate(PortID port) const {
+    auto templates = frameTemplates_.rlock();
+    return templates->frames.find(port) != templates->frames.end();
+  }
+
   LinkNeighborDB* getDB() {
     return &db_;
   }
@@ -124,11 +149,39 @@ class LldpManager : private folly::AsyncTimeout {
 
  private:
   void timeoutExpired() noexcept override;
-  void sendLldpInfo(const std::shared_ptr<Port>& port);
+  /*
+   * Send LLDP frames on every up port in the given slice, i.e.
+   * (PortID % numSlices) == slice. Returns the time spent building and
+   * sending the frames.
+   */
+  std::chrono::microseconds sendLldpOnPortSlice(
+      uint32_t slice,
+      uint32_t numSlices);
+  std::unique_ptr<TxPacket> getLldpPkt(
+      const std::shared_ptr<Port>& port,
+      const std::string& hostname,
+      uint64_t generation);
+  std::string getHostname() const;
 
   SwSwitch* sw_{nullptr};
   std::chrono::milliseconds intervalMsecs_;
   LinkNeighborDB db_;
+
+  struct FrameTemplates {
+    // Fully encoded LLDP frames, indexed by the port they are sent out of.
+    std::unordered_map<PortID, std::unique_ptr<folly::IOBuf>> frames;
+    // Bumped on every invalidation, so that a frame built from a port older
+    // than an invalidation isn't cached
+    uint64_t generation{0};
+  };
+  folly::Synchronized<FrameTemplates> frameTemplates_;
+  // System name the cached frames were built with. Only accessed from the
+  // background thread.
+  std::string templateHostname_;
+  // Next slice to send and time spent sending the current interval so far.
+  // Only accessed from the background thread.
+  uint32_t nextTxSlice_{0};
+  std::chrono::microseconds intervalTxTime_{0};
 };
 
 } // namespace facebook::fboss
@@ -34,8 +34,35 @@ int LookupClassUpdater::getRefCnt(
   }
 }
 
+int& LookupClassUpdater::classIDCount(
+    ClassID2Count& classID2Count,
+    cfg::AclLookupClass classID) {
+  auto iter = std::lower_bound(
+      classID2Count.begin(),
+      classID2Count.end(),
+      classID,
+      [](const auto& entry, auto id) { return entry.first < id; });
+  if (iter == classID2Count.end() || iter->first != classID) {
+    iter = classID2Count.insert(iter, std::make_pair(classID, 0));
+  }
+  return iter->second;
+}
+
+LookupClassUpdater::ClassID2Count& LookupClassUpdater::getClassID2Count(
+    PortID portID) {
+  auto index = static_cast<size_t>(portID);
+  if (index >= port2ClassIDAndCount_.size()) {
+    port2ClassIDAndCount_.resize(index + 1);
+  }
+  auto& classID2Count = port2ClassIDAndCount_[index];
+  if (!classID2Count.has_value()) {
+    classID2Count.emplace();
+  }
+  return classID2Count.value();
+}
+
 cfg::AclLookupClass LookupClassUpdater::getClassIDwithMinimumNeighbors(
-    ClassID2Count classID2Count) const {
+    const ClassID2Count& classID2Count) const {
   auto minItr = std::min_element(
       classID2Count.begin(),
       classID2Count.end(),
@@ -45,6 +72,63 @@ cfg::AclLookupClass LookupClassUpdater::getClassIDwithMinimumNeighbors(
   return minItr->first;
 }
 
+template <typename NeighborEntryT>
+void LookupClassUpdater::enqueueClassIDUpdate(
+    VlanID vlanID,
+    const std::shared_ptr<NeighborEntryT>& entry,
+    std::optional<cfg::AclLookupClass> classID) {
+  if constexpr (std::is_same_v<NeighborEntryT, MacEntry>) {
+    pendingMacClassIDUpdates_.push_back({vlanID, entry, classID});
+  } else if constexpr (std::is_same_v<NeighborEntryT, ArpEntry>) {
+    pendingArpClassIDUpdates_[vlanID].emplace_back(entry->getIP(), classID);
+  } else {
+    pendingNdpClassIDUpdates_[vlanID].emplace_back(entry->getIP(), classID);
+  }
+}
+
+void LookupClassUpdater::applyPendingClassIDUpdates() {
+  if (!pendingMacClassIDUpdates_.empty()) {
+    auto numUpdates = pendingMacClassIDUpdates_.size();
+    auto updateMacClassIDsFn =
+        [updates = std::move(pendingMacClassIDUpdates_)](
+            const std::shared_ptr<SwitchState>& state) {
+          // Updates are applied in the order they were computed, so a
+          // remove followed by re-add (e.g. MAC move) is preserved.
+          auto newState = state;
+          for (const auto& update : updates) {
+            newState = update.classID.has_value()
+                ? MacTableUtils::updateOrAddEntryWithClassID(
+                      newState,
+                      update.vlanID,
+                      update.entry,
+                      update.classID.value())
+                : MacTableUtils::removeClassIDForEntry(
+                      newState, update.vlanID, update.entry);
+          }
+          return newState;
+        };
+    pendingMacClassIDUpdates_.clear();
+
+    sw_->updateState(
+        StateUpdateDescriptor(
+            StateUpdateCategory::MAC_CLASS_ID,
+            static_cast<int64_t>(numUpdates)),
+        std::move(updateMacClassIDsFn));
+  }
+
+  auto updater = sw_->getNeighborUpdater();
+  for (auto& [vlanID, updates] : pendingArpClassIDUpdates_) {
+    updater->updateEntryClassIDs<folly::IPAddressV4>(
+        vlanID, std::move(updates));
+  }
+  pendingArpClassIDUpdates_.clear();
+  for (auto& [vlanID, updates] : pendingNdpClassIDUpdates_) {
+    updater->updateEntryClassIDs<folly::IPAddressV6>(
+        vlanID, std::move(updates));
+  }
+  pendingNdpClassIDUpdates_.clear();
+}
+
 template <typename RemovedEntryT>
 void LookupClassUpdater::removeClassIDForPortAndMac(
     const std::shared_ptr<SwitchState>& switchState,
@@ -72,37 +156,28 @@ void LookupClassUpdater::removeClassIDForPortAndMac(
   }
 
   removeNeighborFromLocalCacheForEntry(removedEntry, vlan);
-
-  if constexpr (std::is_same_v<RemovedEntryT, MacEntry>) {
-    auto removeMacClassIDFn = [vlan, removedEntry](
-                                  const std::shared_ptr<SwitchState>& state) {
-      return MacTableUtils::removeClassIDForEntry(state, vlan, removedEntry);
-    };
-
-    sw_->updateState("remove classID: ", std::move(removeMacClassIDFn));
-  } else {
-    auto updater = sw_->getNeighborUpdater();
-    updater->updateEntryClassID(vlan, removedEntry->getIP());
-  }
+  enqueueClassIDUpdate(vlan, removedEntry);
 }
 
 bool LookupClassUpdater::isInited(PortID portID) {
+  auto index = static_cast<size_t>(portID);
   return port2MacAndVlanEntries_.find(portID) !=
       port2MacAndVlanEntries_.end() &&
-      port2ClassIDAndCount_.find(portID) != port2ClassIDAndCount_.end();
+      index < port2ClassIDAndCount_.size() &&
+      port2ClassIDAndCount_[index].has_value();
 }
 
 void LookupClassUpdater::initPort(
     const std::shared_ptr<SwitchState>& switchState,
     const std::shared_ptr<Port>& port) {
   auto& macAndVlan2ClassIDAndRefCnt = port2MacAndVlanEntries_[port->getID()];
-  auto& classID2Count = port2ClassIDAndCount_[port->getID()];
+  auto& classID2Count = getClassID2Count(port->getID());
 
   macAndVlan2ClassIDAndRefCnt.clear();
   classID2Count.clear();
 
   for (auto classID : port->getLookupClassesToDistributeTrafficOn()) {
-    classID2Count[classID] = 0;
+    classIDCount(classID2Count, classID) = 0;
   }
 }
 
@@ -140,7 +215,7 @@ void LookupClassUpdater::updateNeighborClassID(
   auto setDropClassID = isPresentInBlockList(vlanID, newEntry);
   auto mac = newEntry->getMac();
   auto& macAndVlan2ClassIDAndRefCnt = port2MacAndVlanEntries_[port->getID()];
-  auto& classID2Count = port2ClassIDAndCount_[port->getID()];
+  auto& classID2Count = getClassID2Count(port->getID());
 
   cfg::AclLookupClass classID;
 
@@ -159,7 +234,7 @@ void LookupClassUpdater::updateNeighborClassID(
     if (!setDropClassID) {
       // classID2Count is maitanined to compute getClassIDwithMinimumNeighbors
       // CLASS_DROP is not part of that computation.
-      classID2Count[classID]++;
+      classIDCount(classID2Count, classID)++;
     }
   } else {
     auto& [_classID, refCnt] = iter->second;
@@ -175,20 +250,7 @@ void LookupClassUpdater::updateNeighborClassID(
   XLOG(DBG2) << "Updating Qos Policy for Updated Neighbor: port: "
              << newEntry->str() << " classID: " << static_cast<int>(classID);
 
-  if constexpr (std::is_same_v<NewEntryT, MacEntry>) {
-    auto updateMacClassIDFn =
-        [vlanID, newEntry, classID](const std::shared_ptr<SwitchState>& state) {
-          return MacTableUtils::updateOrAddEntryWithClassID(
-              state, vlanID, newEntry, classID);
-        };
-
-    sw_->updateState(
-        folly::to<std::string>("configure lookup classID: ", classID),
-        std::move(updateMacClassIDFn));
-  } else {
-    auto updater = sw_->getNeighborUpdater();
-    updater->updateEntryClassID(vlanID, newEntry->getIP(), classID);
-  }
+  enqueueClassIDUpdate(vlanID, newEntry, classID);
 }
 
 template <typename NeighborEntryT>
@@ -322,17 +384,7 @@ void LookupClassUpdater::processChanged(
       if (oldEntry->getClassID().has_value() &&
           !newEntry->getClassID().has_value() && port &&
           port->getLookupClassesToDistributeTrafficOn().size() != 0) {
-        auto classID = oldEntry->getClassID().value();
-        auto updateMacClassIDFn =
-            [vlan, newEntry, classID](
-                const std::shared_ptr<SwitchState>& state) {
-              return MacTableUtils::updateOrAddEntryWithClassID(
-                  state, vlan, newEntry, classID);
-            };
-
-        sw_->updateState(
-            folly::to<std::string>("Reconfigure lookup classID: ", classID),
-            std::move(updateMacClassIDFn));
+        enqueueClassIDUpdate(vlan, newEntry, oldEntry->getClassID());
       } else {
         updateNeighborClassID(stateDelta.newState(), vlan, newEntry);
       }
@@ -384,18 +436,7 @@ void LookupClassUpdater::clearClassIdsForResolvedNeighbors(
           entry->getPort().phyPortID() == portID &&
           entry->getClassID().has_value() && !isNoHostRoute(entry)) {
         removeNeighborFromLocalCacheForEntry(entry, vlanID);
-        if constexpr (std::is_same_v<AddrT, MacAddress>) {
-          auto removeMacClassIDFn =
-              [vlanID, entry](const std::shared_ptr<SwitchState>& state) {
-                return MacTableUtils::removeClassIDForEntry(
-                    state, vlanID, entry);
-              };
-
-          sw_->updateState("remove classID: ", std::move(removeMacClassIDFn));
-        } else {
-          auto updater = sw_->getNeighborUpdater();
-          updater->updateEntryClassID(vlanID, entry.get()->getIP());
-        }
+        enqueueClassIDUpdate(vlanID, entry);
       }
     }
   }
@@ -484,7 +525,9 @@ void LookupClassUpdater::processPortRemoved(
   }
 
   port2MacAndVlanEntries_.erase(portID);
-  port2ClassIDAndCount_.erase(portID);
+  if (static_cast<size_t>(portID) < port2ClassIDAndCount_.size()) {
+    port2ClassIDAndCount_[static_cast<size_t>(portID)].reset();
+  }
 }
 
 void LookupClassUpdater::processPortChanged(
@@ -581,7 +624,7 @@ void LookupClassUpdater::removeNeighborFromLocalCacheForEntry(
   auto& macAndVlan2ClassIDAndRefCnt = port2MacAndVlanEntries_[portID];
   auto& [classID, refCnt] =
       macAndVlan2ClassIDAndRefCnt[std::make_pair(mac, vlanID)];
-  auto& classID2Count = port2ClassIDAndCount_[portID];
+  auto& classID2Count = getClassID2Count(portID);
 
   XLOG(DBG2) << "Reference count: " << (int)refCnt
              << " for classID: " << (int)classID;
@@ -596,8 +639,9 @@ void LookupClassUpdater::removeNeighborFromLocalCacheForEntry(
     if (!isDropClassID) {
       // classID2Count is maitanined to compute getClassIDwithMinimumNeighbors
       // CLASS_DROP is not part of that computation.
-      classID2Count[classID]--;
-      CHECK_GE(classID2Count[classID], 0);
+      auto& count = classIDCount(classID2Count, classID);
+      count--;
+      CHECK_GE(count, 0);
     }
 
     macAndVlan2ClassIDAndRefCnt.erase(std::make_pair(mac, vlanID));
@@ -612,7 +656,7 @@ void LookupClassUpdater::updateStateObserverLocalCacheForEntry(
 
   auto portID = newEntry->getPort().phyPortID();
   auto& macAndVlan2ClassIDAndRefCnt = port2MacAndVlanEntries_[portID];
-  auto& classID2Count = port2ClassIDAndCount_[portID];
+  auto& classID2Count = getClassID2Count(portID);
   auto classID = newEntry->getClassID().value();
   auto isDropClassID = (classID == cfg::AclLookupClass::CLASS_DROP);
   auto mac = newEntry->getMac();
@@ -626,7 +670,7 @@ void LookupClassUpdater::updateStateObserverLocalCacheForEntry(
     if (!isDropClassID) {
       // classID2Count is maitanined to compute getClassIDwithMinimumNeighbors
       // CLASS_DROP is not part of that computation.
-      classID2Count[classID]++;
+      classIDCount(classID2Count, classID)++;
     }
 
     XLOG(DBG2) << "Create neighbor entry for port: " << portID
@@ -806,6 +850,8 @@ void LookupClassUpdater::stateUpdated(const StateDelta& stateDelta) {
   VlanTableDeltaCallbackGenerator::genCallbacks(stateDelta, *this);
   processPortUpdates(stateDelta);
   processBlockNeighborUpdates(stateDelta);
+
+  applyPendingClassIDUpdates();
 }
 
 } // namespace facebook::fboss
@@ -12,6 +12,10 @@
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/state/StateDelta.h"
 
+#include <optional>
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
 
 class LookupClassUpdater : public AutoRegisterStateObserver {
@@ -29,7 +33,16 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
       cfg::AclLookupClass classID);
 
  private:
-  using ClassID2Count = boost::container::flat_map<cfg::AclLookupClass, int>;
+  /*
+   * The number of lookup classes per port is small (< 10), so keep the
+   * (classID, count) pairs in a vector sorted by classID rather than a map.
+   */
+  using ClassID2Count = std::vector<std::pair<cfg::AclLookupClass, int>>;
+
+  static int& classIDCount(
+      ClassID2Count& classID2Count,
+      cfg::AclLookupClass classID);
+  ClassID2Count& getClassID2Count(PortID portID);
 
   bool portHasClassID(const std::shared_ptr<Port>& port);
 
@@ -74,7 +87,19 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
       const std::shared_ptr<RemovedEntryT>& removedEntry);
 
   cfg::AclLookupClass getClassIDwithMinimumNeighbors(
-      ClassID2Count classID2Count) const;
+      const ClassID2Count& classID2Count) const;
+
+  /*
+   * ClassID changes computed while processing a StateDelta are queued here
+   * and applied at the end of stateUpdated(): one state update for all the
+   * MAC entries and one neighbor cache update per (vlan, address family).
+   */
+  template <typename NeighborEntryT>
+  void enqueueClassIDUpdate(
+      VlanID vlanID,
+      const std::shared_ptr<NeighborEntryT>& entry,
+      std::optional<cfg::AclLookupClass> classID = std::nullopt);
+  void applyPendingClassIDUpdates();
 
   template <typename RemovedEntryT>
   void removeNeighborFromLocalCacheForEntry(
@@ -145,9 +170,10 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
   /*
    * Maintains the number of times a classID is used. When a new MAC + vlan
    * requires classID assignment, port2ClassIDAndCount_ is used to determine
-   * the least used classID. This is maintained in a map for every port.
+   * the least used classID. This is indexed by PortID, and is std::nullopt
+   * for ports that are not inited.
    */
-  boost::container::flat_map<PortID, ClassID2Count> port2ClassIDAndCount_;
+  std::vector<std::optional<ClassID2Count>> port2ClassIDAndCount_;
 
   /*
    * Maintains:
@@ -191,6 +217,20 @@ class LookupClassUpdater : public AutoRegisterStateObserver {
    */
   std::set<std::pair<VlanID, folly::IPAddress>> blockedNeighbors_;
 
+  struct MacClassIDUpdate {
+    VlanID vlanID;
+    std::shared_ptr<MacEntry> entry;
+    std::optional<cfg::AclLookupClass> classID;
+  };
+  template <typename AddrT>
+  using NeighborClassIDUpdates = boost::container::flat_map<
+      VlanID,
+      std::vector<std::pair<AddrT, std::optional<cfg::AclLookupClass>>>>;
+
+  std::vector<MacClassIDUpdate> pendingMacClassIDUpdates_;
+  NeighborClassIDUpdates<folly::IPAddressV4> pendingArpClassIDUpdates_;
+  NeighborClassIDUpdates<folly::IPAddressV6> pendingNdpClassIDUpdates_;
+
   friend class VlanTableDeltaCallbackGenerator;
   bool inited_{false};
 };
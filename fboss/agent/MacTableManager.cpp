@@ -26,8 +26,12 @@ void MacTableManager::handleL2LearningUpdate(
         return MacTableUtils::updateMacTable(state, l2Entry, l2EntryUpdateType);
       };
 
+  auto category =
+      l2EntryUpdateType == L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD
+      ? StateUpdateCategory::MAC_LEARNING_ADD
+      : StateUpdateCategory::MAC_LEARNING_DELETE;
   sw_->updateState(
-      folly::to<std::string>("Programming : ", l2Entry.str()),
+      StateUpdateDescriptor(category, l2Entry.getMac()),
       std::move(updateMacTableFn));
 }
 
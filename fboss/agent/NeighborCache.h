@@ -103,6 +103,11 @@ class NeighborCache {
     impl_->updateEntryClassID(ip, classID);
   }
 
+  void updateEntryClassIDs(
+      const NeighborEntryClassIDUpdates<AddressType>& updates) {
+    impl_->updateEntryClassIDs(updates);
+  }
+
  protected:
   // protected constructor since this is only meant to be inherited from
   NeighborCache(
@@ -101,7 +101,9 @@ void NeighborCacheImpl<NTable>::programEntry(Entry* entry) {
   };
 
   sw_->updateState(
-      folly::to<std::string>("add neighbor ", fields.ip), std::move(updateFn));
+      StateUpdateDescriptor(
+          StateUpdateCategory::NEIGHBOR_ADD, folly::IPAddress(fields.ip)),
+      std::move(updateFn));
 }
 
 template <typename NTable>
@@ -140,7 +142,8 @@ void NeighborCacheImpl<NTable>::programPendingEntry(Entry* entry, bool force) {
   };
 
   sw_->updateStateNoCoalescing(
-      folly::to<std::string>("add pending entry ", fields.ip),
+      StateUpdateDescriptor(
+          StateUpdateCategory::NEIGHBOR_PENDING, folly::IPAddress(fields.ip)),
       std::move(updateFn));
 }
 
@@ -224,16 +227,74 @@ void NeighborCacheImpl<NTable>::updateEntryClassID(
           return newState;
         };
 
-    auto classIDStr = classID.has_value()
-        ? folly::to<std::string>(static_cast<int>(classID.value()))
-        : "None";
     sw_->updateState(
-        folly::to<std::string>(
-            "NeighborCache configure lookup classID: ", classIDStr),
+        StateUpdateDescriptor(
+            StateUpdateCategory::NEIGHBOR_CLASS_ID, folly::IPAddress(ip)),
         std::move(updateClassIDFn));
   }
 }
 
+template <typename NTable>
+void NeighborCacheImpl<NTable>::updateEntryClassIDs(
+    const NeighborEntryClassIDUpdates<AddressType>& updates) {
+  /*
+   * Update the cache entries right away, but fold the corresponding switch
+   * state changes into a single update: on a port flap, LookupClassUpdater
+   * can generate thousands of these and one state update per neighbor
+   * would otherwise be queued.
+   */
+  NeighborEntryClassIDUpdates<AddressType> toApply;
+  toApply.reserve(updates.size());
+  for (const auto& [ip, classID] : updates) {
+    auto entry = getCacheEntry(ip);
+    if (entry) {
+      entry->updateClassID(classID);
+      toApply.emplace_back(ip, classID);
+    }
+  }
+
+  if (toApply.empty()) {
+    return;
+  }
+
+  auto updateClassIDsFn = [this, toApply = std::move(toApply)](
+                              const std::shared_ptr<SwitchState>& state)
+      -> std::shared_ptr<SwitchState> {
+    auto vlan = state->getVlans()->getVlanIf(vlanID_).get();
+    if (!vlan) {
+      return nullptr;
+    }
+    std::shared_ptr<SwitchState> newState{state};
+    auto* table = vlan->template getNeighborTable<NTable>().get();
+    bool changed = false;
+
+    for (const auto& [ip, classID] : toApply) {
+      auto node = table->getNodeIf(ip);
+      if (!node) {
+        continue;
+      }
+      auto fields = EntryFields(
+          node->getIP(),
+          node->getMac(),
+          node->getPort(),
+          node->getIntfID(),
+          node->getState(),
+          classID);
+      table = table->modify(&vlan, &newState);
+      table->updateEntry(fields);
+      changed = true;
+    }
+
+    return changed ? newState : nullptr;
+  };
+
+  sw_->updateState(
+      StateUpdateDescriptor(
+          StateUpdateCategory::NEIGHBOR_CLASS_ID,
+          static_cast<int64_t>(updates.size())),
+      std::move(updateClassIDsFn));
+}
+
 template <typename NTable>
 NeighborCacheEntry<NTable>* NeighborCacheImpl<NTable>::setEntryInternal(
     const EntryFields& fields,
@@ -360,9 +421,15 @@ void NeighborCacheImpl<NTable>::flushEntry(AddressType ip, bool* flushed) {
   if (flushed) {
     // need a blocking state update if the caller wants to know if an entry
     // was actually flushed
-    sw_->updateStateBlocking("flush neighbor entry", std::move(updateFn));
+    sw_->updateStateBlocking(
+        StateUpdateDescriptor(
+            StateUpdateCategory::NEIGHBOR_REMOVE, folly::IPAddress(ip)),
+        std::move(updateFn));
   } else {
-    sw_->updateState("remove neighbor entry: " + ip.str(), std::move(updateFn));
+    sw_->updateState(
+        StateUpdateDescriptor(
+            StateUpdateCategory::NEIGHBOR_REMOVE, folly::IPAddress(ip)),
+        std::move(updateFn));
   }
 }
 
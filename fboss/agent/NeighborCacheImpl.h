@@ -21,6 +21,8 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -28,6 +30,16 @@ class Vlan;
 template <typename NTable>
 class NeighborCache;
 
+/*
+ * A batch of (neighbor IP, classID) assignments for a single vlan. A classID
+ * of std::nullopt disassociates classID from the neighbor. Entries are applied
+ * in order, so the same IP may appear more than once (e.g. remove followed by
+ * re-add).
+ */
+template <typename AddrT>
+using NeighborEntryClassIDUpdates =
+    std::vector<std::pair<AddrT, std::optional<cfg::AclLookupClass>>>;
+
 /*
  * This class manages the sw state of the neighbor tables. It has
  * a map of NeighborCacheEntries that should each correspond to
@@ -87,6 +99,9 @@ class NeighborCacheImpl {
       AddressType ip,
       std::optional<cfg::AclLookupClass> classID = std::nullopt);
 
+  void updateEntryClassIDs(
+      const NeighborEntryClassIDUpdates<AddressType>& updates);
+
   std::unique_ptr<EntryFields> cloneEntryFields(AddressType ip);
 
   void portDown(PortDescriptor port);
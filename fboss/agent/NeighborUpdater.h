@@ -102,6 +102,17 @@ class NeighborUpdater : public AutoRegisterStateObserver {
     }
   }
 
+  template <typename AddrT>
+  void updateEntryClassIDs(
+      VlanID vlan,
+      NeighborEntryClassIDUpdates<AddrT> updates) {
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      updateArpEntryClassIDs(vlan, std::move(updates));
+    } else {
+      updateNdpEntryClassIDs(vlan, std::move(updates));
+    }
+  }
+
  private:
   void portChanged(
       const std::shared_ptr<Port>& oldPort,
@@ -269,4 +269,18 @@ void NeighborUpdaterImpl::updateNdpEntryClassID(
   cache->updateEntryClassID(ip, classID);
 }
 
+void NeighborUpdaterImpl::updateArpEntryClassIDs(
+    VlanID vlan,
+    ArpEntryClassIDUpdates updates) {
+  auto cache = getArpCacheFor(vlan);
+  cache->updateEntryClassIDs(updates);
+}
+
+void NeighborUpdaterImpl::updateNdpEntryClassIDs(
+    VlanID vlan,
+    NdpEntryClassIDUpdates updates) {
+  auto cache = getNdpCacheFor(vlan);
+  cache->updateEntryClassIDs(updates);
+}
+
 } // namespace facebook::fboss
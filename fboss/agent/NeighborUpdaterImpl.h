@@ -28,6 +28,10 @@ class Vlan;
 enum ArpOpCode : uint16_t;
 enum class ICMPv6Type : uint8_t;
 
+// Aliases so that the types can be used as NeighborUpdater.def arguments.
+using ArpEntryClassIDUpdates = NeighborEntryClassIDUpdates<folly::IPAddressV4>;
+using NdpEntryClassIDUpdates = NeighborEntryClassIDUpdates<folly::IPAddressV6>;
+
 struct NeighborCaches {
   // These are shared_ptrs for safety reasons as it lets callers safely use
   // the results of getArpCacheFor or getNdpCacheFor even if the vlan is
@@ -110,4 +110,12 @@ void NeighborUpdaterNoopImpl::updateNdpEntryClassID(
     VlanID /*vlan*/,
     folly::IPAddressV6 /*ip*/,
     std::optional<cfg::AclLookupClass> /*classID*/) {}
+
+void NeighborUpdaterNoopImpl::updateArpEntryClassIDs(
+    VlanID /*vlan*/,
+    ArpEntryClassIDUpdates /*updates*/) {}
+
+void NeighborUpdaterNoopImpl::updateNdpEntryClassIDs(
+    VlanID /*vlan*/,
+    NdpEntryClassIDUpdates /*updates*/) {}
 } // namespace facebook::fboss
@@ -12,50 +12,21 @@
 #include "fboss/agent/FibHelpers.h"
 #include "fboss/agent/state/DeltaFunctions.h"
 
-namespace facebook::fboss {
+#include <fb303/ServiceData.h>
+#include <gflags/gflags.h>
 
-namespace {
-template <typename AddrT>
-void handleChangedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    RouterID /*rid*/,
-    const std::shared_ptr<Route<AddrT>>& oldRoute,
-    const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logChangedRoute(oldRoute, newRoute, matchedIdentifiers);
-  }
-}
+DEFINE_int32(
+    route_update_log_queue_size,
+    1000000,
+    "Maximum number of route updates waiting to be logged. Updates beyond it "
+    "are dropped.");
 
-template <typename AddrT>
-void handleRemovedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    RouterID /*rid*/,
-    const std::shared_ptr<Route<AddrT>>& oldRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logRemovedRoute(oldRoute, matchedIdentifiers);
-  }
-}
-
-template <typename AddrT>
-void handleAddedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
-    const std::unique_ptr<RouteLogger<AddrT>>& logger,
-    RouterID /*rid*/,
-    const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = newRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logAddedRoute(newRoute, matchedIdentifiers);
-  }
-}
+namespace {
+constexpr auto kDroppedUpdates = "route_update_logger.dropped_updates";
 } // anonymous namespace
 
+namespace facebook::fboss {
+
 RouteUpdateLogger::RouteUpdateLogger(SwSwitch* sw)
     : RouteUpdateLogger(
           sw,
@@ -72,65 +43,150 @@ RouteUpdateLogger::RouteUpdateLogger(
       swSwitch_(sw),
       routeLoggerV4_(std::move(routeLoggerV4)),
       routeLoggerV6_(std::move(routeLoggerV6)),
-      mplsRouteLogger_(std::move(mplsRouteLogger)) {}
+      mplsRouteLogger_(std::move(mplsRouteLogger)) {
+  CHECK(mplsRouteLogger_);
+}
 
 void RouteUpdateLogger::stateUpdated(const StateDelta& delta) {
-  forEachChangedRoute<folly::IPAddressV4>(
-      delta,
-      &handleChangedRoute<folly::IPAddressV4>,
-      &handleAddedRoute<folly::IPAddressV4>,
-      &handleRemovedRoute<folly::IPAddressV4>,
-      prefixTracker_,
-      routeLoggerV4_);
-  forEachChangedRoute<folly::IPAddressV6>(
-      delta,
-      &handleChangedRoute<folly::IPAddressV6>,
-      &handleAddedRoute<folly::IPAddressV6>,
-      &handleRemovedRoute<folly::IPAddressV6>,
-      prefixTracker_,
-      routeLoggerV6_);
-
-  auto* mplsRouteLogger = mplsRouteLogger_.get();
-  CHECK(mplsRouteLogger);
-  const auto labelTracker = labelTracker_.rlock();
-
-  DeltaFunctions::forEachChanged(
-      delta.getLabelForwardingInformationBaseDelta(),
-      [mplsRouteLogger, &labelTracker](
-          const auto& oldEntry, const auto& newEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(oldEntry->getID(), identifiers);
-        if (identifiers.empty()) {
-          return;
-        }
-        mplsRouteLogger->logChangedRoute(
-            oldEntry,
-            newEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
-      },
-      [mplsRouteLogger, &labelTracker](const auto& addedEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(addedEntry->getID(), identifiers);
-        if (identifiers.empty()) {
-          return;
-        }
-        mplsRouteLogger->logAddedRoute(
-            addedEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
-      },
-      [mplsRouteLogger, &labelTracker](const auto& removedEntry) {
-        std::set<std::string> identifiers;
-        labelTracker->getIdentifiersForLabel(
-            removedEntry->getID(), identifiers);
-        if (identifiers.empty()) {
-          return;
-        }
-        mplsRouteLogger->logRemovedRoute(
-            removedEntry,
-            std::vector<std::string>(identifiers.begin(), identifiers.end()));
+  PendingUpdates updates;
+  // A wide tracked prefix matches many routes for the same subscribers, so
+  // consecutive updates share their identifiers when they're the same
+  std::shared_ptr<const std::vector<std::string>> lastIdentifiers;
+  auto capture = [&updates, &lastIdentifiers](
+                     const auto& oldRoute,
+                     const auto& newRoute,
+                     std::vector<std::string>&& identifiers) {
+    if (!lastIdentifiers || *lastIdentifiers != identifiers) {
+      lastIdentifiers = std::make_shared<const std::vector<std::string>>(
+          std::move(identifiers));
+    }
+    using RouteT =
+        typename std::decay_t<decltype(oldRoute)>::element_type;
+    updates.push_back(
+        PendingUpdate<RouteT>{oldRoute, newRoute, lastIdentifiers});
+  };
+
+  auto captureRoutes = [&](auto addr) {
+    using AddrT = decltype(addr);
+    using RoutePtr = std::shared_ptr<Route<AddrT>>;
+    forEachChangedRoute<AddrT>(
+        delta,
+        [&](RouterID /*rid*/,
+            const RoutePtr& oldRoute,
+            const RoutePtr& newRoute) {
+          std::vector<std::string> identifiers;
+          if (prefixTracker_.tracking(oldRoute->prefix(), identifiers)) {
+            capture(oldRoute, newRoute, std::move(identifiers));
+          }
+        },
+        [&](RouterID /*rid*/, const RoutePtr& newRoute) {
+          std::vector<std::string> identifiers;
+          if (prefixTracker_.tracking(newRoute->prefix(), identifiers)) {
+            capture(RoutePtr(), newRoute, std::move(identifiers));
+          }
+        },
+        [&](RouterID /*rid*/, const RoutePtr& oldRoute) {
+          std::vector<std::string> identifiers;
+          if (prefixTracker_.tracking(oldRoute->prefix(), identifiers)) {
+            capture(oldRoute, RoutePtr(), std::move(identifiers));
+          }
+        });
+  };
+  captureRoutes(folly::IPAddressV4());
+  captureRoutes(folly::IPAddressV6());
+
+  {
+    using EntryPtr = std::shared_ptr<LabelForwardingEntry>;
+    const auto labelTracker = labelTracker_.rlock();
+    auto captureLabel = [&](const EntryPtr& oldEntry,
+                            const EntryPtr& newEntry) {
+      std::set<std::string> identifiers;
+      labelTracker->getIdentifiersForLabel(
+          (oldEntry ? oldEntry : newEntry)->getID(), identifiers);
+      if (identifiers.empty()) {
+        return;
+      }
+      capture(
+          oldEntry,
+          newEntry,
+          std::vector<std::string>(identifiers.begin(), identifiers.end()));
+    };
+    DeltaFunctions::forEachChanged(
+        delta.getLabelForwardingInformationBaseDelta(),
+        [&](const auto& oldEntry, const auto& newEntry) {
+          captureLabel(oldEntry, newEntry);
+        },
+        [&](const auto& addedEntry) { captureLabel(EntryPtr(), addedEntry); },
+        [&](const auto& removedEntry) {
+          captureLabel(removedEntry, EntryPtr());
+        });
+  }
+
+  if (updates.empty()) {
+    return;
+  }
+  // Drop what doesn't fit in the queue rather than blocking the update thread
+  uint64_t maxPending = std::max(FLAGS_route_update_log_queue_size, 0);
+  uint64_t pending = pendingUpdates_;
+  uint64_t room = pending < maxPending ? maxPending - pending : 0;
+  if (updates.size() > room) {
+    auto dropped = updates.size() - room;
+    updates.erase(updates.begin() + room, updates.end());
+    droppedUpdates_ += dropped;
+    fb303::fbData->addStatValue(kDroppedUpdates, dropped, fb303::SUM);
+    XLOG_EVERY_MS(WARNING, 1000)
+        << "Dropped " << dropped << " route updates to log, " << pending
+        << " updates are waiting to be logged";
+    if (updates.empty()) {
+      return;
+    }
+  }
+  pendingUpdates_ += updates.size();
+  logThread_.getEventBase()->runInEventBaseThread(
+      [this, updates = std::move(updates)]() {
+        logUpdates(updates);
+        pendingUpdates_ -= updates.size();
       });
 }
 
+void RouteUpdateLogger::logUpdates(const PendingUpdates& updates) {
+  for (const auto& update : updates) {
+    std::visit(
+        [this](const auto& pendingUpdate) {
+          using RouteT = typename std::decay_t<
+              decltype(pendingUpdate.oldRoute)>::element_type;
+          if constexpr (std::is_same_v<RouteT, Route<folly::IPAddressV4>>) {
+            logUpdate(routeLoggerV4_.get(), pendingUpdate);
+          } else if constexpr (std::is_same_v<
+                                   RouteT,
+                                   Route<folly::IPAddressV6>>) {
+            logUpdate(routeLoggerV6_.get(), pendingUpdate);
+          } else {
+            logUpdate(mplsRouteLogger_.get(), pendingUpdate);
+          }
+        },
+        update);
+  }
+}
+
+template <typename RouteT>
+void RouteUpdateLogger::logUpdate(
+    RouteLoggerBase<RouteT>* logger,
+    const PendingUpdate<RouteT>& update) {
+  const auto& identifiers = *update.identifiers;
+  if (!update.oldRoute) {
+    logger->logAddedRoute(update.newRoute, identifiers);
+  } else if (!update.newRoute) {
+    logger->logRemovedRoute(update.oldRoute, identifiers);
+  } else {
+    logger->logChangedRoute(update.oldRoute, update.newRoute, identifiers);
+  }
+}
+
+void RouteUpdateLogger::flush() {
+  logThread_.getEventBase()->runInEventBaseThreadAndWait([] {});
+}
+
 void RouteUpdateLogger::startLoggingForPrefix(
     const RouteUpdateLoggingInstance& req) {
   prefixTracker_.track(req);
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <folly/IPAddress.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 #include <folly/logging/xlog.h>
 #include "fboss/agent/RouteUpdateLoggingPrefixTracker.h"
 #include "fboss/agent/StateObserver.h"
@@ -17,7 +18,9 @@
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/agent/state/StateDelta.h"
 
+#include <atomic>
 #include <memory>
+#include <variant>
 #include <vector>
 
 namespace facebook::fboss {
@@ -147,6 +150,13 @@ class LabelsTracker {
  * (or more specific location with that prefix) is added, removed, or
  * changes, log that information. The logger is pluggable, but by default
  * we use GLOG.
+ *
+ * The update thread only matches the changed routes against the tracked
+ * prefixes and labels. The matching updates are handed to the route loggers
+ * on a background thread, which does the formatting and writing, so that
+ * tracking a wide prefix doesn't slow down state updates. At most
+ * route_update_log_queue_size updates wait to be logged, the ones beyond are
+ * dropped and counted.
  */
 class RouteUpdateLogger : public AutoRegisterStateObserver {
   // TODO(pshaikh): rename RouteUpdateLogger to FibUpdateObserver
@@ -186,13 +196,49 @@ class RouteUpdateLogger : public AutoRegisterStateObserver {
     return mplsRouteLogger_.get();
   }
 
+  // Wait for the updates queued so far to be logged
+  void flush();
+
+  uint64_t getDroppedUpdates() const {
+    return droppedUpdates_;
+  }
+
  private:
+  /*
+   * A matching update, as captured on the update thread. The routes are
+   * nodes of published, immutable states, so keeping a reference to them is
+   * enough to format them later. An added route has no oldRoute, a removed
+   * one no newRoute. All the updates of a state update matched by the same
+   * subscribers share their identifiers.
+   */
+  template <typename RouteT>
+  struct PendingUpdate {
+    std::shared_ptr<RouteT> oldRoute;
+    std::shared_ptr<RouteT> newRoute;
+    std::shared_ptr<const std::vector<std::string>> identifiers;
+  };
+  using PendingUpdates = std::vector<std::variant<
+      PendingUpdate<Route<folly::IPAddressV4>>,
+      PendingUpdate<Route<folly::IPAddressV6>>,
+      PendingUpdate<LabelForwardingEntry>>>;
+
+  void logUpdates(const PendingUpdates& updates);
+  template <typename RouteT>
+  static void logUpdate(
+      RouteLoggerBase<RouteT>* logger,
+      const PendingUpdate<RouteT>& update);
+
   const SwSwitch* swSwitch_;
   RouteUpdateLoggingPrefixTracker prefixTracker_;
   folly::Synchronized<LabelsTracker> labelTracker_;
   std::unique_ptr<RouteLogger<folly::IPAddressV4>> routeLoggerV4_;
   std::unique_ptr<RouteLogger<folly::IPAddressV6>> routeLoggerV6_;
   std::unique_ptr<MplsRouteLogger> mplsRouteLogger_;
+
+  std::atomic<uint64_t> pendingUpdates_{0};
+  std::atomic<uint64_t> droppedUpdates_{0};
+  // Declared last, so that it's stopped before the loggers are destroyed
+  folly::ScopedEventBaseThread logThread_{"RouteUpdateLogger"};
 };
 
 } // namespace facebook::fboss
@@ -36,7 +36,9 @@ void StaticL2ForNeighborSwSwitchUpdater::ensureMacEntry(
         return newState != state ? newState : nullptr;
       };
 
-  sw_->updateState("updateOrAdd static MAC: ", std::move(staticMacEntryFn));
+  sw_->updateState(
+      StateUpdateDescriptor(StateUpdateCategory::STATIC_MAC_ADD, mac),
+      std::move(staticMacEntryFn));
 }
 
 void StaticL2ForNeighborSwSwitchUpdater::ensureMacEntryForNeighbor(
@@ -76,7 +78,9 @@ void StaticL2ForNeighborSwSwitchUpdater::pruneMacEntry(
     return macPruned ? newState : nullptr;
   };
 
-  sw_->updateState("Prune MAC if unreferenced: ", std::move(removeMacEntryFn));
+  sw_->updateState(
+      StateUpdateDescriptor(StateUpdateCategory::STATIC_MAC_PRUNE, mac),
+      std::move(removeMacEntryFn));
 }
 
 void StaticL2ForNeighborSwSwitchUpdater::pruneMacEntryForNeighbor(
@@ -98,6 +102,9 @@ void StaticL2ForNeighborSwSwitchUpdater::ensureMacEntryIfNeighborExists(
   auto ensureMac = [mac, vlan](const std::shared_ptr<SwitchState>& state) {
     return MacTableUtils::updateOrAddStaticEntryIfNbrExists(state, vlan, mac);
   };
-  sw_->updateState("ensure static MAC for nbr", std::move(ensureMac));
+  sw_->updateState(
+      StateUpdateDescriptor(
+          StateUpdateCategory::STATIC_MAC_ADD_IF_NEIGHBOR, mac),
+      std::move(ensureMac));
 }
 } // namespace facebook::fboss
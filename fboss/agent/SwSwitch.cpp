@@ -14,6 +14,7 @@
 #include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/ArpHandler.h"
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/DHCPRelayContextCache.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/FbossHwUpdateError.h"
 #include "fboss/agent/FibHelpers.h"
@@ -66,6 +67,7 @@
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 #include "fboss/qsfp_service/lib/QsfpCache.h"
 
@@ -75,6 +77,7 @@
 #include <folly/GLog.h>
 #include <folly/MacAddress.h>
 #include <folly/MapUtil.h>
+#include <folly/ScopeGuard.h>
 #include <folly/SocketAddress.h>
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
@@ -85,6 +88,9 @@
 #include <thrift/lib/cpp2/async/RequestChannel.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <chrono>
 #include <condition_variable>
 #include <exception>
@@ -128,6 +134,19 @@ DEFINE_int32(
     64,
     "Expected minimum ethernet packet length");
 
+DEFINE_int32(
+    lacp_thread_niceness,
+    -10,
+    "Niceness of the LACP thread. Negative values raise its scheduling "
+    "priority so LACPDU processing isn't delayed by busy agent threads. "
+    "0 leaves the thread priority untouched");
+
+DEFINE_int32(
+    state_update_history_size,
+    1024,
+    "Number of recently applied state updates to retain for "
+    "getRecentStateUpdates(). 0 disables the history");
+
 namespace {
 
 /**
@@ -172,6 +191,21 @@ facebook::fboss::PortStatus fillInPortStatus(
 
 auto constexpr kHwUpdateFailures = "hw_update_failures";
 
+// TODO(joseph5wu): Control this by distinguishing the highest priority
+// queue from the config.
+constexpr uint8_t kNCStrictPriorityQueue = 7;
+
+void setCurrentThreadNiceness(folly::StringPiece name, int niceness) {
+  if (niceness == 0) {
+    return;
+  }
+  // On Linux, PRIO_PROCESS with a thread id only affects that thread
+  if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), niceness) != 0) {
+    XLOG(WARNING) << "Failed to set niceness of " << name << " to "
+                  << niceness << ": " << folly::errnoStr(errno);
+  }
+}
+
 } // anonymous namespace
 
 namespace facebook::fboss {
@@ -197,11 +231,18 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       macTableManager_(new MacTableManager(this)),
       phySnapshotManager_(
           new PhySnapshotManager<kIphySnapshotIntervalSeconds>()),
-      aclNexthopHandler_(new AclNexthopHandler(this)) {
+      aclNexthopHandler_(new AclNexthopHandler(this)),
+      dhcpRelayContextCache_(new DHCPRelayContextCache(this)) {
   // Create the platform-specific state directories if they
   // don't exist already.
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+
+  // Sized once, so that changing the flag at runtime can't break the ring
+  auto lockedHistory = stateUpdateHistory_.wlock();
+  lockedHistory->capacity =
+      static_cast<size_t>(std::max(FLAGS_state_update_history_size, 0));
+  lockedHistory->updates.reserve(lockedHistory->capacity);
 }
 
 SwSwitch::~SwSwitch() {
@@ -415,6 +456,10 @@ void SwSwitch::updateStats() {
   updateRouteStats();
   updatePortInfo();
   updateLldpStats();
+  if (tunMgr_) {
+    tunMgr_->updateStats();
+  }
+  FunctionCallTimeReporter::publishPhaseStats();
   try {
     getHw()->updateStats(stats());
   } catch (const std::exception& ex) {
@@ -499,8 +544,10 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   setStateInternal(initialState);
 
   // start LACP thread
-  lacpThread_.reset(new std::thread(
-      [=] { this->threadLoop("fbossLacpThread", &lacpEventBase_); }));
+  lacpThread_.reset(new std::thread([=] {
+    setCurrentThreadNiceness("fbossLacpThread", FLAGS_lacp_thread_niceness);
+    this->threadLoop("fbossLacpThread", &lacpEventBase_);
+  }));
 
   // start lagMananger
   if (flags & SwitchFlags::ENABLE_LACP) {
@@ -560,7 +607,11 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       &updateEventBase_,
       "fbossUpdateThread",
       FLAGS_thread_heartbeat_ms,
-      updHeartbeatStatsFunc);
+      updHeartbeatStatsFunc,
+      [this]() {
+        auto update = currentStateUpdate_.rlock();
+        return update->has_value() ? (*update)->str() : std::string();
+      });
 
   auto packetTxHeartbeatStatsFunc = [this](int delay, int backLog) {
     stats()->packetTxHeartbeatDelay(delay);
@@ -594,6 +645,7 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   heartbeatWatchdog_ = std::make_unique<ThreadHeartbeatWatchdog>(
       std::chrono::milliseconds(FLAGS_thread_heartbeat_ms * 10),
       [this]() { stats()->ThreadHeartbeatMissCount(); });
+  heartbeatWatchdog_->enableStallCapture(FLAGS_thread_stall_history);
   heartbeatWatchdog_->startMonitoringHeartbeat(bgThreadHeartbeat_);
   heartbeatWatchdog_->startMonitoringHeartbeat(packetTxThreadHeartbeat_);
   heartbeatWatchdog_->startMonitoringHeartbeat(updThreadHeartbeat_);
@@ -707,6 +759,7 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
     // Make sure the SwSwitch is not already being destroyed
     return;
   }
+  TIME_PHASE("state_observers");
   for (auto observerName : stateObservers_) {
     try {
       auto observer = observerName.first;
@@ -725,6 +778,7 @@ bool SwSwitch::updateState(unique_ptr<StateUpdate> update) {
                << " since exit already started";
     return false;
   }
+  update->enqueueTime_ = steady_clock::now();
   {
     std::unique_lock guard(pendingUpdatesLock_);
     pendingUpdates_.push_back(*update.release());
@@ -738,40 +792,66 @@ bool SwSwitch::updateState(unique_ptr<StateUpdate> update) {
 }
 
 bool SwSwitch::updateState(StringPiece name, StateUpdateFn fn) {
-  auto update = make_unique<FunctionStateUpdate>(name, std::move(fn));
+  return updateState(StateUpdateDescriptor(name), std::move(fn));
+}
+
+bool SwSwitch::updateState(
+    StateUpdateDescriptor descriptor,
+    StateUpdateFn fn) {
+  auto update =
+      make_unique<FunctionStateUpdate>(std::move(descriptor), std::move(fn));
   return updateState(std::move(update));
 }
 
 void SwSwitch::updateStateNoCoalescing(StringPiece name, StateUpdateFn fn) {
+  updateStateNoCoalescing(StateUpdateDescriptor(name), std::move(fn));
+}
+
+void SwSwitch::updateStateNoCoalescing(
+    StateUpdateDescriptor descriptor,
+    StateUpdateFn fn) {
   auto update = make_unique<FunctionStateUpdate>(
-      name,
+      std::move(descriptor),
       std::move(fn),
       static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING));
   updateState(std::move(update));
 }
 
 void SwSwitch::updateStateBlocking(folly::StringPiece name, StateUpdateFn fn) {
+  updateStateBlocking(StateUpdateDescriptor(name), std::move(fn));
+}
+
+void SwSwitch::updateStateBlocking(
+    StateUpdateDescriptor descriptor,
+    StateUpdateFn fn) {
   auto behaviorFlags = static_cast<int>(StateUpdate::BehaviorFlags::NONE);
-  updateStateBlockingImpl(name, fn, behaviorFlags);
+  updateStateBlockingImpl(std::move(descriptor), fn, behaviorFlags);
 }
 
 void SwSwitch::updateStateWithHwFailureProtection(
     folly::StringPiece name,
     StateUpdateFn fn) {
+  updateStateWithHwFailureProtection(
+      StateUpdateDescriptor(name), std::move(fn));
+}
+
+void SwSwitch::updateStateWithHwFailureProtection(
+    StateUpdateDescriptor descriptor,
+    StateUpdateFn fn) {
   int stateUpdateBehavior =
       static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING) |
       static_cast<int>(StateUpdate::BehaviorFlags::HW_FAILURE_PROTECTION);
 
-  updateStateBlockingImpl(name, fn, stateUpdateBehavior);
+  updateStateBlockingImpl(std::move(descriptor), fn, stateUpdateBehavior);
 }
 
 void SwSwitch::updateStateBlockingImpl(
-    folly::StringPiece name,
+    StateUpdateDescriptor descriptor,
     StateUpdateFn fn,
     int stateUpdateBehavior) {
   auto result = std::make_shared<BlockingUpdateResult>();
   auto update = make_unique<BlockingStateUpdate>(
-      name, std::move(fn), result, stateUpdateBehavior);
+      std::move(descriptor), std::move(fn), result, stateUpdateBehavior);
   if (updateState(std::move(update))) {
     result->wait();
   }
@@ -836,6 +916,20 @@ void SwSwitch::handlePendingUpdates() {
   // This function should never be called with valid updates while we are
   // not initialized yet
   DCHECK(isInitialized());
+  ScopedUpdateTimer updateBreakdown(
+      [descriptor = updates.begin()->getDescriptor()] {
+        return descriptor.str();
+      });
+  // Only stall captures read the context
+  bool recordContext = FLAGS_thread_stall_history > 0;
+  if (recordContext) {
+    *currentStateUpdate_.wlock() = updates.begin()->getDescriptor();
+  }
+  SCOPE_EXIT {
+    if (recordContext) {
+      currentStateUpdate_.wlock()->reset();
+    }
+  };
 
   // Call all of the update functions to prepare the new SwitchState
   auto oldAppliedState = getState();
@@ -847,8 +941,9 @@ void SwSwitch::handlePendingUpdates() {
     ++iter;
 
     shared_ptr<SwitchState> intermediateState;
-    XLOG(INFO) << "preparing state update " << update->getName();
+    XLOG(DBG3) << "preparing state update " << update->getName();
     try {
+      TIME_PHASE("state_update_fn");
       intermediateState = update->applyUpdate(newDesiredState);
     } catch (const std::exception& ex) {
       // Call the update's onError() function, and then immediately delete
@@ -921,6 +1016,7 @@ void SwSwitch::handlePendingUpdates() {
     }
   }
   updatePtpTcCounter();
+  recordAppliedUpdates(updates);
   // Notify all of the updates of success and delete them.
   while (!updates.empty()) {
     unique_ptr<StateUpdate> update(&updates.front());
@@ -929,6 +1025,57 @@ void SwSwitch::handlePendingUpdates() {
   }
 }
 
+void SwSwitch::recordAppliedUpdates(const StateUpdateList& updates) {
+  auto steadyNow = steady_clock::now();
+  auto systemNow = system_clock::now();
+  auto lockedHistory = stateUpdateHistory_.wlock();
+  auto historySize = lockedHistory->capacity;
+  for (const auto& update : updates) {
+    auto latency =
+        duration_cast<microseconds>(steadyNow - update.enqueueTime_);
+    stats()->stateUpdateApplied(update.getDescriptor().getCategory(), latency);
+    if (historySize == 0) {
+      continue;
+    }
+    AppliedStateUpdate applied{update.getDescriptor(), systemNow, latency};
+    if (lockedHistory->updates.size() < historySize) {
+      lockedHistory->updates.push_back(std::move(applied));
+    } else {
+      lockedHistory->updates[lockedHistory->next % historySize] =
+          std::move(applied);
+    }
+    lockedHistory->next = (lockedHistory->next + 1) % historySize;
+  }
+}
+
+std::vector<ThreadStallInfo> SwSwitch::getRecentThreadStalls() const {
+  return heartbeatWatchdog_ ? heartbeatWatchdog_->getRecentStalls()
+                            : std::vector<ThreadStallInfo>();
+}
+
+std::vector<StateUpdateInfo> SwSwitch::getRecentStateUpdates() const {
+  std::vector<StateUpdateInfo> recentUpdates;
+  auto lockedHistory = stateUpdateHistory_.rlock();
+  const auto& updates = lockedHistory->updates;
+  recentUpdates.reserve(updates.size());
+  // While the ring is filling up next == updates.size(), once it is full
+  // next points at the oldest update. Either way start from next.
+  auto start = updates.empty() ? 0 : lockedHistory->next % updates.size();
+  for (size_t i = 0; i < updates.size(); ++i) {
+    const auto& update = updates[(start + i) % updates.size()];
+    StateUpdateInfo info;
+    info.name_ref() = update.descriptor.str();
+    info.category_ref() =
+        stateUpdateCategoryName(update.descriptor.getCategory()).str();
+    info.appliedTimeMs_ref() =
+        duration_cast<milliseconds>(update.appliedTime.time_since_epoch())
+            .count();
+    info.latencyUs_ref() = update.latency.count();
+    recentUpdates.push_back(std::move(info));
+  }
+  return recentUpdates;
+}
+
 void SwSwitch::updatePtpTcCounter() {
   // update fb303 counter to reflect current state of PTP
   // should be invoked post update
@@ -982,6 +1129,7 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   // undesirable.  So far I don't think this brief discrepancy should cause
   // major issues.
   try {
+    TIME_PHASE("hw_state_changed");
     newAppliedState = isTransaction ? hw_->stateChangedTransaction(delta)
                                     : hw_->stateChanged(delta);
   } catch (const std::exception& ex) {
@@ -1045,8 +1193,7 @@ PortStats* SwSwitch::portStats(PortID portID) {
   auto portIf = getState()->getPorts()->getPortIf(portID);
   if (portIf) {
     // get portName from current state
-    return stats()->createPortStats(
-        portID, getState()->getPort(portID)->getName());
+    return stats()->createPortStats(portID, portIf->getName());
   } else {
     // only for port0 case
     XLOG(DBG0) << "Port node doesn't exist, use default name=port" << portID;
@@ -1114,7 +1261,8 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
     return;
   }
   PortID port = pkt->getSrcPort();
-  portStats(port)->trappedPkt();
+  auto rxPortStats = portStats(port);
+  rxPortStats->trappedPkt();
 
   pcapMgr_->packetReceived(pkt.get());
 
@@ -1132,7 +1280,7 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
    */
   auto len = pkt->getLength();
   if (len < FLAGS_minimum_ethernet_packet_length) {
-    portStats(port)->pktBogus();
+    rxPortStats->pktBogus();
     return;
   }
 
@@ -1171,7 +1319,7 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
 #if FOLLY_HAS_COROUTINES
     case MKAServiceManager::ETHERTYPE_EAPOL:
       if (mkaServiceManager_) {
-        portStats(port)->MkPduRecvdPkt();
+        rxPortStats->MkPduRecvdPkt();
         mkaServiceManager_->handlePacket(std::move(pkt));
         return;
       }
@@ -1212,7 +1360,7 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
 
   // If we are still here, we don't know what to do with this packet.
   // Increment a counter and just drop the packet on the floor.
-  portStats(port)->pktUnhandled();
+  rxPortStats->pktUnhandled();
 }
 
 void SwSwitch::pfcWatchdogStateChanged(
@@ -1273,7 +1421,8 @@ void SwSwitch::linkStateChanged(
     return newState;
   };
   updateStateNoCoalescing(
-      "Port OperState Update", std::move(updateOperStateFn));
+      StateUpdateDescriptor(StateUpdateCategory::PORT_OPER_STATE),
+      std::move(updateOperStateFn));
 }
 
 void SwSwitch::startThreads() {
@@ -1382,9 +1531,6 @@ void SwSwitch::sendNetworkControlPacketAsync(
     std::unique_ptr<TxPacket> pkt,
     std::optional<PortDescriptor> port) noexcept {
   if (port) {
-    // TODO(joseph5wu): Control this by distinguishing the highest priority
-    // queue from the config.
-    static const uint8_t kNCStrictPriorityQueue = 7;
     auto portVal = *port;
     switch (portVal.type()) {
       case PortDescriptor::PortType::PHYSICAL:
@@ -1401,6 +1547,31 @@ void SwSwitch::sendNetworkControlPacketAsync(
   }
 }
 
+void SwSwitch::sendNetworkControlPacketsAsync(
+    std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> pkts) noexcept {
+  auto state = getState();
+  std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> toSend;
+  toSend.reserve(pkts.size());
+  for (auto& [pkt, portID] : pkts) {
+    if (!state->getPorts()->getPortIf(portID)) {
+      XLOG(ERR)
+          << "SendNetworkControlPacketsAsync: dropping packet to unexpected port "
+          << portID;
+      stats()->pktDropped();
+      continue;
+    }
+    pcapMgr_->packetSent(pkt.get());
+    toSend.emplace_back(std::move(pkt), portID);
+  }
+  auto numToSend = toSend.size();
+  auto numSent =
+      hw_->sendPacketsOutOfPortAsync(std::move(toSend), kNCStrictPriorityQueue);
+  if (numSent != numToSend) {
+    XLOG(ERR) << "failed to send " << (numToSend - numSent) << " of "
+              << numToSend << " network control packets";
+  }
+}
+
 void SwSwitch::sendPacketOutOfPortAsync(
     std::unique_ptr<TxPacket> pkt,
     PortID portID,
@@ -1660,7 +1831,7 @@ void SwSwitch::applyConfig(
   // We don't need to hold a lock here. updateStateBlocking() does that for us.
   auto routeUpdater = getRouteUpdater();
   updateStateBlocking(
-      reason,
+      StateUpdateDescriptor(StateUpdateCategory::CONFIG, reason),
       [&](const shared_ptr<SwitchState>& state) -> shared_ptr<SwitchState> {
         auto originalState = state;
         // Eventually we'll allow qsfp_service to call programInternalPhyPorts
@@ -1751,6 +1922,7 @@ void SwSwitch::updateConfigAppliedInfo() {
 }
 
 bool SwSwitch::isValidStateUpdate(const StateDelta& delta) const {
+  TIME_PHASE("delta_compute");
   bool isValid = true;
 
   forEachChanged(
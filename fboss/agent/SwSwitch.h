@@ -25,6 +25,7 @@
 #include <folly/IntrusiveList.h>
 #include <folly/Range.h>
 #include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
 #include <folly/io/async/EventBase.h>
 #include <optional>
@@ -35,6 +36,7 @@
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -63,6 +65,7 @@ class MirrorManager;
 template <size_t interval>
 class PhySnapshotManager;
 class AclNexthopHandler;
+class DHCPRelayContextCache;
 class LookupClassUpdater;
 class LookupClassRouteUpdater;
 class MacTableManager;
@@ -245,6 +248,12 @@ class SwSwitch : public HwSwitch::Callback {
    * unpublished SwitchState in some cases.
    */
   bool updateState(folly::StringPiece name, StateUpdateFn fn);
+  /*
+   * Same as above, but identifies the update by a StateUpdateDescriptor.
+   * Frequently scheduled updates should prefer this, since the descriptor's
+   * name is only formatted if it is logged or queried.
+   */
+  bool updateState(StateUpdateDescriptor descriptor, StateUpdateFn fn);
 
   /**
    * Schedule an update to the switch state.
@@ -259,6 +268,9 @@ class SwSwitch : public HwSwitch::Callback {
    * implementation, even if the inverse update is immediately applied.
    */
   void updateStateNoCoalescing(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateNoCoalescing(
+      StateUpdateDescriptor descriptor,
+      StateUpdateFn fn);
 
   /*
    * A version of updateState() that doesn't return until the update has been
@@ -269,6 +281,7 @@ class SwSwitch : public HwSwitch::Callback {
    *
    */
   void updateStateBlocking(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateBlocking(StateUpdateDescriptor descriptor, StateUpdateFn fn);
 
   /*
    * A version of updateState() that reports back failures in applying state
@@ -285,6 +298,9 @@ class SwSwitch : public HwSwitch::Callback {
   void updateStateWithHwFailureProtection(
       folly::StringPiece name,
       StateUpdateFn fn);
+  void updateStateWithHwFailureProtection(
+      StateUpdateDescriptor descriptor,
+      StateUpdateFn fn);
 
   /**
    * Apply config from the config file (specified in 'config' flag).
@@ -313,6 +329,18 @@ class SwSwitch : public HwSwitch::Callback {
     return *configAppliedInfo_.rlock();
   }
 
+  /*
+   * Get the most recently applied state updates, oldest first. The number of
+   * updates retained is controlled by --state_update_history_size.
+   */
+  std::vector<StateUpdateInfo> getRecentStateUpdates() const;
+
+  /*
+   * Stack traces of the threads which recently missed their heartbeat. Only
+   * captured when --thread_stall_history is set.
+   */
+  std::vector<ThreadStallInfo> getRecentThreadStalls() const;
+
   /*
    * Registers an observer of all state updates. An observer will be notified of
    * all state updates that occur and all classes that care about state updates
@@ -495,6 +523,14 @@ class SwSwitch : public HwSwitch::Callback {
       std::unique_ptr<TxPacket> pkt,
       std::optional<PortDescriptor> port) noexcept;
 
+  /**
+   * Send a batch of network control packets, each out of its physical port.
+   * Lets HwSwitch implementations that support batched TX submit them at
+   * once.
+   */
+  void sendNetworkControlPacketsAsync(
+      std::vector<std::pair<std::unique_ptr<TxPacket>, PortID>> pkts) noexcept;
+
   void sendPacketOutOfPortAsync(
       std::unique_ptr<TxPacket> pkt,
       PortID portID,
@@ -624,6 +660,10 @@ class SwSwitch : public HwSwitch::Callback {
     return lookupClassRouteUpdater_.get();
   }
 
+  DHCPRelayContextCache* getDhcpRelayContextCache() {
+    return dhcpRelayContextCache_.get();
+  }
+
   /*
    * RIB and switch state need to be kept in sync,
    * so only expose const/non write access to rib
@@ -740,7 +780,7 @@ class SwSwitch : public HwSwitch::Callback {
 
  private:
   void updateStateBlockingImpl(
-      folly::StringPiece name,
+      StateUpdateDescriptor descriptor,
       StateUpdateFn fn,
       int stateUpdateBehavior);
 
@@ -756,6 +796,11 @@ class SwSwitch : public HwSwitch::Callback {
   typedef folly::IntrusiveList<StateUpdate, &StateUpdate::listHook_>
       StateUpdateList;
 
+  /*
+   * Record stats and history for updates that were just applied.
+   */
+  void recordAppliedUpdates(const StateUpdateList& updates);
+
   // Forbidden copy constructor and assignment operator
   SwSwitch(SwSwitch const&) = delete;
   SwSwitch& operator=(SwSwitch const&) = delete;
@@ -958,8 +1003,31 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<PhySnapshotManager<kIphySnapshotIntervalSeconds>>
       phySnapshotManager_;
   std::unique_ptr<AclNexthopHandler> aclNexthopHandler_;
+  std::unique_ptr<DHCPRelayContextCache> dhcpRelayContextCache_;
 
   folly::Synchronized<ConfigAppliedInfo> configAppliedInfo_;
+
+  /*
+   * Ring of recently applied state updates. Only the descriptors are kept,
+   * names are formatted when getRecentStateUpdates() is called.
+   */
+  struct AppliedStateUpdate {
+    StateUpdateDescriptor descriptor;
+    std::chrono::system_clock::time_point appliedTime;
+    std::chrono::microseconds latency;
+  };
+  struct StateUpdateHistory {
+    std::vector<AppliedStateUpdate> updates;
+    size_t next{0};
+    // Set from --state_update_history_size at construction
+    size_t capacity{0};
+  };
+  folly::Synchronized<StateUpdateHistory> stateUpdateHistory_;
+
+  // The first update of the batch being applied by the update thread, as
+  // the context of its stall captures
+  folly::Synchronized<std::optional<StateUpdateDescriptor>>
+      currentStateUpdate_;
 };
 
 } // namespace facebook::fboss
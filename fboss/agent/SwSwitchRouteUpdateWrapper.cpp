@@ -31,7 +31,9 @@ std::shared_ptr<SwitchState> swSwitchFibUpdate(
       vrf, v4NetworkToRoute, v6NetworkToRoute, labelToRoute);
 
   auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
-  sw->updateStateWithHwFailureProtection("", std::move(fibUpdater));
+  sw->updateStateWithHwFailureProtection(
+      StateUpdateDescriptor(StateUpdateCategory::FIB_UPDATE),
+      std::move(fibUpdater));
   return sw->getState();
 }
 
@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/SwitchStats.h"
 
+#include <folly/Conv.h>
 #include <folly/Memory.h>
 #include "fboss/agent/PortStats.h"
 
@@ -245,6 +246,20 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           RATE)),
       LldpNeighborsSize_(
           makeTLTimeseries(map, kCounterPrefix + "lldp.neighbors_size", SUM)),
+      LldpTemplateRebuild_(makeTLTimeseries(
+          map,
+          kCounterPrefix + "lldp.template_rebuild",
+          SUM,
+          RATE)),
+      LldpTxIntervalTime_(makeTLTHistogram(
+          map,
+          kCounterPrefix + "lldp.tx_interval_time.us",
+          100,
+          0,
+          10000,
+          AVG,
+          50,
+          100)),
       LacpRxTimeouts_(
           makeTLTimeseries(map, kCounterPrefix + "lacp.rx_timeout", SUM)),
       LacpMismatchPduTeardown_(makeTLTimeseries(
@@ -289,9 +304,33 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
       threadHeartbeatMissCount_(makeTLTimeseries(
           map,
           kCounterPrefix + "thread_heartbeat_miss",
-          SUM)) {}
+          SUM)) {
+  for (size_t i = 0; i < kNumStateUpdateCategories; ++i) {
+    auto category =
+        stateUpdateCategoryName(static_cast<StateUpdateCategory>(i));
+    stateUpdateCategoryCount_[i] = makeTLTimeseries(
+        map,
+        folly::to<std::string>(kCounterPrefix, "state_update.", category),
+        SUM,
+        RATE);
+    stateUpdateCategoryLatency_[i] = makeTLTHistogram(
+        map,
+        folly::to<std::string>(
+            kCounterPrefix, "state_update.", category, ".latency.us"),
+        1000,
+        0,
+        100000,
+        AVG,
+        50,
+        100);
+  }
+}
 
 PortStats* FOLLY_NULLABLE SwitchStats::port(PortID portID) {
+  auto index = static_cast<uint16_t>(portID);
+  if (index < densePorts_.size()) {
+    return densePorts_[index];
+  }
   auto it = ports_.find(portID);
   if (it != ports_.end()) {
     return it->second.get();
@@ -313,9 +352,24 @@ PortStats* SwitchStats::createPortStats(PortID portID, std::string portName) {
       portID, std::make_unique<PortStats>(portID, portName, this));
   DCHECK(rv.second);
   const auto& it = rv.first;
+  auto index = static_cast<uint16_t>(portID);
+  if (index < kMaxDensePortID) {
+    if (index >= densePorts_.size()) {
+      densePorts_.resize(index + 1, nullptr);
+    }
+    densePorts_[index] = it->second.get();
+  }
   return it->second.get();
 }
 
+void SwitchStats::deletePortStats(PortID portID) {
+  auto index = static_cast<uint16_t>(portID);
+  if (index < densePorts_.size()) {
+    densePorts_[index] = nullptr;
+  }
+  ports_.erase(portID);
+}
+
 AggregatePortStats* SwitchStats::createAggregatePortStats(
     AggregatePortID id,
     std::string name) {
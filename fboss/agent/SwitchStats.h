@@ -12,9 +12,12 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/noncopyable.hpp>
 #include <fb303/ThreadCachedServiceData.h>
+#include <array>
 #include <chrono>
+#include <vector>
 #include "fboss/agent/AggregatePortStats.h"
 #include "fboss/agent/PortStats.h"
+#include "fboss/agent/state/StateUpdate.h"
 #include "fboss/agent/types.h"
 
 namespace facebook::fboss {
@@ -46,9 +49,6 @@ class SwitchStats : public boost::noncopyable {
   /*
    * Getters.
    */
-  PortStatsMap* getPortStats() {
-    return &ports_;
-  }
   const PortStatsMap* getPortStats() const {
     return &ports_;
   }
@@ -59,9 +59,7 @@ class SwitchStats : public boost::noncopyable {
       AggregatePortID id,
       std::string name);
 
-  void deletePortStats(PortID portID) {
-    ports_.erase(portID);
-  }
+  void deletePortStats(PortID portID);
 
   void trappedPkt() {
     addValue(*trapPkts_, 1);
@@ -226,6 +224,14 @@ class SwitchStats : public boost::noncopyable {
     addValue(*updateState_, us.count());
   }
 
+  void stateUpdateApplied(
+      StateUpdateCategory category,
+      std::chrono::microseconds latency) {
+    auto index = static_cast<size_t>(category);
+    addValue(*stateUpdateCategoryCount_[index], 1);
+    addValue(*stateUpdateCategoryLatency_[index], latency.count());
+  }
+
   void routeUpdate(std::chrono::microseconds us, uint64_t routes) {
     // As syncFib() could include no routes.
     if (routes == 0) {
@@ -303,6 +309,12 @@ class SwitchStats : public boost::noncopyable {
   void LldpNeighborsSize(int value) {
     addValue(*LldpNeighborsSize_, value);
   }
+  void LldpTemplateRebuild() {
+    addValue(*LldpTemplateRebuild_, 1);
+  }
+  void LldpTxIntervalTime(int64_t us) {
+    addValue(*LldpTxIntervalTime_, us);
+  }
   void LacpRxTimeouts() {
     addValue(*LacpRxTimeouts_, 1);
   }
@@ -485,6 +497,20 @@ class SwitchStats : public boost::noncopyable {
    */
   TLHistogramPtr updateState_;
 
+  static constexpr auto kNumStateUpdateCategories =
+      static_cast<size_t>(StateUpdateCategory::NUM_CATEGORIES);
+  /**
+   * Number of state updates applied, per StateUpdateCategory
+   */
+  std::array<TLTimeseriesPtr, kNumStateUpdateCategories>
+      stateUpdateCategoryCount_;
+  /**
+   * Time from a state update being queued to it being applied, per
+   * StateUpdateCategory (in microseconds)
+   */
+  std::array<TLHistogramPtr, kNumStateUpdateCategories>
+      stateUpdateCategoryLatency_;
+
   /**
    * Histogram for time used for route update (in microsecond)
    */
@@ -540,6 +566,12 @@ class SwitchStats : public boost::noncopyable {
   // Individual port stats objects, indexed by PortID
   PortStatsMap ports_;
 
+  // PortStats objects of ports_ with IDs below kMaxDensePortID, indexed by
+  // PortID, so that looking up the stats of a trapped packet's port doesn't
+  // have to search ports_
+  static constexpr uint16_t kMaxDensePortID = 4096;
+  std::vector<PortStats*> densePorts_;
+
   AggregatePortStatsMap aggregatePortIDToStats_;
 
   // Number of packets dropped by the PCAP distribution service
@@ -559,6 +591,10 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseriesPtr LldpValidateMisMatch_;
   // Number of LLDP Neighbors.
   TLTimeseriesPtr LldpNeighborsSize_;
+  // Number of times a cached LLDP frame had to be (re)built.
+  TLTimeseriesPtr LldpTemplateRebuild_;
+  // Time spent sending LLDP frames over one LLDP interval (in microseconds)
+  TLHistogramPtr LldpTxIntervalTime_;
 
   // Number of LACP Rx timeouts
   TLTimeseriesPtr LacpRxTimeouts_;
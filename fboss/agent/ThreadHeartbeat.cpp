@@ -9,10 +9,113 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #include "fboss/agent/ThreadHeartbeat.h"
+#include <fb303/ServiceData.h>
+#include <folly/Format.h>
+#include <folly/String.h>
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <folly/experimental/symbolizer/Symbolizer.h>
 #include <folly/logging/xlog.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 using namespace std::chrono;
 
+DEFINE_int32(
+    thread_stall_history,
+    0,
+    "Number of stack traces of threads which missed their heartbeat to keep, "
+    "0 disables capturing them");
+
+namespace {
+constexpr size_t kMaxStackFrames = 64;
+// How long to wait for the stalled thread to run the signal handler
+constexpr auto kStackCaptureTimeout = milliseconds(100);
+
+// Filled by the signal handler on the stalled thread
+struct StackCapture {
+  explicit StackCapture(pid_t tid) : targetTid(tid) {}
+  // Only the handler running on this thread may claim the capture
+  const pid_t targetTid;
+  uintptr_t addresses[kMaxStackFrames];
+  ssize_t numAddresses{0};
+  std::atomic<bool> done{false};
+};
+
+// Only one capture is in flight at a time, see captureMutex
+std::atomic<StackCapture*> pendingCapture{nullptr};
+std::mutex captureMutex;
+
+int stallCaptureSignal() {
+  // Real time signals aren't used by anything else in our processes, and
+  // unlike SIGPROF don't interfere with profilers
+  return SIGRTMIN + 4;
+}
+
+void stackCaptureHandler(int /* signum */) {
+  // Only async-signal-safe calls here. A signal which arrives after the
+  // watchdog gave up finds no pending capture, one which is late for an
+  // earlier capture finds a capture for another thread.
+  auto capture = pendingCapture.load();
+  if (!capture || capture->targetTid != syscall(SYS_gettid) ||
+      !pendingCapture.compare_exchange_strong(capture, nullptr)) {
+    return;
+  }
+  capture->numAddresses = folly::symbolizer::getStackTraceSafe(
+      capture->addresses, kMaxStackFrames);
+  capture->done.store(true, std::memory_order_release);
+}
+
+void installStackCaptureHandler() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    struct sigaction sa {};
+    sa.sa_handler = stackCaptureHandler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    PCHECK(sigaction(stallCaptureSignal(), &sa, nullptr) == 0);
+  });
+}
+
+// Stack trace of the thread, empty if it didn't respond in time
+std::vector<std::string> captureStack(pthread_t thread, pid_t tid) {
+  std::lock_guard<std::mutex> g(captureMutex);
+  StackCapture capture(tid);
+  pendingCapture.store(&capture);
+  if (pthread_kill(thread, stallCaptureSignal()) != 0) {
+    pendingCapture.store(nullptr);
+    return {};
+  }
+  auto deadline = steady_clock::now() + kStackCaptureTimeout;
+  while (!capture.done.load(std::memory_order_acquire)) {
+    if (steady_clock::now() > deadline &&
+        pendingCapture.exchange(nullptr) == &capture) {
+      // The handler never claimed the capture, so it won't touch it anymore
+      return {};
+    }
+    std::this_thread::sleep_for(microseconds(100));
+  }
+
+  std::vector<std::string> stack;
+  if (capture.numAddresses <= 0) {
+    return stack;
+  }
+  folly::symbolizer::FrameArray<kMaxStackFrames> frames;
+  frames.frameCount = capture.numAddresses;
+  std::copy_n(capture.addresses, frames.frameCount, frames.addresses);
+  folly::symbolizer::Symbolizer symbolizer;
+  symbolizer.symbolize(frames);
+  for (size_t i = 0; i < frames.frameCount; i++) {
+    const auto& frame = frames.frames[i];
+    stack.push_back(folly::sformat(
+        "{:#x} {}",
+        frames.addresses[i],
+        frame.found ? frame.demangledName().toStdString() : "(unknown)"));
+  }
+  return stack;
+}
+} // namespace
+
 namespace facebook::fboss {
 
 void ThreadHeartbeat::timeoutExpired() noexcept {
@@ -29,7 +132,7 @@ void ThreadHeartbeat::timeoutExpired() noexcept {
                << " delay ms:" << delay.count()
                << " event queue size:" << evbQueueSize;
   }
-  lastTime_ = now;
+  lastTime_.store(now, std::memory_order_release);
   scheduleTimeout(intervalMsecs_);
 }
 
@@ -42,6 +145,9 @@ void ThreadHeartbeatWatchdog::watchdogLoop() {
         XLOG(ERR) << heartbeat.first->getThreadName()
                   << "thread heartbeat missed!";
         heartbeatMissFunc_();
+        if (maxStalls_ > 0) {
+          captureStall(*heartbeat.first);
+        }
       }
       heartbeats_.assign(heartbeat.first, timestamp);
     }
@@ -50,4 +156,32 @@ void ThreadHeartbeatWatchdog::watchdogLoop() {
   }
 }
 
+void ThreadHeartbeatWatchdog::captureStall(const ThreadHeartbeat& heartbeat) {
+  installStackCaptureHandler();
+  ThreadStallInfo stall;
+  stall.threadName_ref() = heartbeat.getThreadName();
+  stall.timeMs_ref() =
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count();
+  stall.sinceHeartbeatMs_ref() =
+      duration_cast<milliseconds>(
+          steady_clock::now() - heartbeat.getTimestamp())
+          .count();
+  stall.context_ref() = heartbeat.getContext();
+  stall.stack_ref() =
+      captureStack(heartbeat.getThreadId(), heartbeat.getThreadTid());
+  fb303::fbData->addStatValue(
+      heartbeat.getThreadName() + ".thread_stall_captures", 1, fb303::SUM);
+
+  XLOG(ERR) << heartbeat.getThreadName() << " stalled for "
+            << *stall.sinceHeartbeatMs_ref() << "ms in '"
+            << *stall.context_ref() << "':\n"
+            << folly::join("\n", *stall.stack_ref());
+  auto stalls = stalls_.wlock();
+  stalls->push_back(std::move(stall));
+  while (stalls->size() > maxStalls_) {
+    stalls->pop_front();
+  }
+}
+
 } // namespace facebook::fboss
@@ -9,11 +9,21 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+
+#include <folly/Synchronized.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <chrono>
+#include <deque>
+
+DECLARE_int32(thread_stall_history);
 
 namespace facebook::fboss {
 
@@ -28,12 +38,14 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
       folly::EventBase* evb,
       std::string threadName,
       int intervalMsecs,
-      std::function<void(int, int)> heartbeatStatsFunc)
+      std::function<void(int, int)> heartbeatStatsFunc,
+      std::function<std::string()> contextFunc = nullptr)
       : AsyncTimeout(evb),
         evb_(evb),
         threadName_(threadName),
         intervalMsecs_(intervalMsecs),
-        heartbeatStatsFunc_(heartbeatStatsFunc) {
+        heartbeatStatsFunc_(heartbeatStatsFunc),
+        contextFunc_(std::move(contextFunc)) {
     XLOG(DBG2) << "ThreadHeartbeat intervalMsecs:" << intervalMsecs_.count();
     evb_->runInEventBaseThread([this]() { scheduleFirstHeartbeat(); });
   }
@@ -44,19 +56,38 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
   }
 
   std::chrono::time_point<std::chrono::steady_clock> getTimestamp() {
-    return lastTime_.load(std::memory_order_relaxed);
+    return lastTime_.load(std::memory_order_acquire);
   }
 
   const std::string& getThreadName() const {
     return threadName_;
   }
 
+  // Only valid once getTimestamp() moved past time_point::min()
+  pthread_t getThreadId() const {
+    return threadId_;
+  }
+
+  // Kernel thread ID, with the same validity as getThreadId()
+  pid_t getThreadTid() const {
+    return threadTid_;
+  }
+
+  // What the thread is working on, e.g. the name of the state update. Called
+  // from the watchdog thread when the heartbeat is missed.
+  std::string getContext() const {
+    return contextFunc_ ? contextFunc_() : std::string();
+  }
+
  private:
   void timeoutExpired() noexcept override;
 
   void scheduleFirstHeartbeat() {
     CHECK(evb_->inRunningEventBaseThread());
-    lastTime_ = std::chrono::steady_clock::now();
+    threadId_ = pthread_self();
+    threadTid_ = static_cast<pid_t>(syscall(SYS_gettid));
+    lastTime_.store(
+        std::chrono::steady_clock::now(), std::memory_order_release);
     scheduleTimeout(intervalMsecs_);
   }
 
@@ -64,6 +95,10 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
   std::string threadName_;
   std::chrono::milliseconds intervalMsecs_;
   std::function<void(int, int)> heartbeatStatsFunc_;
+  std::function<std::string()> contextFunc_;
+  // Written before the first lastTime_ store, which publishes them
+  pthread_t threadId_{};
+  pid_t threadTid_{0};
   std::atomic<std::chrono::time_point<std::chrono::steady_clock>> lastTime_{
       std::chrono::steady_clock::time_point::min()};
   // XXX: these thresholds could be made configurable if needed
@@ -100,6 +135,22 @@ class ThreadHeartbeatWatchdog {
     heartbeats_.insert(heartbeat, std::chrono::steady_clock::time_point::min());
   }
 
+  /*
+   * On every missed heartbeat, interrupt the stalled thread with a signal and
+   * record its stack trace and context, keeping the last maxStalls records.
+   * Must be called before start(), 0 disables the captures.
+   */
+  void enableStallCapture(size_t maxStalls) {
+    CHECK(!running_);
+    maxStalls_ = maxStalls;
+  }
+
+  // The last stall records, oldest first
+  std::vector<ThreadStallInfo> getRecentStalls() const {
+    auto stalls = stalls_.rlock();
+    return std::vector<ThreadStallInfo>(stalls->begin(), stalls->end());
+  }
+
   // start to monitor
   void start() {
     if (!running_) {
@@ -123,6 +174,7 @@ class ThreadHeartbeatWatchdog {
 
  private:
   void watchdogLoop();
+  void captureStall(const ThreadHeartbeat& heartbeat);
   std::thread thread_;
   std::atomic_bool running_{false};
   std::chrono::milliseconds intervalMsecs_;
@@ -133,6 +185,8 @@ class ThreadHeartbeatWatchdog {
   std::mutex m_;
   std::condition_variable cv_;
   std::function<void()> heartbeatMissFunc_;
+  size_t maxStalls_{0};
+  folly::Synchronized<std::deque<ThreadStallInfo>> stalls_;
 };
 
 } // namespace facebook::fboss
@@ -51,6 +51,7 @@
 #include "fboss/agent/state/Transceiver.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/LogThriftCall.h"
 #include "fboss/lib/config/PlatformConfigUtils.h"
 #include "fboss/lib/phy/PhyInterfaceHandler.h"
@@ -1913,6 +1914,48 @@ void ThriftHandler::getConfigAppliedInfo(ConfigAppliedInfo& configAppliedInfo) {
   configAppliedInfo = sw_->getConfigAppliedInfo();
 }
 
+void ThriftHandler::getRecentStateUpdates(
+    std::vector<StateUpdateInfo>& updates) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  updates = sw_->getRecentStateUpdates();
+}
+
+void ThriftHandler::getRecentThreadStalls(
+    std::vector<ThreadStallInfo>& stalls) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  stalls = sw_->getRecentThreadStalls();
+}
+
+void ThriftHandler::getRecentUpdateBreakdowns(
+    std::vector<UpdateBreakdownInfo>& breakdowns,
+    int32_t count) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  if (count < 0) {
+    throw FbossError("Invalid count: ", count);
+  }
+  for (const auto& breakdown :
+       FunctionCallTimeReporter::getRecentUpdateBreakdowns(count)) {
+    UpdateBreakdownInfo info;
+    info.name_ref() = breakdown.name;
+    info.startTimeMs_ref() =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            breakdown.startTime.time_since_epoch())
+            .count();
+    info.durationUs_ref() = breakdown.duration.count();
+    for (const auto& phase : breakdown.phases) {
+      UpdatePhaseInfo phaseInfo;
+      phaseInfo.phase_ref() = phase.phase;
+      phaseInfo.durationUs_ref() = phase.duration.count();
+      phaseInfo.calls_ref() = phase.calls;
+      info.phases_ref()->push_back(std::move(phaseInfo));
+    }
+    breakdowns.push_back(std::move(info));
+  }
+}
+
 void ThriftHandler::getLacpPartnerPair(
     LacpPartnerPair& lacpPartnerPair,
     int32_t portID) {
@@ -315,6 +315,15 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
    */
   void getConfigAppliedInfo(ConfigAppliedInfo& configAppliedInfo) override;
 
+  /*
+   * Get the most recently applied state updates, oldest first.
+   */
+  void getRecentStateUpdates(std::vector<StateUpdateInfo>& updates) override;
+  void getRecentUpdateBreakdowns(
+      std::vector<UpdateBreakdownInfo>& breakdowns,
+      int32_t count) override;
+  void getRecentThreadStalls(std::vector<ThreadStallInfo>& stalls) override;
+
   /**
    * Serialize live running switch state at the path pointer by JSON Pointer
    */
@@ -251,6 +251,8 @@ void TunIntf::addAddress(const folly::IPAddress& addr, uint8_t mask) {
 
 void TunIntf::setMtu(int mtu) {
   mtu_ = mtu;
+  // One more byte than the MTU, to tell a packet larger than the MTU apart
+  readBuf_.resize(mtu_ + 1);
   auto sock = socket(PF_INET, SOCK_DGRAM, 0);
   sysCheckError(sock, "Failed to open socket");
   SCOPE_EXIT {
@@ -316,20 +318,15 @@ void TunIntf::disableIPv6AddrGenMode(int ifIndex) {
 void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
   CHECK(fd_ != -1);
 
-  // Since this is L3 packet size, we should also reserve some space for L2
-  // header, which is 18 bytes (including one vlan tag)
   int sent = 0;
   int dropped = 0;
   uint64_t bytes = 0;
   bool fdFail = false;
   try {
     while (sent + dropped < kMaxSentOneTime) {
-      std::unique_ptr<TxPacket> pkt;
-      pkt = sw_->allocateL3TxPacket(mtu_);
-      auto buf = pkt->buf();
       int ret = 0;
       do {
-        ret = read(fd_, buf->writableTail(), buf->tailroom());
+        ret = read(fd_, readBuf_.data(), readBuf_.size());
       } while (ret == -1 && errno == EINTR);
       if (ret < 0) {
         if (errno != EAGAIN) {
@@ -344,15 +341,20 @@ void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
         // in debug mode.
         DCHECK(false) << "Unexpected event. Nothing to read.";
         break;
-      } else if (ret > buf->tailroom()) {
-        // The pkt is larger than the buffer. We don't have complete packet.
+      } else if (ret > mtu_) {
+        // The pkt is larger than the MTU. We may not have complete packet.
         // It shall not happen unless the MTU is mis-match. Drop the packet.
-        XLOG(ERR) << "Too large packet (" << ret << " > " << buf->tailroom()
+        XLOG(ERR) << "Too large packet (" << ret << " > " << mtu_
                   << ") received from host. Drop the packet.";
         ++dropped;
       } else {
-        bytes += ret;
+        // The TxPacket reserves some space for the L2 header, which is 18
+        // bytes (including one vlan tag)
+        auto pkt = sw_->allocateL3TxPacket(ret);
+        auto buf = pkt->buf();
+        memcpy(buf->writableTail(), readBuf_.data(), ret);
         buf->append(ret);
+        bytes += ret;
         sw_->sendL3Packet(std::move(pkt), ifID_);
         ++sent;
       }
@@ -362,6 +364,10 @@ void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
                              << folly::exceptionStr(ex);
   }
 
+  pktsFromHost_ += sent;
+  bytesFromHost_ += bytes;
+  pktsFromHostDropped_ += dropped;
+
   if (fdFail) {
     unregisterHandler();
   }
@@ -381,6 +387,7 @@ bool TunIntf::sendPacketToHost(std::unique_ptr<RxPacket> pkt) {
   auto buf = pkt->buf();
   if (buf->length() <= l2Len) {
     XLOG(ERR) << "Received a too small packet with length " << buf->length();
+    pktsToHostErrors_++;
     return false;
   }
 
@@ -393,16 +400,31 @@ bool TunIntf::sendPacketToHost(std::unique_ptr<RxPacket> pkt) {
   } while (ret == -1 && errno == EINTR);
   if (ret < 0) {
     sysLogError(ret, "Failed to send packet to host from Interface ", ifID_);
+    pktsToHostErrors_++;
     return false;
   } else if (ret < buf->length()) {
     XLOG(ERR) << "Failed to send full packet to host from Interface " << ifID_
               << ". " << ret << " bytes sent instead of " << buf->length();
+    pktsToHostErrors_++;
     return false;
   }
+  pktsToHost_++;
+  bytesToHost_ += ret;
 
   XLOG(DBG4) << "Send packet (" << ret << " bytes) to host from Interface "
              << ifID_;
   return true;
 }
 
+TunIntf::Stats TunIntf::getStats() const {
+  Stats stats;
+  stats.pktsFromHost = pktsFromHost_;
+  stats.bytesFromHost = bytesFromHost_;
+  stats.pktsFromHostDropped = pktsFromHostDropped_;
+  stats.pktsToHost = pktsToHost_;
+  stats.bytesToHost = bytesToHost_;
+  stats.pktsToHostErrors = pktsToHostErrors_;
+  return stats;
+}
+
 } // namespace facebook::fboss
@@ -11,6 +11,10 @@
 
 #include <folly/io/async/EventBase.h>
 #include <folly/io/async/EventHandler.h>
+
+#include <atomic>
+#include <vector>
+
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/StateUtils.h"
 #include "fboss/agent/types.h"
@@ -22,6 +26,18 @@ class RxPacket;
 
 class TunIntf : private folly::EventHandler {
  public:
+  /**
+   * Packet counters of the interface, from the point of view of the host.
+   */
+  struct Stats {
+    uint64_t pktsFromHost{0};
+    uint64_t bytesFromHost{0};
+    uint64_t pktsFromHostDropped{0};
+    uint64_t pktsToHost{0};
+    uint64_t bytesToHost{0};
+    uint64_t pktsToHostErrors{0};
+  };
+
   /**
    * Creates a TunIntf object of already existing linux interface. Initial
    * status is set to `false` for discovered interfaces because we do not
@@ -123,6 +139,8 @@ class TunIntf : private folly::EventHandler {
     return status_;
   }
 
+  Stats getStats() const;
+
  private:
   /**
    * Callback for event on Tun interface's read socket-fd
@@ -163,6 +181,21 @@ class TunIntf : private folly::EventHandler {
    */
   int fd_{-1};
   int mtu_{-1};
+
+  /**
+   * Packets from the host are read into this buffer, and only copied into a
+   * TxPacket of their actual size once read. This avoids allocating an MTU
+   * sized TxPacket for the read which finds nothing, and for small packets.
+   * Only used in the evb thread, and resized with the MTU.
+   */
+  std::vector<uint8_t> readBuf_;
+
+  std::atomic<uint64_t> pktsFromHost_{0};
+  std::atomic<uint64_t> bytesFromHost_{0};
+  std::atomic<uint64_t> pktsFromHostDropped_{0};
+  std::atomic<uint64_t> pktsToHost_{0};
+  std::atomic<uint64_t> bytesToHost_{0};
+  std::atomic<uint64_t> pktsToHostErrors_{0};
 };
 
 } // namespace facebook::fboss
@@ -18,6 +18,7 @@ extern "C" {
 #include <sys/ioctl.h>
 }
 
+#include <fb303/ServiceData.h>
 #include <folly/MapUtil.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/lang/CString.h>
@@ -35,7 +36,14 @@ extern "C" {
 
 namespace {
 const int kDefaultMtu = 1500;
-}
+
+constexpr auto kPktsFromHost = "tun.pkts_from_host";
+constexpr auto kBytesFromHost = "tun.bytes_from_host";
+constexpr auto kPktsFromHostDropped = "tun.pkts_from_host_dropped";
+constexpr auto kPktsToHost = "tun.pkts_to_host";
+constexpr auto kBytesToHost = "tun.bytes_to_host";
+constexpr auto kPktsToHostErrors = "tun.pkts_to_host_errors";
+} // namespace
 
 namespace facebook::fboss {
 
@@ -99,6 +107,28 @@ bool TunManager::sendPacketToHost(
   return iter->second->sendPacketToHost(std::move(pkt));
 }
 
+void TunManager::updateStats() {
+  TunIntf::Stats total;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& intf : intfs_) {
+      auto stats = intf.second->getStats();
+      total.pktsFromHost += stats.pktsFromHost;
+      total.bytesFromHost += stats.bytesFromHost;
+      total.pktsFromHostDropped += stats.pktsFromHostDropped;
+      total.pktsToHost += stats.pktsToHost;
+      total.bytesToHost += stats.bytesToHost;
+      total.pktsToHostErrors += stats.pktsToHostErrors;
+    }
+  }
+  fb303::fbData->setCounter(kPktsFromHost, total.pktsFromHost);
+  fb303::fbData->setCounter(kBytesFromHost, total.bytesFromHost);
+  fb303::fbData->setCounter(kPktsFromHostDropped, total.pktsFromHostDropped);
+  fb303::fbData->setCounter(kPktsToHost, total.pktsToHost);
+  fb303::fbData->setCounter(kBytesToHost, total.bytesToHost);
+  fb303::fbData->setCounter(kPktsToHostErrors, total.pktsToHostErrors);
+}
+
 void TunManager::addExistingIntf(const std::string& ifName, int ifIndex) {
   InterfaceID ifID = util::getIDFromTunIntfName(ifName);
   auto ret = intfs_.emplace(ifID, nullptr);
@@ -79,6 +79,12 @@ class TunManager : public StateObserver {
    */
   virtual void probe();
 
+  /**
+   * Publish the packet counters of all TUN interfaces to fb303.
+   * This function can be called from any thread.
+   */
+  void updateStats();
+
  private:
   // no copy to assign
   TunManager(const TunManager&) = delete;
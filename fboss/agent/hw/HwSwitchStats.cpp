@@ -28,6 +28,11 @@ HwSwitchStats::HwSwitchStats(
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.freed",
           SUM,
           RATE)),
+      txPktPoolHits_(SwitchStats::makeTLTimeseries(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.pkt.pool.hits",
+          SUM,
+          RATE)),
       txSent_(SwitchStats::makeTLTimeseries(
           map,
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.sent",
@@ -30,6 +30,9 @@ class HwSwitchStats {
   void txPktFree() {
     SwitchStats::addValue(*txPktFree_, 1);
   }
+  void txPktPoolHit() {
+    SwitchStats::addValue(*txPktPoolHits_, 1);
+  }
   void txSent() {
     SwitchStats::addValue(*txSent_, 1);
   }
@@ -67,6 +70,9 @@ class HwSwitchStats {
   int64_t getTxPktFreeCount() {
     return txPktFree_->count();
   }
+  int64_t getTxPktPoolHitCount() {
+    return txPktPoolHits_->count();
+  }
   int64_t getTxSentCount() {
     return txSent_->count();
   }
@@ -104,6 +110,8 @@ class HwSwitchStats {
   // Total number of Tx packet allocated right now
   TLTimeseriesPtr txPktAlloc_;
   TLTimeseriesPtr txPktFree_;
+  // Tx packets which reused a pooled buffer
+  TLTimeseriesPtr txPktPoolHits_;
   TLTimeseriesPtr txSent_;
   TLTimeseriesPtr txSentDone_;
 
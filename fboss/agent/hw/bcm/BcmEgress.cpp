@@ -294,24 +294,17 @@ BcmEcmpEgress::BcmEcmpEgress(
   if (hw_->getPlatform()->getAsic()->isSupported(HwAsic::Feature::WIDE_ECMP)) {
     wideEcmpSupported_ = true;
   }
-  program();
+  program(egressId2Weight_);
 }
 
-void BcmEcmpEgress::program() {
+void BcmEcmpEgress::program(const EgressId2Weight& egressId2Weight) {
   bcm_l3_egress_ecmp_t obj;
   bcm_l3_egress_ecmp_t_init(&obj);
-  int numPaths = 0;
-  if (ucmpEnabled_) {
-    numPaths = egressId2Weight_.size();
-  } else {
-    for (auto path : egressId2Weight_) {
-      numPaths += path.second;
-    }
-  }
+  int numPaths = getNumPaths(egressId2Weight);
   obj.max_paths = ((numPaths + 3) >> 2) << 2; // multiple of 4
 
   const auto warmBootCache = hw_->getWarmBootCache();
-  auto egressIds2EcmpCItr = warmBootCache->findEcmp(egressId2Weight_);
+  auto egressIds2EcmpCItr = warmBootCache->findEcmp(egressId2Weight);
   if (egressIds2EcmpCItr != warmBootCache->egressIds2Ecmp_end()) {
     const auto& existing = egressIds2EcmpCItr->second;
     // TODO figure out why the following check fails
@@ -323,12 +316,12 @@ void BcmEcmpEgress::program() {
     // CHECK(obj.max_paths == existing.max_paths);
     id_ = existing.ecmp_intf;
     XLOG(DBG1) << "Ecmp egress object for egress : "
-               << BcmWarmBootCache::toEgressId2WeightStr(egressId2Weight_)
+               << BcmWarmBootCache::toEgressId2WeightStr(egressId2Weight)
                << " already exists ";
     warmBootCache->programmed(egressIds2EcmpCItr);
   } else {
     XLOG(DBG1) << "Adding ecmp egress with egress : "
-               << BcmWarmBootCache::toEgressId2WeightStr(egressId2Weight_);
+               << BcmWarmBootCache::toEgressId2WeightStr(egressId2Weight);
     int option = 0;
     if (id_ != INVALID) {
       obj.flags |= BCM_L3_REPLACE | BCM_L3_WITH_ID;
@@ -351,7 +344,7 @@ void BcmEcmpEgress::program() {
       // @lint-ignore CLANGTIDY
       bcm_l3_ecmp_member_t ecmpMemberArray[numPaths];
       auto idx = 0;
-      for (const auto& path : egressId2Weight_) {
+      for (const auto& path : egressId2Weight) {
         if (ucmpEnabled_) {
           if (hw_->getEgressManager()->isResolved(path.first)) {
             bcm_l3_ecmp_member_t_init(&ecmpMemberArray[idx]);
@@ -380,14 +373,14 @@ void BcmEcmpEgress::program() {
           hw_->getUnit(), option, &obj, idx, ecmpMemberArray);
     } else {
       // check whether WideECMP is needed
-      if (numPaths > kMaxNonWeightedEcmpPaths) {
-        createWideEcmpEntry(numPaths);
+      if (isWideEcmpEntry(egressId2Weight)) {
+        createWideEcmpEntry(egressId2Weight, numPaths);
         return;
       } else {
         // @lint-ignore CLANGTIDY
         bcm_if_t pathsArray[numPaths];
         auto index = 0;
-        for (const auto& path : egressId2Weight_) {
+        for (const auto& path : egressId2Weight) {
           for (int i = 0; i < path.second; i++) {
             if (hw_->getEgressManager()->isResolved(path.first)) {
               pathsArray[index++] = path.first;
@@ -416,6 +409,48 @@ void BcmEcmpEgress::program() {
   CHECK_NE(id_, INVALID);
 }
 
+bool BcmEcmpEgress::updateEgressId2Weight(
+    const EgressId2Weight& egressId2Weight,
+    const bool isUcmp) {
+  CHECK_NE(id_, INVALID);
+  bool ucmpEnabled = isUcmp &&
+      hw_->getPlatform()->getAsic()->isSupported(
+          HwAsic::Feature::WEIGHTED_NEXTHOPGROUP_MEMBER);
+  if (ucmpEnabled != ucmpEnabled_ ||
+      isWideEcmpEntry(egressId2Weight) != isWideEcmpEntry(egressId2Weight_)) {
+    return false;
+  }
+  // program() would adopt the group found in the warm boot cache and leak
+  // this one
+  const auto warmBootCache = hw_->getWarmBootCache();
+  if (warmBootCache->findEcmp(egressId2Weight) !=
+      warmBootCache->egressIds2Ecmp_end()) {
+    return false;
+  }
+  XLOG(DBG2) << "Updating L3 ECMP egress object " << id_ << " from "
+             << egressId2WeightToString(egressId2Weight_) << " to "
+             << egressId2WeightToString(egressId2Weight);
+  program(egressId2Weight);
+  egressId2Weight_ = egressId2Weight;
+  return true;
+}
+
+int BcmEcmpEgress::getNumPaths(const EgressId2Weight& egressId2Weight) const {
+  if (ucmpEnabled_) {
+    return egressId2Weight.size();
+  }
+  int numPaths = 0;
+  for (auto path : egressId2Weight) {
+    numPaths += path.second;
+  }
+  return numPaths;
+}
+
+bool BcmEcmpEgress::isWideEcmpEntry(
+    const EgressId2Weight& egressId2Weight) const {
+  return !useHsdk_ && getNumPaths(egressId2Weight) > kMaxNonWeightedEcmpPaths;
+}
+
 BcmEcmpEgress::~BcmEcmpEgress() {
   if (id_ == INVALID) {
     return;
@@ -937,7 +972,9 @@ bool BcmEcmpEgress::rebalanceWideEcmpEntry(
   return false;
 }
 
-void BcmEcmpEgress::createWideEcmpEntry(int numPaths) {
+void BcmEcmpEgress::createWideEcmpEntry(
+    const EgressId2Weight& egressId2Weight,
+    int numPaths) {
   if (!isWideEcmpEnabled(hw_->getPlatform()->getAsic()->isSupported(
           HwAsic::Feature::WIDE_ECMP))) {
     XLOG(ERR) << "Wide ECMP is not supported/enabled. NumPaths : " << numPaths
@@ -946,7 +983,7 @@ void BcmEcmpEgress::createWideEcmpEntry(int numPaths) {
   }
 
   std::set<EgressId> activeMembers;
-  for (const auto& path : egressId2Weight_) {
+  for (const auto& path : egressId2Weight) {
     if (hw_->getEgressManager()->isResolved(path.first)) {
       activeMembers.insert(path.first);
     } else {
@@ -954,7 +991,7 @@ void BcmEcmpEgress::createWideEcmpEntry(int numPaths) {
                  << "programming ECMP group ";
     }
   }
-  programWideEcmp(hw_->getUnit(), id_, egressId2Weight_, activeMembers);
+  programWideEcmp(hw_->getUnit(), id_, egressId2Weight, activeMembers);
 }
 
 std::string BcmEcmpEgress::egressId2WeightToString(
@@ -162,6 +162,15 @@ class BcmEcmpEgress : public BcmEgressBase {
   ~BcmEcmpEgress() override;
   bool pathUnreachableHwLocked(EgressId path);
   bool pathReachableHwLocked(EgressId path);
+  /*
+   * Replace the members of the ECMP group in HW, keeping its ID. Returns
+   * false without touching HW when the group can't be reused for these
+   * members, i.e. when it would change between native UCMP, wide ECMP
+   * and regular ECMP, or when warm boot left a group with these members.
+   */
+  bool updateEgressId2Weight(
+      const EgressId2Weight& egressId2Weight,
+      const bool isUcmp);
   const EgressId2Weight& egressId2Weight() const {
     return egressId2Weight_;
   }
@@ -218,14 +227,18 @@ class BcmEcmpEgress : public BcmEgressBase {
       int unit,
       EgressId ecmpId,
       std::pair<EgressId, int> toRemove);
-  void createWideEcmpEntry(int numPaths);
+  void createWideEcmpEntry(
+      const EgressId2Weight& egressId2Weight,
+      int numPaths);
   static std::string egressId2WeightToString(
       const EgressId2Weight& egressId2Weight);
 
  private:
-  void program();
+  void program(const EgressId2Weight& egressId2Weight);
+  int getNumPaths(const EgressId2Weight& egressId2Weight) const;
+  bool isWideEcmpEntry(const EgressId2Weight& egressId2Weight) const;
   static bool isWideEcmpEnabled(bool wideEcmpSupported);
-  const EgressId2Weight egressId2Weight_;
+  EgressId2Weight egressId2Weight_;
   bool ucmpEnabled_{false};
   // TODO(daiweix): remove this flag when all TH4 devices use B0 chip
   bool useHsdk_{false};
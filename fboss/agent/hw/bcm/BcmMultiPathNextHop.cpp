@@ -8,6 +8,20 @@
 #include "fboss/agent/hw/bcm/BcmSwitch.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootCache.h"
 
+#include <fb303/ServiceData.h>
+#include <gflags/gflags.h>
+
+DEFINE_bool(
+    bcm_ecmp_in_place_update,
+    false,
+    "Update the members of an ECMP group in place when the next hops of its "
+    "only route change, rather than creating a new group for them");
+
+namespace {
+constexpr auto kEcmpGroupsUpdatedInPlace = "bcm.ecmp_groups_updated_in_place";
+constexpr auto kEcmpGroupsRecreated = "bcm.ecmp_groups_recreated";
+} // namespace
+
 namespace facebook::fboss {
 
 BcmMultiPathNextHop::BcmMultiPathNextHop(
@@ -17,6 +31,20 @@ BcmMultiPathNextHop::BcmMultiPathNextHop(
   auto& fwd = key.second;
   CHECK_GT(fwd.size(), 0);
   BcmEcmpEgress::EgressId2Weight egressId2Weight;
+  auto nexthops = refOrEmplaceNextHops(fwd, egressId2Weight);
+  if (egressId2Weight.size() > 1) {
+    // BcmEcmpEgress object only for more than 1 paths.
+    ecmpEgress_ = std::make_unique<BcmEcmpEgress>(
+        hw, std::move(egressId2Weight), RouteNextHopEntry::isUcmp(fwd));
+  }
+  fwd_ = std::move(fwd);
+  nexthops_ = std::move(nexthops);
+}
+
+std::vector<std::shared_ptr<BcmNextHop>>
+BcmMultiPathNextHop::refOrEmplaceNextHops(
+    const RouteNextHopSet& fwd,
+    BcmEcmpEgress::EgressId2Weight& egressId2Weight) {
   std::vector<std::shared_ptr<BcmNextHop>> nexthops;
   // allocate a NextHop object for each path in this ECMP
   for (const auto& nhop : fwd) {
@@ -29,20 +57,34 @@ BcmMultiPathNextHop::BcmMultiPathNextHop(
     // do the HW programming. For now, we program the egress object to punt
     // to CPU. Any traffic going to CPU will trigger the neighbor discovery.
     if (!nexthop->isProgrammed()) {
-      const auto intf = hw->getIntfTable()->getBcmIntf(nhop.intf());
+      const auto intf = hw_->getIntfTable()->getBcmIntf(nhop.intf());
       nexthop->programToCPU(intf->getBcmIfId());
     }
     egressId2Weight.insert(
         std::make_pair(nexthop->getEgressId(), nhop.weight()));
     nexthops.push_back(std::move(nexthopSharedPtr));
   }
-  if (egressId2Weight.size() > 1) {
-    // BcmEcmpEgress object only for more than 1 paths.
-    ecmpEgress_ = std::make_unique<BcmEcmpEgress>(
-        hw, std::move(egressId2Weight), RouteNextHopEntry::isUcmp(fwd));
+  return nexthops;
+}
+
+bool BcmMultiPathNextHop::updateNextHops(const RouteNextHopSet& fwd) {
+  if (!ecmpEgress_) {
+    return false;
   }
-  fwd_ = std::move(fwd);
+  // Reference the new paths before releasing the old ones, so that the
+  // paths in both sets are kept as they are
+  BcmEcmpEgress::EgressId2Weight egressId2Weight;
+  auto nexthops = refOrEmplaceNextHops(fwd, egressId2Weight);
+  if (egressId2Weight.size() <= 1 ||
+      !ecmpEgress_->updateEgressId2Weight(
+          egressId2Weight, RouteNextHopEntry::isUcmp(fwd))) {
+    return false;
+  }
+  XLOG(DBG3) << "Updated egress object " << getEcmpEgressId() << " from "
+             << fwd_ << " to " << fwd;
+  fwd_ = fwd;
   nexthops_ = std::move(nexthops);
+  return true;
 }
 
 std::shared_ptr<BcmNextHop> BcmMultiPathNextHop::refOrEmplaceNextHop(
@@ -66,6 +108,33 @@ BcmMultiPathNextHop::~BcmMultiPathNextHop() {
   XLOG(DBG3) << "Removing egress object for " << fwd_;
 }
 
+std::shared_ptr<BcmMultiPathNextHop>
+BcmMultiPathNextHopTable::referenceOrUpdateNextHop(
+    const std::shared_ptr<BcmMultiPathNextHop>& old,
+    const BcmMultiPathNextHopKey& key) {
+  bool isEcmpChange = old && old->getEgress() && key.second.size() > 1;
+  if (!isEcmpChange || getNextHopIf(key)) {
+    return referenceOrEmplaceNextHop(key);
+  }
+  // Only one user means nothing else points to the ECMP egress ID
+  if (FLAGS_bcm_ecmp_in_place_update && old.use_count() == 1 &&
+      old->getKey().first == key.first) {
+    auto oldKey = old->getKey();
+    if (old->updateNextHops(key.second)) {
+      CHECK(rekeyNextHop(oldKey, key));
+      ecmpGroupsUpdatedInPlace_++;
+      fb303::fbData->incrementCounter(kEcmpGroupsUpdatedInPlace);
+      return old;
+    }
+  }
+  auto nexthop = referenceOrEmplaceNextHop(key);
+  if (nexthop->getEgress()) {
+    ecmpGroupsRecreated_++;
+    fb303::fbData->incrementCounter(kEcmpGroupsRecreated);
+  }
+  return nexthop;
+}
+
 long BcmMultiPathNextHopTable::getEcmpEgressCount() const {
   return std::count_if(
       getNextHops().begin(),
@@ -43,8 +43,22 @@ class BcmMultiPathNextHop {
     return ecmpEgress_.get();
   }
 
+  BcmMultiPathNextHopKey getKey() const {
+    return BcmMultiPathNextHopKey(vrf_, fwd_);
+  }
+
+  /*
+   * Change the paths of the ECMP egress in place, keeping its egress ID.
+   * Returns false if there is no ECMP egress or it can't take these paths,
+   * in which case nothing changed.
+   */
+  bool updateNextHops(const RouteNextHopSet& fwd);
+
  private:
   std::shared_ptr<BcmNextHop> refOrEmplaceNextHop(const HostKey& key);
+  std::vector<std::shared_ptr<BcmNextHop>> refOrEmplaceNextHops(
+      const RouteNextHopSet& fwd,
+      BcmEcmpEgress::EgressId2Weight& egressId2Weight);
 
   const BcmSwitchIf* hw_;
   bcm_vrf_t vrf_;
@@ -80,10 +94,31 @@ class BcmMultiPathNextHopTable : public BcmMultiPathNextHopTableBase {
 
   long getEcmpEgressCount() const;
 
+  /*
+   * Reference the next hop for key, for a user which referenced old before.
+   * With --bcm_ecmp_in_place_update, when that user is the only one left on
+   * the ECMP group of old and key has no group yet, the group of old is
+   * updated to the paths of key instead of a new group being created.
+   */
+  std::shared_ptr<BcmMultiPathNextHop> referenceOrUpdateNextHop(
+      const std::shared_ptr<BcmMultiPathNextHop>& old,
+      const BcmMultiPathNextHopKey& key);
+
+  uint64_t getEcmpGroupsUpdatedInPlace() const {
+    return ecmpGroupsUpdatedInPlace_;
+  }
+  uint64_t getEcmpGroupsRecreated() const {
+    return ecmpGroupsRecreated_;
+  }
+
  private:
   bool ucmpSupported_{false};
   bool useHsdk_{false};
   bool wideEcmpSupported_{false};
+  // ECMP groups of a next hop set change which were updated in place, and
+  // which were replaced by a new group
+  uint64_t ecmpGroupsUpdatedInPlace_{0};
+  uint64_t ecmpGroupsRecreated_{0};
 };
 
 } // namespace facebook::fboss
@@ -101,6 +101,11 @@ class BcmNextHopTable {
     return hw_;
   }
 
+ protected:
+  bool rekeyNextHop(const NextHopKeyT& from, const NextHopKeyT& to) {
+    return nexthops_.rekey(from, to);
+  }
+
  private:
   BcmSwitch* hw_;
   MapT nexthops_;
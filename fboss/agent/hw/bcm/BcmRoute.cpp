@@ -311,11 +311,22 @@ void BcmRoute::program(
     CHECK_GT(nhops.size(), 0);
     // need to get an entry from the host table for the forward info
     nexthopReference =
-        hw_->writableMultiPathNextHopTable()->referenceOrEmplaceNextHop(
+        hw_->writableMultiPathNextHopTable()->referenceOrUpdateNextHop(
+            nextHopHostReference_,
             BcmMultiPathNextHopKey(vrf_, fwd.getNextHopSet()));
     egressId = nexthopReference->getEgressId();
   }
 
+  // The ECMP egress of the route was updated in place, so the route entry
+  // in HW is already right
+  if (added_ && nexthopReference &&
+      nexthopReference == nextHopHostReference_ &&
+      std::tie(egressId, classID, counterID) ==
+          std::tie(egressId_, classID_, oldCounterID)) {
+    fwd_ = fwd;
+    return;
+  }
+
   // At this point host and egress objects for next hops have been
   // created, what remains to be done is to program route into the
   // route table or host table (if this is a host route and use of
@@ -16,8 +16,11 @@
 #include <fcntl.h>
 #include <ifaddrs.h>
 
+#include <fb303/ServiceData.h>
 #include <folly/Range.h>
 #include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <optional>
 
@@ -25,9 +28,28 @@
 
 #include "fboss/agent/FbossError.h"
 
+DEFINE_int32(
+    sflow_export_queue_depth,
+    4096,
+    "Maximum number of sFlow samples waiting to be exported, samples beyond "
+    "it are dropped");
+DEFINE_int32(
+    sflow_export_batch_size,
+    64,
+    "Number of queued sFlow samples which wakes up the export thread");
+DEFINE_int32(
+    sflow_export_flush_interval_ms,
+    10,
+    "Maximum time an sFlow sample waits in the queue before being exported");
+
 using namespace std;
 
 namespace {
+constexpr auto kSflowDatagrams = "sflow_export.datagrams";
+constexpr auto kSflowQueueOverflows = "sflow_export.queue_overflows";
+constexpr auto kSflowSendFailures = "sflow_export.send_failures";
+constexpr auto kSflowQueueDepth = "sflow_export.queue_depth";
+
 std::optional<folly::IPAddress> getLocalIPv6FromWhoAmI() {
   const std::string whoAmIFn = "/etc/fbwhoami";
   const std::string key = "DEVICE_PRIMARY_IPV6";
@@ -189,26 +211,89 @@ ssize_t BcmSflowExporter::sendUDPDatagram(iovec* vec, const size_t iovec_len) {
   return ret;
 }
 
+size_t BcmSflowExporter::sendUDPDatagrams(
+    const std::vector<std::string>& bufs,
+    size_t count) {
+  XLOG(DBG4) << "Sending " << count << " sFlow packets to "
+             << address_.describe();
+
+  sockaddr_storage addrStorage;
+  address_.getAddress(&addrStorage);
+
+  iovecs_.resize(count);
+  msgs_.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    iovecs_[i].iov_base = const_cast<char*>(bufs[i].data());
+    iovecs_[i].iov_len = bufs[i].size();
+    msgs_[i] = {};
+    msgs_[i].msg_hdr.msg_name = reinterpret_cast<void*>(&addrStorage);
+    msgs_[i].msg_hdr.msg_namelen = address_.getActualSize();
+    msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+    msgs_[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  size_t sent = 0;
+  while (sent < count) {
+    auto vlen = std::min<size_t>(count - sent, UIO_MAXIOV);
+    auto ret = ::sendmmsg(socket_, &msgs_[sent], vlen, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      XLOG(DBG1) << "Failed sending " << count - sent << " sFlow packets to "
+                 << address_.describe()
+                 << " reason: " << folly::errnoStr(errno);
+      break;
+    }
+    sent += ret;
+  }
+  XLOG(DBG4) << "Sent " << sent << " sFlow packets to " << address_.describe();
+  return sent;
+}
+
 BcmSflowExporter::~BcmSflowExporter() {
   if (socket_ != -1) {
     close(socket_);
   }
 }
 
+BcmSflowExporterTable::BcmSflowExporterTable()
+    : queue_(std::max(FLAGS_sflow_export_queue_depth, 1)),
+      batch_(queue_.size()) {
+  fb303::fbData->addStatExportType(kSflowDatagrams, fb303::SUM, fb303::RATE);
+  fb303::fbData->addStatExportType(
+      kSflowQueueOverflows, fb303::SUM, fb303::RATE);
+  fb303::fbData->addStatExportType(kSflowSendFailures, fb303::SUM, fb303::RATE);
+  exportThread_ = std::thread([this] { exportThread(); });
+}
+
+BcmSflowExporterTable::~BcmSflowExporterTable() {
+  {
+    std::lock_guard<std::mutex> g(queueLock_);
+    stopping_ = true;
+  }
+  queueCv_.notify_one();
+  exportThread_.join();
+  // Don't lose the samples queued since the last batch
+  flush();
+}
+
 bool BcmSflowExporterTable::contains(
     const shared_ptr<SflowCollector>& c) const {
-  auto iter = map_.find(c->getID());
-  return iter != map_.end();
+  auto lockedMap = map_.lock();
+  return lockedMap->find(c->getID()) != lockedMap->end();
 }
 
 size_t BcmSflowExporterTable::size() const {
-  return map_.size();
+  return numExporters_;
 }
 
 void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
   try {
     auto exporter = make_unique<BcmSflowExporter>(c->getAddress());
-    map_.emplace(c->getID(), move(exporter));
+    auto lockedMap = map_.lock();
+    lockedMap->emplace(c->getID(), move(exporter));
+    numExporters_ = lockedMap->size();
   } catch (const fboss::thrift::FbossBaseError& ex) {
     XLOG(ERR) << "Could not add exporter: "
               << c->getAddress().getFullyQualified()
@@ -222,7 +307,9 @@ void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
 
 void BcmSflowExporterTable::removeExporter(const std::string& id) {
   XLOG(INFO) << "Removed sFlow exporter " << id;
-  map_.erase(id);
+  auto lockedMap = map_.lock();
+  lockedMap->erase(id);
+  numExporters_ = lockedMap->size();
 }
 
 void BcmSflowExporterTable::updateSamplingRates(
@@ -242,29 +329,103 @@ void BcmSflowExporterTable::updateSamplingRates(
 }
 
 void BcmSflowExporterTable::sendToAll(const SflowPacketInfo& info) {
-  if (map_.empty()) {
+  if (numExporters_ == 0) {
     XLOG(DBG1)
         << "zero sFlow collectors with sflow enabled, skipping sample export";
     return;
   }
-  // Serialize info to a string and wrap it in an IOBuf for sending
-  string output;
+  // Serialize info outside of the queue lock. The buffer swapped out of the
+  // queue is the one of an already sent sample, so after a few samples the
+  // serialization doesn't allocate anymore.
+  static thread_local string output;
+  output.clear();
   apache::thrift::BinarySerializer::serialize(info, &output);
-  auto buf = folly::IOBuf::wrapBuffer(output.data(), output.length());
-
-  // Map the IOBuf to a Linux iovec like a champ
-  iovec vec[16] = {};
-  size_t iovec_len = buf->fillIov(vec, sizeof(vec) / sizeof(vec[0])).numIovecs;
-  if (UNLIKELY(iovec_len == 0)) {
-    buf->coalesce();
-    vec[0].iov_base = const_cast<uint8_t*>(buf->data());
-    vec[0].iov_len = buf->length();
-    iovec_len = 1;
+
+  bool wakeUp = false;
+  {
+    std::lock_guard<std::mutex> g(queueLock_);
+    if (queueSize_ == queue_.size()) {
+      queueOverflows_++;
+      fb303::fbData->addStatValue(kSflowQueueOverflows, 1);
+      return;
+    }
+    std::swap(queue_[queueSize_++], output);
+    // The export thread sleeps on an empty queue, and then waits for a full
+    // batch
+    wakeUp = queueSize_ == 1 ||
+        queueSize_ == static_cast<size_t>(FLAGS_sflow_export_batch_size);
   }
+  if (wakeUp) {
+    queueCv_.notify_one();
+  }
+}
+
+void BcmSflowExporterTable::flush() {
+  sendBatch();
+}
+
+size_t BcmSflowExporterTable::getQueueDepth() const {
+  std::lock_guard<std::mutex> g(queueLock_);
+  return queueSize_;
+}
 
-  for (const auto& c : map_) {
-    // TODO: prob need to handle ret code?
-    c.second->sendUDPDatagram(vec, iovec_len);
+uint64_t BcmSflowExporterTable::getQueueOverflows() const {
+  return queueOverflows_;
+}
+
+uint64_t BcmSflowExporterTable::getSendFailures() const {
+  return sendFailures_;
+}
+
+void BcmSflowExporterTable::exportThread() {
+  folly::setThreadName("SflowExporter");
+  const auto interval =
+      std::chrono::milliseconds(FLAGS_sflow_export_flush_interval_ms);
+  std::unique_lock<std::mutex> lock(queueLock_);
+  while (true) {
+    queueCv_.wait(lock, [this] { return stopping_ || queueSize_ > 0; });
+    // Give the first sample up to the flush interval to be joined by a batch
+    queueCv_.wait_for(lock, interval, [this] {
+      return stopping_ ||
+          queueSize_ >= static_cast<size_t>(FLAGS_sflow_export_batch_size);
+    });
+    if (stopping_) {
+      break;
+    }
+    lock.unlock();
+    sendBatch();
+    lock.lock();
+  }
+}
+
+void BcmSflowExporterTable::sendBatch() {
+  std::lock_guard<std::mutex> sendGuard(sendLock_);
+  size_t count;
+  {
+    std::lock_guard<std::mutex> g(queueLock_);
+    std::swap(queue_, batch_);
+    count = queueSize_;
+    queueSize_ = 0;
+  }
+  fb303::fbData->setCounter(kSflowQueueDepth, count);
+  if (count == 0) {
+    return;
+  }
+
+  size_t sent = 0;
+  size_t failed = 0;
+  {
+    auto lockedMap = map_.lock();
+    for (const auto& c : *lockedMap) {
+      auto collectorSent = c.second->sendUDPDatagrams(batch_, count);
+      sent += collectorSent;
+      failed += count - collectorSent;
+    }
+  }
+  fb303::fbData->addStatValue(kSflowDatagrams, sent);
+  if (failed) {
+    sendFailures_ += failed;
+    fb303::fbData->addStatValue(kSflowSendFailures, failed);
   }
 }
 
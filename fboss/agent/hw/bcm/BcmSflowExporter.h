@@ -9,10 +9,19 @@
  */
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
 
 #include <folly/IPAddress.h>
 #include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
 
 #include "fboss/agent/if/gen-cpp2/sflow_types.h"
 #include "fboss/agent/state/SflowCollector.h"
@@ -35,6 +44,12 @@ class BcmSflowExporter {
    */
   ssize_t sendUDPDatagram(iovec* vec, const size_t iovec_len);
 
+  /*
+   * Send the first count buffers of bufs, one datagram each, with as few
+   * sendmmsg() calls as possible. Returns the number of datagrams sent.
+   */
+  size_t sendUDPDatagrams(const std::vector<std::string>& bufs, size_t count);
+
  private:
   // no copy or assignment
   BcmSflowExporter(BcmSflowExporter const&) = delete;
@@ -42,12 +57,24 @@ class BcmSflowExporter {
 
   const folly::SocketAddress address_;
   int socket_{-1};
+  // Reused by every sendUDPDatagrams() call
+  std::vector<iovec> iovecs_;
+  std::vector<mmsghdr> msgs_;
 };
 
+/*
+ * The samples given to sendToAll() are serialized on the RX thread into a
+ * queue, and sent to the collectors from a dedicated export thread. The
+ * export thread sleeps while the queue is empty. Once a sample is queued it
+ * waits for sflow_export_batch_size samples, or at most
+ * sflow_export_flush_interval_ms, and sends the whole queue to each collector
+ * with sendmmsg(). Samples which don't fit in the queue are dropped rather
+ * than slowing down the RX thread.
+ */
 class BcmSflowExporterTable {
  public:
-  BcmSflowExporterTable() = default;
-  ~BcmSflowExporterTable() = default;
+  BcmSflowExporterTable();
+  ~BcmSflowExporterTable();
 
   bool contains(const std::shared_ptr<SflowCollector>& collector) const;
   size_t size() const;
@@ -56,14 +83,49 @@ class BcmSflowExporterTable {
 
   void updateSamplingRates(PortID id, int64_t inRate, int64_t outRate);
 
+  // Queue a sample to be sent to all the collectors
   void sendToAll(const SflowPacketInfo& info);
 
+  // Send the queued samples right away, instead of waiting for the export
+  // thread
+  void flush();
+
+  size_t getQueueDepth() const;
+  // Samples dropped because the queue was full
+  uint64_t getQueueOverflows() const;
+  // Datagrams which failed to be sent to a collector
+  uint64_t getSendFailures() const;
+
  private:
   // no copy or assignment
   BcmSflowExporterTable(BcmSflowExporterTable const&) = delete;
   BcmSflowExporterTable& operator=(BcmSflowExporterTable const&) = delete;
 
-  std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>> map_;
+  void exportThread();
+  // Send the queued samples. The queue is swapped with the buffers of the
+  // previous batch, so that their memory is reused by the next samples.
+  void sendBatch();
+
+  folly::Synchronized<
+      std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>>,
+      std::mutex>
+      map_;
+  std::atomic<size_t> numExporters_{0};
+
+  // Serialized samples waiting to be sent, the first queueSize_ entries of
+  // queue_ are valid. batch_ holds the samples being sent.
+  mutable std::mutex queueLock_;
+  std::condition_variable queueCv_;
+  std::vector<std::string> queue_;
+  size_t queueSize_{0};
+  std::vector<std::string> batch_;
+  // Serializes the senders, i.e. the export thread and flush()
+  std::mutex sendLock_;
+  std::atomic<uint64_t> queueOverflows_{0};
+  std::atomic<uint64_t> sendFailures_{0};
+  bool stopping_{false};
+  std::thread exportThread_;
+
   std::unordered_map<
       PortID,
       std::pair<int64_t /* ingress rate */, int64_t /* egress rate */>>
@@ -16,6 +16,7 @@
 #include <optional>
 #include <utility>
 
+#include <fb303/ServiceData.h>
 #include <folly/Conv.h>
 #include <folly/FileUtil.h>
 #include <folly/Memory.h>
@@ -75,6 +76,7 @@
 #include "fboss/agent/hw/bcm/BcmTrunk.h"
 #include "fboss/agent/hw/bcm/BcmTrunkTable.h"
 #include "fboss/agent/hw/bcm/BcmTxPacket.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
 #include "fboss/agent/hw/bcm/BcmUnit.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootCache.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootHelper.h"
@@ -112,6 +114,7 @@
 #include "fboss/agent/state/VlanMap.h"
 #include "fboss/agent/state/VlanMapDelta.h"
 #include "fboss/agent/types.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 
 extern "C" {
 #include <bcm/link.h>
@@ -163,6 +166,11 @@ DEFINE_int32(
     "Starting ACL entry priority for CoPP");
 
 DEFINE_int32(acl_g_pri, 0, "Group priority for ACL field group");
+DEFINE_int32(
+    bcm_tx_pkt_pool_size,
+    0,
+    "Number of TX packets of each size class kept for reuse instead of being "
+    "freed, 0 disables the pool. Only used without PKTIO.");
 DEFINE_int32(
     qcm_ifp_gid,
     5,
@@ -179,6 +187,8 @@ enum : uint8_t {
 namespace {
 constexpr auto kHostTable = "hostTable";
 constexpr int kLogBcmErrorFreqMs = 3000;
+constexpr auto kTxPktPoolOutstanding = "bcm.tx.pkt.pool.outstanding";
+constexpr auto kTxPktPoolCached = "bcm.tx.pkt.pool.cached";
 // On new platforms we found sflow samplig rate to be inconsistent
 // BRCM found this seed provides better results (see CS00011944544)
 constexpr auto kHSDKSflowSamplingSeed = 0x2f64c448;
@@ -417,6 +427,10 @@ void BcmSwitch::resetTables() {
   macTable_.reset();
   qcmManager_.reset();
   ptpTcMgr_.reset();
+  // Packets still in flight are freed by the SDK as usual from now on
+  if (txPacketPool_) {
+    txPacketPool_->drain();
+  }
   queueFlexCounterMgr_.reset();
   // Reset warmboot cache last in case Bcm object destructors
   // access it during object deletion.
@@ -500,6 +514,9 @@ void BcmSwitch::gracefulExitImpl(folly::dynamic& switchState) {
 
   switchState[kHwSwitch] = toFollyDynamic();
   unitObject_->writeWarmBootState(switchState);
+  if (txPacketPool_) {
+    txPacketPool_->drain();
+  }
   unitObject_.reset();
   XLOG(INFO)
       << "[Exit] BRCM Graceful Exit time "
@@ -776,6 +793,10 @@ HwInitResult BcmSwitch::init(
   unitObject_->setCookie(this);
 
   BcmAPI::initUnit(unit_, platform_);
+  if (FLAGS_bcm_tx_pkt_pool_size > 0 && !usePKTIO()) {
+    txPacketPool_ =
+        std::make_unique<BcmTxPacketPool>(unit_, FLAGS_bcm_tx_pkt_pool_size);
+  }
 
   bootType_ = platform_->getWarmBootHelper()->canWarmBoot()
       ? BootType::WARM_BOOT
@@ -2266,6 +2287,7 @@ void BcmSwitch::processNeighborDelta(
     const StateDelta& delta,
     std::shared_ptr<SwitchState>* appliedState,
     DeltaType optype) {
+  TIME_PHASE("bcm_host_table");
   processNeighborTableDelta<folly::IPAddressV4>(delta, appliedState, optype);
   processNeighborTableDelta<folly::IPAddressV6>(delta, appliedState, optype);
 }
@@ -2363,6 +2385,7 @@ void BcmSwitch::processRemovedRoute(
 }
 
 void BcmSwitch::processRemovedRoutes(const StateDelta& delta) {
+  TIME_PHASE("bcm_route_table");
   forEachChangedRoute(
       delta,
       [](RouterID /*id*/, const auto& /*oldRoute*/, const auto& /*newRoute*/) {
@@ -2376,6 +2399,7 @@ void BcmSwitch::processRemovedRoutes(const StateDelta& delta) {
 void BcmSwitch::processAddedChangedRoutes(
     const StateDelta& delta,
     std::shared_ptr<SwitchState>* appliedState) {
+  TIME_PHASE("bcm_route_table");
   processRouteTableDelta<folly::IPAddressV4>(delta, appliedState);
   processRouteTableDelta<folly::IPAddressV6>(delta, appliedState);
 }
@@ -2598,6 +2622,11 @@ void BcmSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
   updateGlobalStats();
   // Update cpu or host bound packet stats
   controlPlane_->updateQueueCounters();
+  if (txPacketPool_) {
+    fb303::fbData->setCounter(
+        kTxPktPoolOutstanding, txPacketPool_->getOutstanding());
+    fb303::fbData->setCounter(kTxPktPoolCached, txPacketPool_->getNumCached());
+  }
 }
 
 folly::F14FastMap<std::string, HwPortStats> BcmSwitch::getPortStats() const {
@@ -96,6 +96,7 @@ class BcmMacTable;
 class PortQueue;
 class BcmQcmManager;
 class BcmPtpTcMgr;
+class BcmTxPacketPool;
 class BcmEgressQueueFlexCounterManager;
 
 /*
@@ -511,6 +512,11 @@ class BcmSwitch : public BcmSwitchIf {
     return ptpTcMgr_.get();
   }
 
+  // nullptr unless --bcm_tx_pkt_pool_size is set
+  BcmTxPacketPool* getTxPacketPool() const {
+    return txPacketPool_.get();
+  }
+
   BcmEgressQueueFlexCounterManager* getBcmEgressQueueFlexCounterManager()
       const {
     return queueFlexCounterMgr_.get();
@@ -1023,6 +1029,8 @@ class BcmSwitch : public BcmSwitchIf {
   int64_t bstStatsUpdateTime_{0};
   std::unique_ptr<BcmQcmManager> qcmManager_;
   std::unique_ptr<BcmPtpTcMgr> ptpTcMgr_;
+  // Drained before the unit goes away, see resetTables()
+  std::unique_ptr<BcmTxPacketPool> txPacketPool_;
 
   std::unique_ptr<BcmEgressQueueFlexCounterManager> queueFlexCounterMgr_;
 
@@ -14,6 +14,8 @@
 
 #include "fboss/agent/hw/HwSwitchStats.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
+#include "fboss/agent/hw/bcm/BcmSwitch.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
 #include "fboss/agent/packet/EthHdr.h"
 #include "fboss/agent/packet/PktUtil.h"
 
@@ -31,7 +33,7 @@ constexpr auto kVlanTagSize = 4;
 #endif
 
 using namespace facebook::fboss;
-void freeTxBuf(void* /*ptr*/, void* arg) {
+void freeTxBuf(void* ptr, void* arg) {
   // Put the BcmTxIoBufUserData back into a unique_ptr.
   // This will delete it when we return.
   unique_ptr<facebook::fboss::BcmFreeTxBufUserData> freeTxBufUserData(
@@ -40,7 +42,12 @@ void freeTxBuf(void* /*ptr*/, void* arg) {
   int rv;
   if (!bcmPacket.usePktIO) {
     bcm_pkt_t* pkt = bcmPacket.ptrUnion.pkt;
-    rv = bcm_pkt_free(pkt->unit, pkt);
+    if (auto pool = freeTxBufUserData->pool) {
+      rv = pool->free(
+          pkt, freeTxBufUserData->size, static_cast<uint8_t*>(ptr));
+    } else {
+      rv = bcm_pkt_free(pkt->unit, pkt);
+    }
   } else {
 #ifdef INCLUDE_PKTIO
     bcm_pktio_pkt_t* pktioPkt = bcmPacket.ptrUnion.pktioPkt;
@@ -70,26 +77,18 @@ inline void txCallbackImpl(int /*unit*/, bcm_pkt_t* pkt, void* cookie) {
   auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
       end - bcmTxCbUserData->txPacket->getQueueTime());
   bcmTxCbUserData->bcmSwitch->getSwitchStats()->txSentDone(duration.count());
+
+  // Free the packet before waking up a synchronous sender
+  auto sendDone = bcmTxCbUserData->sendDone;
+  bcmTxCbUserData.reset();
+  if (sendDone) {
+    sendDone->post();
+  }
 }
 } // namespace
 
 namespace facebook::fboss {
 
-std::mutex& BcmTxPacket::syncPktMutex() {
-  static std::mutex _syncPktMutex;
-  return _syncPktMutex;
-}
-
-std::condition_variable& BcmTxPacket::syncPktCV() {
-  static std::condition_variable _syncPktCV;
-  return _syncPktCV;
-}
-
-bool& BcmTxPacket::syncPacketSent() {
-  static bool _syncPktSent{false};
-  return _syncPktSent;
-}
-
 BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
     : queued_(std::chrono::time_point<std::chrono::steady_clock>::min())
 #ifdef INCLUDE_PKTIO
@@ -104,13 +103,21 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
   uint32_t allocatedCapacity = size;
 
   bcmPacket_.usePktIO = usePktIO;
+  BcmTxPacketPool* pool = nullptr;
   if (!usePktIO) {
     bcmPacket_.ptrUnion.pkt = nullptr;
-    rv = bcm_pkt_alloc(
-        unit,
-        size,
-        BCM_TX_CRC_APPEND | BCM_TX_ETHER,
-        &(bcmPacket_.ptrUnion.pkt));
+    pool = bcmSwitch->getTxPacketPool();
+    bool fromPool = false;
+    if (pool) {
+      allocatedCapacity = BcmTxPacketPool::getAllocSize(size);
+      rv = pool->alloc(size, &(bcmPacket_.ptrUnion.pkt), &fromPool);
+    } else {
+      rv = bcm_pkt_alloc(
+          unit,
+          size,
+          BCM_TX_CRC_APPEND | BCM_TX_ETHER,
+          &(bcmPacket_.ptrUnion.pkt));
+    }
     if (BCM_FAILURE(rv)) {
       bcmSwitch->getSwitchStats()->txPktAllocErrors();
       bcmCheckError(rv, "Failed to allocate packet.");
@@ -118,6 +125,9 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
       bcm_pkt_t* pkt = bcmPacket_.ptrUnion.pkt;
       CHECK_NOTNULL(pkt);
       bufData = pkt->pkt_data->data;
+      if (fromPool) {
+        bcmSwitch->getSwitchStats()->txPktPoolHit();
+      }
     }
   } else {
 #ifdef INCLUDE_PKTIO
@@ -154,8 +164,8 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
 
   DCHECK(bufData);
 
-  auto freeTxBufUserData =
-      std::make_unique<BcmFreeTxBufUserData>(bcmPacket_, bcmSwitch);
+  auto freeTxBufUserData = std::make_unique<BcmFreeTxBufUserData>(
+      bcmPacket_, bcmSwitch, pool, size);
 
   buf_ = IOBuf::takeOwnership(
       bufData,
@@ -177,7 +187,8 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
 
 inline int BcmTxPacket::sendImpl(
     unique_ptr<BcmTxPacket> pkt,
-    const BcmSwitch* bcmSwitch) noexcept {
+    const BcmSwitch* bcmSwitch,
+    folly::Baton<>* sendDone) noexcept {
   int rv = 0;
 
   std::unique_ptr<BcmTxCallbackUserData> txCbUserData;
@@ -199,8 +210,8 @@ inline int BcmTxPacket::sendImpl(
 
     pkt->queued_ = std::chrono::steady_clock::now();
 
-    txCbUserData =
-        std::make_unique<BcmTxCallbackUserData>(std::move(pkt), bcmSwitch);
+    txCbUserData = std::make_unique<BcmTxCallbackUserData>(
+        std::move(pkt), bcmSwitch, sendDone);
     rv = bcm_tx(bcmPkt->unit, bcmPkt, txCbUserData.get());
 
   } else {
@@ -305,17 +316,10 @@ inline int BcmTxPacket::sendImpl(
   return rv;
 }
 
-void BcmTxPacket::txCallbackAsync(int unit, bcm_pkt_t* pkt, void* cookie) {
+void BcmTxPacket::txCallback(int unit, bcm_pkt_t* pkt, void* cookie) {
   txCallbackImpl(unit, pkt, cookie);
 }
 
-void BcmTxPacket::txCallbackSync(int unit, bcm_pkt_t* pkt, void* cookie) {
-  txCallbackImpl(unit, pkt, cookie);
-  std::lock_guard<std::mutex> lk(syncPktMutex());
-  syncPacketSent() = true;
-  syncPktCV().notify_one();
-}
-
 int BcmTxPacket::sendAsync(
     unique_ptr<BcmTxPacket> pkt,
     const BcmSwitch* bcmSwitch) noexcept {
@@ -325,35 +329,29 @@ int BcmTxPacket::sendAsync(
   }
   bcm_pkt_t* bcmPkt = pkt->bcmPacket_.ptrUnion.pkt;
   DCHECK(bcmPkt->call_back == nullptr);
-  bcmPkt->call_back = BcmTxPacket::txCallbackAsync;
+  bcmPkt->call_back = BcmTxPacket::txCallback;
   return sendImpl(std::move(pkt), bcmSwitch);
 }
 
 int BcmTxPacket::sendSync(
     unique_ptr<BcmTxPacket> pkt,
     const BcmSwitch* bcmSwitch) noexcept {
-  bool usePktIO = pkt->bcmPacket_.usePktIO;
-
-  if (!usePktIO) {
-    bcm_pkt_t* bcmPkt = pkt->bcmPacket_.ptrUnion.pkt;
-    DCHECK(bcmPkt->call_back == nullptr);
-    bcmPkt->call_back = BcmTxPacket::txCallbackSync;
-    std::lock_guard<std::mutex> lk{syncPktMutex()};
-    syncPacketSent() = false;
-  }
-  // Give up the lock when calling sendPacketImpl. Callback
-  // on packet send complete, maybe invoked immediately on
-  // the same thread. Since the callback needs to acquire
-  // the same lock (to mark send as done). We need to give
-  // up the lock here to avoid deadlock. Further since
-  // sendImpl does not update any shared data structures
-  // its optimal to give up the lock anyways.
-  auto rv = sendImpl(std::move(pkt), bcmSwitch);
-  if (!usePktIO) {
-    std::unique_lock<std::mutex> lk{syncPktMutex()};
-    syncPktCV().wait(lk, [] { return syncPacketSent(); });
+  if (pkt->bcmPacket_.usePktIO) {
+    // PKTIO sends are synchronous already
+    return sendImpl(std::move(pkt), bcmSwitch);
   }
 
+  bcm_pkt_t* bcmPkt = pkt->bcmPacket_.ptrUnion.pkt;
+  DCHECK(bcmPkt->call_back == nullptr);
+  bcmPkt->call_back = BcmTxPacket::txCallback;
+  // Every sender waits for its own packet, rather than all of them sharing
+  // one flag. The callback may run before bcm_tx() returns, which the baton
+  // handles as well.
+  folly::Baton<> sendDone;
+  auto rv = sendImpl(std::move(pkt), bcmSwitch, &sendDone);
+  if (BCM_SUCCESS(rv)) {
+    sendDone.wait();
+  }
   return rv;
 }
 
@@ -10,8 +10,8 @@
 #pragma once
 
 #include <chrono>
-#include <condition_variable>
-#include <mutex>
+
+#include <folly/synchronization/Baton.h>
 
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
@@ -29,22 +29,36 @@ extern "C" {
 namespace facebook::fboss {
 
 class BcmTxPacket;
+class BcmTxPacketPool;
 class BcmSwitch;
 
 struct BcmFreeTxBufUserData {
-  BcmFreeTxBufUserData(const BcmPacketT& bcmPacket, const BcmSwitch* bcmSwitch)
-      : bcmPacket(bcmPacket), bcmSwitch(bcmSwitch) {}
+  BcmFreeTxBufUserData(
+      const BcmPacketT& bcmPacket,
+      const BcmSwitch* bcmSwitch,
+      BcmTxPacketPool* pool,
+      uint32_t size)
+      : bcmPacket(bcmPacket), bcmSwitch(bcmSwitch), pool(pool), size(size) {}
   const BcmPacketT bcmPacket;
   const BcmSwitch* bcmSwitch;
+  // Set if the packet was allocated from the pool, which also frees it
+  BcmTxPacketPool* pool;
+  // Size the packet was allocated for
+  uint32_t size;
 };
 
 struct BcmTxCallbackUserData {
   BcmTxCallbackUserData(
       std::unique_ptr<BcmTxPacket> txPacket,
-      const BcmSwitch* bcmSwitch)
-      : txPacket(std::move(txPacket)), bcmSwitch(bcmSwitch) {}
+      const BcmSwitch* bcmSwitch,
+      folly::Baton<>* sendDone)
+      : txPacket(std::move(txPacket)),
+        bcmSwitch(bcmSwitch),
+        sendDone(sendDone) {}
   std::unique_ptr<BcmTxPacket> txPacket;
   const BcmSwitch* bcmSwitch;
+  // Posted once the packet is freed, for synchronous sends
+  folly::Baton<>* sendDone;
 };
 
 class BcmTxPacket : public TxPacket {
@@ -120,19 +134,14 @@ class BcmTxPacket : public TxPacket {
  private:
   inline static int sendImpl(
       std::unique_ptr<BcmTxPacket> pkt,
-      const BcmSwitch* bcmSwitch) noexcept;
-  static void txCallbackAsync(int unit, bcm_pkt_t* pkt, void* cookie);
-  static void txCallbackSync(int unit, bcm_pkt_t* pkt, void* cookie);
+      const BcmSwitch* bcmSwitch,
+      folly::Baton<>* sendDone = nullptr) noexcept;
+  static void txCallback(int unit, bcm_pkt_t* pkt, void* cookie);
 
   // Forbidden copy constructor and assignment operator
   BcmTxPacket(BcmTxPacket const&) = delete;
   BcmTxPacket& operator=(BcmTxPacket const&) = delete;
 
-  // Synchronization around synchrnous packet sending
-  static std::mutex& syncPktMutex();
-  static std::condition_variable& syncPktCV();
-  static bool& syncPacketSent();
-
   BcmPacketT bcmPacket_;
 
   // time point when the packet is queued to HW
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
+
+#include "fboss/agent/hw/bcm/BcmError.h"
+
+#include <algorithm>
+
+extern "C" {
+#include <bcm/tx.h>
+}
+
+namespace {
+constexpr uint32_t kTxPktFlags = BCM_TX_CRC_APPEND | BCM_TX_ETHER;
+} // namespace
+
+namespace facebook::fboss {
+
+BcmTxPacketPool::BcmTxPacketPool(int unit, size_t maxCachedPerClass)
+    : unit_(unit), maxCachedPerClass_(maxCachedPerClass) {
+  for (auto& freeList : freeLists_) {
+    freeList.pkts.reserve(maxCachedPerClass_);
+  }
+}
+
+BcmTxPacketPool::~BcmTxPacketPool() {
+  drain();
+}
+
+uint32_t BcmTxPacketPool::getAllocSize(uint32_t size) {
+  auto it = std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), size);
+  return it == kSizeClasses.end() ? size : *it;
+}
+
+int BcmTxPacketPool::getSizeClass(uint32_t allocSize) {
+  auto it =
+      std::lower_bound(kSizeClasses.begin(), kSizeClasses.end(), allocSize);
+  if (it == kSizeClasses.end() || *it != allocSize) {
+    return -1;
+  }
+  return it - kSizeClasses.begin();
+}
+
+int BcmTxPacketPool::alloc(uint32_t size, bcm_pkt_t** pkt, bool* fromPool) {
+  auto allocSize = getAllocSize(size);
+  auto sizeClass = getSizeClass(allocSize);
+  *pkt = sizeClass < 0 ? nullptr : getCached(sizeClass);
+  *fromPool = *pkt != nullptr;
+  if (*fromPool) {
+    // bcm_tx() and BcmTxPacket modify these, reset them to what
+    // bcm_pkt_alloc() sets up
+    (*pkt)->call_back = nullptr;
+    BCM_PBMP_CLEAR((*pkt)->tx_pbmp);
+    BCM_PBMP_CLEAR((*pkt)->tx_upbmp);
+    (*pkt)->cos = 0;
+    auto rv = bcm_pkt_flags_init(unit_, *pkt, kTxPktFlags);
+    if (BCM_FAILURE(rv)) {
+      bcm_pkt_free(unit_, *pkt);
+      *pkt = nullptr;
+      return rv;
+    }
+  } else {
+    auto rv = bcm_pkt_alloc(unit_, allocSize, kTxPktFlags, pkt);
+    if (BCM_FAILURE(rv)) {
+      return rv;
+    }
+  }
+  outstanding_.fetch_add(1, std::memory_order_relaxed);
+  return BCM_E_NONE;
+}
+
+int BcmTxPacketPool::free(bcm_pkt_t* pkt, uint32_t size, uint8_t* buf) {
+  outstanding_.fetch_sub(1, std::memory_order_relaxed);
+  auto allocSize = getAllocSize(size);
+  auto sizeClass = getSizeClass(allocSize);
+  if (sizeClass >= 0) {
+    pkt->pkt_data->data = buf;
+    pkt->pkt_data->len = allocSize;
+    if (putCached(sizeClass, pkt)) {
+      return BCM_E_NONE;
+    }
+  }
+  return bcm_pkt_free(unit_, pkt);
+}
+
+bcm_pkt_t* BcmTxPacketPool::getCached(int sizeClass) {
+  auto& freeList = freeLists_[sizeClass];
+  std::lock_guard<folly::SpinLock> g(freeList.lock);
+  if (freeList.pkts.empty()) {
+    return nullptr;
+  }
+  auto pkt = freeList.pkts.back();
+  freeList.pkts.pop_back();
+  return pkt;
+}
+
+bool BcmTxPacketPool::putCached(int sizeClass, bcm_pkt_t* pkt) {
+  auto& freeList = freeLists_[sizeClass];
+  std::lock_guard<folly::SpinLock> g(freeList.lock);
+  // Checked under the lock, so that drain() can't miss this packet
+  if (draining_.load() || freeList.pkts.size() >= maxCachedPerClass_) {
+    return false;
+  }
+  freeList.pkts.push_back(pkt);
+  return true;
+}
+
+void BcmTxPacketPool::drain() {
+  draining_.store(true);
+  for (auto& freeList : freeLists_) {
+    std::vector<bcm_pkt_t*> pkts;
+    {
+      std::lock_guard<folly::SpinLock> g(freeList.lock);
+      pkts.swap(freeList.pkts);
+    }
+    for (auto pkt : pkts) {
+      bcmLogError(bcm_pkt_free(unit_, pkt), "Failed to free pooled packet");
+    }
+  }
+}
+
+size_t BcmTxPacketPool::getNumCached() const {
+  size_t cached = 0;
+  for (const auto& freeList : freeLists_) {
+    std::lock_guard<folly::SpinLock> g(freeList.lock);
+    cached += freeList.pkts.size();
+  }
+  return cached;
+}
+
+} // namespace facebook::fboss
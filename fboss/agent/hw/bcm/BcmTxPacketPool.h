@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/SpinLock.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+extern "C" {
+#include <bcm/pkt.h>
+}
+
+namespace facebook::fboss {
+
+/*
+ * Free lists of the DMA packets of bcm_tx(), so that the control plane
+ * packets (ARP/NDP, LLDP, LACP, tun) don't go through bcm_pkt_alloc() and
+ * bcm_pkt_free(), and the SDK DMA allocator lock, for every packet.
+ *
+ * Packets are allocated in size classes, and go back to the free list of
+ * their class when their IOBuf is freed, i.e. on TX completion. Packets are
+ * allocated on many threads but mostly freed on the SDK TX thread, so the
+ * free lists are shared rather than per thread caches, each behind its own
+ * spin lock. Packets larger than the largest class aren't cached.
+ *
+ * Only used with bcm_tx(), PKTIO packets are allocated and freed as before.
+ */
+class BcmTxPacketPool {
+ public:
+  static constexpr std::array<uint32_t, 7> kSizeClasses = {
+      128,
+      256,
+      512,
+      1024,
+      2048,
+      4096,
+      10240};
+
+  BcmTxPacketPool(int unit, size_t maxCachedPerClass);
+  ~BcmTxPacketPool();
+
+  // The buffer size to allocate for a packet of size bytes: the smallest class
+  // which fits it, or size itself if it's larger than all classes
+  static uint32_t getAllocSize(uint32_t size);
+
+  /*
+   * Allocate a packet with a buffer of getAllocSize(size) bytes, as
+   * bcm_pkt_alloc() with BCM_TX_CRC_APPEND | BCM_TX_ETHER would. Cached
+   * packets are reused first, fromPool tells whether one was. Returns the
+   * bcm_pkt_alloc() error, if it was called and failed.
+   */
+  int alloc(uint32_t size, bcm_pkt_t** pkt, bool* fromPool);
+
+  /*
+   * Free a packet allocated by alloc() for size bytes, whose buffer starts at
+   * buf (the packet data may point past it after a send). It is cached for
+   * reuse if its class isn't full, and freed with bcm_pkt_free() otherwise.
+   */
+  int free(bcm_pkt_t* pkt, uint32_t size, uint8_t* buf);
+
+  // Free all cached packets, and stop caching the ones freed later
+  void drain();
+
+  // Packets allocated and not freed yet
+  size_t getOutstanding() const {
+    return outstanding_.load(std::memory_order_relaxed);
+  }
+  size_t getNumCached() const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  BcmTxPacketPool(BcmTxPacketPool const&) = delete;
+  BcmTxPacketPool& operator=(BcmTxPacketPool const&) = delete;
+
+  struct FreeList {
+    mutable folly::SpinLock lock;
+    std::vector<bcm_pkt_t*> pkts;
+  };
+
+  // Index of the class of allocSize, or -1 if it isn't a class size
+  static int getSizeClass(uint32_t allocSize);
+  bcm_pkt_t* getCached(int sizeClass);
+  bool putCached(int sizeClass, bcm_pkt_t* pkt);
+
+  const int unit_;
+  const size_t maxCachedPerClass_;
+  std::atomic<bool> draining_{false};
+  std::atomic<size_t> outstanding_{0};
+  std::array<FreeList, kSizeClasses.size()> freeLists_;
+};
+
+} // namespace facebook::fboss
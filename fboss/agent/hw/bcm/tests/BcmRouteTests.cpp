@@ -24,6 +24,7 @@
 #include "fboss/agent/hw/bcm/tests/BcmTestUtils.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleRouteUpdateWrapper.h"
+#include "fboss/agent/hw/test/HwTestEcmpUtils.h"
 #include "fboss/agent/platforms/tests/utils/BcmTestPlatform.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/Route.h"
@@ -35,13 +36,17 @@
 
 #include <boost/range/combine.hpp>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 
+#include <set>
 #include <string>
 
 extern "C" {
 #include <bcm/l3.h>
 }
 
+DECLARE_bool(bcm_ecmp_in_place_update);
+
 using folly::ByteRange;
 using folly::CIDRNetwork;
 using folly::IPAddress;
@@ -1059,6 +1064,86 @@ TEST_F(BcmRouteTest, UnresolveResolveNextHop) {
   verify();
 }
 
+class BcmRouteEcmpInPlaceTest : public BcmRouteTest {
+ protected:
+  cfg::SwitchConfig initialConfig() const override {
+    return utility::onePortPerVlanConfig(
+        getHwSwitch(), masterLogicalPortIds());
+  }
+};
+
+TEST_F(BcmRouteEcmpInPlaceTest, UpdateEcmpEgressInPlace) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_bcm_ecmp_in_place_update = true;
+  auto network = CIDRNetwork(IPAddress("2401:db00:1::"), 64);
+  auto growingNetwork = CIDRNetwork(IPAddress("2401:db00:2::"), 64);
+  auto sharedNetwork = CIDRNetwork(IPAddress("2401:db00:3::"), 64);
+  applyNewConfig(initialConfig());
+  utility::EcmpSetupAnyNPorts6 ecmpHelper(getProgrammedState(), kRouter0);
+  applyNewState(ecmpHelper.resolveNextHops(getProgrammedState(), 6));
+
+  auto nexthops = [&ecmpHelper](const std::vector<int>& ids) {
+    std::vector<IPAddress> ips;
+    for (auto id : ids) {
+      ips.emplace_back(ecmpHelper.ip(id));
+    }
+    return ips;
+  };
+  auto getEgressId = [this](const CIDRNetwork& network) {
+    return getHwSwitch()
+        ->routeTable()
+        ->getBcmRoute(0, network.first, network.second)
+        ->getEgressId();
+  };
+  // The group in HW has exactly the egresses of the given next hops
+  auto verifyEcmpMembers = [this, &ecmpHelper](
+                               const CIDRNetwork& network,
+                               const std::vector<int>& ids) {
+    std::multiset<uint64_t> expected;
+    for (auto id : ids) {
+      expected.insert(getHwSwitch()
+                          ->getHostTable()
+                          ->getBcmHost(getHostKey(ecmpHelper.ip(id)))
+                          ->getEgressId());
+    }
+    EXPECT_EQ(
+        utility::getEcmpMembersInHw(
+            getHwSwitch(), network, kRouter0, ids.size()),
+        expected);
+  };
+  const auto* table = getHwSwitch()->getMultiPathNextHopTable();
+  auto updatedInPlace = table->getEcmpGroupsUpdatedInPlace();
+  auto recreated = table->getEcmpGroupsRecreated();
+
+  // The only route on the group keeps its egress
+  addRoute(network, nexthops({0, 1, 2}));
+  auto egressId = getEgressId(network);
+  addRoute(network, nexthops({0, 2, 3}));
+  EXPECT_EQ(getEgressId(network), egressId);
+  verifyEcmpMembers(network, {0, 2, 3});
+  EXPECT_EQ(table->getEcmpGroupsUpdatedInPlace(), updatedInPlace + 1);
+  EXPECT_EQ(table->getEcmpGroupsRecreated(), recreated);
+
+  // Growing past the max_paths the group was created with, 4 for 2 paths
+  addRoute(growingNetwork, nexthops({0, 1}));
+  auto growingEgressId = getEgressId(growingNetwork);
+  addRoute(growingNetwork, nexthops({0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(getEgressId(growingNetwork), growingEgressId);
+  verifyEcmpMembers(growingNetwork, {0, 1, 2, 3, 4, 5});
+  EXPECT_EQ(table->getEcmpGroupsUpdatedInPlace(), updatedInPlace + 2);
+  EXPECT_EQ(table->getEcmpGroupsRecreated(), recreated);
+
+  // A group shared by two routes is not changed under the other one
+  addRoute(sharedNetwork, nexthops({0, 2, 3}));
+  addRoute(network, nexthops({0, 1, 2}));
+  EXPECT_NE(getEgressId(network), egressId);
+  EXPECT_EQ(getEgressId(sharedNetwork), egressId);
+  verifyEcmpMembers(network, {0, 1, 2});
+  verifyEcmpMembers(sharedNetwork, {0, 2, 3});
+  EXPECT_EQ(table->getEcmpGroupsUpdatedInPlace(), updatedInPlace + 2);
+  EXPECT_EQ(table->getEcmpGroupsRecreated(), recreated + 1);
+}
+
 TEST_F(BcmTest, VerifyDropEgress) {
   auto setup = [] {
     // Default drop egress should be created during BcmUnit initialization.
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmSflowExporter.h"
+
+#include <folly/Benchmark.h>
+#include <folly/SocketAddress.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/SflowCollector.h"
+
+DECLARE_int32(sflow_export_queue_depth);
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kNumCollectors = 2;
+constexpr auto kSnapLen = 128;
+
+/*
+ * A local UDP socket which a collector sends to. It's never read, the
+ * kernel drops what doesn't fit in its receive buffer, which doesn't change
+ * the cost of sending.
+ */
+class UdpSink {
+ public:
+  UdpSink() {
+    socket_ = ::socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_ == -1) {
+      throw FbossError("Error creating UDP socket: ", folly::errnoStr(errno));
+    }
+    folly::SocketAddress addr("::1", 0);
+    sockaddr_storage addrStorage;
+    addr.getAddress(&addrStorage);
+    if (bind(
+            socket_,
+            reinterpret_cast<sockaddr*>(&addrStorage),
+            addr.getActualSize()) != 0) {
+      throw FbossError("Failed to bind UDP sink: ", folly::errnoStr(errno));
+    }
+    address_.setFromLocalAddress(socket_);
+  }
+  ~UdpSink() {
+    close(socket_);
+  }
+
+  const folly::SocketAddress& getAddress() const {
+    return address_;
+  }
+
+ private:
+  int socket_{-1};
+  folly::SocketAddress address_;
+};
+
+SflowPacketInfo makeSample() {
+  SflowPacketInfo info;
+  *info.ingressSampled_ref() = true;
+  info.srcPort_ref() = 1;
+  info.dstPort_ref() = 2;
+  info.vlan_ref() = 1;
+  *info.packetData_ref() = std::string(kSnapLen, 'x');
+  return info;
+}
+} // namespace
+
+/*
+ * One iteration exports one sample to every collector, the way sendToAll()
+ * used to: serialize and one sendmsg() per collector
+ */
+BENCHMARK(SflowExportPerSample, n) {
+  std::vector<std::unique_ptr<UdpSink>> sinks;
+  std::vector<std::unique_ptr<BcmSflowExporter>> exporters;
+  SflowPacketInfo info;
+  BENCHMARK_SUSPEND {
+    for (int i = 0; i < kNumCollectors; i++) {
+      sinks.push_back(std::make_unique<UdpSink>());
+      exporters.push_back(
+          std::make_unique<BcmSflowExporter>(sinks.back()->getAddress()));
+    }
+    info = makeSample();
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    std::string output;
+    apache::thrift::BinarySerializer::serialize(info, &output);
+    iovec vec;
+    vec.iov_base = output.data();
+    vec.iov_len = output.size();
+    for (auto& exporter : exporters) {
+      exporter->sendUDPDatagram(&vec, 1);
+    }
+  }
+
+  BENCHMARK_SUSPEND {
+    exporters.clear();
+    sinks.clear();
+  }
+}
+
+/*
+ * Same through the export queue, including the time the export thread takes
+ * to send all the samples. The queue is large enough to not drop samples.
+ */
+BENCHMARK_RELATIVE(SflowExportBatched, n) {
+  std::vector<std::unique_ptr<UdpSink>> sinks;
+  std::unique_ptr<BcmSflowExporterTable> table;
+  SflowPacketInfo info;
+  BENCHMARK_SUSPEND {
+    FLAGS_sflow_export_queue_depth = n;
+    table = std::make_unique<BcmSflowExporterTable>();
+    for (int i = 0; i < kNumCollectors; i++) {
+      sinks.push_back(std::make_unique<UdpSink>());
+      const auto& address = sinks.back()->getAddress();
+      table->addExporter(std::make_shared<SflowCollector>(
+          address.getAddressStr(), address.getPort()));
+    }
+    info = makeSample();
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    table->sendToAll(info);
+  }
+  table->flush();
+
+  BENCHMARK_SUSPEND {
+    table.reset();
+    sinks.clear();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
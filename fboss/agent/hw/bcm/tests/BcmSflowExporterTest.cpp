@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmSflowExporter.h"
+
+#include <folly/SocketAddress.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <optional>
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/state/SflowCollector.h"
+
+DECLARE_int32(sflow_export_queue_depth);
+DECLARE_int32(sflow_export_batch_size);
+DECLARE_int32(sflow_export_flush_interval_ms);
+
+using namespace facebook::fboss;
+
+namespace {
+// A local UDP socket standing in for a collector
+class UdpCollector {
+ public:
+  UdpCollector() {
+    socket_ = ::socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_ == -1) {
+      throw FbossError("Error creating UDP socket: ", folly::errnoStr(errno));
+    }
+    folly::SocketAddress addr("::1", 0);
+    sockaddr_storage addrStorage;
+    addr.getAddress(&addrStorage);
+    if (bind(
+            socket_,
+            reinterpret_cast<sockaddr*>(&addrStorage),
+            addr.getActualSize()) != 0) {
+      throw FbossError(
+          "Failed to bind UDP collector: ", folly::errnoStr(errno));
+    }
+    // Don't hang the test if a sample never arrives
+    timeval timeout{5, 0};
+    setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    address_.setFromLocalAddress(socket_);
+  }
+  ~UdpCollector() {
+    close(socket_);
+  }
+
+  std::shared_ptr<SflowCollector> getCollector() const {
+    return std::make_shared<SflowCollector>(
+        address_.getAddressStr(), address_.getPort());
+  }
+
+  // Each datagram holds one serialized sample
+  std::optional<SflowPacketInfo> receive() {
+    std::string buf(4096, '\0');
+    auto len = ::recv(socket_, buf.data(), buf.size(), 0);
+    if (len < 0) {
+      return std::nullopt;
+    }
+    buf.resize(len);
+    return apache::thrift::BinarySerializer::deserialize<SflowPacketInfo>(buf);
+  }
+
+ private:
+  int socket_{-1};
+  folly::SocketAddress address_;
+};
+
+SflowPacketInfo makeSample(int srcPort) {
+  SflowPacketInfo info;
+  *info.ingressSampled_ref() = true;
+  info.srcPort_ref() = srcPort;
+  info.dstPort_ref() = 2;
+  info.vlan_ref() = 1;
+  *info.packetData_ref() = std::string(128, 'x');
+  return info;
+}
+} // namespace
+
+TEST(BcmSflowExporterTest, queuedSamplesReachCollectors) {
+  gflags::FlagSaver flagSaver;
+  // The samples never fill a batch, the flush interval sends them
+  FLAGS_sflow_export_batch_size = 64;
+  FLAGS_sflow_export_flush_interval_ms = 10;
+  UdpCollector collector1;
+  UdpCollector collector2;
+  BcmSflowExporterTable table;
+  table.addExporter(collector1.getCollector());
+  table.addExporter(collector2.getCollector());
+
+  for (int i = 0; i < 5; i++) {
+    table.sendToAll(makeSample(i));
+  }
+  for (auto* collector : {&collector1, &collector2}) {
+    for (int i = 0; i < 5; i++) {
+      auto sample = collector->receive();
+      ASSERT_TRUE(sample.has_value());
+      EXPECT_EQ(*sample, makeSample(i));
+    }
+  }
+  EXPECT_EQ(table.getQueueDepth(), 0);
+  EXPECT_EQ(table.getQueueOverflows(), 0);
+  EXPECT_EQ(table.getSendFailures(), 0);
+}
+
+TEST(BcmSflowExporterTest, queueOverflow) {
+  gflags::FlagSaver flagSaver;
+  // Only flush() sends the samples
+  FLAGS_sflow_export_queue_depth = 2;
+  FLAGS_sflow_export_batch_size = 64;
+  FLAGS_sflow_export_flush_interval_ms = 3600 * 1000;
+  UdpCollector collector;
+  BcmSflowExporterTable table;
+  table.addExporter(collector.getCollector());
+
+  for (int i = 0; i < 3; i++) {
+    table.sendToAll(makeSample(i));
+  }
+  EXPECT_EQ(table.getQueueDepth(), 2);
+  EXPECT_EQ(table.getQueueOverflows(), 1);
+
+  table.flush();
+  EXPECT_EQ(table.getQueueDepth(), 0);
+  for (int i = 0; i < 2; i++) {
+    auto sample = collector.receive();
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_EQ(*sample, makeSample(i));
+  }
+  EXPECT_EQ(table.getSendFailures(), 0);
+}
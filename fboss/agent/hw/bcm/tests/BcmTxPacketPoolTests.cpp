@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
+#include "fboss/agent/hw/HwSwitchStats.h"
+#include "fboss/agent/hw/bcm/BcmSwitch.h"
+#include "fboss/agent/hw/bcm/tests/BcmTest.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwTestPacketUtils.h"
+#include "fboss/agent/platforms/tests/utils/BcmTestPlatform.h"
+#include "fboss/lib/CommonUtils.h"
+
+#include <folly/IPAddressV6.h>
+#include <folly/MacAddress.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(bcm_tx_pkt_pool_size);
+
+namespace {
+constexpr int kPoolSize = 16;
+constexpr int kNumPackets = 10;
+} // namespace
+
+namespace facebook::fboss {
+
+class BcmTxPacketPoolTest : public BcmTest {
+ protected:
+  void SetUp() override {
+    // The pool is created when the switch is initialized
+    FLAGS_bcm_tx_pkt_pool_size = kPoolSize;
+    BcmTest::SetUp();
+  }
+
+  cfg::SwitchConfig initialConfig() const override {
+    return utility::oneL3IntfConfig(getHwSwitch(), masterLogicalPortIds()[0]);
+  }
+
+  void sendPackets(int numPackets) {
+    auto vlanId = VlanID(*initialConfig().vlanPorts_ref()[0].vlanID_ref());
+    auto cpuMac = getPlatform()->getLocalMac();
+    for (int i = 0; i < numPackets; i++) {
+      auto txPacket = utility::makeIpTxPacket(
+          getHwSwitch(),
+          vlanId,
+          folly::MacAddress("fa:ce:b0:00:00:0c"),
+          cpuMac,
+          folly::IPAddressV6("2620:0:1cfe:face:b00c::3"),
+          folly::IPAddressV6("2620:0:1cfe:face:b00c::4"));
+      EXPECT_TRUE(getHwSwitch()->sendPacketSwitchedSync(std::move(txPacket)));
+    }
+  }
+
+  // Every packet is freed back to the pool once the SDK is done with it
+  void waitForNoOutstandingPackets(const BcmTxPacketPool* pool) {
+    checkWithRetry(
+        [pool] { return pool->getOutstanding() == 0; },
+        10,
+        std::chrono::milliseconds(100));
+  }
+
+ private:
+  gflags::FlagSaver flagSaver_;
+};
+
+TEST_F(BcmTxPacketPoolTest, sendReusesPooledPackets) {
+  auto setup = [this]() { applyNewConfig(initialConfig()); };
+  auto verify = [this]() {
+    const auto* pool = getHwSwitch()->getTxPacketPool();
+    if (!pool) {
+      // PKTIO packets aren't pooled
+      return;
+    }
+    // The TX stats are thread local, the packets are allocated on this one
+    auto stats = getHwSwitch()->getSwitchStats();
+
+    // Fill the pool, the first packets may miss
+    sendPackets(kNumPackets);
+    waitForNoOutstandingPackets(pool);
+    EXPECT_GT(pool->getNumCached(), 0);
+
+    auto poolHitsBefore = stats->getTxPktPoolHitCount();
+    sendPackets(kNumPackets);
+    EXPECT_GT(stats->getTxPktPoolHitCount(), poolHitsBefore);
+    waitForNoOutstandingPackets(pool);
+    EXPECT_LE(
+        pool->getNumCached(), kPoolSize * BcmTxPacketPool::kSizeClasses.size());
+  };
+  verifyAcrossWarmBoots(setup, verify);
+}
+
+} // namespace facebook::fboss
@@ -20,15 +20,34 @@
 #include "fboss/agent/test/RouteScaleGenerators.h"
 #include "fboss/lib/FunctionCallTimeReporter.h"
 
+#include <fb303/ServiceData.h>
 #include <folly/Benchmark.h>
+#include <folly/Format.h>
 #include <folly/IPAddress.h>
 
+#include <map>
 #include <thread>
 
 namespace facebook::fboss {
 
 using utility::getEcmpSizeInHw;
 
+namespace {
+// ECMP group writes done for next hop set changes, exported by the BCM
+// multipath next hop table
+const std::vector<std::string> kEcmpGroupCounters = {
+    "bcm.ecmp_groups_updated_in_place",
+    "bcm.ecmp_groups_recreated"};
+
+std::map<std::string, int64_t> getEcmpGroupCounters() {
+  std::map<std::string, int64_t> counters;
+  for (const auto& name : kEcmpGroupCounters) {
+    counters[name] = fb303::fbData->getCounterIfExists(name).value_or(0);
+  }
+  return counters;
+}
+} // namespace
+
 BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   folly::BenchmarkSuspender suspender;
   constexpr int kEcmpWidth = 4;
@@ -105,4 +124,87 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   t.join();
 }
 
+/*
+ * Same as above, but the competing updates change the next hops of WCMP
+ * routes which each have their own ECMP group, as when a BGP peer goes
+ * away. Reports how many ECMP groups got updated in place (see
+ * --bcm_ecmp_in_place_update) and how many had to be recreated.
+ */
+BENCHMARK_COUNTERS(HwEcmpGroupShrinkWithCompetingNextHopUpdates, counters) {
+  folly::BenchmarkSuspender suspender;
+  constexpr int kEcmpWidth = 4;
+  constexpr int kNumRoutes = 256;
+  auto ensemble = createHwEnsemble(
+      {HwSwitchEnsemble::LINKSCAN, HwSwitchEnsemble::PACKET_RX});
+  auto hwSwitch = ensemble->getHwSwitch();
+
+  auto config =
+      utility::onePortPerVlanConfig(hwSwitch, ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  auto ecmpHelper =
+      utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
+  ensemble->applyNewState(
+      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth));
+  ecmpHelper.programRoutes(
+      std::make_unique<HwSwitchEnsembleRouteUpdateWrapper>(
+          ensemble->getRouteUpdater()),
+      kEcmpWidth);
+
+  // Route i uses next hop j with weight 1 + the jth base 4 digit of i, so
+  // that every route has a distinct next hop set
+  auto programWcmpRoutes = [&ensemble, &ecmpHelper](int skipNextHop) {
+    auto updater = ensemble->getRouteUpdater();
+    for (int i = 0; i < kNumRoutes; i++) {
+      RouteNextHopSet nexthops;
+      for (int j = 0; j < kEcmpWidth; j++) {
+        if (j != skipNextHop) {
+          nexthops.emplace(
+              UnresolvedNextHop(ecmpHelper.ip(j), 1 + (i >> (2 * j)) % 4));
+        }
+      }
+      updater.addRoute(
+          RouterID(0),
+          folly::IPAddressV6(folly::sformat("2401:db00:{:x}::", i + 1)),
+          64,
+          ClientID::BGPD,
+          RouteNextHopEntry(
+              std::move(nexthops), AdminDistance::MAX_ADMIN_DISTANCE));
+    }
+    updater.program();
+  };
+  programWcmpRoutes(kEcmpWidth);
+
+  auto prefix = folly::CIDRNetwork(folly::IPAddress("::"), 0);
+  CHECK_EQ(
+      kEcmpWidth,
+      getEcmpSizeInHw(hwSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth));
+  // Warm up the stats cache
+  ensemble->getLatestPortStats(ensemble->masterLogicalPortIds());
+  auto countersBefore = getEcmpGroupCounters();
+
+  // The routes stop using the last next hop
+  std::thread t([&programWcmpRoutes]() { programWcmpRoutes(kEcmpWidth - 1); });
+
+  utility::setPortLoopbackMode(
+      hwSwitch,
+      ecmpHelper.ecmpPortDescriptorAt(0).phyPortID(),
+      cfg::PortLoopbackMode::NONE);
+  {
+    ScopedCallTimer timeIt;
+    suspender.dismiss();
+    while (getEcmpSizeInHw(
+               hwSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth) !=
+           kEcmpWidth - 1) {
+      usleep(1);
+    }
+    suspender.rehire();
+  }
+  t.join();
+
+  auto countersAfter = getEcmpGroupCounters();
+  for (const auto& name : kEcmpGroupCounters) {
+    counters[name] = countersAfter[name] - countersBefore[name];
+  }
+}
+
 } // namespace facebook::fboss
@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/benchmarks/HwRouteScaleBenchmarkHelpers.h"
+
+#include "fboss/agent/test/RouteScaleGenerators.h"
+
+DECLARE_bool(enable_parallel_route_programming);
+
+namespace facebook::fboss {
+
+/*
+ * Same as HwFswScaleRouteAddBenchmark, but with per VRF/address family
+ * route deltas programmed concurrently.
+ */
+BENCHMARK(HwFswScaleRouteAddParallelBenchmark) {
+  FLAGS_enable_parallel_route_programming = true;
+  routeAddDelBenchmarker<utility::FSWRouteScaleGenerator>(true);
+}
+} // namespace facebook::fboss
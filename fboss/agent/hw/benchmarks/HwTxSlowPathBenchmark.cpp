@@ -58,10 +58,21 @@ void runTxSlowPathBenchmark() {
       kEcmpWidth);
   auto cpuMac = ensemble->getPlatform()->getLocalMac();
   std::atomic<bool> packetTxDone{false};
-  std::thread t([cpuMac, hwSwitch, &config, &packetTxDone]() {
+  // The TX stats are thread local, so the sending thread reports them
+  int64_t pktsAllocated{0};
+  int64_t poolHits{0};
+  std::thread t([cpuMac,
+                 hwSwitch,
+                 &config,
+                 &packetTxDone,
+                 &pktsAllocated,
+                 &poolHits]() {
     const auto kSrcIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::3");
     const auto kDstIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::4");
     const auto kSrcMac = folly::MacAddress{"fa:ce:b0:00:00:0c"};
+    auto stats = hwSwitch->getSwitchStats();
+    auto allocsBefore = stats->getTxPktAllocCount();
+    auto poolHitsBefore = stats->getTxPktPoolHitCount();
     while (!packetTxDone) {
       for (auto i = 0; i < 1'000; ++i) {
         // Send packet
@@ -75,6 +86,8 @@ void runTxSlowPathBenchmark() {
         hwSwitch->sendPacketSwitchedAsync(std::move(txPacket));
       }
     }
+    pktsAllocated = stats->getTxPktAllocCount() - allocsBefore;
+    poolHits = stats->getTxPktPoolHitCount() - poolHitsBefore;
   });
 
   auto [pktsBefore, bytesBefore] =
@@ -100,11 +113,15 @@ void runTxSlowPathBenchmark() {
     folly::dynamic cpuTxRateJson = folly::dynamic::object;
     cpuTxRateJson["cpu_tx_pps"] = pps;
     cpuTxRateJson["cpu_tx_bytes_per_sec"] = bytesPerSec;
+    cpuTxRateJson["cpu_tx_pkts_allocated"] = pktsAllocated;
+    cpuTxRateJson["cpu_tx_pkt_pool_hits"] = poolHits;
     std::cout << toPrettyJson(cpuTxRateJson) << std::endl;
   } else {
     XLOG(INFO) << " Pkts before: " << pktsBefore << " Pkts after: " << pktsAfter
                << " interval ms: " << durationMillseconds.count()
-               << " pps: " << pps << " bytes per sec: " << bytesPerSec;
+               << " pps: " << pps << " bytes per sec: " << bytesPerSec
+               << " pkts allocated: " << pktsAllocated
+               << " pool hits: " << poolHits;
   }
 }
 } // namespace facebook::fboss
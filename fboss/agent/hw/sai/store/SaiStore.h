@@ -27,6 +27,7 @@
 #include <folly/dynamic.h>
 
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <type_traits>
@@ -244,6 +245,42 @@ class SaiObjectStore {
     return object;
   }
 
+  /*
+   * setObject for callers that program disjoint keys of this store from
+   * several threads against a thread safe adapter. mapMutex only guards the
+   * store maps; the adapter create or set call runs without it. The caller
+   * must hold mapMutex whenever it drops what may be the last reference to
+   * the returned object, since that erases it from the store.
+   */
+  std::shared_ptr<ObjectType> setObjectConcurrently(
+      const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
+      const typename SaiObjectTraits::CreateAttributes& attributes,
+      std::mutex& mapMutex) {
+    static_assert(
+        !IsObjectPublisher<SaiObjectTraits>::value,
+        "method not available for publisher objects");
+    std::shared_ptr<ObjectType> object;
+    {
+      std::lock_guard<std::mutex> lock(mapMutex);
+      object = objects_.ref(adapterHostKey);
+    }
+    std::optional<ObjectType> created;
+    if (object) {
+      object->setAttributes(attributes);
+    } else {
+      created.emplace(adapterHostKey, attributes, switchId_.value());
+    }
+    std::lock_guard<std::mutex> lock(mapMutex);
+    if (created) {
+      auto ins = objects_.refOrInsert(
+          adapterHostKey, std::move(created.value()), true /*force*/);
+      object = ins.first;
+    }
+    warmBootHandles_.erase(adapterHostKey);
+    XLOGF(DBG5, "SaiStore set object {}", *object);
+    return object;
+  }
+
   std::shared_ptr<ObjectType> get(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey) {
     XLOGF(DBG5, "SaiStore get object {}", adapterHostKey);
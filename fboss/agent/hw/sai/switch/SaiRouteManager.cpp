@@ -129,16 +129,15 @@ bool SaiRouteManager::validRoute(const std::shared_ptr<Route<AddrT>>& swRoute) {
 }
 
 template <typename AddrT>
-void SaiRouteManager::addOrUpdateRoute(
+SaiRouteTraits::CreateAttributes SaiRouteManager::routeAttributes(
     SaiRouteHandle* routeHandle,
-    RouterID routerId,
+    const SaiRouteTraits::RouteEntry& entry,
     const std::shared_ptr<Route<AddrT>>& oldRoute,
-    const std::shared_ptr<Route<AddrT>>& newRoute) {
-  SaiRouteTraits::RouteEntry entry = routeEntryFromSwRoute(routerId, newRoute);
+    const std::shared_ptr<Route<AddrT>>& newRoute,
+    SaiRouteHandle::NextHopHandle& nextHopHandle) {
   auto fwd = newRoute->getForwardInfo();
   sai_int32_t packetAction;
   std::optional<SaiRouteTraits::CreateAttributes> attributes;
-  SaiRouteHandle::NextHopHandle nextHopHandle;
   std::optional<SaiRouteTraits::Attributes::Metadata> metadata;
   if (newRoute->getClassID()) {
     metadata = static_cast<sai_uint32_t>(newRoute->getClassID().value());
@@ -241,12 +240,72 @@ void SaiRouteManager::addOrUpdateRoute(
 
     XLOG(DBG3) << "Route action DROP: " << newRoute->str();
   }
+  return attributes.value();
+}
+
+template <typename AddrT>
+void SaiRouteManager::addOrUpdateRoute(
+    SaiRouteHandle* routeHandle,
+    RouterID routerId,
+    const std::shared_ptr<Route<AddrT>>& oldRoute,
+    const std::shared_ptr<Route<AddrT>>& newRoute) {
+  SaiRouteTraits::RouteEntry entry = routeEntryFromSwRoute(routerId, newRoute);
+  SaiRouteHandle::NextHopHandle nextHopHandle;
+  auto attributes =
+      routeAttributes(routeHandle, entry, oldRoute, newRoute, nextHopHandle);
   auto& store = saiStore_->get<SaiRouteTraits>();
-  auto route = store.setObject(entry, attributes.value());
+  auto route = store.setObject(entry, attributes);
   routeHandle->route = route;
   routeHandle->nexthopHandle_ = nextHopHandle;
 }
 
+template <typename AddrT>
+void SaiRouteManager::addOrUpdateRouteConcurrently(
+    SaiRouteHandle* routeHandle,
+    RouterID routerId,
+    const std::shared_ptr<Route<AddrT>>& oldRoute,
+    const std::shared_ptr<Route<AddrT>>& newRoute,
+    std::mutex& switchMutex) {
+  std::optional<SaiRouteTraits::RouteEntry> entry;
+  std::optional<SaiRouteTraits::CreateAttributes> attributes;
+  SaiRouteHandle::NextHopHandle nextHopHandle;
+  {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    /*
+     * A route over a single next hop subscribes to that next hop, and the
+     * subscriber updates the route object from neighbor and link events on
+     * other threads under switchMutex. Program such routes, and routes
+     * moving away from one, entirely under the lock.
+     */
+    auto fwd = newRoute->getForwardInfo();
+    if (!std::holds_alternative<std::shared_ptr<SaiNextHopGroupHandle>>(
+            routeHandle->nexthopHandle_) ||
+        (fwd.getAction() == RouteForwardAction::NEXTHOPS &&
+         !newRoute->isConnected() && fwd.getNextHopSet().size() == 1)) {
+      addOrUpdateRoute(routeHandle, routerId, oldRoute, newRoute);
+      return;
+    }
+    entry = routeEntryFromSwRoute(routerId, newRoute);
+    // Declared after lock, so a throw drops any reference under the lock
+    SaiRouteHandle::NextHopHandle newNextHopHandle;
+    attributes = routeAttributes(
+        routeHandle, entry.value(), oldRoute, newRoute, newNextHopHandle);
+    nextHopHandle = std::move(newNextHopHandle);
+  }
+  std::shared_ptr<SaiRoute> route;
+  try {
+    route = saiStore_->get<SaiRouteTraits>().setObjectConcurrently(
+        entry.value(), attributes.value(), switchMutex);
+  } catch (const std::exception&) {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    nextHopHandle = SaiRouteHandle::NextHopHandle{};
+    throw;
+  }
+  std::lock_guard<std::mutex> lock(switchMutex);
+  routeHandle->route = std::move(route);
+  routeHandle->nexthopHandle_ = std::move(nextHopHandle);
+}
+
 template <typename AddrT>
 void SaiRouteManager::changeRoute(
     const std::shared_ptr<Route<AddrT>>& oldSwRoute,
@@ -304,6 +363,80 @@ void SaiRouteManager::removeRoute(
   }
 }
 
+template <typename AddrT>
+void SaiRouteManager::changeRouteConcurrently(
+    const std::shared_ptr<Route<AddrT>>& oldSwRoute,
+    const std::shared_ptr<Route<AddrT>>& newSwRoute,
+    RouterID routerId,
+    std::mutex& switchMutex) {
+  if (!validRoute(newSwRoute)) {
+    XLOG(DBG3) << "Not a valid route, don't change:: old: " << oldSwRoute->str()
+               << " new: " << newSwRoute->str();
+    return;
+  }
+  SaiRouteHandle* routeHandle{nullptr};
+  {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    auto itr = handles_.find(routeEntryFromSwRoute(routerId, newSwRoute));
+    if (itr == handles_.end()) {
+      throw FbossError(
+          "Failure to update route. Route does not exist ",
+          newSwRoute->prefix().str());
+    }
+    // Handles are heap allocated, so this stays valid while other
+    // partitions insert into or erase from handles_
+    routeHandle = itr->second.get();
+  }
+  addOrUpdateRouteConcurrently(
+      routeHandle, routerId, oldSwRoute, newSwRoute, switchMutex);
+}
+
+template <typename AddrT>
+void SaiRouteManager::addRouteConcurrently(
+    const std::shared_ptr<Route<AddrT>>& swRoute,
+    RouterID routerId,
+    std::mutex& switchMutex) {
+  auto entry = [&] {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    auto routeEntry = routeEntryFromSwRoute(routerId, swRoute);
+    if (handles_.find(routeEntry) != handles_.end()) {
+      throw FbossError(
+          "Failure to add route. A route already exists to ",
+          swRoute->prefix().str());
+    }
+    return routeEntry;
+  }();
+  if (!validRoute(swRoute)) {
+    XLOG(DBG3) << "Not a valid route, don't add: " << swRoute->str();
+    return;
+  }
+  auto routeHandle = std::make_unique<SaiRouteHandle>();
+  try {
+    addOrUpdateRouteConcurrently(
+        routeHandle.get(),
+        routerId,
+        std::shared_ptr<Route<AddrT>>{},
+        swRoute,
+        switchMutex);
+  } catch (const std::exception&) {
+    std::lock_guard<std::mutex> lock(switchMutex);
+    routeHandle.reset();
+    throw;
+  }
+  std::lock_guard<std::mutex> lock(switchMutex);
+  handles_.emplace(entry, std::move(routeHandle));
+}
+
+template <typename AddrT>
+void SaiRouteManager::removeRouteConcurrently(
+    const std::shared_ptr<Route<AddrT>>& swRoute,
+    RouterID routerId,
+    std::mutex& switchMutex) {
+  // Dropping the last reference erases the route from the store
+  std::lock_guard<std::mutex> lock(switchMutex);
+  removeRoute(swRoute, routerId);
+}
+
 SaiRouteHandle* SaiRouteManager::getRouteHandle(
     const SaiRouteTraits::RouteEntry& entry) {
   return getRouteHandleImpl(entry);
@@ -500,4 +633,33 @@ template void SaiRouteManager::removeRoute<folly::IPAddressV4>(
     const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry,
     RouterID routerId);
 
+template void SaiRouteManager::changeRouteConcurrently<folly::IPAddressV6>(
+    const std::shared_ptr<Route<folly::IPAddressV6>>& oldSwEntry,
+    const std::shared_ptr<Route<folly::IPAddressV6>>& newSwEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+template void SaiRouteManager::changeRouteConcurrently<folly::IPAddressV4>(
+    const std::shared_ptr<Route<folly::IPAddressV4>>& oldSwEntry,
+    const std::shared_ptr<Route<folly::IPAddressV4>>& newSwEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+
+template void SaiRouteManager::addRouteConcurrently<folly::IPAddressV6>(
+    const std::shared_ptr<Route<folly::IPAddressV6>>& swEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+template void SaiRouteManager::addRouteConcurrently<folly::IPAddressV4>(
+    const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+
+template void SaiRouteManager::removeRouteConcurrently<folly::IPAddressV6>(
+    const std::shared_ptr<Route<folly::IPAddressV6>>& swEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+template void SaiRouteManager::removeRouteConcurrently<folly::IPAddressV4>(
+    const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry,
+    RouterID routerId,
+    std::mutex& switchMutex);
+
 } // namespace facebook::fboss
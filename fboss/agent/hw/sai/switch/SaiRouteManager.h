@@ -108,6 +108,33 @@ class SaiRouteManager {
       const std::shared_ptr<Route<AddrT>>& swRoute,
       RouterID routerId);
 
+  /*
+   * Variants of the above for route partitions (one per VRF and address
+   * family) programmed concurrently against a thread safe adapter. They
+   * take switchMutex only around state shared with other partitions and
+   * the rest of SaiSwitch: route handles, next hop and next hop group
+   * references and the route store maps. Route creates and attribute sets
+   * run outside it, except for routes over a single next hop and removals.
+   */
+  template <typename AddrT>
+  void changeRouteConcurrently(
+      const std::shared_ptr<Route<AddrT>>& oldSwRoute,
+      const std::shared_ptr<Route<AddrT>>& newSwRoute,
+      RouterID routerId,
+      std::mutex& switchMutex);
+
+  template <typename AddrT>
+  void addRouteConcurrently(
+      const std::shared_ptr<Route<AddrT>>& swRoute,
+      RouterID routerId,
+      std::mutex& switchMutex);
+
+  template <typename AddrT>
+  void removeRouteConcurrently(
+      const std::shared_ptr<Route<AddrT>>& swRoute,
+      RouterID routerId,
+      std::mutex& switchMutex);
+
   SaiRouteHandle* getRouteHandle(const SaiRouteTraits::RouteEntry& entry);
   const SaiRouteHandle* getRouteHandle(
       const SaiRouteTraits::RouteEntry& entry) const;
@@ -121,11 +148,25 @@ class SaiRouteManager {
   SaiRouteHandle* getRouteHandleImpl(
       const SaiRouteTraits::RouteEntry& entry) const;
   template <typename AddrT>
+  SaiRouteTraits::CreateAttributes routeAttributes(
+      SaiRouteHandle* routeHandle,
+      const SaiRouteTraits::RouteEntry& entry,
+      const std::shared_ptr<Route<AddrT>>& oldRoute,
+      const std::shared_ptr<Route<AddrT>>& newRoute,
+      SaiRouteHandle::NextHopHandle& nextHopHandle);
+  template <typename AddrT>
   void addOrUpdateRoute(
       SaiRouteHandle* routeHandle,
       RouterID routerId,
       const std::shared_ptr<Route<AddrT>>& oldRoute,
       const std::shared_ptr<Route<AddrT>>& newRoute);
+  template <typename AddrT>
+  void addOrUpdateRouteConcurrently(
+      SaiRouteHandle* routeHandle,
+      RouterID routerId,
+      const std::shared_ptr<Route<AddrT>>& oldRoute,
+      const std::shared_ptr<Route<AddrT>>& newRoute,
+      std::mutex& switchMutex);
 
   template <typename AddrT>
   bool validRoute(const std::shared_ptr<Route<AddrT>>& swRoute);
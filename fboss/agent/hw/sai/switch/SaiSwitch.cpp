@@ -24,6 +24,7 @@
 #include "fboss/agent/hw/sai/api/HostifApi.h"
 #include "fboss/agent/hw/sai/api/HwWriteBehavior.h"
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
@@ -58,13 +59,17 @@
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 #include "folly/MacAddress.h"
 
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
+#include <atomic>
 #include <chrono>
 #include <optional>
 
@@ -98,6 +103,18 @@ DEFINE_bool(
     false,
     "force recreate acl tables during warmboot.");
 
+DEFINE_bool(
+    enable_parallel_route_programming,
+    false,
+    "Program route deltas of different VRFs and address families "
+    "concurrently on a worker pool. Only takes effect when the SAI adapter "
+    "is thread safe.");
+
+DEFINE_int32(
+    route_programming_threads,
+    4,
+    "Number of threads used for parallel route programming.");
+
 namespace {
 /*
  * For the devices/SDK we use, the only events we should get (and process)
@@ -206,10 +223,82 @@ SaiSwitch::SaiSwitch(SaiPlatform* platform, uint32_t featuresDesired)
       saiStore_(std::make_unique<SaiStore>()) {
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+  if (FLAGS_enable_parallel_route_programming) {
+    routeProgrammingExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_route_programming_threads,
+        std::make_shared<folly::NamedThreadFactory>("SaiRouteProgramming"));
+  }
 }
 
 SaiSwitch::~SaiSwitch() {}
 
+void SaiSwitch::programRoutePartitionsInParallel(
+    std::vector<folly::Function<void(const std::atomic<bool>&)>> partitions) {
+  // Set by the first failed partition. Partitions that have not started yet
+  // skip their delta, and running ones stop before their next route.
+  auto failed = std::make_shared<std::atomic<bool>>(false);
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(partitions.size());
+  for (auto& partition : partitions) {
+    futures.push_back(
+        folly::via(
+            routeProgrammingExecutor_.get(),
+            [failed, partition = std::move(partition)]() mutable {
+              if (failed->load()) {
+                return;
+              }
+              try {
+                partition(*failed);
+              } catch (const std::exception&) {
+                failed->store(true);
+                throw;
+              }
+            })
+            .semi());
+  }
+  // Wait for every partition so that no worker is still touching managers
+  // when the caller starts a rollback, then surface the first error in delta
+  // order.
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.throwIfFailed();
+  }
+}
+
+template <typename Delta>
+void SaiSwitch::processRoutesDeltaConcurrently(
+    RouterID routerID,
+    const Delta& routesDelta,
+    const std::atomic<bool>& failed) {
+  auto& routeManager = managerTable_->routeManager();
+  DeltaFunctions::forEachChanged(
+      routesDelta,
+      [&](const std::shared_ptr<typename Delta::Node>& oldRoute,
+          const std::shared_ptr<typename Delta::Node>& newRoute) {
+        if (failed.load()) {
+          return LoopAction::BREAK;
+        }
+        routeManager.changeRouteConcurrently(
+            oldRoute, newRoute, routerID, saiSwitchMutex_);
+        return LoopAction::CONTINUE;
+      },
+      [&](const std::shared_ptr<typename Delta::Node>& newRoute) {
+        if (failed.load()) {
+          return LoopAction::BREAK;
+        }
+        routeManager.addRouteConcurrently(newRoute, routerID, saiSwitchMutex_);
+        return LoopAction::CONTINUE;
+      },
+      [&](const std::shared_ptr<typename Delta::Node>& oldRoute) {
+        if (failed.load()) {
+          return LoopAction::BREAK;
+        }
+        routeManager.removeRouteConcurrently(
+            oldRoute, routerID, saiSwitchMutex_);
+        return LoopAction::CONTINUE;
+      });
+}
+
 HwInitResult SaiSwitch::init(
     Callback* callback,
     bool failHwCallsOnWarmboot) noexcept {
@@ -571,22 +660,26 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       &SaiRouterInterfaceManager::removeRouterInterface);
 
   for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<ArpEntry>,
-        &SaiNeighborManager::addNeighbor<ArpEntry>,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<NdpEntry>,
-        &SaiNeighborManager::addNeighbor<NdpEntry>,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
+    {
+      TIME_PHASE("sai_neighbor_manager");
+      processDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<ArpEntry>,
+          &SaiNeighborManager::addNeighbor<ArpEntry>,
+          &SaiNeighborManager::removeNeighbor<ArpEntry>);
+
+      processDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<NdpEntry>,
+          &SaiNeighborManager::addNeighbor<NdpEntry>,
+          &SaiNeighborManager::removeNeighbor<NdpEntry>);
+    }
 
+    TIME_PHASE("sai_fdb_manager");
     processDelta(
         vlanDelta.getMacDelta(),
         managerTable_->fdbManager(),
@@ -620,13 +713,51 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
         rid);
   };
 
-  for (const auto& routeDelta : delta.getFibsDelta()) {
-    auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
-                                        : routeDelta.getNew()->getID();
-    processV4RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV4>());
-    processV6RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV6>());
+  {
+    TIME_PHASE("sai_route_manager");
+    // Routes in different VRFs and address families never share
+    // SaiRouteEntry keys, so each (VRF, AF) delta can be programmed
+    // independently once the next hops and next hop groups they point to have
+    // been created above. Rollback replays state under a coarse grained lock
+    // held by this thread, so only fine grained (regular) state updates may
+    // fan out, and only when the adapter serves concurrent calls.
+    bool programRoutesInParallel = false;
+    if constexpr (std::is_same_v<LockPolicyT, FineGrainedLockPolicy>) {
+      programRoutesInParallel = routeProgrammingExecutor_ &&
+          SaiApiLock::getInstance()->isAdaptorThreadSafe();
+    }
+    if (programRoutesInParallel) {
+      std::vector<folly::Function<void(const std::atomic<bool>&)>>
+          routePartitions;
+      for (const auto& routeDelta : delta.getFibsDelta()) {
+        auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
+                                            : routeDelta.getNew()->getID();
+        routePartitions.emplace_back(
+            [this, routerID, routeDelta](const std::atomic<bool>& failed) {
+              processRoutesDeltaConcurrently(
+                  routerID,
+                  routeDelta.getFibDelta<folly::IPAddressV4>(),
+                  failed);
+            });
+        routePartitions.emplace_back(
+            [this, routerID, routeDelta](const std::atomic<bool>& failed) {
+              processRoutesDeltaConcurrently(
+                  routerID,
+                  routeDelta.getFibDelta<folly::IPAddressV6>(),
+                  failed);
+            });
+      }
+      programRoutePartitionsInParallel(std::move(routePartitions));
+    } else {
+      for (const auto& routeDelta : delta.getFibsDelta()) {
+        auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
+                                            : routeDelta.getNew()->getID();
+        processV4RoutesDelta(
+            routerID, routeDelta.getFibDelta<folly::IPAddressV4>());
+        processV6RoutesDelta(
+            routerID, routeDelta.getFibDelta<folly::IPAddressV6>());
+      }
+    }
   }
   {
     auto controlPlaneDelta = delta.getControlPlaneDelta();
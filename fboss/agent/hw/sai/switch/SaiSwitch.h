@@ -19,12 +19,15 @@
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
 #include "folly/MacAddress.h"
 
+#include <folly/Function.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/io/async/EventBase.h>
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 DECLARE_int32(update_watermark_stats_interval_s);
 DECLARE_bool(force_recreate_acl_tables);
@@ -194,6 +197,19 @@ class SaiSwitch : public HwSwitch {
   std::shared_ptr<SwitchState> stateChangedImpl(
       const StateDelta& delta,
       const LockPolicyT& lk);
+  /*
+   * Run independent route delta partitions on routeProgrammingExecutor_ and
+   * wait for all of them. Each partition gets a flag that is set once any
+   * partition fails, so the rest stop early. Rethrows the error of the first
+   * failed partition.
+   */
+  void programRoutePartitionsInParallel(
+      std::vector<folly::Function<void(const std::atomic<bool>&)>> partitions);
+  template <typename Delta>
+  void processRoutesDeltaConcurrently(
+      RouterID routerID,
+      const Delta& routesDelta,
+      const std::atomic<bool>& failed);
   friend class SaiRollbackTest;
   void rollback(const std::shared_ptr<SwitchState>& knownGoodState) noexcept;
   std::string listObjectsLocked(
@@ -446,6 +462,9 @@ class SaiSwitch : public HwSwitch {
   std::unique_ptr<std::thread> fdbEventBottomHalfThread_;
   folly::EventBase fdbEventBottomHalfEventBase_;
 
+  // Only created with --enable_parallel_route_programming
+  std::unique_ptr<folly::CPUThreadPoolExecutor> routeProgrammingExecutor_;
+
   HwResourceStats hwResourceStats_;
   std::atomic<SwitchRunState> runState_{SwitchRunState::UNINITIALIZED};
 
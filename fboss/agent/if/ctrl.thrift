@@ -600,6 +600,46 @@ struct ConfigAppliedInfo {
   2: optional i64 lastColdbootAppliedInMs;
 }
 
+struct StateUpdateInfo {
+  1: string name;
+  2: string category;
+  // Time(ms since epoch) the update was applied
+  3: i64 appliedTimeMs;
+  // Time from the update being queued to it being applied
+  4: i64 latencyUs;
+}
+
+struct UpdatePhaseInfo {
+  1: string phase;
+  2: i64 durationUs;
+  3: i32 calls;
+}
+
+/*
+ * A thread which missed its heartbeat, captured by the heartbeat watchdog
+ * when --thread_stall_history is set
+ */
+struct ThreadStallInfo {
+  1: string threadName;
+  // Time(ms since epoch) of the capture
+  2: i64 timeMs;
+  // Time since the last heartbeat the thread processed
+  3: i64 sinceHeartbeatMs;
+  // What the thread was working on, e.g. the name of the state update
+  4: string context;
+  // Symbolized frames, innermost first. Empty if the thread didn't respond.
+  5: list<string> stack;
+}
+
+struct UpdateBreakdownInfo {
+  1: string name;
+  // Time(ms since epoch) the update started being applied
+  2: i64 startTimeMs;
+  3: i64 durationUs;
+  // Phases timed on the updating thread, in the order they first ran
+  4: list<UpdatePhaseInfo> phases;
+}
+
 service FbossCtrl extends phy.FbossCommonPhyCtrl {
   /*
    * Retrieve up-to-date counters from the hardware, and publish all
@@ -1018,6 +1058,27 @@ service FbossCtrl extends phy.FbossCommonPhyCtrl {
     1: fboss.FbossBaseError error,
   );
 
+  /*
+   * Get the most recently applied state updates, oldest first.
+   */
+  list<StateUpdateInfo> getRecentStateUpdates() throws (
+    1: fboss.FbossBaseError error,
+  );
+
+  /*
+   * Time spent in each phase of the most recent state updates
+   */
+  list<UpdateBreakdownInfo> getRecentUpdateBreakdowns(1: i32 count) throws (
+    1: fboss.FbossBaseError error,
+  );
+
+  /*
+   * Stack traces of the agent threads which recently missed their heartbeat
+   */
+  list<ThreadStallInfo> getRecentThreadStalls() throws (
+    1: fboss.FbossBaseError error,
+  );
+
   /*
    * Serialize switch state at path pointed by JSON pointer
    */
@@ -27,8 +27,16 @@ using folly::io::Cursor;
 
 IPv4Hdr::IPv4Hdr(Cursor& cursor) {
   try {
-    uint8_t buf[12];
-    cursor.pull(buf, sizeof(buf));
+    // Parse straight out of the packet buffer when the fixed header is
+    // contiguous, which it almost always is
+    uint8_t copy[20];
+    const uint8_t* buf = copy;
+    if (cursor.length() >= sizeof(copy)) {
+      buf = cursor.data();
+      cursor.skip(sizeof(copy));
+    } else {
+      cursor.pull(copy, sizeof(copy));
+    }
     version = buf[0] >> 4;
     if (version != IPV4_VERSION) {
       throw HdrParseError("IPv4: version != 4");
@@ -54,10 +62,8 @@ IPv4Hdr::IPv4Hdr(Cursor& cursor) {
     csum =
         (static_cast<uint16_t>(buf[10]) << 8) | static_cast<uint16_t>(buf[11]);
     // TODO: check the checksum
-    uint32_t srcAddrRaw = cursor.readBE<uint32_t>();
-    uint32_t dstAddrRaw = cursor.readBE<uint32_t>();
-    srcAddr = IPAddressV4::fromLongHBO(srcAddrRaw);
-    dstAddr = IPAddressV4::fromLongHBO(dstAddrRaw);
+    srcAddr = IPAddressV4::fromBinary(folly::ByteRange(buf + 12, 4));
+    dstAddr = IPAddressV4::fromBinary(folly::ByteRange(buf + 16, 4));
 
     if (UNLIKELY(ihl > 5)) {
       cursor.pull(optionBuf, (ihl - 5) * sizeof(uint32_t));
@@ -127,9 +133,8 @@ string IPv4Hdr::toString() const {
 }
 
 uint32_t IPv4Hdr::addrPartialCsum(const IPAddressV4& addr) {
-  IOBuf buf(IOBuf::WRAP_BUFFER, addr.bytes(), 4);
-  Cursor c(&buf);
-  return c.readBE<uint16_t>() + c.readBE<uint16_t>();
+  auto bytes = addr.bytes();
+  return ((bytes[0] << 8) | bytes[1]) + ((bytes[2] << 8) | bytes[3]);
 }
 
 } // namespace facebook::fboss
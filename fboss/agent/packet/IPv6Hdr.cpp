@@ -20,7 +20,6 @@
 namespace facebook::fboss {
 
 using folly::Endian;
-using folly::IOBuf;
 using folly::IPAddress;
 using folly::IPAddressV6;
 using folly::io::Cursor;
@@ -29,8 +28,16 @@ using std::stringstream;
 
 IPv6Hdr::IPv6Hdr(Cursor& cursor) {
   try {
-    uint8_t buf[16];
-    cursor.pull(buf, 4);
+    // Parse straight out of the packet buffer when the header is contiguous,
+    // which it almost always is
+    uint8_t copy[SIZE];
+    const uint8_t* buf = copy;
+    if (cursor.length() >= sizeof(copy)) {
+      buf = cursor.data();
+      cursor.skip(sizeof(copy));
+    } else {
+      cursor.pull(copy, sizeof(copy));
+    }
     version = buf[0] >> 4;
     if (version != IPV6_VERSION) {
       throw HdrParseError("IPv6: version != 6");
@@ -38,11 +45,12 @@ IPv6Hdr::IPv6Hdr(Cursor& cursor) {
     trafficClass = ((buf[0] & 0x0F) << 4) | ((buf[1] & 0xF0) >> 4);
     flowLabel = (static_cast<uint32_t>(buf[1] & 0x0F) << 16) |
         (static_cast<uint32_t>(buf[2]) << 8) | static_cast<uint32_t>(buf[3]);
-    payloadLength = cursor.readBE<uint16_t>();
-    nextHeader = cursor.read<uint8_t>();
-    hopLimit = cursor.read<uint8_t>();
-    srcAddr = PktUtil::readIPv6(&cursor);
-    dstAddr = PktUtil::readIPv6(&cursor);
+    payloadLength =
+        (static_cast<uint16_t>(buf[4]) << 8) | static_cast<uint16_t>(buf[5]);
+    nextHeader = buf[6];
+    hopLimit = buf[7];
+    srcAddr = IPAddressV6::fromBinary(folly::ByteRange(buf + 8, 16));
+    dstAddr = IPAddressV6::fromBinary(folly::ByteRange(buf + 24, 16));
   } catch (const std::out_of_range& e) {
     throw HdrParseError("IPv6 header too small");
   }
@@ -75,11 +83,10 @@ uint32_t IPv6Hdr::pseudoHdrPartialCsum(uint32_t length) const {
 }
 
 uint32_t IPv6Hdr::addrPartialCsum(const IPAddressV6& addr) {
-  IOBuf buf(IOBuf::WRAP_BUFFER, addr.bytes(), 16);
-  Cursor c(&buf);
+  auto bytes = addr.bytes();
   uint32_t sum = 0;
-  for (uint8_t n = 0; n < 8; ++n) {
-    sum += c.readBE<uint16_t>();
+  for (uint8_t n = 0; n < 16; n += 2) {
+    sum += (bytes[n] << 8) | bytes[n + 1];
   }
   return sum;
 }
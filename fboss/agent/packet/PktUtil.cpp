@@ -9,13 +9,22 @@
  */
 #include "fboss/agent/packet/PktUtil.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <folly/Format.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/Portability.h>
 #include <folly/io/Cursor.h>
+#include <folly/lang/Bits.h>
 #include "fboss/agent/FbossError.h"
 
+#if FOLLY_SSE >= 2
+#include <emmintrin.h>
+#endif
+
 using folly::ByteRange;
 using folly::IOBuf;
 using folly::IPAddressV4;
@@ -26,6 +35,60 @@ using folly::io::Appender;
 using folly::io::Cursor;
 using std::string;
 
+namespace {
+/*
+ * Fold a ones' complement sum into 16 bits.
+ */
+uint16_t foldChecksum(uint64_t sum) {
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(sum);
+}
+
+/*
+ * Ones' complement sum of an even number of contiguous bytes, folded to 16
+ * bits and in host byte order of the big endian 16 bit words, i.e. the value
+ * the readBE<uint16_t>() loop would have summed up.
+ *
+ * The sum is byte order independent (RFC 1071 section 2.B), so it's done on
+ * native 32 bit words, and the result is swapped once at the end.
+ */
+uint16_t contiguousChecksum(const uint8_t* data, size_t length) {
+  uint64_t sum = 0;
+#if FOLLY_SSE >= 2
+  // 16 bytes at a time, into two 64 bit lanes which can't overflow
+  const auto zero = _mm_setzero_si128();
+  auto acc = _mm_setzero_si128();
+  while (length >= 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+    data += 16;
+    length -= 16;
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+  // Fold each lane first so that adding them up can't overflow
+  sum += foldChecksum(lanes[0]);
+  sum += foldChecksum(lanes[1]);
+#endif
+  while (length >= 4) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    sum += word;
+    data += 4;
+    length -= 4;
+  }
+  if (length >= 2) {
+    uint16_t word;
+    memcpy(&word, data, sizeof(word));
+    sum += word;
+  }
+  return folly::Endian::big(foldChecksum(sum));
+}
+} // namespace
+
 namespace facebook::fboss {
 
 MacAddress PktUtil::readMac(Cursor* cursor) {
@@ -68,8 +131,11 @@ uint16_t PktUtil::internetChecksum(folly::io::Cursor start, uint64_t length) {
 }
 
 uint16_t PktUtil::internetChecksum(const uint8_t* buffer, uint32_t size) {
-  auto buf = IOBuf(IOBuf::WRAP_BUFFER, buffer, size);
-  return finalizeChecksum(Cursor(&buf), size, 0);
+  uint32_t sum = contiguousChecksum(buffer, size & ~1U);
+  if (size & 1) {
+    sum += buffer[size - 1] << 8;
+  }
+  return finalizeChecksum(sum);
 }
 
 uint16_t PktUtil::internetChecksum(const IOBuf* buf) {
@@ -80,10 +146,18 @@ uint32_t PktUtil::partialChecksumImpl(
     folly::io::Cursor cursor,
     uint64_t length,
     uint32_t value) {
-  // Checksum all the pairs of bytes first
+  // Checksum all the pairs of bytes first, a buffer of the chain at a time
   while (length > 1) {
-    value += cursor.readBE<uint16_t>();
-    length -= 2;
+    auto contiguous = std::min<uint64_t>(cursor.length(), length) & ~1ULL;
+    if (contiguous) {
+      value += contiguousChecksum(cursor.data(), contiguous);
+      cursor.skip(contiguous);
+      length -= contiguous;
+    } else {
+      // A pair of bytes split across two buffers
+      value += cursor.readBE<uint16_t>();
+      length -= 2;
+    }
   }
   if (length) {
     // Bytes are interpreted in n/w byte order
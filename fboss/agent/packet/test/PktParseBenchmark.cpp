@@ -0,0 +1,281 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <gflags/gflags.h>
+
+#include "fboss/agent/packet/ArpHdr.h"
+#include "fboss/agent/packet/DHCPv4Packet.h"
+#include "fboss/agent/packet/EthHdr.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/packet/IPv4Hdr.h"
+#include "fboss/agent/packet/IPv6Hdr.h"
+#include "fboss/agent/packet/PktUtil.h"
+#include "fboss/agent/packet/UDPHeader.h"
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+using folly::io::Cursor;
+using folly::io::RWPrivateCursor;
+
+/*
+ * Parse and checksum the packets the CPU packet path handles most, the way
+ * SwSwitch and the protocol handlers do.
+ */
+
+namespace {
+const auto kSrcMac = MacAddress("02:00:01:00:00:01");
+const auto kDstMac = MacAddress("02:00:01:00:00:02");
+const VlanID kVlan(1);
+
+void writeEthHdr(RWPrivateCursor* cursor, ETHERTYPE etherType) {
+  cursor->push(kDstMac.bytes(), MacAddress::SIZE);
+  cursor->push(kSrcMac.bytes(), MacAddress::SIZE);
+  cursor->writeBE<uint16_t>(static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN));
+  cursor->writeBE<uint16_t>(kVlan);
+  cursor->writeBE<uint16_t>(static_cast<uint16_t>(etherType));
+}
+
+IOBuf makeArpRequest() {
+  IOBuf buf(IOBuf::CREATE, EthHdr::SIZE + ArpHdr::size());
+  buf.append(EthHdr::SIZE + ArpHdr::size());
+  RWPrivateCursor cursor(&buf);
+  writeEthHdr(&cursor, ETHERTYPE::ETHERTYPE_ARP);
+  cursor.writeBE<uint16_t>(1); // htype: ethernet
+  cursor.writeBE<uint16_t>(static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_IPV4));
+  cursor.write<uint8_t>(MacAddress::SIZE);
+  cursor.write<uint8_t>(4);
+  cursor.writeBE<uint16_t>(1); // request
+  cursor.push(kSrcMac.bytes(), MacAddress::SIZE);
+  cursor.push(IPAddressV4("10.0.0.2").bytes(), 4);
+  cursor.push(MacAddress().bytes(), MacAddress::SIZE);
+  cursor.push(IPAddressV4("10.0.0.1").bytes(), 4);
+  return buf;
+}
+
+IOBuf makeNeighborSolicitation() {
+  // Reserved, target and a source link-layer address option
+  const uint32_t bodyLength = 4 + IPAddressV6::byteCount() + 8;
+  IPv6Hdr ipv6(IPAddressV6("fe80::2"), IPAddressV6("ff02::1:ff00:1"));
+  ipv6.nextHeader = static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP);
+  ipv6.hopLimit = 255;
+  ipv6.payloadLength = ICMPHdr::SIZE + bodyLength;
+  ICMPHdr icmp6(
+      static_cast<uint8_t>(ICMPv6Type::ICMPV6_TYPE_NDP_NEIGHBOR_SOLICITATION),
+      0,
+      0);
+
+  auto length = ICMPHdr::computeTotalLengthV6(bodyLength);
+  IOBuf buf(IOBuf::CREATE, length);
+  buf.append(length);
+  RWPrivateCursor cursor(&buf);
+  auto serializeBody = [](RWPrivateCursor* body) {
+    body->writeBE<uint32_t>(0);
+    body->push(IPAddressV6("fe80::1").bytes(), IPAddressV6::byteCount());
+    body->write<uint8_t>(1); // source link-layer address
+    body->write<uint8_t>(1); // length in units of 8 bytes
+    body->push(kSrcMac.bytes(), MacAddress::SIZE);
+  };
+  icmp6.serializeFullPacket(
+      &cursor, kDstMac, kSrcMac, kVlan, ipv6, bodyLength, serializeBody);
+  return buf;
+}
+
+IOBuf makeDhcpDiscover() {
+  DHCPv4Packet dhcp;
+  dhcp.op = 1; // BOOTREQUEST
+  dhcp.htype = 1;
+  dhcp.hlen = MacAddress::SIZE;
+  dhcp.hops = 0;
+  dhcp.xid = IPAddressV4("0.0.0.1");
+  dhcp.secs = 0;
+  dhcp.flags = 0;
+  dhcp.chaddr.fill(0);
+  std::copy_n(kSrcMac.bytes(), MacAddress::SIZE, dhcp.chaddr.begin());
+  dhcp.sname.fill(0);
+  dhcp.file.fill(0);
+  dhcp.dhcpCookie.assign(
+      DHCPv4Packet::kOptionsCookie,
+      DHCPv4Packet::kOptionsCookie + DHCPv4Packet::kOptionsCookieSize);
+  const uint8_t discover = 1;
+  dhcp.appendOption(53, 1, &discover); // DHCP message type
+  dhcp.appendOption(255, 0, nullptr); // end
+  dhcp.padToMinLength();
+
+  IPv4Hdr ipv4(
+      IPAddressV4("0.0.0.0"),
+      IPAddressV4("255.255.255.255"),
+      static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP),
+      UDPHeader::size() + dhcp.size());
+  ipv4.computeChecksum();
+  UDPHeader udp(68, 67, UDPHeader::size() + dhcp.size());
+
+  auto length = EthHdr::SIZE + ipv4.length;
+  IOBuf buf(IOBuf::CREATE, length);
+  buf.append(length);
+  RWPrivateCursor cursor(&buf);
+  writeEthHdr(&cursor, ETHERTYPE::ETHERTYPE_IPV4);
+  ipv4.write(&cursor);
+  cursor.writeBE<uint16_t>(udp.srcPort);
+  cursor.writeBE<uint16_t>(udp.dstPort);
+  cursor.writeBE<uint16_t>(udp.length);
+  RWPrivateCursor csumCursor(cursor);
+  cursor.skip(2);
+  Cursor payloadStart(cursor);
+  dhcp.write(&cursor);
+  csumCursor.writeBE<uint16_t>(udp.computeChecksum(ipv4, payloadStart));
+  return buf;
+}
+
+IOBuf makeTtlExpired() {
+  const uint32_t bodyLength = 64;
+  IPv4Hdr ipv4(
+      IPAddressV4("10.0.0.2"),
+      IPAddressV4("10.1.0.1"),
+      static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP),
+      bodyLength);
+  ipv4.ttl = 1;
+  ipv4.computeChecksum();
+
+  auto length = EthHdr::SIZE + ipv4.length;
+  IOBuf buf(IOBuf::CREATE, length);
+  buf.append(length);
+  RWPrivateCursor cursor(&buf);
+  writeEthHdr(&cursor, ETHERTYPE::ETHERTYPE_IPV4);
+  ipv4.write(&cursor);
+  for (uint32_t i = 0; i < bodyLength; ++i) {
+    cursor.write<uint8_t>(i);
+  }
+  return buf;
+}
+
+template <typename ParseFn>
+void runParseBenchmark(unsigned n, const IOBuf& pkt, ParseFn parseFn) {
+  for (unsigned i = 0; i < n; ++i) {
+    Cursor cursor(&pkt);
+    EthHdr ethHdr(cursor);
+    folly::doNotOptimizeAway(ethHdr);
+    parseFn(cursor);
+  }
+}
+} // namespace
+
+BENCHMARK(ArpParse, n) {
+  IOBuf pkt;
+  BENCHMARK_SUSPEND {
+    pkt = makeArpRequest();
+  }
+  runParseBenchmark(n, pkt, [](Cursor& cursor) {
+    ArpHdr arpHdr(cursor);
+    folly::doNotOptimizeAway(arpHdr);
+  });
+}
+
+BENCHMARK(NdpParseAndChecksum, n) {
+  IOBuf pkt;
+  BENCHMARK_SUSPEND {
+    pkt = makeNeighborSolicitation();
+  }
+  runParseBenchmark(n, pkt, [](Cursor& cursor) {
+    IPv6Hdr ipv6(cursor);
+    ICMPHdr icmp6(cursor);
+    folly::doNotOptimizeAway(icmp6.validateChecksum(ipv6, cursor));
+  });
+}
+
+BENCHMARK(DhcpParseAndChecksum, n) {
+  IOBuf pkt;
+  BENCHMARK_SUSPEND {
+    pkt = makeDhcpDiscover();
+  }
+  runParseBenchmark(n, pkt, [](Cursor& cursor) {
+    Cursor ipStart(cursor);
+    IPv4Hdr ipv4(cursor);
+    folly::doNotOptimizeAway(PktUtil::internetChecksum(ipStart, ipv4.size()));
+    UDPHeader udp;
+    udp.parse(&cursor, nullptr);
+    folly::doNotOptimizeAway(udp.computeChecksum(ipv4, cursor) == udp.csum);
+    DHCPv4Packet dhcp;
+    dhcp.parse(&cursor);
+    folly::doNotOptimizeAway(dhcp);
+  });
+}
+
+/*
+ * Parse an IPv4 packet whose TTL expires, and build the ICMP time exceeded
+ * reply, whose checksum covers the original header and 8 bytes of payload
+ */
+BENCHMARK(IcmpTtlExceeded, n) {
+  IOBuf pkt;
+  IOBuf reply;
+  BENCHMARK_SUSPEND {
+    pkt = makeTtlExpired();
+    auto length = ICMPHdr::computeTotalLengthV4(
+        ICMPHdr::ICMPV4_UNUSED_LEN + IPv4Hdr::minSize() +
+        ICMPHdr::ICMPV4_SENDER_BYTES);
+    reply = IOBuf(IOBuf::CREATE, length);
+    reply.append(length);
+  }
+  runParseBenchmark(n, pkt, [&reply](Cursor& cursor) {
+    IPv4Hdr v4Hdr(cursor);
+    auto bodyLength = ICMPHdr::ICMPV4_UNUSED_LEN + v4Hdr.size() +
+        ICMPHdr::ICMPV4_SENDER_BYTES;
+    IPv4Hdr ipv4(
+        IPAddressV4("10.0.0.1"),
+        v4Hdr.srcAddr,
+        static_cast<uint8_t>(IP_PROTO::IP_PROTO_ICMP),
+        ICMPHdr::SIZE + bodyLength);
+    ipv4.computeChecksum();
+    ICMPHdr icmp4(
+        static_cast<uint8_t>(ICMPv4Type::ICMPV4_TYPE_TIME_EXCEEDED),
+        static_cast<uint8_t>(
+            ICMPv4Code::ICMPV4_CODE_TIME_EXCEEDED_TTL_EXCEEDED),
+        0);
+    RWPrivateCursor replyCursor(&reply);
+    icmp4.serializeFullPacket(
+        &replyCursor,
+        kSrcMac,
+        kDstMac,
+        kVlan,
+        ipv4,
+        bodyLength,
+        [&](RWPrivateCursor* body) {
+          body->writeBE<uint32_t>(0);
+          v4Hdr.write(body);
+          body->push(cursor.data(), ICMPHdr::ICMPV4_SENDER_BYTES);
+        });
+    folly::doNotOptimizeAway(icmp4.csum);
+  });
+}
+
+BENCHMARK(InternetChecksum1500, n) {
+  std::vector<uint8_t> bytes;
+  BENCHMARK_SUSPEND {
+    bytes.resize(1500);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      bytes[i] = i;
+    }
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    folly::doNotOptimizeAway(
+        PktUtil::internetChecksum(bytes.data(), bytes.size()));
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -222,3 +222,25 @@ TEST(Checksum, TestKnownOdd) {
   expected = ~expected;
   EXPECT_EQ(expected, PktUtil::internetChecksum(bytes, 9));
 }
+
+TEST(Checksum, TestChained) {
+  // The checksum of a chain must not depend on where the buffers are split,
+  // including splits in the middle of a 16 bit word
+  std::vector<uint8_t> bytes(301);
+  for (auto& byte : bytes) {
+    byte = Random::rand32(std::numeric_limits<uint8_t>::max());
+  }
+  auto expected = PktUtil::internetChecksum(bytes.data(), bytes.size());
+  for (size_t split : {0, 1, 2, 15, 16, 17, 150, 299, 300}) {
+    auto buf = IOBuf::copyBuffer(bytes.data(), split);
+    buf->appendChain(
+        IOBuf::copyBuffer(bytes.data() + split, bytes.size() - split));
+    EXPECT_EQ(expected, PktUtil::internetChecksum(buf.get())) << split;
+    // And the same through partial checksums of the even length prefix
+    auto partial = PktUtil::partialChecksum(Cursor(buf.get()), 300);
+    EXPECT_EQ(
+        expected,
+        PktUtil::finalizeChecksum(Cursor(buf.get()) + 300, 1, partial))
+        << split;
+  }
+}
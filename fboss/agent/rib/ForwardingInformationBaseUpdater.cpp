@@ -17,6 +17,7 @@
 #include "fboss/agent/state/NodeMap.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 
 #include <folly/logging/xlog.h>
 
@@ -36,6 +37,7 @@ ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
 
 std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
+  TIME_PHASE("fib_build");
   // A ForwardingInformationBaseContainer holds a
   // ForwardingInformationBaseV4 and a ForwardingInformationBaseV6 for a
   // particular VRF. Since FIBs for both address families will be updated,
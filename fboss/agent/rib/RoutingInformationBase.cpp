@@ -23,6 +23,7 @@
 #include "fboss/agent/state/ForwardingInformationBaseMap.h"
 #include "fboss/agent/state/NodeMap-defs.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 
 #include "fboss/agent/rib/RouteUpdater.h"
 
@@ -263,6 +264,7 @@ void RibRouteTables::update(
     const FibUpdateFunction& fibUpdateCallback,
     void* cookie) {
   updateRib(routerID, [&](auto& routeTable) {
+    TIME_PHASE("rib_resolve");
     RibRouteUpdater updater(
         &(routeTable.v4NetworkToRoute),
         &(routeTable.v6NetworkToRoute),
@@ -277,6 +279,7 @@ void RibRouteTables::updateFib(
     const FibUpdateFunction& fibUpdateCallback,
     void* cookie) {
   try {
+    TIME_PHASE("fib_update");
     auto lockedRouteTables = synchronizedRouteTables_.rlock();
     auto& routeTable = lockedRouteTables->find(vrf)->second;
     fibUpdateCallback(
@@ -477,6 +480,7 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::updateImpl(
   Timer updateTimer(&duration);
   std::exception_ptr updateException;
   auto updateFn = [&]() {
+    ScopedUpdateTimer updateBreakdown(updateType);
     std::vector<typename TraitsType::RibRoute> toAddRoutes;
     toAddRoutes.reserve(toAdd.size());
 
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/StateUpdate.h"
+
+#include <folly/Conv.h>
+
+namespace facebook::fboss {
+
+folly::StringPiece stateUpdateCategoryName(StateUpdateCategory category) {
+  switch (category) {
+    case StateUpdateCategory::OTHER:
+      return "other";
+    case StateUpdateCategory::CONFIG:
+      return "config";
+    case StateUpdateCategory::FIB_UPDATE:
+      return "fib_update";
+    case StateUpdateCategory::PORT_OPER_STATE:
+      return "port_oper_state";
+    case StateUpdateCategory::LACP:
+      return "lacp";
+    case StateUpdateCategory::MAC_LEARNING_ADD:
+      return "mac_learning_add";
+    case StateUpdateCategory::MAC_LEARNING_DELETE:
+      return "mac_learning_delete";
+    case StateUpdateCategory::MAC_CLASS_ID:
+      return "mac_class_id";
+    case StateUpdateCategory::STATIC_MAC_ADD:
+      return "static_mac_add";
+    case StateUpdateCategory::STATIC_MAC_ADD_IF_NEIGHBOR:
+      return "static_mac_add_if_neighbor";
+    case StateUpdateCategory::STATIC_MAC_PRUNE:
+      return "static_mac_prune";
+    case StateUpdateCategory::NEIGHBOR_ADD:
+      return "neighbor_add";
+    case StateUpdateCategory::NEIGHBOR_PENDING:
+      return "neighbor_pending";
+    case StateUpdateCategory::NEIGHBOR_REMOVE:
+      return "neighbor_remove";
+    case StateUpdateCategory::NEIGHBOR_CLASS_ID:
+      return "neighbor_class_id";
+    case StateUpdateCategory::NUM_CATEGORIES:
+      break;
+  }
+  return "unknown";
+}
+
+std::string StateUpdateDescriptor::str() const {
+  if (auto name = std::get_if<std::string>(&payload_)) {
+    return *name;
+  }
+  auto category = stateUpdateCategoryName(category_);
+  if (auto value = std::get_if<int64_t>(&payload_)) {
+    return folly::to<std::string>(category, " ", *value);
+  } else if (auto ip = std::get_if<folly::IPAddress>(&payload_)) {
+    return folly::to<std::string>(category, " ", ip->str());
+  } else if (auto mac = std::get_if<folly::MacAddress>(&payload_)) {
+    return folly::to<std::string>(category, " ", mac->toString());
+  }
+  return category.str();
+}
+
+} // namespace facebook::fboss
@@ -9,15 +9,90 @@
  */
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <variant>
 
 #include <folly/FBString.h>
+#include <folly/IPAddress.h>
 #include <folly/IntrusiveList.h>
+#include <folly/MacAddress.h>
+#include <folly/Range.h>
 
 namespace facebook::fboss {
 
 class SwitchState;
 
+/*
+ * Categories of state updates.
+ *
+ * Frequently scheduled updates should use a dedicated category rather than a
+ * free form name, so that no string has to be built when the update is
+ * scheduled. Categories also key the per-category update stats.
+ */
+enum class StateUpdateCategory : uint8_t {
+  OTHER,
+  CONFIG,
+  FIB_UPDATE,
+  PORT_OPER_STATE,
+  LACP,
+  MAC_LEARNING_ADD,
+  MAC_LEARNING_DELETE,
+  MAC_CLASS_ID,
+  STATIC_MAC_ADD,
+  STATIC_MAC_ADD_IF_NEIGHBOR,
+  STATIC_MAC_PRUNE,
+  NEIGHBOR_ADD,
+  NEIGHBOR_PENDING,
+  NEIGHBOR_REMOVE,
+  NEIGHBOR_CLASS_ID,
+  NUM_CATEGORIES,
+};
+
+folly::StringPiece stateUpdateCategoryName(StateUpdateCategory category);
+
+/*
+ * Identifies a state update: a static category plus a small typed payload
+ * (e.g. the neighbor IP or MAC address being programmed). The human readable
+ * name is only formatted when asked for, i.e. when logging at a verbose
+ * level or when recent updates are queried.
+ */
+class StateUpdateDescriptor {
+ public:
+  using Payload = std::variant<
+      std::monostate,
+      int64_t,
+      folly::IPAddress,
+      folly::MacAddress,
+      std::string>;
+
+  explicit StateUpdateDescriptor(
+      StateUpdateCategory category,
+      Payload payload = std::monostate())
+      : category_(category), payload_(std::move(payload)) {}
+
+  /*
+   * Free form name, copied into the descriptor. Meant for infrequent updates.
+   */
+  explicit StateUpdateDescriptor(folly::StringPiece name)
+      : category_(StateUpdateCategory::OTHER), payload_(name.str()) {}
+
+  StateUpdateCategory getCategory() const {
+    return category_;
+  }
+  const Payload& getPayload() const {
+    return payload_;
+  }
+
+  std::string str() const;
+
+ private:
+  StateUpdateCategory category_;
+  Payload payload_;
+};
+
 /*
  * StateUpdate objects are used to make changes to the SwitchState.
  *
@@ -39,12 +114,17 @@ class StateUpdate {
   };
   static constexpr int kDefaultBehaviorFlags =
       static_cast<int>(BehaviorFlags::NONE);
+  explicit StateUpdate(StateUpdateDescriptor descriptor, int behaviorFlags)
+      : descriptor_(std::move(descriptor)), behaviorFlags_(behaviorFlags) {}
   explicit StateUpdate(folly::StringPiece name, int behaviorFlags)
-      : name_(name.str()), behaviorFlags_(behaviorFlags) {}
+      : StateUpdate(StateUpdateDescriptor(name), behaviorFlags) {}
   virtual ~StateUpdate() {}
 
-  const std::string& getName() const {
-    return name_;
+  std::string getName() const {
+    return descriptor_.str();
+  }
+  const StateUpdateDescriptor& getDescriptor() const {
+    return descriptor_;
   }
 
   bool allowsCoalescing() const {
@@ -96,8 +176,10 @@ class StateUpdate {
   StateUpdate(StateUpdate const&) = delete;
   StateUpdate& operator=(StateUpdate const&) = delete;
 
-  std::string name_;
+  StateUpdateDescriptor descriptor_;
   int behaviorFlags_{static_cast<int>(BehaviorFlags::NONE)};
+  // Set by SwSwitch when the update is queued.
+  std::chrono::steady_clock::time_point enqueueTime_;
 
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
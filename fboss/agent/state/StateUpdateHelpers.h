@@ -30,10 +30,10 @@ class FunctionStateUpdate : public StateUpdate {
       StateUpdateFn;
 
   FunctionStateUpdate(
-      folly::StringPiece name,
+      StateUpdateDescriptor descriptor,
       StateUpdateFn fn,
       int flags = kDefaultBehaviorFlags)
-      : StateUpdate(name, flags), function_(fn) {}
+      : StateUpdate(std::move(descriptor), flags), function_(std::move(fn)) {}
 
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& origState) override {
@@ -101,11 +101,13 @@ class BlockingStateUpdate : public StateUpdate {
       StateUpdateFn;
 
   BlockingStateUpdate(
-      folly::StringPiece name,
+      StateUpdateDescriptor descriptor,
       StateUpdateFn fn,
       std::shared_ptr<BlockingUpdateResult> result,
       int flags = kDefaultBehaviorFlags)
-      : StateUpdate(name, flags), function_(fn), result_(result) {}
+      : StateUpdate(std::move(descriptor), flags),
+        function_(std::move(fn)),
+        result_(result) {}
 
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& origState) override {
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <gflags/gflags.h>
+
+#include "fboss/agent/DHCPv4Handler.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/hw/mock/MockHwSwitch.h"
+#include "fboss/agent/packet/DHCPv4Packet.h"
+#include "fboss/agent/packet/DHCPv6Packet.h"
+#include "fboss/agent/packet/EthHdr.h"
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/packet/IPv4Hdr.h"
+#include "fboss/agent/packet/IPv6Hdr.h"
+#include "fboss/agent/packet/UDPHeader.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+using folly::io::RWPrivateCursor;
+using std::shared_ptr;
+using std::unique_ptr;
+using ::testing::_;
+
+/*
+ * Relay client DHCP messages received on a VLAN with a relay configured, as
+ * happens for every server of a rack being reimaged at once. Each iteration
+ * is one message from RX to the relayed message being sent.
+ */
+
+namespace {
+const VlanID kVlan(1);
+const PortID kPort(1);
+const MacAddress kClientMac("02:00:00:00:00:02");
+
+shared_ptr<SwitchState> relayState() {
+  auto state = testStateA();
+  auto vlan = state->getVlans()->getVlan(kVlan);
+  vlan->setDhcpV4Relay(IPAddressV4("20.20.20.20"));
+  vlan->setDhcpV6Relay(IPAddressV6("2401:db00:1::20"));
+  return state;
+}
+
+unique_ptr<HwTestHandle> setupRelayHandle() {
+  auto handle = createTestHandle(relayState());
+  EXPECT_HW_CALL(handle->getSw(), sendPacketSwitchedAsync_(_))
+      .Times(::testing::AnyNumber());
+  return handle;
+}
+
+void writeEthHdr(RWPrivateCursor* cursor, ETHERTYPE etherType) {
+  cursor->push(MacAddress::BROADCAST.bytes(), MacAddress::SIZE);
+  cursor->push(kClientMac.bytes(), MacAddress::SIZE);
+  cursor->writeBE<uint16_t>(static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN));
+  cursor->writeBE<uint16_t>(kVlan);
+  cursor->writeBE<uint16_t>(static_cast<uint16_t>(etherType));
+}
+
+IOBuf makeDhcpV4Discover() {
+  DHCPv4Packet dhcp;
+  dhcp.op = DHCPv4Handler::BOOTREQUEST;
+  dhcp.htype = 1;
+  dhcp.hlen = MacAddress::SIZE;
+  dhcp.hops = 0;
+  dhcp.xid = IPAddressV4("0.0.0.1");
+  dhcp.secs = 0;
+  dhcp.flags = 0;
+  dhcp.chaddr.fill(0);
+  std::copy_n(kClientMac.bytes(), MacAddress::SIZE, dhcp.chaddr.begin());
+  dhcp.sname.fill(0);
+  dhcp.file.fill(0);
+  dhcp.dhcpCookie.assign(
+      DHCPv4Packet::kOptionsCookie,
+      DHCPv4Packet::kOptionsCookie + DHCPv4Packet::kOptionsCookieSize);
+  const uint8_t discover = 1;
+  dhcp.appendOption(DHCPv4Handler::DHCP_MESSAGE_TYPE, 1, &discover);
+  dhcp.appendOption(DHCPv4Handler::END, 0, nullptr);
+  dhcp.padToMinLength();
+
+  IPv4Hdr ipv4(
+      IPAddressV4("0.0.0.0"),
+      IPAddressV4("255.255.255.255"),
+      static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP),
+      UDPHeader::size() + dhcp.size());
+  ipv4.ttl = 64;
+  UDPHeader udp(
+      DHCPv4Handler::kBootPCPort,
+      DHCPv4Handler::kBootPSPort,
+      UDPHeader::size() + dhcp.size());
+
+  auto length = EthHdr::SIZE + ipv4.length;
+  IOBuf buf(IOBuf::CREATE, length);
+  buf.append(length);
+  RWPrivateCursor cursor(&buf);
+  writeEthHdr(&cursor, ETHERTYPE::ETHERTYPE_IPV4);
+  ipv4.write(&cursor);
+  udp.write(&cursor);
+  dhcp.write(&cursor);
+  return buf;
+}
+
+IOBuf makeDhcpV6Solicit() {
+  // Solicit, transaction id and an elapsed time option
+  const uint8_t solicit[] = {0x01, 0x00, 0x00, 0x01, 0x00, 0x08, 0x00, 0x02,
+                             0x00, 0x00};
+  IPv6Hdr ipv6(IPAddressV6("fe80::2"), IPAddressV6("ff02::1:2"));
+  ipv6.nextHeader = static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP);
+  ipv6.hopLimit = 1;
+  ipv6.payloadLength = UDPHeader::size() + sizeof(solicit);
+  UDPHeader udp(
+      DHCPv6Packet::DHCP6_CLIENT_UDPPORT,
+      DHCPv6Packet::DHCP6_SERVERAGENT_UDPPORT,
+      ipv6.payloadLength);
+
+  auto length = EthHdr::SIZE + IPv6Hdr::SIZE + ipv6.payloadLength;
+  IOBuf buf(IOBuf::CREATE, length);
+  buf.append(length);
+  RWPrivateCursor cursor(&buf);
+  writeEthHdr(&cursor, ETHERTYPE::ETHERTYPE_IPV6);
+  ipv6.serialize(&cursor);
+  udp.write(&cursor);
+  cursor.push(solicit, sizeof(solicit));
+  return buf;
+}
+
+void runRelayBenchmark(unsigned n, IOBuf (*makePacket)()) {
+  unique_ptr<HwTestHandle> handle;
+  IOBuf pkt;
+  BENCHMARK_SUSPEND {
+    handle = setupRelayHandle();
+    pkt = makePacket();
+  }
+
+  for (unsigned i = 0; i < n; ++i) {
+    handle->rxPacket(pkt.clone(), kPort, kVlan);
+  }
+
+  BENCHMARK_SUSPEND {
+    handle.reset();
+  }
+}
+} // namespace
+
+BENCHMARK(DHCPv4RelayRequest, n) {
+  runRelayBenchmark(n, makeDhcpV4Discover);
+}
+
+BENCHMARK(DHCPv6RelaySolicit, n) {
+  runRelayBenchmark(n, makeDhcpV6Solicit);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
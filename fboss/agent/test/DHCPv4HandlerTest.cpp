@@ -14,6 +14,7 @@
 #include <folly/io/IOBuf.h>
 #include <algorithm>
 #include <string>
+#include "fboss/agent/DHCPRelayContextCache.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
@@ -31,6 +32,7 @@
 #include "fboss/agent/state/ArpResponseTable.h"
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/PortDescriptor.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
@@ -410,6 +412,64 @@ TEST(DHCPv4HandlerTest, DHCPRequest) {
   counters.update();
   counters.checkDelta(SwitchStats::kCounterPrefix + "dhcpV4.pkt.sum", 1);
   counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.pkts.sum", 1);
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "vlan.1.dhcpV4.relayed.sum", 1);
+}
+
+TEST(DHCPv4HandlerTest, RelayContextInvalidation) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  auto cache = sw->getDhcpRelayContextCache();
+  auto senderMac = kClientMac.toString();
+  std::replace(senderMac.begin(), senderMac.end(), ':', ' ');
+  auto sendRequest = [&]() {
+    sendDHCPPacket(
+        handle.get(),
+        senderMac,
+        "ff ff ff ff ff ff",
+        "00 01",
+        "00 00 00 00",
+        "ff ff ff ff",
+        "00 43",
+        "00 44",
+        "01",
+        "35  01  01");
+  };
+
+  EXPECT_SWITCHED_PKT(sw, "DHCP request", checkDHCPReq());
+  sendRequest();
+  EXPECT_EQ(1, cache->size());
+
+  // Neighbor updates change the VLAN, but not its relay context
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(2);
+  sw->updateStateBlocking(
+      "add arp entry", [](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto vlan = newState->getVlans()->getVlan(VlanID(1));
+        auto arpTable = vlan->getArpTable()->modify(VlanID(1), &newState);
+        arpTable->addEntry(
+            IPAddressV4("10.0.0.20"),
+            MacAddress("02:00:00:00:00:20"),
+            PortDescriptor(PortID(1)),
+            vlan->getInterfaceID());
+        return newState;
+      });
+  EXPECT_EQ(1, cache->size());
+
+  // A new relay drops the context, and the next request goes to it
+  const IPAddressV4 kNewRelay("40.40.40.40");
+  sw->updateStateBlocking(
+      "change dhcp relay", [&](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto vlan = newState->getVlans()->getVlan(VlanID(1))->modify(&newState);
+        vlan->setDhcpV4Relay(kNewRelay);
+        return newState;
+      });
+  EXPECT_EQ(0, cache->size());
+
+  EXPECT_SWITCHED_PKT(sw, "DHCP request", checkDHCPReq(kNewRelay));
+  sendRequest();
+  EXPECT_EQ(1, cache->size());
 }
 
 TEST(DHCPv4HandlerOverrideTest, DHCPRequest) {
@@ -14,6 +14,7 @@
 #include <folly/io/IOBuf.h>
 #include <algorithm>
 #include <string>
+#include "fboss/agent/DHCPRelayContextCache.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
@@ -25,6 +26,7 @@
 #include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/packet/UDPHeader.h"
 #include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
@@ -492,6 +494,77 @@ TEST(DHCPv6HandlerTest, DHCPV6Request) {
   counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.pkts.sum", 1);
 }
 
+// Test that a VLAN's relay context, and so the source of the RelayForward TX
+// packet, follows the address of the VLAN interface
+TEST(DHCPv6HandlerTest, RelayContextIntfAddressChange) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  auto cache = sw->getDhcpRelayContextCache();
+
+  auto senderMac = kClientMac.toString();
+  std::replace(senderMac.begin(), senderMac.end(), ':', ' ');
+  auto targetMac = kDhcpV6AllRoutersMac.toString();
+  std::replace(targetMac.begin(), targetMac.end(), ':', ' ');
+  // DHCPV6 Request Message type (3), txnId (dummy 0x571958)
+  const string dhcpV6Hdr = "03 57 19 58";
+  // DHCPv6 Elapsed time Option (0008), Length (0002), Value (0000)
+  const string dhcpV6RequestOptions = "00 08 00 02 00 00";
+  constexpr auto dhcpV6HdrSize = 10; // computed for hdr and options above
+  auto dhcp6RawPktBuf = PktUtil::parseHexData(dhcpV6Hdr + dhcpV6RequestOptions);
+  Cursor cDhcp(&dhcp6RawPktBuf);
+  DHCPv6Packet dhcp6TxPkt;
+  dhcp6TxPkt.parse(&cDhcp);
+  auto sendRequest = [&]() {
+    sendDHCPV6Packet(
+        handle.get(),
+        senderMac,
+        targetMac,
+        kClientVlanStr,
+        kDhcpV6ClientLocalIpStr,
+        kDhcpV6AllRoutersIpStr,
+        "02 22",
+        "02 23",
+        dhcpV6HdrSize,
+        dhcpV6Hdr,
+        dhcpV6RequestOptions);
+  };
+  CounterCache counters(sw);
+
+  EXPECT_SWITCHED_PKT(
+      sw, "DHCPV6 request", checkDHCPV6Request(dhcp6TxPkt, kVlanInterfaceIP));
+  sendRequest();
+  EXPECT_EQ(1, cache->size());
+
+  // Renumbering the VLAN interface drops the context
+  const IPAddressV6 kNewVlanInterfaceIP("2401:db00:2110:3001::0002");
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(testing::AtLeast(1));
+  sw->updateStateBlocking(
+      "renumber interface", [&](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto newIntfs = newState->getInterfaces()->clone();
+        auto newIntf = newIntfs->getInterface(InterfaceID(1))->clone();
+        auto addresses = newIntf->getAddresses();
+        addresses.erase(kVlanInterfaceIP);
+        addresses.emplace(kNewVlanInterfaceIP, 64);
+        newIntf->setAddresses(addresses);
+        newIntfs->updateNode(newIntf);
+        newState->resetIntfs(newIntfs);
+        return newState;
+      });
+  EXPECT_EQ(0, cache->size());
+
+  EXPECT_SWITCHED_PKT(
+      sw,
+      "DHCPV6 request",
+      checkDHCPV6Request(dhcp6TxPkt, kNewVlanInterfaceIP));
+  sendRequest();
+  EXPECT_EQ(1, cache->size());
+
+  counters.update();
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "vlan.1.dhcpV6.relayed.sum", 2);
+}
+
 // Test to inject a DHCPV6 client's RX Request packet with a override-MAC
 // and validate RelayForward TX packet
 TEST(DHCPv6HandlerOverrideTest, DHCPV6Request) {
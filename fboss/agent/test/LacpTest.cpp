@@ -7,9 +7,13 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -17,10 +21,14 @@
 #include <vector>
 
 #include <boost/container/flat_map.hpp>
+#include <folly/Conv.h>
 #include <folly/Function.h>
 #include <folly/MacAddress.h>
 #include <folly/Range.h>
+#include <folly/ScopeGuard.h>
 #include <folly/Synchronized.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
 #include <folly/synchronization/Baton.h>
 #include <folly/system/ThreadName.h>
@@ -30,14 +38,24 @@
 #include "fboss/agent/LacpController.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LinkAggregationManager.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/TxPacket.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/state/AggregatePort.h"
+#include "fboss/agent/state/AggregatePortMap.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 #include "fboss/agent/types.h"
 
 using namespace facebook::fboss;
+using ::testing::_;
+using ::testing::Invoke;
 
 namespace {
 
@@ -172,6 +190,19 @@ class LacpServiceInterceptor : public LacpServicerIf {
 
     return lacpduTransmitted;
   }
+  std::optional<LACPDU> lastLacpduTransmittedIf(PortID portID) {
+    std::optional<LACPDU> lacpduTransmitted;
+
+    lacpEvb_->runInEventBaseThreadAndWait([this, portID, &lacpduTransmitted]() {
+      auto portToLastTransmissionLocked = portToLastTransmission_.rlock();
+      auto it = portToLastTransmissionLocked->find(portID);
+      if (it != portToLastTransmissionLocked->end()) {
+        lacpduTransmitted = it->second;
+      }
+    });
+
+    return lacpduTransmitted;
+  }
   bool isForwarding(PortID portID) {
     bool forwarding = false;
 
@@ -1288,3 +1319,297 @@ TEST_F(LacpTest, lacpDownCounters) {
   // both members should timeout
   counters.checkDelta(SwitchStats::kCounterPrefix + "lacp.rx_timeout.sum", 2);
 }
+
+/*
+ * Soak many fast-rate members of an aggregate port, run by the SwSwitch's
+ * LinkAggregationManager, while the update thread is busy applying route
+ * updates. LACPDUs are relayed between the switch and simulated partner
+ * controllers, and all members are flapped a few times, so the members'
+ * forwarding and partner state changes are programmed by the coalesced
+ * updates in between the route updates. Reports how long the LACP EventBase
+ * takes to process a round of LACPDUs received on every member, and how long
+ * the members take to forward again after a flap.
+ */
+TEST_F(LacpTest, multiMemberSoakWithRouteUpdates) {
+  constexpr int kNumMembers = 16;
+  constexpr int kNumFlaps = 3;
+  constexpr int kNumRoutesPerUpdate = 256;
+  constexpr auto kRelayInterval = std::chrono::milliseconds(100);
+  constexpr auto kConvergenceTimeout = std::chrono::seconds(30);
+  const AggregatePortID kAggPortID(1);
+  const MacAddress kPartnerMac("02:90:fb:5e:1e:85");
+
+  auto config = testConfigA();
+  config.aggregatePorts_ref()->resize(1);
+  auto& aggPortCfg = config.aggregatePorts_ref()[0];
+  *aggPortCfg.key_ref() = static_cast<uint16_t>(kAggPortID);
+  *aggPortCfg.name_ref() = "Port-Channel1";
+  *aggPortCfg.description_ref() = "soak bundle";
+  aggPortCfg.memberPorts_ref()->resize(kNumMembers);
+  for (auto i = 0; i < kNumMembers; ++i) {
+    config.ports_ref()[i].state_ref() = cfg::PortState::ENABLED;
+    *aggPortCfg.memberPorts_ref()[i].memberPortID_ref() = i + 1;
+    *aggPortCfg.memberPorts_ref()[i].rate_ref() = cfg::LacpPortRate::FAST;
+  }
+
+  // The LACPDUs the switch transmitted, as its partner would receive them
+  folly::Synchronized<std::map<PortID, LACPDU>> duTransmissions;
+  auto handle = createTestHandle(&config, SwitchFlags::ENABLE_LACP);
+  auto sw = handle->getSw();
+  ASSERT_NE(sw->getLagManager(), nullptr);
+  EXPECT_HW_CALL(sw, sendPacketOutOfPortAsync_(_, _, _))
+      .WillRepeatedly(Invoke(
+          [&duTransmissions](
+              TxPacket* pkt, PortID port, std::optional<uint8_t> /* queue */) {
+            folly::io::Cursor c(pkt->buf());
+            c += 2 * MacAddress::SIZE;
+            auto ethertype = c.readBE<uint16_t>();
+            if (ethertype == 0x8100) {
+              c += 2;
+              ethertype = c.readBE<uint16_t>();
+            }
+            if (ethertype == LACPDU::EtherType::SLOW_PROTOCOLS &&
+                c.readBE<uint8_t>() == LACPDU::EtherSubtype::LACP) {
+              (*duTransmissions.wlock())[port] = LACPDU::from(&c);
+            }
+            return true;
+          }));
+
+  auto lacpEvbase = lacpEvb();
+  LacpServiceInterceptor uuEventInterceptor(lacpEvbase);
+  std::vector<PortID> duPorts, uuPorts;
+  std::vector<VlanID> duVlans;
+  std::vector<std::shared_ptr<LacpController>> uuControllers;
+  for (auto i = 0; i < kNumMembers; ++i) {
+    PortID duPort(i + 1);
+    PortID uuPort(static_cast<uint16_t>(0x100 + i));
+    auto controller = std::make_shared<LacpController>(
+        uuPort,
+        lacpEvbase,
+        32768 /* port priority */,
+        cfg::LacpPortRate::FAST,
+        cfg::LacpPortActivity::ACTIVE,
+        cfg::switch_config_constants::DEFAULT_LACP_HOLD_TIMER_MULTIPLIER(),
+        AggregatePortID(1),
+        65535 /* system priority */,
+        kPartnerMac,
+        1 /* minimum-link count */,
+        &uuEventInterceptor);
+    uuEventInterceptor.addController(controller);
+    controller->startMachines();
+    controller->portUp();
+    duPorts.push_back(duPort);
+    duVlans.push_back(sw->getState()->getPort(duPort)->getIngressVlan());
+    uuPorts.push_back(uuPort);
+    uuControllers.push_back(controller);
+  }
+
+  auto makeLacpFrame = [&kPartnerMac](const LACPDU& lacpdu, VlanID vlan) {
+    auto buf = folly::IOBuf::create(LACPDU::LENGTH);
+    buf->append(LACPDU::LENGTH);
+    folly::io::RWPrivateCursor writer(buf.get());
+    TxPacket::writeEthHeader(
+        &writer,
+        LACPDU::kSlowProtocolsDstMac(),
+        kPartnerMac,
+        vlan,
+        LACPDU::EtherType::SLOW_PROTOCOLS);
+    writer.writeBE<uint8_t>(LACPDU::EtherSubtype::LACP);
+    lacpdu.to(&writer);
+    return buf;
+  };
+
+  // Deliver the latest LACPDU each end transmitted on a member to the other
+  // end. The switch receives them like any other frame, and the time until
+  // its LACP EventBase processed them is recorded.
+  std::vector<std::chrono::microseconds> latencies;
+  auto relay = [&]() {
+    std::vector<std::optional<LACPDU>> uuPdus;
+    for (const auto& uuPort : uuPorts) {
+      uuPdus.push_back(uuEventInterceptor.lastLacpduTransmittedIf(uuPort));
+    }
+    auto duPdus = *duTransmissions.rlock();
+
+    auto begin = std::chrono::steady_clock::now();
+    for (auto i = 0; i < kNumMembers; ++i) {
+      if (uuPdus[i]) {
+        handle->rxPacket(
+            makeLacpFrame(*uuPdus[i], duVlans[i]), duPorts[i], duVlans[i]);
+      }
+    }
+    sw->getLacpEvb()->runInEventBaseThreadAndWait([]() {});
+    latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin));
+
+    for (auto i = 0; i < kNumMembers; ++i) {
+      auto it = duPdus.find(duPorts[i]);
+      if (it != duPdus.end()) {
+        uuControllers[i]->received(it->second);
+      }
+    }
+  };
+  auto allForwarding = [&]() {
+    auto aggPort =
+        sw->getState()->getAggregatePorts()->getAggregatePort(kAggPortID);
+    return std::all_of(duPorts.begin(), duPorts.end(), [&](PortID port) {
+      return aggPort->getForwardingState(port) ==
+          AggregatePort::Forwarding::ENABLED;
+    });
+  };
+  // Relay LACPDUs until every member of the switch forwards, and return how
+  // long it took
+  auto converge = [&]() {
+    auto begin = std::chrono::steady_clock::now();
+    while (!allForwarding()) {
+      if (std::chrono::steady_clock::now() - begin > kConvergenceTimeout) {
+        throw std::runtime_error("Aggregate port members didn't converge");
+      }
+      relay();
+      std::this_thread::sleep_for(kRelayInterval);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin);
+  };
+
+  // Keep the update thread busy with route churn for the whole soak
+  std::atomic<bool> done{false};
+  std::atomic<int> routeUpdates{0};
+  std::thread routeChurn([sw, &done, &routeUpdates]() {
+    RouteNextHopSet nexthops{
+        UnresolvedNextHop(folly::IPAddress("10.0.0.22"), UCMP_DEFAULT_WEIGHT)};
+    bool add = true;
+    while (!done) {
+      auto updater = sw->getRouteUpdater();
+      for (auto i = 0; i < kNumRoutesPerUpdate; ++i) {
+        folly::IPAddress network(folly::to<std::string>("10.100.", i, ".0"));
+        if (add) {
+          updater.addRoute(
+              RouterID(0),
+              network,
+              24,
+              ClientID::BGPD,
+              RouteNextHopEntry(nexthops, AdminDistance::EBGP));
+        } else {
+          updater.delRoute(RouterID(0), network, 24, ClientID::BGPD);
+        }
+      }
+      updater.program();
+      add = !add;
+      ++routeUpdates;
+    }
+  });
+  SCOPE_EXIT {
+    done = true;
+    if (routeChurn.joinable()) {
+      routeChurn.join();
+    }
+  };
+
+  for (const auto& port : duPorts) {
+    handle->forcePortUp(port);
+  }
+  std::vector<std::chrono::milliseconds> convergenceTimes;
+  convergenceTimes.push_back(converge());
+  for (auto flap = 0; flap < kNumFlaps; ++flap) {
+    // Both ends see the links go down, e.g. on a linecard reset
+    for (auto i = 0; i < kNumMembers; ++i) {
+      handle->forcePortDown(duPorts[i]);
+      uuControllers[i]->portDown();
+    }
+    duTransmissions.wlock()->clear();
+    waitForStateUpdates(sw);
+    EXPECT_FALSE(allForwarding());
+    for (auto i = 0; i < kNumMembers; ++i) {
+      handle->forcePortUp(duPorts[i]);
+      uuControllers[i]->portUp();
+    }
+    convergenceTimes.push_back(converge());
+  }
+  // Steady state, in sync LACPDUs only
+  for (auto round = 0; round < 10; ++round) {
+    relay();
+    std::this_thread::sleep_for(kRelayInterval);
+  }
+  done = true;
+  routeChurn.join();
+
+  std::sort(latencies.begin(), latencies.end());
+  XLOG(INFO) << "Processed " << latencies.size() << " rounds of "
+             << kNumMembers << " LACPDUs during " << routeUpdates
+             << " route updates. PDU round latency p50: "
+             << latencies[latencies.size() / 2].count()
+             << "us, max: " << latencies.back().count() << "us";
+  for (size_t i = 0; i < convergenceTimes.size(); ++i) {
+    XLOG(INFO) << (i == 0 ? "Initial convergence" : "Convergence after flap")
+               << ": " << convergenceTimes[i].count() << "ms";
+  }
+
+  EXPECT_TRUE(allForwarding());
+  auto syncState = LacpState::AGGREGATABLE | LacpState::ACTIVE |
+      LacpState::IN_SYNC | LacpState::COLLECTING | LacpState::DISTRIBUTING |
+      LacpState::SHORT_TIMEOUT;
+  auto duPdus = *duTransmissions.rlock();
+  for (auto i = 0; i < kNumMembers; ++i) {
+    ASSERT_NE(duPdus.find(duPorts[i]), duPdus.end());
+    EXPECT_EQ(duPdus[duPorts[i]].actorInfo.state, syncState);
+    EXPECT_EQ(
+        uuEventInterceptor.lastActorStateTransmitted(uuPorts[i]), syncState);
+  }
+  for (auto& controller : uuControllers) {
+    controller->stopMachines();
+  }
+}
+
+/*
+ * Forwarding and partner state changes made by the LACP state machines of
+ * several members, across aggregate ports, in one LACP EventBase loop
+ * iteration must be programmed as a single state update.
+ */
+TEST_F(LacpTest, coalesceForwardingAndPartnerStates) {
+  auto config = testConfigA();
+  config.aggregatePorts_ref()->resize(2);
+  for (auto i = 0; i < 2; ++i) {
+    auto& aggPort = config.aggregatePorts_ref()[i];
+    *aggPort.key_ref() = i + 1;
+    *aggPort.name_ref() = folly::to<std::string>("Port-Channel", i + 1);
+    *aggPort.description_ref() = "double bundle";
+    aggPort.memberPorts_ref()->resize(2);
+    *aggPort.memberPorts_ref()[0].memberPortID_ref() = 8 * i + 1;
+    *aggPort.memberPorts_ref()[1].memberPortID_ref() = 8 * i + 5;
+  }
+  auto handle = createTestHandle(&config);
+  auto sw = handle->getSw();
+  LinkAggregationManager lagMgr(sw);
+
+  const std::vector<std::pair<PortID, AggregatePortID>> members = {
+      {PortID(1), AggregatePortID(1)},
+      {PortID(5), AggregatePortID(1)},
+      {PortID(9), AggregatePortID(2)},
+      {PortID(13), AggregatePortID(2)}};
+  AggregatePort::PartnerState partnerState{};
+  partnerState.key = 7;
+
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(1);
+  auto lacpEvbase = sw->getLacpEvb();
+  folly::Baton<> flushed;
+  lacpEvbase->runInEventBaseThreadAndWait([&]() {
+    // Only the latest transition of a member is programmed
+    lagMgr.disableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), partnerState);
+    for (const auto& [port, aggPort] : members) {
+      lagMgr.enableForwardingAndSetPartnerState(port, aggPort, partnerState);
+    }
+    // Loop callbacks run in order, so this runs right after the flush
+    lacpEvbase->runInLoop([&flushed]() { flushed.post(); });
+  });
+  flushed.wait();
+  waitForStateUpdates(sw);
+
+  auto state = sw->getState();
+  for (const auto& [port, aggPortID] : members) {
+    auto aggPort = state->getAggregatePorts()->getAggregatePort(aggPortID);
+    EXPECT_EQ(
+        aggPort->getForwardingState(port), AggregatePort::Forwarding::ENABLED);
+    EXPECT_EQ(aggPort->getPartnerState(port), partnerState);
+  }
+}
@@ -160,6 +160,67 @@ TEST(LldpManagerTest, LldpSendPeriodic) {
   lldpManager.stop();
 }
 
+TEST(LldpManagerTest, LldpTemplateInvalidation) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+
+  EXPECT_HW_CALL(
+      sw,
+      sendPacketOutOfPortAsync_(
+          TxPacketMatcher::createMatcher("Lldp PDU", checkLldpPDU()),
+          _,
+          std::optional<uint8_t>(kNCStrictPriorityQueue)))
+      .Times(AtLeast(1));
+  LldpManager lldpManager(sw);
+  EXPECT_EQ(lldpManager.getNumFrameTemplates(), 0);
+  lldpManager.sendLldpOnAllPorts();
+  auto numTemplates = lldpManager.getNumFrameTemplates();
+  EXPECT_GT(numTemplates, 0);
+  EXPECT_TRUE(lldpManager.hasFrameTemplate(PortID(1)));
+  EXPECT_TRUE(lldpManager.hasFrameTemplate(PortID(2)));
+
+  // Resending must reuse the cached frames
+  CounterCache counters(sw);
+  lldpManager.sendLldpOnAllPorts();
+  counters.update();
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "lldp.template_rebuild.sum", 0);
+  EXPECT_EQ(lldpManager.getNumFrameTemplates(), numTemplates);
+
+  // Port description is part of the frame, changing it drops that frame only
+  sw->updateStateBlocking(
+      "Change port description", [](const std::shared_ptr<SwitchState>& state) {
+        std::shared_ptr<SwitchState> newState(state);
+        auto port = newState->getPorts()->getPortIf(PortID(1)).get();
+        port = port->modify(&newState);
+        port->setDescription("new port description");
+        return newState;
+      });
+  waitForStateUpdates(sw);
+  EXPECT_FALSE(lldpManager.hasFrameTemplate(PortID(1)));
+  EXPECT_TRUE(lldpManager.hasFrameTemplate(PortID(2)));
+  EXPECT_EQ(lldpManager.getNumFrameTemplates(), numTemplates - 1);
+
+  // Oper state changes don't touch the frame contents
+  sw->updateStateBlocking(
+      "Bring port down", [](const std::shared_ptr<SwitchState>& state) {
+        std::shared_ptr<SwitchState> newState(state);
+        auto port = newState->getPorts()->getPortIf(PortID(2)).get();
+        port = port->modify(&newState);
+        port->setOperState(false);
+        return newState;
+      });
+  waitForStateUpdates(sw);
+  EXPECT_TRUE(lldpManager.hasFrameTemplate(PortID(2)));
+
+  counters.update();
+  lldpManager.sendLldpOnAllPorts();
+  counters.update();
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "lldp.template_rebuild.sum", 1);
+  EXPECT_TRUE(lldpManager.hasFrameTemplate(PortID(1)));
+}
+
 TEST(LldpManagerTest, NoLldpPktsIfSwitchConfigured) {
   auto handle = setupTestHandle(true /*enableLldp*/);
   auto sw = handle->getSw();
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/MacEntry.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using folly::MacAddress;
+using std::make_shared;
+using std::shared_ptr;
+
+namespace {
+
+static constexpr int kNumPorts = 32;
+static constexpr int kNumHosts = 4096;
+const VlanID kVlan(1);
+
+const std::vector<cfg::AclLookupClass> kLookupClasses = {
+    cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0,
+    cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1,
+    cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_2,
+    cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3,
+    cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_4,
+};
+
+shared_ptr<SwitchState> lookupClassState() {
+  auto state = make_shared<SwitchState>();
+  auto vlan = make_shared<Vlan>(kVlan, "Vlan1");
+  state->addVlan(vlan);
+  for (int idx = 1; idx <= kNumPorts; ++idx) {
+    state->registerPort(PortID(idx), folly::to<std::string>("port", idx));
+    vlan->addPort(PortID(idx), false);
+    auto port = state->getPorts()->getPortIf(PortID(idx));
+    port->addVlan(kVlan, false);
+    port->setLookupClassesToDistributeTrafficOn(kLookupClasses);
+  }
+
+  auto intf = make_shared<Interface>(
+      InterfaceID(1),
+      RouterID(0),
+      kVlan,
+      "interface1",
+      MacAddress("00:02:00:00:00:01"),
+      9000,
+      false, /* is virtual */
+      false /* is state_sync disabled */);
+  Interface::Addresses addrs;
+  addrs.emplace(IPAddress("10.0.0.1"), 16);
+  intf->setAddresses(addrs);
+  state->addIntf(intf);
+  vlan->setInterfaceID(InterfaceID(1));
+  return state;
+}
+
+MacAddress hostMac(int host) {
+  return MacAddress::fromHBO(0x020000000000 + host);
+}
+
+/*
+ * Learn kNumHosts MACs spread evenly across kNumPorts ports in a single
+ * state update. LookupClassUpdater assigns a classID to each of them.
+ */
+void learnHosts(SwSwitch* sw) {
+  sw->updateStateBlocking(
+      "learn hosts", [](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto vlan = newState->getVlans()->getVlan(kVlan).get();
+        auto macTable = vlan->getMacTable()->modify(&vlan, &newState);
+        for (int host = 0; host < kNumHosts; ++host) {
+          macTable->addEntry(make_shared<MacEntry>(
+              hostMac(host),
+              PortDescriptor(PortID(1 + host % kNumPorts))));
+        }
+        return newState;
+      });
+}
+
+void waitForClassIDs(SwSwitch* sw) {
+  auto state = waitForStateUpdates(sw);
+  for (const auto& entry :
+       *state->getVlans()->getVlan(kVlan)->getMacTable()) {
+    CHECK(entry->getClassID().has_value());
+  }
+}
+
+} // namespace
+
+BENCHMARK(LookupClassUpdaterLearnHosts) {
+  std::unique_ptr<HwTestHandle> handle;
+  BENCHMARK_SUSPEND {
+    handle = createTestHandle(lookupClassState());
+  }
+
+  learnHosts(handle->getSw());
+  waitForClassIDs(handle->getSw());
+
+  BENCHMARK_SUSPEND {
+    handle.reset();
+  }
+}
+
+BENCHMARK(LookupClassUpdaterReassignLookupClasses) {
+  std::unique_ptr<HwTestHandle> handle;
+  BENCHMARK_SUSPEND {
+    handle = createTestHandle(lookupClassState());
+    learnHosts(handle->getSw());
+    waitForClassIDs(handle->getSw());
+  }
+
+  // Changing the lookup classes of every port clears and reassigns classIDs
+  // for every host, like a port flap with queue-per-host enabled.
+  auto newLookupClasses = kLookupClasses;
+  newLookupClasses.pop_back();
+  handle->getSw()->updateStateBlocking(
+      "reassign lookup classes",
+      [&newLookupClasses](const shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto newPortMap = newState->getPorts()->modify(&newState);
+        for (auto port : *newPortMap) {
+          auto newPort = port->clone();
+          newPort->setLookupClassesToDistributeTrafficOn(newLookupClasses);
+          newPortMap->updatePort(newPort);
+        }
+        return newState;
+      });
+  waitForClassIDs(handle->getSw());
+
+  BENCHMARK_SUSPEND {
+    handle.reset();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -473,6 +473,65 @@ TYPED_TEST(LookupClassUpdaterTest, LookupClassesChange) {
   }
 }
 
+/*
+ * A lookup class change reassigns the classIDs of all the neighbors of a port
+ * in one batch. They must end up with the same classIDs and reference counts
+ * as when they were resolved, and got their classIDs, one at a time.
+ */
+TYPED_TEST(LookupClassUpdaterTest, BatchedUpdatesMatchPerEntryUpdates) {
+  // In ascending IP and MAC order, which is the order lookup class changes
+  // walk the neighbor and MAC tables in
+  const std::vector<std::pair<IPAddress, MacAddress>> hosts = {
+      {this->getIpAddress(), this->kMacAddress()},
+      {this->getIpAddress2(), this->kMacAddress2()},
+      {this->getIpAddress3(), MacAddress("01:02:03:04:05:08")}};
+  auto getClassID = [this](const IPAddress& ip, const MacAddress& mac) {
+    auto vlan = this->sw_->getState()->getVlans()->getVlan(this->kVlan());
+    if constexpr (std::is_same_v<TypeParam, folly::MacAddress>) {
+      return vlan->getMacTable()->getNode(mac)->getClassID();
+    } else if constexpr (std::is_same_v<TypeParam, folly::IPAddressV4>) {
+      return vlan->getArpTable()->getEntry(ip.asV4())->getClassID();
+    } else {
+      return vlan->getNdpTable()->getEntry(ip.asV6())->getClassID();
+    }
+  };
+  auto getClassIDsAndRefCnts = [this, &hosts, &getClassID]() {
+    auto lookupClassUpdater = this->sw_->getLookupClassUpdater();
+    std::vector<std::pair<std::optional<cfg::AclLookupClass>, int>> result;
+    for (const auto& [ip, mac] : hosts) {
+      auto classID = getClassID(ip, mac);
+      auto refCnt = classID.has_value()
+          ? lookupClassUpdater->getRefCnt(
+                this->kPortID(), mac, this->kVlan(), classID.value())
+          : 0;
+      result.emplace_back(classID, refCnt);
+    }
+    return result;
+  };
+
+  for (const auto& [ip, mac] : hosts) {
+    this->resolve(ip, mac);
+  }
+  auto perEntry = getClassIDsAndRefCnts();
+  EXPECT_EQ(
+      perEntry[0].first, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+  EXPECT_EQ(
+      perEntry[1].first, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1);
+  EXPECT_EQ(
+      perEntry[2].first, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_2);
+
+  auto lookupClasses = this->sw_->getState()
+                           ->getPorts()
+                           ->getPort(this->kPortID())
+                           ->getLookupClassesToDistributeTrafficOn();
+  this->updateLookupClasses({});
+  for (const auto& classIDAndRefCnt : getClassIDsAndRefCnts()) {
+    EXPECT_EQ(classIDAndRefCnt.first, std::nullopt);
+  }
+  this->updateLookupClasses(lookupClasses);
+  EXPECT_EQ(getClassIDsAndRefCnts(), perEntry);
+}
+
 TYPED_TEST(LookupClassUpdaterTest, MacMove) {
   if constexpr (!std::is_same_v<TypeParam, folly::MacAddress>) {
     return;
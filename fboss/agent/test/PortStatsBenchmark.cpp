@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "fboss/agent/PortStats.h"
+#include "fboss/agent/SwitchStats.h"
+
+using namespace facebook::fboss;
+
+/*
+ * Per packet port stats overhead of the CPU packet path on a 512 port
+ * switch: look up the stats of the port a packet was trapped on and count
+ * it, as SwSwitch::handlePacket() does for every packet.
+ */
+
+namespace {
+constexpr uint16_t kNumPorts = 512;
+
+std::string portName(uint16_t port) {
+  return folly::to<std::string>("eth", port / 4 + 1, "/", port % 4 + 1, "/1");
+}
+
+// Ports packets arrive on, in an order the branch predictor can't learn
+std::vector<PortID> rxPorts() {
+  std::vector<PortID> ports;
+  for (uint16_t i = 0; i < 4 * kNumPorts; ++i) {
+    ports.emplace_back(i % kNumPorts + 1);
+  }
+  std::shuffle(ports.begin(), ports.end(), std::mt19937(0));
+  return ports;
+}
+} // namespace
+
+BENCHMARK(PortStatsMapLookup, n) {
+  std::unique_ptr<SwitchStats> stats;
+  PortStatsMap ports;
+  std::vector<PortID> rx;
+  BENCHMARK_SUSPEND {
+    stats = std::make_unique<SwitchStats>();
+    for (uint16_t i = 1; i <= kNumPorts; ++i) {
+      auto portStats =
+          std::make_unique<PortStats>(PortID(i), portName(i), stats.get());
+      ports.emplace(PortID(i), std::move(portStats));
+    }
+    rx = rxPorts();
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    auto it = ports.find(rx[i % rx.size()]);
+    it->second->trappedPkt();
+  }
+}
+
+BENCHMARK_RELATIVE(PortStatsDenseLookup, n) {
+  std::unique_ptr<SwitchStats> stats;
+  std::vector<PortID> rx;
+  BENCHMARK_SUSPEND {
+    stats = std::make_unique<SwitchStats>();
+    for (uint16_t i = 1; i <= kNumPorts; ++i) {
+      stats->createPortStats(PortID(i), portName(i));
+    }
+    rx = rxPorts();
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    stats->port(rx[i % rx.size()])->trappedPkt();
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+/*
+ * The counters a trapped ARP request updates, on top of the lookup
+ */
+BENCHMARK(PortStatsArpRequest, n) {
+  std::unique_ptr<SwitchStats> stats;
+  std::vector<PortID> rx;
+  BENCHMARK_SUSPEND {
+    stats = std::make_unique<SwitchStats>();
+    for (uint16_t i = 1; i <= kNumPorts; ++i) {
+      stats->createPortStats(PortID(i), portName(i));
+    }
+    rx = rxPorts();
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    auto portStats = stats->port(rx[i % rx.size()]);
+    portStats->trappedPkt();
+    portStats->arpPkt();
+    portStats->arpRequestRx();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
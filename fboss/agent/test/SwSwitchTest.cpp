@@ -81,6 +81,21 @@ TEST_F(SwSwitchTest, GetPortStats) {
   EXPECT_EQ(sw->stats()->getPortStats()->size(), 2);
   EXPECT_EQ(portStats->getPortName(), "port0");
 }
+
+TEST_F(SwSwitchTest, DeletePortStats) {
+  auto portStats = sw->portStats(PortID(5));
+  EXPECT_EQ(sw->stats()->port(PortID(5)), portStats);
+  sw->stats()->deletePortStats(PortID(5));
+  EXPECT_EQ(sw->stats()->port(PortID(5)), nullptr);
+  EXPECT_EQ(sw->stats()->getPortStats()->size(), 0);
+
+  // Port IDs too large to be indexed densely are still found
+  portStats = sw->portStats(PortID(5000));
+  EXPECT_EQ(sw->stats()->port(PortID(5000)), portStats);
+  EXPECT_EQ(sw->stats()->port(PortID(4999)), nullptr);
+  sw->stats()->deletePortStats(PortID(5000));
+  EXPECT_EQ(sw->stats()->port(PortID(5000)), nullptr);
+}
 ACTION(ThrowException) {
   throw std::exception();
 }
@@ -161,6 +176,30 @@ TEST_F(SwSwitchTest, TestStateNonCoalescing) {
   verifyReachableCnt(0);
 }
 
+TEST_F(SwSwitchTest, RecentStateUpdates) {
+  auto noopUpdateFn = [](const std::shared_ptr<SwitchState>& /*state*/) {
+    return std::shared_ptr<SwitchState>();
+  };
+  sw->updateStateBlocking("test update", noopUpdateFn);
+  sw->updateStateBlocking(
+      StateUpdateDescriptor(
+          StateUpdateCategory::NEIGHBOR_ADD,
+          folly::IPAddress("10.0.0.2")),
+      noopUpdateFn);
+
+  auto updates = sw->getRecentStateUpdates();
+  ASSERT_GE(updates.size(), 2);
+  const auto& stringUpdate = updates[updates.size() - 2];
+  EXPECT_EQ(*stringUpdate.name_ref(), "test update");
+  EXPECT_EQ(*stringUpdate.category_ref(), "other");
+  const auto& neighborUpdate = updates.back();
+  EXPECT_EQ(*neighborUpdate.name_ref(), "neighbor_add 10.0.0.2");
+  EXPECT_EQ(*neighborUpdate.category_ref(), "neighbor_add");
+  EXPECT_GE(*neighborUpdate.latencyUs_ref(), 0);
+  EXPECT_GE(
+      *neighborUpdate.appliedTimeMs_ref(), *stringUpdate.appliedTimeMs_ref());
+}
+
 TEST_F(SwSwitchTest, VerifyIsValidStateUpdate) {
   ON_CALL(*getMockHw(sw), isValidStateUpdate(_))
       .WillByDefault(testing::Return(true));
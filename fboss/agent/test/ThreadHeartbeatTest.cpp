@@ -60,3 +60,55 @@ TEST(ThreadHeartbeatTest, WatchDogTest) {
   testEvb.runInEventBaseThread([&testEvb] { testEvb.terminateLoopSoon(); });
   testThread.join();
 }
+
+TEST(ThreadHeartbeatTest, StallCaptureTest) {
+  folly::EventBase testEvb;
+  std::thread testThread([&testEvb]() {
+    folly::setThreadName("testThread");
+    testEvb.loopForever();
+  });
+  std::atomic_int misses = 0;
+  auto testHb = std::make_shared<ThreadHeartbeat>(
+      &testEvb,
+      "testThread",
+      heartbeatInterval,
+      [](int /*delay*/, int /*backLog*/) {},
+      []() { return std::string("blockingUpdate"); });
+  ThreadHeartbeatWatchdog testWd(
+      std::chrono::milliseconds(heartbeatInterval * 10),
+      [&misses]() { misses++; });
+  testWd.enableStallCapture(2);
+  testWd.startMonitoringHeartbeat(testHb);
+  testWd.start();
+
+  sleep(1.0);
+  EXPECT_TRUE(testWd.getRecentStalls().empty());
+  // Captures are only claimed by the signal handler on this thread
+  pid_t evbTid = 0;
+  testEvb.runInEventBaseThreadAndWait(
+      [&evbTid]() { evbTid = static_cast<pid_t>(syscall(SYS_gettid)); });
+  EXPECT_EQ(testHb->getThreadTid(), evbTid);
+
+  // Block the evb long enough for several captures. The sleep is
+  // interrupted by the capture signal, but resumes afterwards.
+  testEvb.runInEventBaseThreadAndWait([]() {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(heartbeatInterval * 50));
+  });
+  testWd.stop();
+
+  EXPECT_GE(misses, 2);
+  auto stalls = testWd.getRecentStalls();
+  // Only the last 2 are kept
+  ASSERT_EQ(stalls.size(), 2);
+  for (const auto& stall : stalls) {
+    EXPECT_EQ(*stall.threadName_ref(), "testThread");
+    EXPECT_EQ(*stall.context_ref(), "blockingUpdate");
+    EXPECT_GE(*stall.sinceHeartbeatMs_ref(), heartbeatInterval * 5);
+    EXPECT_FALSE(stall.stack_ref()->empty());
+  }
+
+  testHb.reset();
+  testEvb.runInEventBaseThread([&testEvb] { testEvb.terminateLoopSoon(); });
+  testThread.join();
+}
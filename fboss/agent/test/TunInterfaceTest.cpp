@@ -10,11 +10,32 @@
 
 #include <gtest/gtest.h>
 
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <folly/Synchronized.h>
+#include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
 
+#include <linux/if.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/TunIntf.h"
+#include "fboss/agent/TxPacket.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/hw/mock/MockHwSwitch.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/packet/EthHdr.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/MockTunManager.h"
 #include "fboss/agent/test/TestUtils.h"
@@ -22,6 +43,81 @@
 using namespace facebook::fboss;
 
 using ::testing::_;
+using ::testing::Invoke;
+
+namespace {
+void setIntfUp(const std::string& name) {
+  auto sock = socket(PF_INET, SOCK_DGRAM, 0);
+  sysCheckError(sock, "Failed to open socket");
+  SCOPE_EXIT {
+    close(sock);
+  };
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  memmove(
+      ifr.ifr_name, name.c_str(), std::min(name.size(), sizeof(ifr.ifr_name)));
+  sysCheckError(ioctl(sock, SIOCGIFFLAGS, &ifr), "Failed to get flags");
+  ifr.ifr_flags |= IFF_UP;
+  sysCheckError(ioctl(sock, SIOCSIFFLAGS, &ifr), "Failed to set flags");
+}
+
+void setKernelIntfMtu(const std::string& name, int mtu) {
+  auto sock = socket(PF_INET, SOCK_DGRAM, 0);
+  sysCheckError(sock, "Failed to open socket");
+  SCOPE_EXIT {
+    close(sock);
+  };
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  memmove(
+      ifr.ifr_name, name.c_str(), std::min(name.size(), sizeof(ifr.ifr_name)));
+  ifr.ifr_mtu = mtu;
+  sysCheckError(ioctl(sock, SIOCSIFMTU, &ifr), "Failed to set MTU");
+}
+
+/*
+ * Transmit an L3 packet on the tun interface from the host side, so that it
+ * is queued for the reader of the tun fd.
+ */
+void sendFromHost(const std::string& name, const std::vector<uint8_t>& pkt) {
+  auto sock = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+  sysCheckError(sock, "Failed to open packet socket");
+  SCOPE_EXIT {
+    close(sock);
+  };
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  memmove(
+      ifr.ifr_name, name.c_str(), std::min(name.size(), sizeof(ifr.ifr_name)));
+  sysCheckError(ioctl(sock, SIOCGIFINDEX, &ifr), "Failed to get ifindex");
+  struct sockaddr_ll addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_IP);
+  addr.sll_ifindex = ifr.ifr_ifindex;
+  auto ret = sendto(
+      sock,
+      pkt.data(),
+      pkt.size(),
+      0,
+      reinterpret_cast<struct sockaddr*>(&addr),
+      sizeof(addr));
+  sysCheckError(ret, "Failed to send packet on ", name);
+}
+
+// IPv4 packet of the given total length, to a multicast group so that
+// sendL3Packet() doesn't need to resolve the next hop
+std::vector<uint8_t> makeIpv4Packet(uint16_t length) {
+  std::vector<uint8_t> pkt(length, 0);
+  const uint8_t hdr[] = {
+      0x45, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+      0x00, 0x00, 0x0a, 0x00, 0x00, 0x01, 0xe0, 0x00, 0x00, 0x01};
+  memcpy(pkt.data(), hdr, sizeof(hdr));
+  pkt[2] = length >> 8;
+  pkt[3] = length & 0xff;
+  return pkt;
+}
+} // namespace
 
 TEST(TunInterfacesTest, Initialization) {
   auto sw = setupMockSwitchWithoutHW(
@@ -36,3 +132,100 @@ TEST(TunInterfacesTest, Initialization) {
   // event base. So wait for pending operations there to complete
   waitForBackgroundThread(sw.get());
 }
+
+TEST(TunInterfacesTest, SendPacketsToHost) {
+  auto sw = setupMockSwitchWithoutHW(
+      createMockPlatform(), nullptr, SwitchFlags::ENABLE_TUN);
+  std::unique_ptr<TunIntf> intf;
+  try {
+    intf = std::make_unique<TunIntf>(
+        sw.get(),
+        sw->getBackgroundEvb(),
+        InterfaceID(4000),
+        true /* status */,
+        Interface::Addresses{},
+        1500);
+    intf->setDelete();
+    setIntfUp(intf->getName());
+  } catch (const SysError& ex) {
+    GTEST_SKIP() << "Cannot create a tun interface: " << ex.what();
+  }
+
+  // Ethernet header, followed by an IPv4 header with a 4 byte payload
+  const std::string pktHex =
+      "02 00 01 00 00 01  02 00 02 00 00 01  08 00"
+      "45 00 00 18 00 00 40 00 40 11 00 00 0a 00 00 01 0a 00 00 02"
+      "00 00 00 00";
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(intf->sendPacketToHost(MockRxPacket::fromHex(pktHex)));
+  }
+  // Nothing left once the L2 header is stripped
+  EXPECT_FALSE(intf->sendPacketToHost(
+      MockRxPacket::fromHex("02 00 01 00 00 01  02 00 02 00 00 01  08 00")));
+
+  auto stats = intf->getStats();
+  EXPECT_EQ(stats.pktsToHost, 3);
+  EXPECT_EQ(stats.bytesToHost, 3 * 24);
+  EXPECT_EQ(stats.pktsToHostErrors, 1);
+  EXPECT_EQ(stats.pktsFromHost, 0);
+}
+
+TEST(TunInterfacesTest, ReadPacketsFromHost) {
+  auto handle = createTestHandle(testStateA());
+  auto sw = handle->getSw();
+  constexpr int kMtu = 1500;
+  std::unique_ptr<TunIntf> intf;
+  try {
+    intf = std::make_unique<TunIntf>(
+        sw,
+        sw->getBackgroundEvb(),
+        InterfaceID(1),
+        true /* status */,
+        Interface::Addresses{},
+        kMtu);
+    intf->setDelete();
+    // Keep the kernel from sending its own IPv6 packets on the interface
+    folly::writeFile(
+        std::string("1"),
+        folly::to<std::string>(
+            "/proc/sys/net/ipv6/conf/", intf->getName(), "/disable_ipv6")
+            .c_str());
+    // Let the host send packets larger than the MTU of the TunIntf, as if
+    // the MTUs were out of sync
+    setKernelIntfMtu(intf->getName(), 2 * kMtu);
+    setIntfUp(intf->getName());
+  } catch (const SysError& ex) {
+    GTEST_SKIP() << "Cannot create a tun interface: " << ex.what();
+  }
+
+  // L3 lengths of the IPv4 packets sendL3Packet() switched out
+  folly::Synchronized<std::vector<uint32_t>> l3Lengths;
+  EXPECT_HW_CALL(sw, sendPacketSwitchedAsync_(_))
+      .WillRepeatedly(Invoke([&l3Lengths](TxPacket* pkt) {
+        folly::io::Cursor c(pkt->buf());
+        c += EthHdr::SIZE - 2;
+        if (c.readBE<uint16_t>() == 0x0800) {
+          l3Lengths.wlock()->push_back(pkt->buf()->length() - EthHdr::SIZE);
+        }
+        return true;
+      }));
+
+  const std::vector<uint16_t> sizes = {100, kMtu, kMtu + 1, 2 * kMtu, 64};
+  for (auto size : sizes) {
+    sendFromHost(intf->getName(), makeIpv4Packet(size));
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  auto stats = intf->getStats();
+  while (stats.pktsFromHost + stats.pktsFromHostDropped < sizes.size() &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    stats = intf->getStats();
+  }
+  waitForBackgroundThread(sw);
+
+  EXPECT_EQ(stats.pktsFromHost, 3);
+  EXPECT_EQ(stats.bytesFromHost, 100 + kMtu + 64);
+  EXPECT_EQ(stats.pktsFromHostDropped, 2);
+  EXPECT_EQ(*l3Lengths.rlock(), std::vector<uint32_t>({100, kMtu, 64}));
+}
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/ScopeGuard.h>
+#include <folly/SocketAddress.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <arpa/inet.h>
+#include <linux/if.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+
+#include <array>
+#include <thread>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/TunIntf.h"
+#include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/test/TestUtils.h"
+
+using namespace facebook::fboss;
+
+/*
+ * Throughput of the packets between the switch and the host through a tun
+ * interface. Needs CAP_NET_ADMIN, and runs in its own network namespace so
+ * that it doesn't touch the interfaces of the host.
+ */
+
+namespace {
+constexpr auto kIntfAddr = "10.0.0.1";
+constexpr auto kPeerAddr = "10.0.0.2";
+constexpr auto kPayloadLen = 64;
+
+void setupIntf(const std::string& name) {
+  auto sock = socket(PF_INET, SOCK_DGRAM, 0);
+  sysCheckError(sock, "Failed to open socket");
+  SCOPE_EXIT {
+    close(sock);
+  };
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  memmove(
+      ifr.ifr_name, name.c_str(), std::min(name.size(), sizeof(ifr.ifr_name)));
+
+  auto addr = reinterpret_cast<sockaddr_in*>(&ifr.ifr_addr);
+  addr->sin_family = AF_INET;
+  inet_pton(AF_INET, kIntfAddr, &addr->sin_addr);
+  sysCheckError(ioctl(sock, SIOCSIFADDR, &ifr), "Failed to set address");
+  inet_pton(AF_INET, "255.255.255.0", &addr->sin_addr);
+  sysCheckError(ioctl(sock, SIOCSIFNETMASK, &ifr), "Failed to set netmask");
+
+  sysCheckError(ioctl(sock, SIOCGIFFLAGS, &ifr), "Failed to get flags");
+  ifr.ifr_flags |= IFF_UP;
+  sysCheckError(ioctl(sock, SIOCSIFFLAGS, &ifr), "Failed to set flags");
+}
+
+struct TunSetup {
+  TunSetup() {
+    sw = setupMockSwitchWithoutHW(
+        createMockPlatform(), nullptr, SwitchFlags::ENABLE_TUN);
+    intf = std::make_unique<TunIntf>(
+        sw.get(),
+        sw->getBackgroundEvb(),
+        InterfaceID(1),
+        true /* status */,
+        Interface::Addresses{},
+        1500);
+    intf->setDelete();
+    setupIntf(intf->getName());
+  }
+
+  std::unique_ptr<SwSwitch> sw;
+  std::unique_ptr<TunIntf> intf;
+};
+} // namespace
+
+/*
+ * One iteration is an IPv4 packet written to the host
+ */
+BENCHMARK(TunSendToHost, n) {
+  std::unique_ptr<TunSetup> setup;
+  std::unique_ptr<MockRxPacket> pkt;
+  BENCHMARK_SUSPEND {
+    setup = std::make_unique<TunSetup>();
+    // Ethernet header, then an IPv4 header and its payload
+    pkt = MockRxPacket::fromHex(
+        "02 00 01 00 00 01  02 00 02 00 00 01  08 00"
+        "45 00 00 54 00 00 40 00 40 11 00 00 0a 00 00 02 0a 00 00 01");
+    pkt->padToLength(14 + 20 + kPayloadLen);
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    std::unique_ptr<MockRxPacket> copy;
+    BENCHMARK_SUSPEND {
+      copy = pkt->clone();
+    }
+    setup->intf->sendPacketToHost(std::move(copy));
+  }
+
+  BENCHMARK_SUSPEND {
+    setup.reset();
+  }
+}
+
+/*
+ * One iteration is a UDP datagram sent by the host, read from the tun
+ * interface and handed to the switch
+ */
+BENCHMARK(TunReadFromHost, n) {
+  std::unique_ptr<TunSetup> setup;
+  int sock = -1;
+  folly::SocketAddress peer(kPeerAddr, 4000);
+  sockaddr_storage peerStorage;
+  BENCHMARK_SUSPEND {
+    setup = std::make_unique<TunSetup>();
+    sock = socket(PF_INET, SOCK_DGRAM, 0);
+    sysCheckError(sock, "Failed to open socket");
+    peer.getAddress(&peerStorage);
+    setup->sw->getBackgroundEvb()->runInEventBaseThreadAndWait(
+        [&] { setup->intf->start(); });
+  }
+
+  std::array<char, kPayloadLen> payload{};
+  size_t sent = 0;
+  for (size_t i = 0; i < n; i++) {
+    // The host drops what doesn't fit in the tun queue, so pace the sender
+    while (sent - setup->intf->getStats().pktsFromHost > 256) {
+      std::this_thread::yield();
+    }
+    sent += sendto(
+                sock,
+                payload.data(),
+                payload.size(),
+                0,
+                reinterpret_cast<sockaddr*>(&peerStorage),
+                peer.getActualSize()) > 0;
+  }
+  while (setup->intf->getStats().pktsFromHost < sent) {
+    std::this_thread::yield();
+  }
+
+  BENCHMARK_SUSPEND {
+    setup->sw->getBackgroundEvb()->runInEventBaseThreadAndWait(
+        [&] { setup->intf->stop(); });
+    close(sock);
+    setup.reset();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (unshare(CLONE_NEWNET) != 0) {
+    XLOG(ERR) << "Failed to create a network namespace: "
+              << folly::errnoStr(errno);
+    return 1;
+  }
+  folly::runBenchmarks();
+  return 0;
+}
@@ -12,14 +12,31 @@
 
 #include <folly/logging/xlog.h>
 
+#include <fb303/ServiceData.h>
+#include <folly/Bits.h>
+#include <folly/Conv.h>
 #include <folly/Format.h>
 #include <folly/Singleton.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
 #include <folly/system/ThreadName.h>
 #include <gflags/gflags.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <sstream>
 #include <thread>
 
 DEFINE_bool(enable_call_timing, false, "Enable call time reporting");
+DEFINE_bool(
+    enable_phase_timing,
+    true,
+    "Record the latency histograms and update breakdowns of hot path phases");
+DEFINE_int32(
+    update_breakdown_history,
+    64,
+    "Number of update phase breakdowns kept for getRecentUpdateBreakdowns");
 
 namespace {
 
@@ -27,6 +44,7 @@ struct singleton_tag_type {};
 } // namespace
 
 using facebook::fboss::FunctionCallTimeReporter;
+using facebook::fboss::ScopedUpdateTimer;
 static folly::Singleton<FunctionCallTimeReporter, singleton_tag_type>
     functionCallTimeReporterSingleton;
 
@@ -35,6 +53,91 @@ FunctionCallTimeReporter::getInstance() {
   return functionCallTimeReporterSingleton.try_get();
 }
 
+namespace {
+using std::chrono::microseconds;
+
+// Bucket i counts the phases which took [2^i, 2^(i+1)) usecs, bucket 0 also
+// has the ones under 1us
+constexpr size_t kNumBuckets = 32;
+using BucketCounts = std::array<uint64_t, kNumBuckets>;
+// Indexed by PhaseID
+using PhaseCounts = std::vector<BucketCounts>;
+
+// Histograms of the phases of a thread. Only the thread itself writes to
+// them, the atomics let publishPhaseStats() read them without a lock.
+struct PhaseHistograms {
+  ~PhaseHistograms();
+
+  std::array<
+      std::array<std::atomic<uint64_t>, kNumBuckets>,
+      FunctionCallTimeReporter::kMaxPhases>
+      counts{};
+};
+
+struct PhaseTag {};
+
+// A breakdown whose name is only built when it's read
+struct RecordedUpdate {
+  ScopedUpdateTimer::NameFn name;
+  FunctionCallTimeReporter::UpdateBreakdown breakdown;
+};
+
+// The phase state outlives any thread using it, so it's never destroyed
+struct PhaseState {
+  folly::Synchronized<std::vector<std::string>> names;
+  // Strict, so that a thread exits either before or after an
+  // accessAllThreads(), not while its counts are being retired
+  folly::ThreadLocal<PhaseHistograms, PhaseTag, folly::AccessModeStrict>
+      histograms;
+  // Counts of the threads which exited
+  folly::Synchronized<PhaseCounts> retiredCounts{
+      PhaseCounts(FunctionCallTimeReporter::kMaxPhases)};
+  // Totals at the last publishes, to export the percentiles of a window
+  folly::Synchronized<std::deque<PhaseCounts>> publishedCounts;
+  folly::Synchronized<std::deque<RecordedUpdate>> breakdowns;
+};
+
+// An update being run, with the IDs of its phases
+struct UpdateInProgress {
+  RecordedUpdate update;
+  std::vector<FunctionCallTimeReporter::PhaseID> phaseIds;
+};
+
+PhaseState& phaseState() {
+  static auto* state = new PhaseState();
+  return *state;
+}
+
+PhaseHistograms::~PhaseHistograms() {
+  auto retiredCounts = phaseState().retiredCounts.wlock();
+  for (size_t phase = 0; phase < retiredCounts->size(); phase++) {
+    for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+      (*retiredCounts)[phase][bucket] +=
+          counts[phase][bucket].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// The update this thread is running, if any
+thread_local UpdateInProgress* currentUpdate{nullptr};
+
+// Upper bound of the bucket of the given percentile
+int64_t getPercentile(
+    const BucketCounts& counts,
+    uint64_t total,
+    double percentile) {
+  uint64_t rank = std::max<uint64_t>(1, total * percentile / 100);
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+    seen += counts[bucket];
+    if (seen >= rank) {
+      return int64_t(1) << (bucket + 1);
+    }
+  }
+  return int64_t(1) << kNumBuckets;
+}
+} // namespace
+
 namespace facebook::fboss {
 
 thread_local FunctionCallTimeReporter::CallTimeTracker
@@ -70,6 +173,108 @@ void FunctionCallTimeReporter::end() {
   isOn_ = false;
 }
 
+// static
+FunctionCallTimeReporter::PhaseID FunctionCallTimeReporter::registerPhase(
+    folly::StringPiece name) {
+  auto names = phaseState().names.wlock();
+  for (PhaseID phase = 0; phase < names->size(); phase++) {
+    if ((*names)[phase] == name) {
+      return phase;
+    }
+  }
+  CHECK_LT(names->size(), kMaxPhases) << "Too many phases to add " << name;
+  names->push_back(name.str());
+  return names->size() - 1;
+}
+
+// static
+void FunctionCallTimeReporter::recordPhase(
+    PhaseID phase,
+    microseconds duration) {
+  auto usecs = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 1));
+  auto bucket = std::min<size_t>(folly::findLastSet(usecs) - 1, kNumBuckets - 1);
+  auto& count = phaseState().histograms->counts[phase][bucket];
+  count.store(
+      count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  if (currentUpdate) {
+    auto& phaseIds = currentUpdate->phaseIds;
+    auto& phases = currentUpdate->update.breakdown.phases;
+    auto idx = std::find(phaseIds.begin(), phaseIds.end(), phase) -
+        phaseIds.begin();
+    if (idx == phaseIds.size()) {
+      phaseIds.push_back(phase);
+      phases.push_back(PhaseTime{phaseState().names.rlock()->at(phase)});
+    }
+    phases[idx].duration += duration;
+    phases[idx].calls++;
+  }
+}
+
+// static
+void FunctionCallTimeReporter::publishPhaseStats() {
+  auto& state = phaseState();
+  PhaseCounts totals;
+  {
+    // Threads can't exit while the accessor is held, so each count is
+    // either in retiredCounts or in a live thread
+    auto accessor = state.histograms.accessAllThreads();
+    totals = *state.retiredCounts.rlock();
+    for (const auto& histograms : accessor) {
+      for (size_t phase = 0; phase < kMaxPhases; phase++) {
+        for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+          totals[phase][bucket] +=
+              histograms.counts[phase][bucket].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  // Only keep the registered phases in the window
+  auto names = *state.names.rlock();
+  totals.resize(names.size());
+  PhaseCounts windowStart;
+  {
+    auto publishedCounts = state.publishedCounts.wlock();
+    if (!publishedCounts->empty()) {
+      windowStart = publishedCounts->front();
+    }
+    publishedCounts->push_back(totals);
+    if (publishedCounts->size() > kPhaseStatsWindow) {
+      publishedCounts->pop_front();
+    }
+  }
+  windowStart.resize(names.size());
+
+  for (size_t phase = 0; phase < names.size(); phase++) {
+    BucketCounts window;
+    uint64_t calls = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+      window[bucket] = totals[phase][bucket] - windowStart[phase][bucket];
+      calls += window[bucket];
+    }
+    auto prefix = folly::to<std::string>("phase.", names[phase]);
+    fb303::fbData->setCounter(prefix + ".calls", calls);
+    fb303::fbData->setCounter(
+        prefix + ".p50_us", calls ? getPercentile(window, calls, 50) : 0);
+    fb303::fbData->setCounter(
+        prefix + ".p99_us", calls ? getPercentile(window, calls, 99) : 0);
+  }
+}
+
+// static
+std::vector<FunctionCallTimeReporter::UpdateBreakdown>
+FunctionCallTimeReporter::getRecentUpdateBreakdowns(size_t count) {
+  auto breakdowns = phaseState().breakdowns.rlock();
+  auto start = breakdowns->size() > count ? breakdowns->size() - count : 0;
+  std::vector<UpdateBreakdown> recent;
+  for (auto it = breakdowns->begin() + start; it != breakdowns->end(); ++it) {
+    recent.push_back(it->breakdown);
+    recent.back().name = it->name();
+  }
+  return recent;
+}
+
 ScopedCallTimer::ScopedCallTimer() {
   if (FLAGS_enable_call_timing) {
     FunctionCallTimeReporter::getInstance()->start();
@@ -81,4 +286,36 @@ ScopedCallTimer::~ScopedCallTimer() {
   }
 }
 
+ScopedUpdateTimer::ScopedUpdateTimer(NameFn name) {
+  if (!FLAGS_enable_phase_timing || currentUpdate) {
+    return;
+  }
+  isOn_ = true;
+  startTime_ = std::chrono::steady_clock::now();
+  currentUpdate = new UpdateInProgress();
+  currentUpdate->update.name = std::move(name);
+  currentUpdate->update.breakdown.startTime = std::chrono::system_clock::now();
+}
+
+ScopedUpdateTimer::ScopedUpdateTimer(folly::StringPiece name)
+    : ScopedUpdateTimer(NameFn([name = name.str()] { return name; })) {}
+
+ScopedUpdateTimer::~ScopedUpdateTimer() {
+  if (!isOn_) {
+    return;
+  }
+  std::unique_ptr<UpdateInProgress> update(currentUpdate);
+  currentUpdate = nullptr;
+  update->update.breakdown.duration =
+      std::chrono::duration_cast<microseconds>(
+          std::chrono::steady_clock::now() - startTime_);
+
+  size_t historySize = std::max(FLAGS_update_breakdown_history, 0);
+  auto breakdowns = phaseState().breakdowns.wlock();
+  breakdowns->push_back(std::move(update->update));
+  while (breakdowns->size() > historySize) {
+    breakdowns->pop_front();
+  }
+}
+
 } // namespace facebook::fboss
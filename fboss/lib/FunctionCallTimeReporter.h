@@ -12,10 +12,18 @@
 
 #include <memory>
 
+#include <folly/Function.h>
+#include <folly/Preprocessor.h>
+#include <folly/Range.h>
 #include <folly/ScopeGuard.h>
 #include <folly/Singleton.h>
+#include <gflags/gflags.h>
 
 #include <chrono>
+#include <string>
+#include <vector>
+
+DECLARE_bool(enable_phase_timing);
 
 namespace facebook::fboss {
 
@@ -39,6 +47,44 @@ class FunctionCallTimeReporter {
     }
   }
 
+  /*
+   * Phases of the hot paths, e.g. RIB resolution, the HW programming done by
+   * a manager or observer notification. Unlike call timing, phase timing is
+   * cheap enough to always be on.
+   *
+   * Every thread records the times of its phases into its own log2
+   * histograms, which only it writes to. publishPhaseStats() merges the
+   * histograms of all threads and exports the percentiles of the last
+   * kPhaseStatsWindow publishes to fb303.
+   *
+   * The phases run by a thread within a ScopedUpdateTimer are also added to
+   * the breakdown of that update. The last --update_breakdown_history
+   * breakdowns are kept.
+   */
+  using PhaseID = uint32_t;
+  static constexpr size_t kMaxPhases = 64;
+  static constexpr size_t kPhaseStatsWindow = 60;
+
+  struct PhaseTime {
+    std::string phase;
+    std::chrono::microseconds duration{0};
+    uint32_t calls{0};
+  };
+  struct UpdateBreakdown {
+    std::string name;
+    std::chrono::system_clock::time_point startTime;
+    std::chrono::microseconds duration{0};
+    // In the order the phases were first run
+    std::vector<PhaseTime> phases;
+  };
+
+  // Returns the same ID for the same name
+  static PhaseID registerPhase(folly::StringPiece name);
+  static void recordPhase(PhaseID phase, std::chrono::microseconds duration);
+  static void publishPhaseStats();
+  // The last count breakdowns, oldest first
+  static std::vector<UpdateBreakdown> getRecentUpdateBreakdowns(size_t count);
+
  private:
   struct CallTimeTracker {
     ~CallTimeTracker();
@@ -79,4 +125,56 @@ class ScopedCallTimer {
   ScopedCallTimer(const ScopedCallTimer&) = delete;
   ScopedCallTimer& operator=(const ScopedCallTimer&) = delete;
 };
+
+class ScopedPhaseTimer {
+ public:
+  explicit ScopedPhaseTimer(FunctionCallTimeReporter::PhaseID phase)
+      : phase_(phase), isOn_(FLAGS_enable_phase_timing) {
+    if (isOn_) {
+      startTime_ = std::chrono::steady_clock::now();
+    }
+  }
+  ~ScopedPhaseTimer() {
+    if (isOn_) {
+      FunctionCallTimeReporter::recordPhase(
+          phase_,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - startTime_));
+    }
+  }
+  ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+  ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+ private:
+  const FunctionCallTimeReporter::PhaseID phase_;
+  const bool isOn_;
+  std::chrono::steady_clock::time_point startTime_;
+};
+
+/*
+ * Collect the phases run by this thread until the end of the scope into one
+ * update breakdown. Nested update timers are part of the outer update.
+ */
+class ScopedUpdateTimer {
+ public:
+  // Only called when the breakdown is read
+  using NameFn = folly::Function<std::string() const>;
+  explicit ScopedUpdateTimer(NameFn name);
+  explicit ScopedUpdateTimer(folly::StringPiece name);
+  ~ScopedUpdateTimer();
+  ScopedUpdateTimer(const ScopedUpdateTimer&) = delete;
+  ScopedUpdateTimer& operator=(const ScopedUpdateTimer&) = delete;
+
+ private:
+  bool isOn_{false};
+  std::chrono::steady_clock::time_point startTime_;
+};
+
+#define TIME_PHASE_IMPL(name, phaseId)                              \
+  static const auto phaseId =                                       \
+      FunctionCallTimeReporter::registerPhase(name);                \
+  ScopedPhaseTimer FB_ANONYMOUS_VARIABLE(phaseTimer)(phaseId);
+
+// Time the rest of the scope as the phase name, a string literal
+#define TIME_PHASE(name) TIME_PHASE_IMPL(name, FB_ANONYMOUS_VARIABLE(phaseId))
 } // namespace facebook::fboss
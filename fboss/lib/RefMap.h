@@ -109,6 +109,19 @@ class RefMap {
     return map_.cend();
   }
 
+  // Move the object referenced under from to key to, without touching the
+  // object itself. Fails if from is not referenced or to already is.
+  bool rekey(const K& from, const K& to) {
+    auto vsp = ref(from);
+    if (!vsp || ref(to)) {
+      return false;
+    }
+    std::get_deleter<Deleter>(vsp)->key = to;
+    map_.erase(from);
+    map_[to] = vsp;
+    return true;
+  }
+
   long referenceCount(const K& k) const {
     auto iter = map_.find(k);
     if (iter == map_.cend() || iter->second.expired()) {
@@ -122,13 +135,21 @@ class RefMap {
   }
 
  private:
+  // Removes the object from the map when the last reference goes away. The
+  // key is kept here rather than captured so that rekey() can update it.
+  struct Deleter {
+    MapType& map;
+    K key;
+    void operator()(V* v) {
+      map.erase(key);
+      std::default_delete<V>()(v);
+    }
+  };
+
   template <typename... Args>
   std::shared_ptr<V> makeShared(const K& k, Args&&... args) {
-    auto del = [&m = map_, k](V* v) {
-      m.erase(k);
-      std::default_delete<V>()(v);
-    };
-    return std::shared_ptr<V>(new V{std::forward<Args>(args)...}, del);
+    return std::shared_ptr<V>(
+        new V{std::forward<Args>(args)...}, Deleter{map_, k});
   }
 
   template <typename... Args>
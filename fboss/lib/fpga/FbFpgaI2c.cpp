@@ -3,6 +3,7 @@
 #include "fboss/lib/fpga/FbFpgaI2c.h"
 
 #include "fboss/agent/Utils.h"
+#include "fboss/lib/fpga/FbFpgaI2cAsyncEngine.h"
 #include "fboss/lib/fpga/FbFpgaRegisters.h"
 
 #include <folly/CppAttributes.h>
@@ -14,6 +15,12 @@
 #include <algorithm>
 #include <thread>
 
+DEFINE_bool(
+    fpga_i2c_async_engine,
+    false,
+    "Issue FPGA I2C transactions through the shared async engine instead of "
+    "blocking the controller thread until each transaction completes");
+
 namespace {
 constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
 constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
@@ -48,26 +55,31 @@ FbFpgaI2c::FbFpgaI2c(
 }
 
 bool FbFpgaI2c::waitForResponse(size_t len) {
-  I2cRtcStatus rtcStatus(version_);
   uint32_t retries = 20;
 
   // Make the initial wait according to the length of read/write.
   usleep(100 * len);
 
-  readReg(rtcStatus);
-
-  while (!rtcStatus.dataUnion.desc0done && --retries) {
+  auto response = checkResponse();
+  while (!response.has_value() && --retries) {
     usleep(1000);
-    readReg(rtcStatus);
+    response = checkResponse();
   }
+  return response.value_or(false);
+}
+
+std::optional<bool> FbFpgaI2c::checkResponse() {
+  I2cRtcStatus rtcStatus(version_);
+  readReg(rtcStatus);
 
   if (rtcStatus.dataUnion.desc0error) {
     XLOG(DBG5) << "I2C read/write ops has error.";
-    rtcStatus.dataUnion.reg = 0xffffffff;
     return false;
   }
-
-  return rtcStatus.dataUnion.desc0done;
+  if (!rtcStatus.dataUnion.desc0done) {
+    return std::nullopt;
+  }
+  return true;
 }
 
 uint8_t
@@ -82,13 +94,22 @@ void FbFpgaI2c::read(
     uint8_t offset,
     folly::MutableByteRange buf,
     uint8_t i2cAddress) {
+  startRead(channel, offset, buf.size(), i2cAddress);
+  completeRead(buf, waitForResponse(buf.size()));
+}
+
+void FbFpgaI2c::startRead(
+    uint8_t channel,
+    uint8_t offset,
+    size_t len,
+    uint8_t i2cAddress) {
   I2cDescriptorLower descLower(version_);
   I2cDescriptorUpper descUpper(version_);
   descLower.dataUnion.reg = 0;
   descUpper.dataUnion.reg = 0;
 
   descLower.dataUnion.op = 1; // Read
-  descLower.dataUnion.len = buf.size();
+  descLower.dataUnion.len = len;
 
   descUpper.dataUnion.offset = offset;
   descUpper.dataUnion.channel = channel;
@@ -100,27 +121,28 @@ void FbFpgaI2c::read(
 
   // Increment the counter for I2C read tranbsaction issued
   incrReadTotal();
+}
 
-  uint32_t readBlockAddr =
-      getRegAddr(kFacebookFpgaRTCReadBlock, getRTCIOBlockSize());
-
-  if (!waitForResponse(descLower.dataUnion.len)) {
+void FbFpgaI2c::completeRead(folly::MutableByteRange buf, bool success) {
+  if (!success) {
     // Increment the counter for I2C read transaction failure and
     // throw error
     incrReadFailed();
 
     throw FbFpgaI2cError("I2C read failed.");
-  } else {
-    for (int bytesRead = 0; bytesRead < buf.size(); bytesRead += 4) {
-      uint32_t data = fpga_->read(readBlockAddr + bytesRead);
-      std::memcpy(
-          buf.begin() + bytesRead,
-          &data,
-          std::min(buf.size() - bytesRead, (size_t)4));
-    }
-    // Update the number of bytes read
-    incrReadBytes(buf.size());
   }
+
+  uint32_t readBlockAddr =
+      getRegAddr(kFacebookFpgaRTCReadBlock, getRTCIOBlockSize());
+  for (int bytesRead = 0; bytesRead < buf.size(); bytesRead += 4) {
+    uint32_t data = fpga_->read(readBlockAddr + bytesRead);
+    std::memcpy(
+        buf.begin() + bytesRead,
+        &data,
+        std::min(buf.size() - bytesRead, (size_t)4));
+  }
+  // Update the number of bytes read
+  incrReadBytes(buf.size());
 }
 
 void FbFpgaI2c::writeByte(
@@ -136,6 +158,15 @@ void FbFpgaI2c::write(
     uint8_t offset,
     folly::ByteRange buf,
     uint8_t i2cAddress) {
+  startWrite(channel, offset, buf, i2cAddress);
+  completeWrite(buf.size(), waitForResponse(buf.size()));
+}
+
+void FbFpgaI2c::startWrite(
+    uint8_t channel,
+    uint8_t offset,
+    folly::ByteRange buf,
+    uint8_t i2cAddress) {
   I2cDescriptorLower descLower(version_);
   I2cDescriptorUpper descUpper(version_);
   descLower.dataUnion.reg = 0;
@@ -166,8 +197,10 @@ void FbFpgaI2c::write(
 
   writeReg(descLower);
   writeReg(descUpper);
+}
 
-  if (!waitForResponse(descLower.dataUnion.len)) {
+void FbFpgaI2c::completeWrite(size_t len, bool success) {
+  if (!success) {
     // Increment the counter for I2c write transaction failure and
     // throw error
     incrWriteFailed();
@@ -175,7 +208,7 @@ void FbFpgaI2c::write(
     throw FbFpgaI2cError("I2C write failed.");
   }
   // Update the number of bytes write
-  incrWriteBytes(buf.size());
+  incrWriteBytes(len);
 }
 
 template <typename Register>
@@ -231,6 +264,9 @@ FbFpgaI2cController::FbFpgaI2cController(
       })) {
   pim_ = pim;
   rtc_ = rtcId;
+  if (FLAGS_fpga_i2c_async_engine) {
+    asyncEngine_ = FbFpgaI2cAsyncEngine::getSharedEngine();
+  }
 }
 
 FbFpgaI2cController::FbFpgaI2cController(
@@ -246,11 +282,18 @@ FbFpgaI2cController::FbFpgaI2cController(
       })) {
   pim_ = pim;
   rtc_ = rtcId;
+  if (FLAGS_fpga_i2c_async_engine) {
+    asyncEngine_ = FbFpgaI2cAsyncEngine::getSharedEngine();
+  }
 }
 
 FbFpgaI2cController::~FbFpgaI2cController() {
+  // Work on our thread may still wait on the engine, stop it first
   eventBase_->runInEventBaseThread([&] { eventBase_->terminateLoopSoon(); });
   thread_->join();
+  if (asyncEngine_) {
+    asyncEngine_->unregisterController(&syncedFbI2c_);
+  }
 }
 
 uint8_t FbFpgaI2cController::readByte(
@@ -264,7 +307,10 @@ uint8_t FbFpgaI2cController::readByte(
       rtc_,
       channel,
       offset);
-  if (eventBase_->isInEventBaseThread()) {
+  if (asyncEngine_) {
+    auto data = futureRead(channel, offset, 1, i2cAddress).get();
+    buf = data->data()[0];
+  } else if (eventBase_->isInEventBaseThread()) {
     buf = syncedFbI2c_.lock()->readByte(channel, offset, i2cAddress);
   } else {
     via(eventBase_.get())
@@ -287,7 +333,10 @@ void FbFpgaI2cController::read(
       rtc_,
       channel,
       offset);
-  if (eventBase_->isInEventBaseThread()) {
+  if (asyncEngine_) {
+    auto data = futureRead(channel, offset, buf.size(), i2cAddress).get();
+    std::memcpy(buf.begin(), data->data(), buf.size());
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->read(channel, offset, buf, i2cAddress);
   } else {
     via(eventBase_.get())
@@ -310,7 +359,9 @@ void FbFpgaI2cController::writeByte(
       channel,
       offset,
       val);
-  if (eventBase_->isInEventBaseThread()) {
+  if (asyncEngine_) {
+    futureWrite(channel, offset, folly::ByteRange(&val, 1), i2cAddress).get();
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->writeByte(channel, offset, val, i2cAddress);
   } else {
     via(eventBase_.get())
@@ -332,7 +383,9 @@ void FbFpgaI2cController::write(
       rtc_,
       channel,
       offset);
-  if (eventBase_->isInEventBaseThread()) {
+  if (asyncEngine_) {
+    futureWrite(channel, offset, buf, i2cAddress).get();
+  } else if (eventBase_->isInEventBaseThread()) {
     syncedFbI2c_.lock()->write(channel, offset, buf, i2cAddress);
   } else {
     via(eventBase_.get())
@@ -343,6 +396,50 @@ void FbFpgaI2cController::write(
   }
 }
 
+folly::SemiFuture<std::unique_ptr<folly::IOBuf>>
+FbFpgaI2cController::futureRead(
+    uint8_t channel,
+    uint8_t offset,
+    uint8_t len,
+    uint8_t i2cAddress) {
+  if (asyncEngine_) {
+    return asyncEngine_->read(&syncedFbI2c_, channel, offset, len, i2cAddress);
+  }
+  return via(eventBase_.get())
+      .thenValue([=](auto&&) mutable {
+        auto data = folly::IOBuf::create(len);
+        syncedFbI2c_.lock()->read(
+            channel,
+            offset,
+            folly::MutableByteRange(data->writableData(), len),
+            i2cAddress);
+        data->append(len);
+        return data;
+      })
+      .semi();
+}
+
+folly::SemiFuture<folly::Unit> FbFpgaI2cController::futureWrite(
+    uint8_t channel,
+    uint8_t offset,
+    folly::ByteRange buf,
+    uint8_t i2cAddress) {
+  if (asyncEngine_) {
+    return asyncEngine_->write(&syncedFbI2c_, channel, offset, buf, i2cAddress);
+  }
+  auto data = folly::IOBuf::copyBuffer(buf.data(), buf.size());
+  return via(eventBase_.get())
+      .thenValue([this, channel, offset, i2cAddress, data = std::move(data)](
+                     auto&&) mutable {
+        syncedFbI2c_.lock()->write(
+            channel,
+            offset,
+            folly::ByteRange(data->data(), data->length()),
+            i2cAddress);
+      })
+      .semi();
+}
+
 folly::EventBase* FbFpgaI2cController::getEventBase() {
   return eventBase_.get();
 }
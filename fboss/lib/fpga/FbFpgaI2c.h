@@ -8,12 +8,17 @@
 
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+#include <folly/io/IOBuf.h>
 #include <folly/io/async/EventBase.h>
 
 #include <stdint.h>
+#include <optional>
 #include <thread>
 
 namespace facebook::fboss {
+
+class FbFpgaI2cAsyncEngine;
 inline uint8_t getI2cControllerIdx(uint8_t port) {
   return port / 4;
 }
@@ -57,6 +62,28 @@ class FbFpgaI2c : public I2cController {
       folly::ByteRange buf,
       uint8_t i2cAddress = 0x50);
 
+  /*
+   * Split-phase versions of read()/write() for callers that don't want to
+   * block while the transaction is in flight (FbFpgaI2cAsyncEngine). Issue
+   * the descriptor with start*(), poll checkResponse() until it returns a
+   * value and hand that value to complete*(), which throws FbFpgaI2cError
+   * if the transaction failed. Only one transaction can be in flight.
+   */
+  void startRead(
+      uint8_t channel,
+      uint8_t offset,
+      size_t len,
+      uint8_t i2cAddress = 0x50);
+  void completeRead(folly::MutableByteRange buf, bool success);
+  void startWrite(
+      uint8_t channel,
+      uint8_t offset,
+      folly::ByteRange buf,
+      uint8_t i2cAddress = 0x50);
+  void completeWrite(size_t len, bool success);
+  // Return std::nullopt while the transaction is still in flight
+  std::optional<bool> checkResponse();
+
  private:
   bool waitForResponse(size_t len);
   uint32_t getRegAddr(uint32_t regBase, uint32_t regIncr);
@@ -111,6 +138,22 @@ class FbFpgaI2cController {
       folly::ByteRange buf,
       uint8_t i2cAddress = 0x50);
 
+  /*
+   * Non-blocking versions of read()/write(). With --fpga_i2c_async_engine
+   * the transaction is queued on the shared FbFpgaI2cAsyncEngine, otherwise
+   * it runs on this controller's EventBase thread.
+   */
+  folly::SemiFuture<std::unique_ptr<folly::IOBuf>> futureRead(
+      uint8_t channel,
+      uint8_t offset,
+      uint8_t len,
+      uint8_t i2cAddress = 0x50);
+  folly::SemiFuture<folly::Unit> futureWrite(
+      uint8_t channel,
+      uint8_t offset,
+      folly::ByteRange buf,
+      uint8_t i2cAddress = 0x50);
+
   folly::EventBase* getEventBase();
 
   /* Get the I2c transaction stats from this controller with the lock
@@ -121,8 +164,12 @@ class FbFpgaI2cController {
 
  private:
   folly::Synchronized<FbFpgaI2c, std::mutex> syncedFbI2c_;
+  // Even with the async engine every controller keeps its own thread, so
+  // that blocking callers of different controllers never wait on each other
   std::unique_ptr<folly::EventBase> eventBase_;
   std::unique_ptr<std::thread> thread_;
+  // Only set with --fpga_i2c_async_engine
+  std::shared_ptr<FbFpgaI2cAsyncEngine> asyncEngine_;
   uint32_t pim_;
   uint32_t rtc_;
 };
@@ -0,0 +1,233 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2cAsyncEngine.h"
+
+#include "fboss/agent/Utils.h"
+
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+
+namespace {
+// Roughly the time to clock one byte out on a 400KHz I2C bus
+constexpr auto kFirstPollPerByte = std::chrono::microseconds(25);
+constexpr auto kMinPollBackoff = std::chrono::microseconds(50);
+constexpr auto kMaxPollBackoff = std::chrono::microseconds(1000);
+// Same budget as FbFpgaI2c::waitForResponse() for the longest transaction
+constexpr auto kTransactionTimeout = std::chrono::milliseconds(25);
+} // unnamed namespace
+
+namespace facebook::fboss {
+
+FbFpgaI2cAsyncEngine::FbFpgaI2cAsyncEngine()
+    : poller_([this]() {
+        initThread("FbFpgaI2cAsync");
+        pollerLoop();
+      }) {}
+
+FbFpgaI2cAsyncEngine::~FbFpgaI2cAsyncEngine() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  poller_.join();
+}
+
+std::shared_ptr<FbFpgaI2cAsyncEngine> FbFpgaI2cAsyncEngine::getSharedEngine() {
+  static std::mutex mutex;
+  static std::weak_ptr<FbFpgaI2cAsyncEngine> sharedEngine;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto engine = sharedEngine.lock();
+  if (!engine) {
+    engine = std::make_shared<FbFpgaI2cAsyncEngine>();
+    sharedEngine = engine;
+  }
+  return engine;
+}
+
+void FbFpgaI2cAsyncEngine::unregisterController(SyncedFbFpgaI2c* i2c) {
+  std::unique_lock<std::mutex> guard(mutex_);
+  auto iter = controllers_.find(i2c);
+  if (iter == controllers_.end()) {
+    return;
+  }
+  auto& queue = iter->second;
+  queue.unregistering = true;
+  // Only the in-flight transaction, at the front, still reaches the device
+  auto pending = queue.transactions.begin() + (queue.inFlight ? 1 : 0);
+  for (auto txn = pending; txn != queue.transactions.end(); ++txn) {
+    failTransaction(*txn, FbFpgaI2cError("I2C controller is unregistered"));
+  }
+  queue.transactions.erase(pending, queue.transactions.end());
+  unregisterCv_.wait(guard, [&queue]() { return !queue.inFlight; });
+  controllers_.erase(iter);
+}
+
+folly::SemiFuture<std::unique_ptr<folly::IOBuf>> FbFpgaI2cAsyncEngine::read(
+    SyncedFbFpgaI2c* i2c,
+    uint8_t channel,
+    uint8_t offset,
+    uint8_t len,
+    uint8_t i2cAddress) {
+  Transaction txn;
+  txn.isRead = true;
+  txn.channel = channel;
+  txn.offset = offset;
+  txn.i2cAddress = i2cAddress;
+  txn.data = folly::IOBuf::create(len);
+  txn.len = len;
+  auto future = txn.readPromise.getSemiFuture();
+  enqueue(i2c, std::move(txn));
+  return future;
+}
+
+folly::SemiFuture<folly::Unit> FbFpgaI2cAsyncEngine::write(
+    SyncedFbFpgaI2c* i2c,
+    uint8_t channel,
+    uint8_t offset,
+    folly::ByteRange buf,
+    uint8_t i2cAddress) {
+  Transaction txn;
+  txn.isRead = false;
+  txn.channel = channel;
+  txn.offset = offset;
+  txn.i2cAddress = i2cAddress;
+  txn.data = folly::IOBuf::copyBuffer(buf.data(), buf.size());
+  txn.len = buf.size();
+  auto future = txn.writePromise.getSemiFuture();
+  enqueue(i2c, std::move(txn));
+  return future;
+}
+
+void FbFpgaI2cAsyncEngine::enqueue(SyncedFbFpgaI2c* i2c, Transaction txn) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (stop_) {
+      failTransaction(txn, FbFpgaI2cError("I2C async engine is stopped"));
+      return;
+    }
+    controllers_[i2c].transactions.push_back(std::move(txn));
+  }
+  cv_.notify_one();
+}
+
+void FbFpgaI2cAsyncEngine::pollerLoop() {
+  std::unique_lock<std::mutex> guard(mutex_);
+  while (!stop_) {
+    auto nextWakeup = std::chrono::steady_clock::time_point::max();
+    for (auto& [i2c, queue] : controllers_) {
+      // Keep every controller busy as long as it has queued transactions
+      while (true) {
+        if (!queue.inFlight) {
+          if (queue.transactions.empty()) {
+            break;
+          }
+          if (!issueLocked(i2c, queue)) {
+            continue;
+          }
+        }
+        if (std::chrono::steady_clock::now() < queue.nextPoll ||
+            !pollLocked(i2c, queue)) {
+          nextWakeup = std::min(nextWakeup, queue.nextPoll);
+          break;
+        }
+      }
+    }
+
+    if (nextWakeup == std::chrono::steady_clock::time_point::max()) {
+      cv_.wait(guard);
+    } else {
+      cv_.wait_until(guard, nextWakeup);
+    }
+  }
+
+  // Nobody will poll the remaining transactions anymore
+  for (auto& [i2c, queue] : controllers_) {
+    for (auto& txn : queue.transactions) {
+      failTransaction(txn, FbFpgaI2cError("I2C async engine is stopped"));
+    }
+    queue.transactions.clear();
+  }
+}
+
+bool FbFpgaI2cAsyncEngine::issueLocked(
+    SyncedFbFpgaI2c* i2c,
+    ControllerQueue& queue) {
+  auto& txn = queue.transactions.front();
+  try {
+    auto lockedI2c = i2c->lock();
+    if (txn.isRead) {
+      lockedI2c->startRead(txn.channel, txn.offset, txn.len, txn.i2cAddress);
+    } else {
+      lockedI2c->startWrite(
+          txn.channel,
+          txn.offset,
+          folly::ByteRange(txn.data->data(), txn.data->length()),
+          txn.i2cAddress);
+    }
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to issue I2C transaction: " << ex.what();
+    failTransaction(txn, FbFpgaI2cError(ex.what()));
+    queue.transactions.pop_front();
+    return false;
+  }
+
+  queue.inFlight = true;
+  queue.issueTime = std::chrono::steady_clock::now();
+  queue.nextPoll = queue.issueTime + kFirstPollPerByte * txn.len;
+  queue.backoff = kMinPollBackoff;
+  return true;
+}
+
+bool FbFpgaI2cAsyncEngine::pollLocked(
+    SyncedFbFpgaI2c* i2c,
+    ControllerQueue& queue) {
+  auto response = i2c->lock()->checkResponse();
+  auto now = std::chrono::steady_clock::now();
+  if (!response.has_value() && now - queue.issueTime < kTransactionTimeout) {
+    queue.nextPoll = now + queue.backoff;
+    queue.backoff = std::min(queue.backoff * 2, kMaxPollBackoff);
+    return false;
+  }
+
+  auto txn = std::move(queue.transactions.front());
+  queue.transactions.pop_front();
+  queue.inFlight = false;
+  if (queue.unregistering) {
+    unregisterCv_.notify_all();
+  }
+
+  // The promises are only fulfilled here, and SemiFuture callers decide which
+  // executor runs their continuation, so nothing runs inline on the poller.
+  try {
+    auto lockedI2c = i2c->lock();
+    if (txn.isRead) {
+      lockedI2c->completeRead(
+          folly::MutableByteRange(txn.data->writableData(), txn.len),
+          response.value_or(false));
+      txn.data->append(txn.len);
+      txn.readPromise.setValue(std::move(txn.data));
+    } else {
+      lockedI2c->completeWrite(txn.len, response.value_or(false));
+      txn.writePromise.setValue();
+    }
+  } catch (const FbFpgaI2cError& ex) {
+    failTransaction(txn, ex);
+  } catch (const std::exception& ex) {
+    failTransaction(txn, FbFpgaI2cError(ex.what()));
+  }
+  return true;
+}
+
+void FbFpgaI2cAsyncEngine::failTransaction(
+    Transaction& txn,
+    const FbFpgaI2cError& error) {
+  if (txn.isRead) {
+    txn.readPromise.setException(error);
+  } else {
+    txn.writePromise.setException(error);
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,114 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+#include <folly/io/IOBuf.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace facebook::fboss {
+
+/*
+ * FbFpgaI2cAsyncEngine issues FPGA I2C transactions without blocking the
+ * caller. Each controller (RTC) can only have one descriptor in flight, so
+ * transactions are queued per controller and a single poller thread issues
+ * them and polls the RTC status of every busy controller. The first poll of
+ * a transaction is scheduled from its length and later polls back off
+ * exponentially, which keeps the latency close to the actual transaction
+ * time instead of the fixed sleeps of FbFpgaI2c::read()/write().
+ *
+ * Once a controller is handed to the engine, all its transactions should go
+ * through the engine, as the engine doesn't hold the controller lock while a
+ * transaction is in flight. A controller must be unregistered before it is
+ * destroyed. Controllers still schedule their callers, such as transceiver
+ * refreshes, on their own EventBase thread, so the engine doesn't change
+ * which transactions run concurrently, only how each one is waited for.
+ */
+class FbFpgaI2cAsyncEngine {
+ public:
+  using SyncedFbFpgaI2c = folly::Synchronized<FbFpgaI2c, std::mutex>;
+
+  FbFpgaI2cAsyncEngine();
+  ~FbFpgaI2cAsyncEngine();
+
+  // The engine shared by all FbFpgaI2cControllers of this process. It stays
+  // alive as long as one of the returned pointers does.
+  static std::shared_ptr<FbFpgaI2cAsyncEngine> getSharedEngine();
+
+  // Fail the queued transactions of a controller and wait for the one in
+  // flight, after which the engine no longer touches the controller
+  void unregisterController(SyncedFbFpgaI2c* i2c);
+
+  folly::SemiFuture<std::unique_ptr<folly::IOBuf>> read(
+      SyncedFbFpgaI2c* i2c,
+      uint8_t channel,
+      uint8_t offset,
+      uint8_t len,
+      uint8_t i2cAddress = 0x50);
+
+  folly::SemiFuture<folly::Unit> write(
+      SyncedFbFpgaI2c* i2c,
+      uint8_t channel,
+      uint8_t offset,
+      folly::ByteRange buf,
+      uint8_t i2cAddress = 0x50);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  FbFpgaI2cAsyncEngine(FbFpgaI2cAsyncEngine const&) = delete;
+  FbFpgaI2cAsyncEngine& operator=(FbFpgaI2cAsyncEngine const&) = delete;
+
+  struct Transaction {
+    bool isRead{true};
+    uint8_t channel{0};
+    uint8_t offset{0};
+    uint8_t i2cAddress{0x50};
+    uint8_t len{0};
+    // Data to write, or the buffer to read into
+    std::unique_ptr<folly::IOBuf> data;
+    folly::Promise<std::unique_ptr<folly::IOBuf>> readPromise;
+    folly::Promise<folly::Unit> writePromise;
+  };
+
+  struct ControllerQueue {
+    std::deque<Transaction> transactions;
+    bool inFlight{false};
+    std::chrono::steady_clock::time_point issueTime;
+    std::chrono::steady_clock::time_point nextPoll;
+    std::chrono::microseconds backoff{0};
+    bool unregistering{false};
+  };
+
+  void enqueue(SyncedFbFpgaI2c* i2c, Transaction txn);
+  void pollerLoop();
+
+  // Issue the next transaction of an idle controller. Returns false if the
+  // transaction failed to start and was completed.
+  bool issueLocked(SyncedFbFpgaI2c* i2c, ControllerQueue& queue);
+  // Poll the in-flight transaction of a controller. Returns true if it's done
+  // and was completed.
+  bool pollLocked(SyncedFbFpgaI2c* i2c, ControllerQueue& queue);
+  static void failTransaction(Transaction& txn, const FbFpgaI2cError& error);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Signaled when the in-flight transaction of an unregistering controller
+  // completes
+  std::condition_variable unregisterCv_;
+  std::unordered_map<SyncedFbFpgaI2c*, ControllerQueue> controllers_;
+  bool stop_{false};
+  std::thread poller_;
+};
+
+} // namespace facebook::fboss
@@ -45,17 +45,29 @@ bool FbFpgaPimQsfpController::isQsfpPresent(int qsfp) {
 }
 
 std::vector<bool> FbFpgaPimQsfpController::scanQsfpPresence() {
+  uint32_t qsfpPresentReg = getQsfpPresenceBitmap();
+  std::vector<bool> qsfpPresence;
+  for (int i = 0; i < portsPerPim_; i++) {
+    qsfpPresence.push_back((qsfpPresentReg >> i) & 1);
+  }
+  return qsfpPresence;
+}
+
+uint32_t FbFpgaPimQsfpController::getQsfpPresenceBitmap() {
   folly::SharedMutex::ReadHolder g(getMutex(kFacebookFpgaQsfpPresentRegOffset));
   uint32_t qsfpPresentReg =
       memoryRegion_->read(kFacebookFpgaQsfpPresentRegOffset);
   // From the lower end, each bit of this register represent the presence of a
   // QSFP.
   XLOG(DBG5) << folly::format("qsfpPresentReg value:{:#x}", qsfpPresentReg);
-  std::vector<bool> qsfpPresence;
-  for (int i = 0; i < portsPerPim_; i++) {
-    qsfpPresence.push_back((qsfpPresentReg >> i) & 1);
-  }
-  return qsfpPresence;
+  return qsfpPresentReg & ((1ULL << portsPerPim_) - 1);
+}
+
+uint32_t FbFpgaPimQsfpController::getQsfpResetBitmap() {
+  folly::SharedMutex::ReadHolder g(getMutex(kFacebookFpgaQsfpResetRegOffset));
+  uint32_t qsfpResetReg = memoryRegion_->read(kFacebookFpgaQsfpResetRegOffset);
+  XLOG(DBG5) << folly::format("qsfpResetReg value:{:#x}", qsfpResetReg);
+  return qsfpResetReg & ((1ULL << portsPerPim_) - 1);
 }
 
 // Trigger the QSFP hard reset for a given QSFP module.
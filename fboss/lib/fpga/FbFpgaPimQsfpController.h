@@ -19,6 +19,11 @@ class FbFpgaPimQsfpController {
 
   std::vector<bool> scanQsfpPresence();
 
+  // The presence and reset state of all the QSFPs of the PIM, each read with
+  // one register access. Bit i is set when QSFP i is present or held in reset.
+  uint32_t getQsfpPresenceBitmap();
+  uint32_t getQsfpResetBitmap();
+
   // Trigger the QSFP hard reset for a given QSFP module.
   void triggerQsfpHardReset(unsigned int port);
 
@@ -0,0 +1,44 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FpgaDevice.h"
+#include "fboss/lib/test/FakePhysicalMemory.h"
+
+#include <atomic>
+
+namespace facebook::fboss {
+
+/*
+ * FpgaDevice backed by plain FakePhysicalMemory, which counts the register
+ * reads so that tests can check how many accesses a scan takes.
+ */
+class FakeFpgaDevice : public FpgaDevice {
+ public:
+  FakeFpgaDevice(uint32_t fpgaBar0, uint32_t fpgaBar0Size)
+      : FpgaDevice(fpgaBar0, fpgaBar0Size),
+        mem_(fpgaBar0, fpgaBar0Size, false) {
+    mem_.mmap();
+  }
+
+  void mmap() override {}
+
+  uint32_t read(uint32_t offset) const override {
+    numReads_++;
+    return mem_.read(offset);
+  }
+
+  void write(uint32_t offset, uint32_t value) override {
+    mem_.write(offset, value);
+  }
+
+  uint64_t getNumReads() const {
+    return numReads_;
+  }
+
+ private:
+  mutable FakePhysicalMemory32 mem_;
+  mutable std::atomic<uint64_t> numReads_{0};
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,154 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+#include "fboss/lib/fpga/FpgaDevice.h"
+#include "fboss/lib/test/FakePhysicalMemory.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace facebook::fboss {
+
+/*
+ * FpgaDevice backed by FakePhysicalMemory which emulates the RTC I2C
+ * controllers of a version 0 FbFpga. Writing a valid upper descriptor starts
+ * a transaction which completes perByteTime * len later, or as soon as the
+ * status register is read when perByteTime is 0. Every channel of every RTC
+ * is backed by a 256 byte fake eeprom.
+ */
+class FakeFpgaI2cDevice : public FpgaDevice {
+ public:
+  static constexpr uint32_t kRtcWriteBlock = 0x2000;
+  static constexpr uint32_t kRtcReadBlock = 0x3000;
+  static constexpr uint32_t kRtcIOBlockSize = 0x200;
+  static constexpr int kMaxRtcs = 8;
+  static constexpr int kNumChannels = 4;
+
+  FakeFpgaI2cDevice(
+      uint32_t fpgaBar0,
+      uint32_t fpgaBar0Size,
+      std::chrono::microseconds perByteTime = std::chrono::microseconds(0))
+      : FpgaDevice(fpgaBar0, fpgaBar0Size),
+        mem_(fpgaBar0, fpgaBar0Size, false),
+        perByteTime_(perByteTime) {
+    mem_.mmap();
+  }
+
+  void mmap() override {}
+
+  uint32_t read(uint32_t offset) const override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (auto rtc = statusRegRtc(offset)) {
+      maybeCompleteLocked(*rtc);
+    }
+    return mem_.read(offset);
+  }
+
+  void write(uint32_t offset, uint32_t value) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    mem_.write(offset, value);
+    if (auto rtc = descUpperRegRtc(offset)) {
+      I2cDescriptorUpperDataUnion upper;
+      upper.reg = value;
+      if (upper.valid) {
+        startLocked(*rtc, upper);
+      }
+    }
+  }
+
+  // Fail the next transaction issued on the rtc
+  void failNextTransaction(int rtc) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    failNext_[rtc] = true;
+  }
+
+  uint8_t eepromByte(int rtc, int channel, uint8_t offset) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return eeproms_[rtc][channel][offset];
+  }
+
+ private:
+  struct Transaction {
+    I2cDescriptorLowerDataUnion lower;
+    I2cDescriptorUpperDataUnion upper;
+    std::chrono::steady_clock::time_point completeAt;
+    bool fail{false};
+  };
+
+  static std::optional<int> descUpperRegRtc(uint32_t offset) {
+    if (offset < 0x500 || offset >= 0x600 || (offset - 0x500) % 0x20 != 4) {
+      return std::nullopt;
+    }
+    return (offset - 0x504) / 0x20;
+  }
+
+  static std::optional<int> statusRegRtc(uint32_t offset) {
+    if (offset < 0x600 || offset >= 0x600 + 4 * kMaxRtcs) {
+      return std::nullopt;
+    }
+    return (offset - 0x600) / 4;
+  }
+
+  void startLocked(int rtc, I2cDescriptorUpperDataUnion upper) {
+    Transaction txn;
+    txn.lower.reg = mem_.read(0x500 + 0x20 * rtc);
+    txn.upper = upper;
+    txn.completeAt = std::chrono::steady_clock::now() +
+        perByteTime_ * txn.lower.len;
+    txn.fail = failNext_[rtc];
+    failNext_[rtc] = false;
+    inFlight_[rtc] = txn;
+    // A new transaction clears the done and error bits
+    mem_.write(0x600 + 4 * rtc, 0);
+  }
+
+  void maybeCompleteLocked(int rtc) const {
+    auto it = inFlight_.find(rtc);
+    if (it == inFlight_.end() ||
+        std::chrono::steady_clock::now() < it->second.completeAt) {
+      return;
+    }
+    const auto& txn = it->second;
+    I2cRtcStatusDataUnion status;
+    status.reg = 0;
+    if (txn.fail) {
+      status.desc0error = 1;
+    } else {
+      auto& eeprom = eeproms_[rtc][txn.upper.channel];
+      auto len = std::min<size_t>(txn.lower.len, 256 - txn.upper.offset);
+      for (size_t i = 0; i < len; i += 4) {
+        auto blockOffset = kRtcIOBlockSize * rtc + i;
+        auto chunk = std::min<size_t>(len - i, 4);
+        if (txn.lower.op == 1) {
+          uint32_t data = 0;
+          std::memcpy(&data, &eeprom[txn.upper.offset + i], chunk);
+          mem_.write(kRtcReadBlock + blockOffset, data);
+        } else {
+          uint32_t data = mem_.read(kRtcWriteBlock + blockOffset);
+          std::memcpy(&eeprom[txn.upper.offset + i], &data, chunk);
+        }
+      }
+      status.desc0done = 1;
+    }
+    mem_.write(0x600 + 4 * rtc, status.reg);
+    inFlight_.erase(it);
+  }
+
+  mutable std::mutex mutex_;
+  mutable FakePhysicalMemory32 mem_;
+  const std::chrono::microseconds perByteTime_;
+  std::map<int, bool> failNext_;
+  mutable std::map<int, Transaction> inFlight_;
+  mutable std::array<
+      std::array<std::array<uint8_t, 256>, kNumChannels>,
+      kMaxRtcs>
+      eeproms_{};
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,158 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaI2cAsyncEngine.h"
+#include "fboss/lib/fpga/tests/FakeFpgaI2cDevice.h"
+
+#include <folly/futures/Future.h>
+#include <folly/synchronization/Baton.h>
+
+#include <set>
+
+DECLARE_bool(fpga_i2c_async_engine);
+
+namespace {
+constexpr auto kFakePhysicalAddr = 0xfdf00000;
+constexpr auto kFakeSize = 0x10000;
+constexpr auto kPim = 2;
+constexpr auto kNumRtcs = 4;
+} // namespace
+
+namespace facebook::fboss {
+
+class FbFpgaI2cAsyncEngineTests : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    FLAGS_fpga_i2c_async_engine = true;
+    device_ =
+        std::make_unique<FakeFpgaI2cDevice>(kFakePhysicalAddr, kFakeSize);
+    for (int rtc = 0; rtc < kNumRtcs; rtc++) {
+      controllers_.push_back(std::make_unique<FbFpgaI2cController>(
+          std::make_unique<FpgaMemoryRegion>(
+              "pim", device_.get(), 0, kFakeSize),
+          rtc,
+          kPim));
+    }
+  }
+
+  void TearDown() override {
+    controllers_.clear();
+  }
+
+  gflags::FlagSaver flagSaver_;
+  std::unique_ptr<FakeFpgaI2cDevice> device_;
+  std::vector<std::unique_ptr<FbFpgaI2cController>> controllers_;
+};
+
+TEST_F(FbFpgaI2cAsyncEngineTests, writeThenReadOnAllControllers) {
+  // Queue a write followed by a read on every controller and channel before
+  // waiting on any of them
+  std::vector<folly::SemiFuture<folly::Unit>> writes;
+  std::vector<folly::SemiFuture<std::unique_ptr<folly::IOBuf>>> reads;
+  for (int rtc = 0; rtc < kNumRtcs; rtc++) {
+    for (int channel = 0; channel < FakeFpgaI2cDevice::kNumChannels;
+         channel++) {
+      std::array<uint8_t, 10> data;
+      for (int i = 0; i < data.size(); i++) {
+        data[i] = rtc * 16 + channel * 4 + i;
+      }
+      writes.push_back(controllers_[rtc]->futureWrite(
+          channel, 0x10, folly::ByteRange(data.data(), data.size())));
+      reads.push_back(controllers_[rtc]->futureRead(channel, 0x10, 10));
+    }
+  }
+
+  folly::collectAll(std::move(writes)).get();
+  auto results = folly::collectAll(std::move(reads)).get();
+  for (int rtc = 0; rtc < kNumRtcs; rtc++) {
+    for (int channel = 0; channel < FakeFpgaI2cDevice::kNumChannels;
+         channel++) {
+      const auto& buf =
+          results[rtc * FakeFpgaI2cDevice::kNumChannels + channel].value();
+      ASSERT_EQ(buf->length(), 10);
+      for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(buf->data()[i], rtc * 16 + channel * 4 + i);
+        EXPECT_EQ(device_->eepromByte(rtc, channel, 0x10 + i), buf->data()[i]);
+      }
+    }
+  }
+
+  for (const auto& controller : controllers_) {
+    const auto& stats = controller->getI2cControllerPlatformStats();
+    EXPECT_EQ(*stats.readTotal__ref(), FakeFpgaI2cDevice::kNumChannels);
+    EXPECT_EQ(*stats.writeTotal__ref(), FakeFpgaI2cDevice::kNumChannels);
+    EXPECT_EQ(*stats.readBytes__ref(), FakeFpgaI2cDevice::kNumChannels * 10);
+    EXPECT_EQ(*stats.readFailed__ref(), 0);
+  }
+}
+
+TEST_F(FbFpgaI2cAsyncEngineTests, blockingApiUsesEngine) {
+  controllers_[1]->writeByte(2, 0x80, 0xab);
+  EXPECT_EQ(device_->eepromByte(1, 2, 0x80), 0xab);
+  EXPECT_EQ(controllers_[1]->readByte(2, 0x80), 0xab);
+}
+
+TEST_F(FbFpgaI2cAsyncEngineTests, failedTransaction) {
+  device_->failNextTransaction(3);
+  auto failedRead = controllers_[3]->futureRead(0, 0, 4);
+  auto nextRead = controllers_[3]->futureRead(0, 0, 4);
+  EXPECT_THROW(std::move(failedRead).get(), FbFpgaI2cError);
+  // A failed transaction doesn't stall the ones queued behind it
+  EXPECT_EQ(std::move(nextRead).get()->length(), 4);
+
+  const auto& stats = controllers_[3]->getI2cControllerPlatformStats();
+  EXPECT_EQ(*stats.readTotal__ref(), 2);
+  EXPECT_EQ(*stats.readFailed__ref(), 1);
+}
+
+TEST_F(FbFpgaI2cAsyncEngineTests, destroyControllerWithQueuedTransactions) {
+  std::vector<folly::SemiFuture<std::unique_ptr<folly::IOBuf>>> reads;
+  for (int i = 0; i < 10; i++) {
+    reads.push_back(controllers_[0]->futureRead(0, 0, 4));
+  }
+  // The engine drops the controller, so every read is either done or failed
+  // once the controller is gone
+  controllers_[0].reset();
+  for (auto& result : folly::collectAll(std::move(reads)).get()) {
+    if (result.hasException()) {
+      EXPECT_TRUE(result.exception().is_compatible_with<FbFpgaI2cError>());
+    } else {
+      EXPECT_EQ(result.value()->length(), 4);
+    }
+  }
+
+  // A new controller for the same RTC starts from a clean queue
+  controllers_[0] = std::make_unique<FbFpgaI2cController>(
+      std::make_unique<FpgaMemoryRegion>("pim", device_.get(), 0, kFakeSize),
+      0,
+      kPim);
+  EXPECT_EQ(controllers_[0]->futureRead(0, 0, 4).get()->length(), 4);
+}
+
+TEST_F(FbFpgaI2cAsyncEngineTests, controllersKeepOwnEventBases) {
+  std::set<folly::EventBase*> evbs;
+  for (const auto& controller : controllers_) {
+    evbs.insert(controller->getEventBase());
+  }
+  EXPECT_EQ(evbs.size(), controllers_.size());
+
+  // A caller stuck on one controller's thread doesn't hold up the others
+  folly::Baton<> blocked;
+  auto blockedFut = folly::via(
+      controllers_[0]->getEventBase(), [&blocked]() { blocked.wait(); });
+  for (int rtc = 1; rtc < kNumRtcs; rtc++) {
+    auto controller = controllers_[rtc].get();
+    // Blocking calls on the controller's thread go through the engine
+    folly::via(controller->getEventBase(), [controller]() {
+      controller->writeByte(1, 0x20, 0x5a);
+    }).get();
+    EXPECT_EQ(device_->eepromByte(rtc, 1, 0x20), 0x5a);
+  }
+  blocked.post();
+  std::move(blockedFut).get();
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,83 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <folly/Benchmark.h>
+#include <folly/futures/Future.h>
+#include <gflags/gflags.h>
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/tests/FakeFpgaI2cDevice.h"
+
+DECLARE_bool(fpga_i2c_async_engine);
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kFakePhysicalAddr = 0xfdf00000;
+constexpr auto kFakeSize = 0x10000;
+// A full chassis of 8 PIMs with 4 RTCs each
+constexpr auto kNumPims = 8;
+constexpr auto kNumRtcs = 4;
+constexpr auto kReadLength = 128;
+// Roughly the time to clock one byte on a 400KHz I2C bus
+constexpr auto kPerByteTime = std::chrono::microseconds(25);
+
+/*
+ * Read kReadLength bytes n times from every controller of every PIM, with all
+ * controllers running in parallel. The reported iters/s is the number of
+ * transactions per second each controller completes.
+ */
+void readAllControllers(size_t n, bool asyncEngine) {
+  std::vector<std::unique_ptr<FakeFpgaI2cDevice>> devices;
+  std::vector<std::unique_ptr<FbFpgaI2cController>> controllers;
+  BENCHMARK_SUSPEND {
+    FLAGS_fpga_i2c_async_engine = asyncEngine;
+    for (int pim = 0; pim < kNumPims; pim++) {
+      devices.push_back(std::make_unique<FakeFpgaI2cDevice>(
+          kFakePhysicalAddr, kFakeSize, kPerByteTime));
+      for (int rtc = 0; rtc < kNumRtcs; rtc++) {
+        controllers.push_back(std::make_unique<FbFpgaI2cController>(
+            std::make_unique<FpgaMemoryRegion>(
+                "pim", devices.back().get(), 0, kFakeSize),
+            rtc,
+            pim + 2));
+      }
+    }
+  }
+
+  std::vector<folly::SemiFuture<folly::Unit>> futs;
+  for (auto& controller : controllers) {
+    futs.push_back(folly::via(controller->getEventBase())
+                       .thenValue([&controller, n](auto&&) {
+                         std::array<uint8_t, kReadLength> buf;
+                         for (size_t i = 0; i < n; i++) {
+                           controller->read(
+                               0,
+                               0,
+                               folly::MutableByteRange(buf.data(), buf.size()));
+                         }
+                       })
+                       .semi());
+  }
+  folly::collectAll(std::move(futs)).get();
+
+  BENCHMARK_SUSPEND {
+    controllers.clear();
+    devices.clear();
+  }
+}
+
+} // namespace
+
+BENCHMARK(FbFpgaI2cBlockingRead, n) {
+  readAllControllers(n, false);
+}
+
+BENCHMARK_RELATIVE(FbFpgaI2cAsyncEngineRead, n) {
+  readAllControllers(n, true);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaPimQsfpController.h"
+#include "fboss/lib/fpga/tests/FakeFpgaDevice.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook::fboss {
+
+namespace {
+constexpr auto kFakePhysicalAddr = 0xfdf00000;
+constexpr auto kFakeSize = 0x1000;
+constexpr auto kPortsPerPim = 16;
+constexpr uint32_t kQsfpPresentRegOffset = 0x8;
+constexpr uint32_t kQsfpResetRegOffset = 0x30;
+
+class FbFpgaPimQsfpControllerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    device_ = std::make_unique<FakeFpgaDevice>(kFakePhysicalAddr, kFakeSize);
+    controller_ = std::make_unique<FbFpgaPimQsfpController>(
+        std::make_unique<FpgaMemoryRegion>(
+            "pim", device_.get(), 0, kFakeSize),
+        kPortsPerPim);
+  }
+
+  std::unique_ptr<FakeFpgaDevice> device_;
+  std::unique_ptr<FbFpgaPimQsfpController> controller_;
+};
+} // namespace
+
+TEST_F(FbFpgaPimQsfpControllerTest, presenceBitmap) {
+  // The upper bits don't belong to any QSFP of the PIM
+  device_->write(kQsfpPresentRegOffset, 0xffff8421);
+  auto reads = device_->getNumReads();
+  EXPECT_EQ(controller_->getQsfpPresenceBitmap(), 0x8421);
+  EXPECT_EQ(device_->getNumReads(), reads + 1);
+
+  // The vector scan is built from the same single read
+  auto presence = controller_->scanQsfpPresence();
+  EXPECT_EQ(device_->getNumReads(), reads + 2);
+  ASSERT_EQ(presence.size(), kPortsPerPim);
+  for (int qsfp = 0; qsfp < kPortsPerPim; qsfp++) {
+    EXPECT_EQ(presence[qsfp], qsfp % 5 == 0) << "qsfp " << qsfp;
+    EXPECT_EQ(controller_->isQsfpPresent(qsfp), presence[qsfp]);
+  }
+}
+
+TEST_F(FbFpgaPimQsfpControllerTest, resetBitmap) {
+  device_->write(kQsfpResetRegOffset, 0x00030006);
+  EXPECT_EQ(controller_->getQsfpResetBitmap(), 0x6);
+  controller_->clearAllTransceiverReset();
+  EXPECT_EQ(controller_->getQsfpResetBitmap(), 0);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,96 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include "fboss/lib/fpga/FbFpgaPimQsfpController.h"
+#include "fboss/lib/fpga/tests/FakeFpgaDevice.h"
+
+#include <iostream>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kFakePhysicalAddr = 0xfdf00000;
+constexpr auto kPimSize = 0x1000;
+// An 8 PIM chassis with 16 QSFPs on each PIM
+constexpr auto kNumPims = 8;
+constexpr auto kPortsPerPim = 16;
+
+struct Chassis {
+  Chassis() : device(kFakePhysicalAddr, kPimSize * kNumPims) {
+    for (int pim = 0; pim < kNumPims; pim++) {
+      pims.push_back(std::make_unique<FbFpgaPimQsfpController>(
+          std::make_unique<FpgaMemoryRegion>(
+              "pim", &device, pim * kPimSize, kPimSize),
+          kPortsPerPim));
+    }
+  }
+
+  FakeFpgaDevice device;
+  std::vector<std::unique_ptr<FbFpgaPimQsfpController>> pims;
+};
+
+uint32_t scanByModule(Chassis& chassis) {
+  uint32_t present = 0;
+  for (auto& pim : chassis.pims) {
+    for (int qsfp = 0; qsfp < kPortsPerPim; qsfp++) {
+      present += pim->isQsfpPresent(qsfp);
+    }
+  }
+  return present;
+}
+
+uint32_t scanByBitmap(Chassis& chassis) {
+  uint32_t present = 0;
+  for (auto& pim : chassis.pims) {
+    present += __builtin_popcount(pim->getQsfpPresenceBitmap());
+  }
+  return present;
+}
+} // namespace
+
+/*
+ * One iteration is a presence scan of all the QSFPs of the chassis
+ */
+BENCHMARK(PresenceScanByModule, n) {
+  std::unique_ptr<Chassis> chassis;
+  BENCHMARK_SUSPEND {
+    chassis = std::make_unique<Chassis>();
+  }
+  for (size_t i = 0; i < n; i++) {
+    folly::doNotOptimizeAway(scanByModule(*chassis));
+  }
+  BENCHMARK_SUSPEND {
+    chassis.reset();
+  }
+}
+
+BENCHMARK_RELATIVE(PresenceScanByBitmap, n) {
+  std::unique_ptr<Chassis> chassis;
+  BENCHMARK_SUSPEND {
+    chassis = std::make_unique<Chassis>();
+  }
+  for (size_t i = 0; i < n; i++) {
+    folly::doNotOptimizeAway(scanByBitmap(*chassis));
+  }
+  BENCHMARK_SUSPEND {
+    chassis.reset();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  // The fake device doesn't model the PCIe latency of a register read, so
+  // also report how many reads a scan of the chassis takes
+  Chassis byModule;
+  scanByModule(byModule);
+  Chassis byBitmap;
+  scanByBitmap(byBitmap);
+  std::cout << "Register reads for " << kNumPims << " PIMs x " << kPortsPerPim
+            << " QSFPs: " << byModule.device.getNumReads() << " by module, "
+            << byBitmap.device.getNumReads() << " by bitmap" << std::endl;
+  return 0;
+}
@@ -25,12 +25,6 @@ static constexpr uint8_t kCdbCommandStatusBusyCmdCaptured = 0x81;
 static constexpr uint8_t kCdbCommandStatusBusyCmdCheck = 0x82;
 static constexpr uint8_t kCdbCommandStatusBusyCmdExec = 0x83;
 
-// All the CDB commands finishes well within 2 seconds but one particular DSP
-// firmware download takes too much time. During this each CDB command takes
-// average 5 seconds to increasing this CDB timeout value to 10 seconds
-constexpr int cdbCommandTimeoutUsec = 10000000;
-constexpr int cdbCommandIntervalUsec = 100000;
-
 // CMIS firmware related register offsets
 constexpr uint8_t kCdbCommandStatusReg = 37;
 constexpr uint8_t kModulePasswordEntryReg = 122;
@@ -56,7 +50,7 @@ static void i2cWriteAndContinue(
     bus->moduleWrite(modId, i2cAddress, offset, length, buf);
   } catch (const std::exception& e) {
     XLOG(INFO) << "write() raised exception: Sleep for 100ms and continue";
-    usleep(cdbCommandIntervalUsec);
+    usleep(CdbCommandBlock::kCdbCommandIntervalUsec);
   }
 }
 
@@ -72,6 +66,46 @@ static void i2cWriteAndContinue(
 bool CdbCommandBlock::cmisRunCdbCommand(
     TransceiverI2CApi* bus,
     unsigned int modId) {
+  cmisIssueCdbCommand(bus, modId);
+
+  // Special handling for RUN command
+  if (isRunCommand()) {
+    return true;
+  }
+
+  // Now read the CDB command status register till the status becomes success
+  // or fail
+  auto status = CdbCommandStatus::BUSY;
+  auto currTime = std::chrono::steady_clock::now();
+  auto finishTime =
+      currTime + std::chrono::microseconds(kCdbCommandTimeoutUsec);
+  usleep(kCdbCommandIntervalUsec);
+  while (true) {
+    status = cmisCheckCdbCommandStatus(bus, modId);
+    if (status != CdbCommandStatus::BUSY) {
+      break;
+    }
+
+    currTime = std::chrono::steady_clock::now();
+    if (currTime > finishTime) {
+      break;
+    }
+    usleep(kCdbCommandIntervalUsec);
+  }
+
+  return status == CdbCommandStatus::SUCCESS;
+}
+
+/*
+ * cmisIssueCdbCommand
+ *
+ * Writes the command block to the CDB page of the module. The write to the
+ * command LSB register starts the command, and it doesn't wait for it to
+ * finish.
+ */
+void CdbCommandBlock::cmisIssueCdbCommand(
+    TransceiverI2CApi* bus,
+    unsigned int modId) {
   // Command block length is 8 plus lpl memory length
   int len = this->cdbFields_.cdbLplLength + 8;
 
@@ -124,45 +158,35 @@ bool CdbCommandBlock::cmisRunCdbCommand(
       bus, modId, TransceiverI2CApi::ADDR_QSFP, kCdbCommandMsbReg, 1, &buf[0]);
   i2cWriteAndContinue(
       bus, modId, TransceiverI2CApi::ADDR_QSFP, kCdbCommandLsbReg, 1, &buf[1]);
+}
 
-  // Special handling for RUN command
-  if (this->cdbFields_.cdbCommandCode ==
-      htons(kCdbCommandFirmwareDownloadRun)) {
-    return true;
-  }
-
-  // Now read the CDB command status register till the status becomes success
-  // or fail
+/*
+ * cmisCheckCdbCommandStatus
+ *
+ * Reads the CDB command status register once. When the command finished
+ * successfully, the data returned by the command (if any) is read into the
+ * LPL memory of this block.
+ */
+CdbCommandBlock::CdbCommandStatus CdbCommandBlock::cmisCheckCdbCommandStatus(
+    TransceiverI2CApi* bus,
+    unsigned int modId) {
   uint8_t status = 0;
-  auto currTime = std::chrono::steady_clock::now();
-  auto finishTime = currTime + std::chrono::microseconds(cdbCommandTimeoutUsec);
-  usleep(cdbCommandIntervalUsec);
-  while (true) {
-    try {
-      bus->moduleRead(
-          modId,
-          TransceiverI2CApi::ADDR_QSFP,
-          kCdbCommandStatusReg,
-          1,
-          &status);
-    } catch (const std::exception& e) {
-      XLOG(INFO) << "read() raised exception: Sleep for 100ms and continue";
-      usleep(cdbCommandIntervalUsec);
-      status = kCdbCommandStatusBusyCmdCaptured;
-    }
-    if (status != kCdbCommandStatusBusyCmdCaptured &&
-        status != kCdbCommandStatusBusyCmdCheck &&
-        status != kCdbCommandStatusBusyCmdExec) {
-      break;
-    }
-
-    currTime = std::chrono::steady_clock::now();
-    if (currTime > finishTime) {
-      break;
-    }
-    usleep(cdbCommandIntervalUsec);
+  try {
+    bus->moduleRead(
+        modId, TransceiverI2CApi::ADDR_QSFP, kCdbCommandStatusReg, 1, &status);
+  } catch (const std::exception& e) {
+    // The module may not respond while it's busy with the command, the
+    // caller waits before checking again
+    XLOG(INFO) << "read() raised exception: Treat the command as busy";
+    return CdbCommandStatus::BUSY;
+  }
+  if (status == kCdbCommandStatusBusyCmdCaptured ||
+      status == kCdbCommandStatusBusyCmdCheck ||
+      status == kCdbCommandStatusBusyCmdExec) {
+    return CdbCommandStatus::BUSY;
   }
 
+  const uint8_t* buf = (uint8_t*)this;
   if (status != kCdbCommandStatusSuccess) {
     XLOG(INFO) << folly::sformat(
         "cmisRunCdbCommand: Mod{:d}: CDB command {:#x}.{:#x} not successful, status {:#x}",
@@ -170,7 +194,7 @@ bool CdbCommandBlock::cmisRunCdbCommand(
         buf[0],
         buf[1],
         status);
-    return false;
+    return CdbCommandStatus::FAILED;
   }
 
   // Check if the CDB block has returned some information in the LPL memory
@@ -188,7 +212,7 @@ bool CdbCommandBlock::cmisRunCdbCommand(
           bus->moduleRead(modId, i2cAddress, offset, length, buf);
         } catch (const std::exception& e) {
           XLOG(INFO) << "read() raised exception: Sleep for 100ms and retry";
-          usleep(cdbCommandIntervalUsec);
+          usleep(kCdbCommandIntervalUsec);
           bus->moduleRead(modId, i2cAddress, offset, length, buf);
         }
       };
@@ -205,7 +229,11 @@ bool CdbCommandBlock::cmisRunCdbCommand(
         this->cdbFields_.cdbRlplLength,
         this->cdbFields_.cdbLplMemory.cdbLplFlatMemory);
   }
-  return true;
+  return CdbCommandStatus::SUCCESS;
+}
+
+bool CdbCommandBlock::isRunCommand() const {
+  return cdbFields_.cdbCommandCode == htons(kCdbCommandFirmwareDownloadRun);
 }
 
 /*
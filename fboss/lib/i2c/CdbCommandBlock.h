@@ -20,6 +20,19 @@ namespace facebook::fboss {
  */
 class CdbCommandBlock {
  public:
+  // Status of a CDB command issued with cmisIssueCdbCommand()
+  enum class CdbCommandStatus {
+    BUSY,
+    SUCCESS,
+    FAILED,
+  };
+
+  // All the CDB commands finishes well within 2 seconds but one particular
+  // DSP firmware download takes too much time. During this each CDB command
+  // takes average 5 seconds to increasing this CDB timeout value to 10 seconds
+  static constexpr int kCdbCommandTimeoutUsec = 10000000;
+  static constexpr int kCdbCommandIntervalUsec = 100000;
+
   // Constructor to initialize data block from 0
   CdbCommandBlock() {
     resetCdbBlock();
@@ -64,6 +77,15 @@ class CdbCommandBlock {
 
   // Public function to run the CDB command on the module
   bool cmisRunCdbCommand(TransceiverI2CApi* bus, unsigned int modId);
+  // The two non blocking halves of cmisRunCdbCommand(): write the command to
+  // the module, then check its status until it's not busy anymore. On
+  // success the returned RLPL data is read into this block.
+  void cmisIssueCdbCommand(TransceiverI2CApi* bus, unsigned int modId);
+  CdbCommandStatus cmisCheckCdbCommandStatus(
+      TransceiverI2CApi* bus,
+      unsigned int modId);
+  // The RUN command resets the module, so its status can't be checked
+  bool isRunCommand() const;
   // Provide response data to caller
   uint8_t getResponseData(uint8_t** pResponse);
 
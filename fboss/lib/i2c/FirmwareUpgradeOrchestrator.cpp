@@ -0,0 +1,106 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/i2c/FirmwareUpgradeOrchestrator.h"
+
+#include <folly/Format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+using std::chrono::steady_clock;
+
+namespace facebook::fboss {
+
+void CmisFirmwareUpgradeOrchestrator::addModule(
+    int controller,
+    std::unique_ptr<CmisFirmwareUpgrader> upgrader) {
+  progress_.wlock()->emplace(upgrader->getModuleId(), upgrader->getProgress());
+  controllers_[controller].push_back(std::move(upgrader));
+}
+
+std::map<unsigned int, bool> CmisFirmwareUpgradeOrchestrator::run() {
+  if (!controllers_.empty()) {
+    folly::CPUThreadPoolExecutor pool(
+        controllers_.size(),
+        std::make_shared<folly::NamedThreadFactory>("FwUpgrade"));
+    std::vector<folly::Future<folly::Unit>> futs;
+    for (auto& [controller, upgraders] : controllers_) {
+      futs.push_back(
+          folly::via(&pool, [this, controller = controller, &upgraders] {
+            runController(controller, upgraders);
+          }));
+    }
+    folly::collectAll(std::move(futs)).wait();
+    pool.join();
+  }
+
+  std::map<unsigned int, bool> results;
+  for (const auto& [controller, upgraders] : controllers_) {
+    for (const auto& upgrader : upgraders) {
+      results[upgrader->getModuleId()] = upgrader->succeeded();
+    }
+  }
+  return results;
+}
+
+void CmisFirmwareUpgradeOrchestrator::runController(
+    int controller,
+    std::vector<std::unique_ptr<CmisFirmwareUpgrader>>& upgraders) {
+  // When each upgrader wants to be stepped next
+  std::vector<steady_clock::time_point> nextStep(
+      upgraders.size(), steady_clock::now());
+
+  while (true) {
+    // Step the upgrader which is due first
+    std::optional<size_t> next;
+    for (size_t i = 0; i < upgraders.size(); i++) {
+      if (!upgraders[i]->isDone() &&
+          (!next || nextStep[i] < nextStep[*next])) {
+        next = i;
+      }
+    }
+    if (!next) {
+      break;
+    }
+
+    auto& upgrader = upgraders[*next];
+    if (nextStep[*next] > steady_clock::now()) {
+      /* sleep override */
+      std::this_thread::sleep_until(nextStep[*next]);
+    }
+    auto wait = upgrader->step();
+    nextStep[*next] = steady_clock::now() + wait;
+
+    auto progress = upgrader->getProgress();
+    progress_.wlock()->insert_or_assign(progress.moduleId, progress);
+    if (upgrader->isDone()) {
+      auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           progress.elapsed)
+                           .count();
+      XLOG(INFO) << folly::sformat(
+          "Controller {:d}: Mod{:d}: Firmware upgrade {:s}, {:d} bytes in {:d}ms ({:.1f} KB/s)",
+          controller,
+          progress.moduleId,
+          upgrader->succeeded() ? "done" : "failed",
+          progress.bytesDownloaded,
+          elapsedMs,
+          elapsedMs ? progress.bytesDownloaded / 1.024 / elapsedMs : 0.0);
+    }
+  }
+}
+
+std::vector<CmisFirmwareUpgrader::Progress>
+CmisFirmwareUpgradeOrchestrator::getProgress() const {
+  std::vector<CmisFirmwareUpgrader::Progress> progress;
+  for (const auto& [moduleId, moduleProgress] : *progress_.rlock()) {
+    progress.push_back(moduleProgress);
+  }
+  return progress;
+}
+
+} // namespace facebook::fboss
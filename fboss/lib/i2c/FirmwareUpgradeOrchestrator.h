@@ -0,0 +1,58 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <folly/Synchronized.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+#include "fboss/lib/i2c/FirmwareUpgrader.h"
+
+namespace facebook::fboss {
+
+/*
+ * Runs the firmware upgrade of many CMIS modules at once.
+ *
+ * Modules behind different I2C controllers are upgraded in parallel, one
+ * thread per controller. Within a controller the upgrades are interleaved:
+ * while one module is busy with a CDB command, the thread polls it only when
+ * due and issues the commands and EPL/LPL image writes of the other modules
+ * in between, instead of sleeping until the command is done. The controller
+ * is the unit of parallelism because its modules share one bus anyway.
+ */
+class CmisFirmwareUpgradeOrchestrator {
+ public:
+  CmisFirmwareUpgradeOrchestrator() = default;
+
+  // Add a module to upgrade, behind the given I2C controller
+  void addModule(
+      int controller,
+      std::unique_ptr<CmisFirmwareUpgrader> upgrader);
+
+  // Run all the upgrades and wait for them to finish. Returns whether the
+  // upgrade of each module succeeded.
+  std::map<unsigned int, bool> run();
+
+  // Progress of all modules. Can be called while run() is in progress.
+  std::vector<CmisFirmwareUpgrader::Progress> getProgress() const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  CmisFirmwareUpgradeOrchestrator(CmisFirmwareUpgradeOrchestrator const&) =
+      delete;
+  CmisFirmwareUpgradeOrchestrator& operator=(
+      CmisFirmwareUpgradeOrchestrator const&) = delete;
+
+  // Drive the upgrades of all modules behind one controller
+  void runController(
+      int controller,
+      std::vector<std::unique_ptr<CmisFirmwareUpgrader>>& upgraders);
+
+  std::map<int, std::vector<std::unique_ptr<CmisFirmwareUpgrader>>>
+      controllers_;
+  folly::Synchronized<std::map<unsigned int, CmisFirmwareUpgrader::Progress>>
+      progress_;
+};
+
+} // namespace facebook::fboss
@@ -33,13 +33,26 @@ using std::chrono::seconds;
 using std::chrono::steady_clock;
 using namespace facebook::fboss;
 
+// The image is run and committed by a soft reset of the module, which then
+// needs some time to initialize its datapath
+DEFINE_int32(
+    cdb_fw_run_wait_ms,
+    10000,
+    "Time to wait after running a new firmware image on a CMIS module");
+DEFINE_int32(
+    cdb_fw_commit_wait_ms,
+    50000,
+    "Time to wait after committing a new firmware image on a CMIS module");
+
 namespace facebook::fboss {
 
 // CMIS firmware related register offsets
 constexpr uint8_t kfirmwareVersionReg = 39;
 constexpr uint8_t kModulePasswordEntryReg = 122;
 
-constexpr int moduleDatapathInitDurationUsec = 5000000;
+// First CDB command status poll, later polls back off up to the regular CDB
+// command interval
+constexpr std::chrono::microseconds kCdbFirstPollInterval(5000);
 
 /*
  * CmisFirmwareUpgrader
@@ -64,6 +77,8 @@ CmisFirmwareUpgrader::CmisFirmwareUpgrader(
   fbossFirmware_->load();
   // Get the image pointer
   imageCursor_ = fbossFirmware_->getImage();
+  imageBuf_ = imageCursor_.data();
+  imageLen_ = imageCursor_.totalLength();
 
   // Get the header length of image
   std::string hdrLen = fbossFirmware_->getProperty("header_length");
@@ -85,251 +100,386 @@ CmisFirmwareUpgrader::CmisFirmwareUpgrader(
 /*
  * cmisModuleFirmwareDownload
  *
- * This function runs the firmware download operation for a module. This takes
- * the image buffer as input. This is basic function to do firmware download
- * and it can be run in any context - single thread, multiple thread etc
+ * This function runs the firmware download operation for a module to
+ * completion in the context of the calling thread, sleeping whenever the
+ * module is busy with a CDB command.
  */
-bool CmisFirmwareUpgrader::cmisModuleFirmwareDownload(
-    const uint8_t* imageBuf,
-    int imageLen) {
-  uint8_t startCommandPayloadSize = 0;
-  bool status;
-  int imageOffset, imageChunkLen;
-  bool eplSupported = false;
-
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Starting to download the image with length {:d}",
-      moduleId_,
-      imageLen);
-
-  // Set the password to let the privileged operation of firmware download
-  bus_->moduleWrite(
-      moduleId_,
-      TransceiverI2CApi::ADDR_QSFP,
-      kModulePasswordEntryReg,
-      4,
-      msaPassword_.data());
+bool CmisFirmwareUpgrader::cmisModuleFirmwareDownload() {
+  while (!isDone()) {
+    auto wait = step();
+    if (wait.count() > 0) {
+      /* sleep override */
+      std::this_thread::sleep_for(wait);
+    }
+  }
+  return succeeded();
+}
 
-  CdbCommandBlock commandBlockBuf;
-  CdbCommandBlock* commandBlock = &commandBlockBuf;
-
-  // Basic validation first. Check if the firmware download is allowed by
-  // issuing the Query command to CDB
-  commandBlock->createCdbCmdModuleQuery();
-  // Run the CDB command
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-  if (status) {
-    // Query result will be in LPL memory at byte offset 2
-    if (commandBlock->getCdbRlplLength() >= 3) {
-      if (commandBlock->getCdbLplFlatMemory()[2] == 0) {
-        // This should not happen because before calling this function
-        // we supply the password to module to allow priviledged
-        // operation. But still download feature is not available here
-        // so return false here
-        XLOG(INFO) << folly::sformat(
-            "cmisModuleFirmwareDownload: Mod{:d}: The firmware download feature is locked by vendor",
+/*
+ * step
+ *
+ * Runs the next step of the firmware download. The steps are:
+ *   Query the module and the firmware upgrade feature info (header size, EPL)
+ *   Step 1: Firmware download start with the image header
+ *   Step 2: Firmware download image, in LPL or EPL sized chunks
+ *   Step 3: Firmware download complete
+ *   Step 4: Run the downloaded image (application images only)
+ *   Step 5: Commit the downloaded image (application images only)
+ * Each CDB command is issued and then its status is polled, starting with a
+ * short interval and backing off, instead of sleeping for a fixed time.
+ */
+std::chrono::microseconds CmisFirmwareUpgrader::step() {
+  if (isDone()) {
+    return std::chrono::microseconds(0);
+  }
+  try {
+    if (!started_) {
+      started_ = true;
+      startTime_ = steady_clock::now();
+      if (imageBuf_ == nullptr) {
+        XLOG(ERR) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: No firmware image to download",
             moduleId_);
-        return false;
+        return fail();
       }
+      XLOG(INFO) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Starting to download the image with length {:d}",
+          moduleId_,
+          imageLen_);
+      // Set the password to let the privileged operation of firmware download
+      writePassword();
     }
-  } else {
-    // The QUERY command can fail if the module is in bootloader mode
-    // Not able to determine CDB module status but don't return from here
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Could not get result from CDB Query command",
-        moduleId_);
+    if (commandInFlight_) {
+      return pollCommand();
+    }
+    return issueNext();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << folly::sformat(
+        "cmisModuleFirmwareDownload: Mod{:d}: Failed in stage {:s}: {:s}",
+        moduleId_,
+        getStageName(stage_),
+        ex.what());
+    return fail();
   }
+}
 
-  // Step 0: Retrieve the Start Command Payload Size (the image header size)
-  // Done by sending Firmware upgrade feature command to CDB
-  commandBlock->createCdbCmdGetFwFeatureInfo();
-  // Run the CDB command
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-
-  // If the CDB command is successfull then the Start Command Payload Size is
-  // returned by CDB in LPL memory at offset 2
-
-  if (status && commandBlock->getCdbRlplLength() >= 3) {
-    // Get the firmware header size from CDB
-    startCommandPayloadSize = commandBlock->getCdbLplFlatMemory()[2];
+std::chrono::microseconds CmisFirmwareUpgrader::issueNext() {
+  if (passwordPending_) {
+    writePassword();
+  }
 
-    // Check if EPL memory is supported
-    if (commandBlock->getCdbLplFlatMemory()[5] == 0x10 ||
-        commandBlock->getCdbLplFlatMemory()[5] == 0x11) {
-      eplSupported = true;
+  switch (stage_) {
+    case Stage::QUERY:
+      // Basic validation first. Check if the firmware download is allowed by
+      // issuing the Query command to CDB
+      commandBlock_.createCdbCmdModuleQuery();
+      return issueCommand();
+    case Stage::FEATURE_INFO:
+      // Step 0: Retrieve the Start Command Payload Size (the image header
+      // size). Done by sending Firmware upgrade feature command to CDB
+      commandBlock_.createCdbCmdGetFwFeatureInfo();
+      return issueCommand();
+    case Stage::DOWNLOAD_START:
+      // Step 1: Issue CDB command: Firmware Download start
+      imageChunkLen_ = startCommandPayloadSize_;
+      commandBlock_.createCdbCmdFwDownloadStart(
+          startCommandPayloadSize_, imageLen_, imageOffset_, imageBuf_);
+      return issueCommand();
+    case Stage::DOWNLOAD_IMAGE:
+      // Step 2: Issue CDB command: Firmware Download image
+      if (!eplSupported_) {
+        // Create CDB command block using internal LPL memory
+        commandBlock_.createCdbCmdFwDownloadImageLpl(
+            startCommandPayloadSize_,
+            imageLen_,
+            imageBuf_,
+            imageOffset_,
+            imageChunkLen_);
+      } else {
+        // Create CDB command block assuming external EPL memory
+        commandBlock_.createCdbCmdFwDownloadImageEpl(
+            startCommandPayloadSize_, imageLen_, imageOffset_, imageChunkLen_);
+
+        // Write the image payload to external EPL before invoking the command
+        commandBlock_.writeEplPayload(
+            bus_, moduleId_, imageBuf_, imageOffset_, imageChunkLen_);
+      }
+      return issueCommand();
+    case Stage::DOWNLOAD_COMPLETE:
+      // Step 3: Issue CDB command: Firmware download complete
+      commandBlock_.createCdbCmdFwDownloadComplete();
+      return issueCommand();
+    case Stage::RUN:
+      // Step 4: Issue CDB command: Run the downloaded firmware
+      // No need to check status because RUN command issues soft reset to CDB
+      // so we can't check status here
+      commandBlock_.createCdbCmdFwImageRun();
+      commandBlock_.cmisIssueCdbCommand(bus_, moduleId_);
       XLOG(INFO) << folly::sformat(
-          "cmisModuleFirmwareDownload: Mod{:d} will use EPL memory for firmware download",
+          "cmisModuleFirmwareDownload: Mod{:d}: Step 4: Issued Firmware download Run command successfully",
           moduleId_);
-    }
-  } else {
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Could not get result from CDB Firmware Update Feature command",
-        moduleId_);
-
-    // Sometime when the optics is  in boot loader mode, this CDB command
-    // fails. So fill in the header size if it is a known optics otherwise
-    // return false
-    startCommandPayloadSize = imageHeaderLen_;
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Setting the module startCommandPayloadSize as {:d}",
-        moduleId_,
-        startCommandPayloadSize);
+      stage_ = Stage::COMMIT;
+      passwordPending_ = true;
+      return std::chrono::milliseconds(FLAGS_cdb_fw_run_wait_ms);
+    case Stage::COMMIT:
+      // Step 5: Issue CDB command: Commit the downloaded firmware
+      commandBlock_.createCdbCmdFwCommit();
+      return issueCommand();
+    case Stage::FINISH:
+      // The password was set again above
+      stage_ = Stage::DONE;
+      endTime_ = steady_clock::now();
+      XLOG(INFO) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Downloaded {:d} bytes in {:d}ms",
+          moduleId_,
+          imageLen_,
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              endTime_ - startTime_)
+              .count());
+      return std::chrono::microseconds(0);
+    case Stage::DONE:
+    case Stage::FAILED:
+      break;
   }
+  return std::chrono::microseconds(0);
+}
 
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 0: Got Start Command Payload Size as {:d}",
-      moduleId_,
-      startCommandPayloadSize);
+std::chrono::microseconds CmisFirmwareUpgrader::issueCommand() {
+  commandBlock_.cmisIssueCdbCommand(bus_, moduleId_);
+  commandInFlight_ = true;
+  commandDeadline_ = steady_clock::now() +
+      std::chrono::microseconds(CdbCommandBlock::kCdbCommandTimeoutUsec);
+  pollInterval_ = kCdbFirstPollInterval;
+  return pollInterval_;
+}
 
-  // Validate if the image length is greater than this. If not then our new
-  // image is bad
-  if (imageLen < startCommandPayloadSize) {
+std::chrono::microseconds CmisFirmwareUpgrader::pollCommand() {
+  auto status = commandBlock_.cmisCheckCdbCommandStatus(bus_, moduleId_);
+  if (status == CdbCommandBlock::CdbCommandStatus::BUSY) {
+    if (steady_clock::now() < commandDeadline_) {
+      // Back off until the regular CDB command interval
+      pollInterval_ = std::min(
+          pollInterval_ * 2,
+          std::chrono::microseconds(CdbCommandBlock::kCdbCommandIntervalUsec));
+      return pollInterval_;
+    }
     XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: The image length {:d} is smaller than startCommandPayloadSize {:d}",
+        "cmisModuleFirmwareDownload: Mod{:d}: CDB command timed out in stage {:s}",
         moduleId_,
-        imageLen,
-        startCommandPayloadSize);
-    return false;
+        getStageName(stage_));
   }
+  commandInFlight_ = false;
+  return onCommandDone(status == CdbCommandBlock::CdbCommandStatus::SUCCESS);
+}
 
-  // Step 1: Issue CDB command: Firmware Download start
-  imageChunkLen = startCommandPayloadSize;
-  commandBlock->createCdbCmdFwDownloadStart(
-      startCommandPayloadSize, imageLen, imageOffset, imageBuf);
-
-  // Run the CDB command
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-  if (!status) {
-    // DOWNLOAD_START command failed
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Start command",
-        moduleId_);
-    return false;
-  }
+std::chrono::microseconds CmisFirmwareUpgrader::onCommandDone(bool status) {
+  switch (stage_) {
+    case Stage::QUERY:
+      if (status) {
+        // Query result will be in LPL memory at byte offset 2
+        if (commandBlock_.getCdbRlplLength() >= 3 &&
+            commandBlock_.getCdbLplFlatMemory()[2] == 0) {
+          // This should not happen because before calling this function
+          // we supply the password to module to allow priviledged
+          // operation. But still download feature is not available here
+          // so return false here
+          XLOG(INFO) << folly::sformat(
+              "cmisModuleFirmwareDownload: Mod{:d}: The firmware download feature is locked by vendor",
+              moduleId_);
+          return fail();
+        }
+      } else {
+        // The QUERY command can fail if the module is in bootloader mode
+        // Not able to determine CDB module status but don't return from here
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Could not get result from CDB Query command",
+            moduleId_);
+      }
+      stage_ = Stage::FEATURE_INFO;
+      break;
+
+    case Stage::FEATURE_INFO:
+      // If the CDB command is successfull then the Start Command Payload Size
+      // is returned by CDB in LPL memory at offset 2
+      if (status && commandBlock_.getCdbRlplLength() >= 3) {
+        // Get the firmware header size from CDB
+        startCommandPayloadSize_ = commandBlock_.getCdbLplFlatMemory()[2];
+
+        // Check if EPL memory is supported
+        if (commandBlock_.getCdbLplFlatMemory()[5] == 0x10 ||
+            commandBlock_.getCdbLplFlatMemory()[5] == 0x11) {
+          eplSupported_ = true;
+          XLOG(INFO) << folly::sformat(
+              "cmisModuleFirmwareDownload: Mod{:d} will use EPL memory for firmware download",
+              moduleId_);
+        }
+      } else {
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Could not get result from CDB Firmware Update Feature command",
+            moduleId_);
 
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 1: Issued Firmware download start command successfully",
-      moduleId_);
+        // Sometime when the optics is  in boot loader mode, this CDB command
+        // fails. So fill in the header size if it is a known optics otherwise
+        // return false
+        startCommandPayloadSize_ = imageHeaderLen_;
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Setting the module startCommandPayloadSize as {:d}",
+            moduleId_,
+            startCommandPayloadSize_);
+      }
 
-  // Step 2: Issue CDB command: Firmware Download image
+      XLOG(INFO) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Step 0: Got Start Command Payload Size as {:d}",
+          moduleId_,
+          startCommandPayloadSize_);
 
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 2: Issuing Firmware Download Image command. Starting offset: {:d}",
-      moduleId_,
-      imageOffset);
-
-  while (imageOffset < imageLen) {
-    if (!eplSupported) {
-      // Create CDB command block using internal LPL memory
-      commandBlock->createCdbCmdFwDownloadImageLpl(
-          startCommandPayloadSize,
-          imageLen,
-          imageBuf,
-          imageOffset,
-          imageChunkLen);
-    } else {
-      // Create CDB command block assuming external EPL memory
-      commandBlock->createCdbCmdFwDownloadImageEpl(
-          startCommandPayloadSize, imageLen, imageOffset, imageChunkLen);
-
-      // Write the image payload to external EPL before invoking the command
-      commandBlock->writeEplPayload(
-          bus_, moduleId_, imageBuf, imageOffset, imageChunkLen);
-    }
+      // Validate if the image length is greater than this. If not then our
+      // new image is bad
+      if (imageLen_ < startCommandPayloadSize_) {
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: The image length {:d} is smaller than startCommandPayloadSize {:d}",
+            moduleId_,
+            imageLen_,
+            startCommandPayloadSize_);
+        return fail();
+      }
+      stage_ = Stage::DOWNLOAD_START;
+      break;
 
-    // Run the CDB command
-    status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-    if (!status) {
-      // DOWNLOAD_IMAGE command failed
+    case Stage::DOWNLOAD_START:
+      if (!status) {
+        // DOWNLOAD_START command failed
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Start command",
+            moduleId_);
+        return fail();
+      }
       XLOG(INFO) << folly::sformat(
-          "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Image command",
+          "cmisModuleFirmwareDownload: Mod{:d}: Step 1: Issued Firmware download start command successfully",
           moduleId_);
-      return false;
-    }
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Image wrote, offset: {:d} .. {:d}",
-        moduleId_,
-        imageOffset - imageChunkLen,
-        imageOffset);
-  }
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 2: Issued Firmware Download Image successfully. Downloaded file size {:d}",
-      moduleId_,
-      imageOffset);
-
-  // Step 3: Issue CDB command: Firmware download complete
-  commandBlock->createCdbCmdFwDownloadComplete();
-
-  // Run the CDB command
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-  if (!status) {
-    // DOWNLOAD_COMPLETE command failed
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Complete command",
-        moduleId_);
-    // Send the DOWNLOAD_ABORT command to CDB and return.
-    return false;
-  }
+      XLOG(INFO) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Step 2: Issuing Firmware Download Image command. Starting offset: {:d}",
+          moduleId_,
+          imageOffset_);
+      stage_ = Stage::DOWNLOAD_IMAGE;
+      break;
+
+    case Stage::DOWNLOAD_IMAGE:
+      if (!status) {
+        // DOWNLOAD_IMAGE command failed
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Image command",
+            moduleId_);
+        return fail();
+      }
+      XLOG(DBG2) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Image wrote, offset: {:d} .. {:d}",
+          moduleId_,
+          imageOffset_ - imageChunkLen_,
+          imageOffset_);
+      if (imageOffset_ >= imageLen_) {
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Step 2: Issued Firmware Download Image successfully. Downloaded file size {:d}",
+            moduleId_,
+            imageOffset_);
+        stage_ = Stage::DOWNLOAD_COMPLETE;
+      }
+      break;
 
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 3: Issued Firmware download complete command successfully",
-      moduleId_);
+    case Stage::DOWNLOAD_COMPLETE:
+      if (!status) {
+        // DOWNLOAD_COMPLETE command failed
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Could not run the CDB Firmware Download Complete command",
+            moduleId_);
+        return fail();
+      }
+      XLOG(INFO) << folly::sformat(
+          "cmisModuleFirmwareDownload: Mod{:d}: Step 3: Issued Firmware download complete command successfully",
+          moduleId_);
+      // Non App images like DSP image don't need last 2 steps (Run, Commit)
+      // for the firmware download
+      stage_ = appImage_ ? Stage::RUN : Stage::FINISH;
+      break;
 
-  // Non App images like DSP image don't need last 2 steps (Run, Commit) for the
-  // firmware download
-  if (!appImage_) {
-    return true;
+    case Stage::COMMIT:
+      if (!status) {
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Step 5: Issued Firmware commit command failed",
+            moduleId_);
+      } else {
+        XLOG(INFO) << folly::sformat(
+            "cmisModuleFirmwareDownload: Mod{:d}: Step 5: Issued Firmware commit command successful",
+            moduleId_);
+      }
+      stage_ = Stage::FINISH;
+      passwordPending_ = true;
+      return std::chrono::milliseconds(FLAGS_cdb_fw_commit_wait_ms);
+
+    case Stage::RUN:
+    case Stage::FINISH:
+    case Stage::DONE:
+    case Stage::FAILED:
+      break;
   }
+  return std::chrono::microseconds(0);
+}
 
-  // Step 4: Issue CDB command: Run the downloaded firmware
-  commandBlock->createCdbCmdFwImageRun();
-
-  // Run the CDB command
-  // No need to check status because RUN command issues soft reset to CDB
-  // so we can't check status here
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-
-  XLOG(INFO) << folly::sformat(
-      "cmisModuleFirmwareDownload: Mod{:d}: Step 4: Issued Firmware download Run command successfully",
-      moduleId_);
-
-  usleep(2 * moduleDatapathInitDurationUsec);
+std::chrono::microseconds CmisFirmwareUpgrader::fail() {
+  stage_ = Stage::FAILED;
+  commandInFlight_ = false;
+  endTime_ = steady_clock::now();
+  return std::chrono::microseconds(0);
+}
 
-  // Set the password to let the privileged operation of firmware download
+void CmisFirmwareUpgrader::writePassword() {
   bus_->moduleWrite(
       moduleId_,
       TransceiverI2CApi::ADDR_QSFP,
       kModulePasswordEntryReg,
       4,
       msaPassword_.data());
+  passwordPending_ = false;
+}
 
-  // Step 5: Issue CDB command: Commit the downloaded firmware
-  commandBlock->createCdbCmdFwCommit();
-
-  // Run the CDB command
-  status = commandBlock->cmisRunCdbCommand(bus_, moduleId_);
-
-  if (!status) {
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Step 5: Issued Firmware commit command failed",
-        moduleId_);
-  } else {
-    XLOG(INFO) << folly::sformat(
-        "cmisModuleFirmwareDownload: Mod{:d}: Step 5: Issued Firmware commit command successful",
-        moduleId_);
+CmisFirmwareUpgrader::Progress CmisFirmwareUpgrader::getProgress() const {
+  Progress progress;
+  progress.moduleId = moduleId_;
+  progress.stage = stage_;
+  progress.bytesDownloaded = imageOffset_;
+  progress.imageLen = imageLen_;
+  if (started_) {
+    progress.elapsed =
+        (isDone() ? endTime_ : steady_clock::now()) - startTime_;
   }
+  return progress;
+}
 
-  usleep(10 * moduleDatapathInitDurationUsec);
-
-  // Set the password to let the privileged operation of firmware download
-  bus_->moduleWrite(
-      moduleId_,
-      TransceiverI2CApi::ADDR_QSFP,
-      kModulePasswordEntryReg,
-      4,
-      msaPassword_.data());
-
-  return true;
+// static
+const char* CmisFirmwareUpgrader::getStageName(Stage stage) {
+  switch (stage) {
+    case Stage::QUERY:
+      return "QUERY";
+    case Stage::FEATURE_INFO:
+      return "FEATURE_INFO";
+    case Stage::DOWNLOAD_START:
+      return "DOWNLOAD_START";
+    case Stage::DOWNLOAD_IMAGE:
+      return "DOWNLOAD_IMAGE";
+    case Stage::DOWNLOAD_COMPLETE:
+      return "DOWNLOAD_COMPLETE";
+    case Stage::RUN:
+      return "RUN";
+    case Stage::COMMIT:
+      return "COMMIT";
+    case Stage::FINISH:
+      return "FINISH";
+    case Stage::DONE:
+      return "DONE";
+    case Stage::FAILED:
+      return "FAILED";
+  }
+  return "UNKNOWN";
 }
 
 /*
@@ -350,8 +500,7 @@ bool CmisFirmwareUpgrader::cmisModuleFirmwareUpgrade() {
       moduleId_);
 
   // Call the firmware download operation with this image content
-  result = cmisModuleFirmwareDownload(
-      imageCursor_.data(), imageCursor_.totalLength());
+  result = cmisModuleFirmwareDownload();
   if (!result) {
     // If the download failed then print the message and return. No need
     // to do any recovery here
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <utility>
 #include "fboss/lib/firmware_storage/FbossFirmware.h"
@@ -18,6 +19,28 @@ namespace facebook::fboss {
  */
 class CmisFirmwareUpgrader {
  public:
+  enum class Stage {
+    QUERY,
+    FEATURE_INFO,
+    DOWNLOAD_START,
+    DOWNLOAD_IMAGE,
+    DOWNLOAD_COMPLETE,
+    RUN,
+    COMMIT,
+    FINISH,
+    DONE,
+    FAILED,
+  };
+
+  struct Progress {
+    unsigned int moduleId{0};
+    Stage stage{Stage::QUERY};
+    int bytesDownloaded{0};
+    int imageLen{0};
+    // Time spent on the upgrade so far, or in total once it's done
+    std::chrono::steady_clock::duration elapsed{0};
+  };
+
   // Mapping the module type string to module type part number string
   // The module type string is provided by user CLI and the mapped module part
   // number string can be compared with modules's register page 1 byte 148-163
@@ -45,6 +68,23 @@ class CmisFirmwareUpgrader {
   // Function to trigger the firmware download to the QSFP module of CMIS type
   bool cmisModuleFirmwareUpgrade();
 
+  // Issue the next bus operation of the upgrade. Returns how long to wait
+  // before calling step() again, for a CDB command to make progress.
+  std::chrono::microseconds step();
+
+  bool isDone() const {
+    return stage_ == Stage::DONE || stage_ == Stage::FAILED;
+  }
+  bool succeeded() const {
+    return stage_ == Stage::DONE;
+  }
+  unsigned int getModuleId() const {
+    return moduleId_;
+  }
+  Progress getProgress() const;
+
+  static const char* getStageName(Stage stage);
+
  private:
   // Bus class for moduleRead/Write() functions
   TransceiverI2CApi* bus_;
@@ -63,10 +103,35 @@ class CmisFirmwareUpgrader {
   uint32_t imageHeaderLen_;
   // Image type (App/Dsp)
   bool appImage_{true};
+  // Image to download
+  const uint8_t* imageBuf_{nullptr};
+  int imageLen_{0};
+
+  // State of the download
+  Stage stage_{Stage::QUERY};
+  bool started_{false};
+  bool passwordPending_{false};
+  CdbCommandBlock commandBlock_;
+  bool commandInFlight_{false};
+  std::chrono::steady_clock::time_point commandDeadline_;
+  std::chrono::microseconds pollInterval_{0};
+  uint8_t startCommandPayloadSize_{0};
+  bool eplSupported_{false};
+  int imageOffset_{0};
+  int imageChunkLen_{0};
+  std::chrono::steady_clock::time_point startTime_;
+  std::chrono::steady_clock::time_point endTime_;
 
   // Private function to finally download firmware image on module using cdb
   // process
-  bool cmisModuleFirmwareDownload(const uint8_t* imageBuf, int imageLen);
+  bool cmisModuleFirmwareDownload();
+
+  std::chrono::microseconds issueNext();
+  std::chrono::microseconds issueCommand();
+  std::chrono::microseconds pollCommand();
+  std::chrono::microseconds onCommandDone(bool success);
+  std::chrono::microseconds fail();
+  void writePassword();
 };
 
 } // namespace facebook::fboss
@@ -64,23 +64,23 @@ bool MinipackBaseI2cBus::isPresent(unsigned int module) {
 
 void MinipackBaseI2cBus::scanPresence(
     std::map<int32_t, ModulePresence>& presences) {
-  std::set<uint8_t> pimsToScan;
-  for (auto presence : presences) {
-    pimsToScan.insert(getPim(presence.first + 1));
-  }
-
-  for (auto pim : pimsToScan) {
-    const auto& pimQsfpPresence = systemContainer_->getPimContainer(pim)
-                                      ->getPimQsfpController()
-                                      ->scanQsfpPresence();
-    for (int port = 0; port < portsPerPim_; port++) {
-      assert(pimQsfpPresence.size() > port);
-      if (pimQsfpPresence[port]) {
-        presences[getModule(pim, port) - 1] = ModulePresence::PRESENT;
-      } else {
-        presences[getModule(pim, port) - 1] = ModulePresence::ABSENT;
-      }
+  // Read the presence of all the QSFPs of a PIM at once, and only once
+  std::map<uint8_t, uint32_t> pimPresence;
+  for (auto& [module, presence] : presences) {
+    auto pim = getPim(module + 1);
+    auto it = pimPresence.find(pim);
+    if (it == pimPresence.end()) {
+      it = pimPresence
+               .emplace(
+                   pim,
+                   systemContainer_->getPimContainer(pim)
+                       ->getPimQsfpController()
+                       ->getQsfpPresenceBitmap())
+               .first;
     }
+    presence = ((it->second >> getQsfpPimPort(module + 1)) & 1)
+        ? ModulePresence::PRESENT
+        : ModulePresence::ABSENT;
   }
 }
 
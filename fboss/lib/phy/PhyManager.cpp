@@ -11,13 +11,24 @@
 #include "fboss/lib/phy/ExternalPhy.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/SharedPromise.h>
 #include <folly/json.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <chrono>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 
+DEFINE_int32(
+    xphy_stats_collection_threads,
+    8,
+    "Number of threads collecting xphy stats. Each xphy is collected by one "
+    "thread at a time, different xphys in parallel");
+
 namespace {
 // Key of the portToCacheInfo map in warmboot state cache
 constexpr auto kPortToCacheInfoKey = "portToCacheInfo";
@@ -25,6 +36,9 @@ constexpr auto kSystemLanesKey = "systemLanes";
 constexpr auto kLineLanesKey = "lineLanes";
 constexpr auto kPortProfileStrKey = "profile";
 constexpr auto kPortSpeedStrKey = "speed";
+
+constexpr auto kXphyStatsCycleTimeCounter = "xphy.stats.cycle_time_ms";
+constexpr auto kXphyStatsMaxXphyTimeCounter = "xphy.stats.max_xphy_time_ms";
 } // namespace
 
 namespace facebook::fboss {
@@ -67,7 +81,14 @@ PhyManager::PhyManager(const PlatformMapping* platformMapping)
       xphySnapshotManager_(
           std::make_unique<
               PhySnapshotManager<kXphySnapshotIntervalSeconds>>()) {}
-PhyManager::~PhyManager() {}
+PhyManager::~PhyManager() {
+  // Wait for any ongoing stats cycle, which uses this object
+  std::lock_guard<std::mutex> guard(xphyStatsExecutorsLock_);
+  xphyStatsExecutors_.clear();
+  if (xphyStatsThreadPool_) {
+    xphyStatsThreadPool_->join();
+  }
+}
 
 PhyManager::PortToCacheInfo PhyManager::setupPortToCacheInfo(
     const PlatformMapping* platformMapping) {
@@ -205,6 +226,22 @@ void PhyManager::setupPimEventMultiThreading(PimID pimID) {
   pimToThread_.emplace(pimID, std::make_unique<PimEventMultiThreading>(pimID));
 }
 
+folly::Executor::KeepAlive<> PhyManager::getXphyStatsExecutor(
+    GlobalXphyID xphyID) {
+  std::lock_guard<std::mutex> guard(xphyStatsExecutorsLock_);
+  if (!xphyStatsThreadPool_) {
+    xphyStatsThreadPool_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_xphy_stats_collection_threads,
+        std::make_shared<folly::NamedThreadFactory>("XphyStats"));
+  }
+  auto& executor = xphyStatsExecutors_[xphyID];
+  if (!executor) {
+    executor = folly::SerialExecutor::create(
+        folly::getKeepAliveToken(xphyStatsThreadPool_.get()));
+  }
+  return executor;
+}
+
 bool PhyManager::setPortToPortCacheInfoLocked(
     const PortCacheWLockedPtr& lockedCache,
     PortID portID,
@@ -496,108 +533,180 @@ void PhyManager::setPortToExternalPhyPortStatsLocked(
   lockedCache->stats = std::move(stats);
 }
 
+using namespace std::chrono;
 void PhyManager::updateAllXphyPortsStats() {
+  if (ongoingStatsCycle_.has_value() && !ongoingStatsCycle_->isReady()) {
+    XLOG(DBG4) << "XPHY stats collection cycle still underway...";
+    return;
+  }
+
+  auto cycleDone = std::make_shared<folly::SharedPromise<folly::Unit>>();
+  // Group the ports by xphy, as each xphy is collected by its own job
+  std::map<GlobalXphyID, std::vector<XphyPortStatsResult>> xphyToPorts;
   for (const auto& portCacheInfo : portToCacheInfo_) {
     const auto& wLockedCache = portCacheInfo.second->wlock();
     // If the port is not programmed yet, skip updating xphy stats for it
     if (wLockedCache->systemLanes.empty() || wLockedCache->lineLanes.empty()) {
       continue;
     }
-    updateStatsLocked(wLockedCache, portCacheInfo.first);
-  }
-}
-
-using namespace std::chrono;
-void PhyManager::updateStatsLocked(
-    const PortCacheWLockedPtr& wLockedCache,
-    PortID portID) {
-  if (wLockedCache->systemLanes.empty() || wLockedCache->lineLanes.empty()) {
-    throw FbossError(
-        "Port:", portID, " is not programmed and can't find cached lanes");
+    auto* xphy = getExternalPhyLocked(wLockedCache);
+    XphyPortStatsResult result;
+    result.portID = portCacheInfo.first;
+    result.systemLanes = wLockedCache->systemLanes;
+    result.lineLanes = wLockedCache->lineLanes;
+    result.collectStats =
+        xphy->isSupported(phy::ExternalPhy::Feature::PORT_STATS) ||
+        xphy->isSupported(phy::ExternalPhy::Feature::PORT_INFO);
+    // Only needs to update prbs stats as long as there's one side enabled
+    result.collectPrbsStats =
+        xphy->isSupported(phy::ExternalPhy::Feature::PRBS_STATS) &&
+        (wLockedCache->stats->isPrbsCollectionEnabled(phy::Side::SYSTEM) ||
+         wLockedCache->stats->isPrbsCollectionEnabled(phy::Side::LINE));
+    if (!result.collectStats && !result.collectPrbsStats) {
+      continue;
+    }
+    if (result.collectStats) {
+      wLockedCache->ongoingStatCollection = cycleDone->getFuture();
+    }
+    if (result.collectPrbsStats) {
+      wLockedCache->ongoingPrbsStatCollection = cycleDone->getFuture();
+    }
+    xphyToPorts[wLockedCache->xphyID].push_back(std::move(result));
   }
-
-  auto xphyID = getGlobalXphyIDbyPortIDLocked(wLockedCache);
-  auto* xphy = getExternalPhyLocked(wLockedCache);
-  // If the xphy doesn't support either port or prbs stats, no-op
-  if (!xphy->isSupported(phy::ExternalPhy::Feature::PORT_STATS) &&
-      !xphy->isSupported(phy::ExternalPhy::Feature::PORT_INFO) &&
-      !xphy->isSupported(phy::ExternalPhy::Feature::PRBS_STATS)) {
+  if (xphyToPorts.empty()) {
     return;
   }
 
-  auto pimID = getPhyIDInfo(xphyID).pimID;
-  auto evb = getPimEventBase(pimID);
-  if (xphy->isSupported(phy::ExternalPhy::Feature::PORT_STATS) ||
-      xphy->isSupported(phy::ExternalPhy::Feature::PORT_INFO)) {
-    if (wLockedCache->ongoingStatCollection.has_value() &&
-        !wLockedCache->ongoingStatCollection->isReady()) {
-      XLOG(DBG4) << "XPHY Port Stat collection for Port:" << portID
-                 << " still underway...";
-    } else {
-      // Collect xphy port stats
-      wLockedCache->ongoingStatCollection =
-          folly::via(evb).thenValue([this, portID, xphy](auto&&) {
-            // Since this is future job, we need to fetch the cache with wlock
-            // again
-            const auto& wCache = getWLockedCache(portID);
-            steady_clock::time_point begin = steady_clock::now();
-            std::optional<ExternalPhyPortStats> stats;
-            // if PORT_INFO feature is supported, use getPortInfo instead
-            if (xphy->isSupported(phy::ExternalPhy::Feature::PORT_INFO)) {
-              auto xphyPortInfo =
-                  xphy->getPortInfo(wCache->systemLanes, wCache->lineLanes);
-              xphyPortInfo.name_ref() = getPortName(portID);
-              if (auto programmedSpeed = wCache->speed) {
-                xphyPortInfo.speed_ref() = *programmedSpeed;
-              } else {
-                throw FbossError("Missing programmed speed for port:", portID);
-              }
-              updateXphyInfo(portID, xphyPortInfo);
-              stats = ExternalPhyPortStats::fromPhyInfo(xphyPortInfo);
-            } else {
-              stats =
-                  xphy->getPortStats(wCache->systemLanes, wCache->lineLanes);
-            }
-            wCache->stats->updateXphyStats(*stats);
-            XLOG(DBG3) << "Port " << portID
-                       << ": xphy port stat collection took "
-                       << duration_cast<milliseconds>(
-                              steady_clock::now() - begin)
-                              .count()
-                       << "ms";
-          });
+  auto begin = steady_clock::now();
+  std::vector<folly::Future<std::pair<
+      std::vector<XphyPortStatsResult>,
+      std::chrono::microseconds>>>
+      xphyJobs;
+  for (auto& [xphyID, results] : xphyToPorts) {
+    auto* xphy = getExternalPhy(xphyID);
+    xphyJobs.push_back(
+        folly::via(getXphyStatsExecutor(xphyID))
+            .thenValue([this, xphy, results = std::move(results)](
+                           auto&&) mutable {
+              auto xphyTime = collectXphyStats(xphy, results);
+              return std::make_pair(std::move(results), xphyTime);
+            }));
+  }
+
+  // Publish the stats of all ports at once, when all xphys are done. The
+  // cycle is only done once its stats are published.
+  ongoingStatsCycle_ = cycleDone->getFuture();
+  folly::collectAll(std::move(xphyJobs))
+      .via(folly::getKeepAliveToken(xphyStatsThreadPool_.get()))
+      .thenValue([this, begin](auto&& xphyResults) {
+        std::vector<XphyPortStatsResult> allResults;
+        std::chrono::microseconds maxXphyTime{0};
+        for (auto& xphyResult : xphyResults) {
+          if (!xphyResult.hasValue()) {
+            continue;
+          }
+          auto& [results, xphyTime] = xphyResult.value();
+          maxXphyTime = std::max(maxXphyTime, xphyTime);
+          std::move(
+              results.begin(), results.end(), std::back_inserter(allResults));
+        }
+        publishXphyStats(
+            std::move(allResults),
+            steady_clock::now() - begin,
+            maxXphyTime);
+      })
+      .ensure([cycleDone]() { cycleDone->setValue(); });
+}
+
+std::chrono::microseconds PhyManager::collectXphyStats(
+    phy::ExternalPhy* xphy,
+    std::vector<XphyPortStatsResult>& results) {
+  steady_clock::time_point begin = steady_clock::now();
+  for (auto& result : results) {
+    auto portID = result.portID;
+    try {
+      // Reading the xphy doesn't change the cache, but the port must not be
+      // reprogrammed while we read its lanes
+      const auto& rCache = getRLockedCache(portID);
+      if (rCache->systemLanes != result.systemLanes ||
+          rCache->lineLanes != result.lineLanes) {
+        XLOG(DBG3) << "Port " << portID
+                   << " reprogrammed, skip xphy stat collection";
+        continue;
+      }
+      if (result.collectStats) {
+        // if PORT_INFO feature is supported, use getPortInfo instead
+        if (xphy->isSupported(phy::ExternalPhy::Feature::PORT_INFO)) {
+          auto xphyPortInfo =
+              xphy->getPortInfo(result.systemLanes, result.lineLanes);
+          xphyPortInfo.name_ref() = getPortName(portID);
+          if (auto programmedSpeed = rCache->speed) {
+            xphyPortInfo.speed_ref() = *programmedSpeed;
+          } else {
+            throw FbossError("Missing programmed speed for port:", portID);
+          }
+          result.stats = phy::ExternalPhyPortStats::fromPhyInfo(xphyPortInfo);
+          result.phyInfo = std::move(xphyPortInfo);
+        } else {
+          result.stats =
+              xphy->getPortStats(result.systemLanes, result.lineLanes);
+        }
+      }
+      if (result.collectPrbsStats) {
+        result.prbsStats =
+            xphy->getPortPrbsStats(result.systemLanes, result.lineLanes);
+      }
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Port " << portID
+                << ": xphy stat collection failed: " << ex.what();
     }
   }
-
-  if (xphy->isSupported(phy::ExternalPhy::Feature::PRBS_STATS)) {
-    // Only needs to update prbs stats as long as there's one side enabled
-    if (wLockedCache->stats->isPrbsCollectionEnabled(phy::Side::SYSTEM) ||
-        wLockedCache->stats->isPrbsCollectionEnabled(phy::Side::LINE)) {
-      if (wLockedCache->ongoingPrbsStatCollection.has_value() &&
-          !wLockedCache->ongoingPrbsStatCollection->isReady()) {
-        XLOG(DBG4) << "XPHY PRBS Stat collection for Port:" << portID
-                   << " still underway...";
-      } else {
-        // Collect xphy prbs stats
-        wLockedCache->ongoingPrbsStatCollection =
-            folly::via(evb).thenValue([this, portID, xphy](auto&&) {
-              // Since this is future job, we need to fetch the cache with wlock
-              // again
-              const auto& wCache = getWLockedCache(portID);
-              steady_clock::time_point begin = steady_clock::now();
-              const auto& stats = xphy->getPortPrbsStats(
-                  wCache->systemLanes, wCache->lineLanes);
-              wCache->stats->updateXphyPrbsStats(stats);
-              XLOG(DBG3) << "Port " << portID
-                         << ": xphy prbs stat collection took "
-                         << duration_cast<milliseconds>(
-                                steady_clock::now() - begin)
-                                .count()
-                         << "ms";
-            });
-      }
+  auto xphyTime = duration_cast<microseconds>(steady_clock::now() - begin);
+  XLOG(DBG3) << "xphy stat collection of " << results.size()
+             << " ports took " << duration_cast<milliseconds>(xphyTime).count()
+             << "ms";
+  return xphyTime;
+}
+
+void PhyManager::publishXphyStats(
+    std::vector<XphyPortStatsResult> results,
+    steady_clock::duration cycleTime,
+    microseconds maxXphyTime) {
+  for (auto& result : results) {
+    auto portID = result.portID;
+    const auto& wCache = getWLockedCache(portID);
+    // The stats are reset when the port is reprogrammed, so drop the ones
+    // collected for the old lanes
+    if (wCache->systemLanes != result.systemLanes ||
+        wCache->lineLanes != result.lineLanes || !wCache->stats) {
+      continue;
+    }
+    if (result.phyInfo) {
+      updateXphyInfo(portID, *result.phyInfo);
+    }
+    if (result.stats) {
+      wCache->stats->updateXphyStats(*result.stats);
+    }
+    if (result.prbsStats) {
+      wCache->stats->updateXphyPrbsStats(*result.prbsStats);
     }
   }
+
+  publishXphyStatsCycleTime(cycleTime, maxXphyTime);
+  XLOG(DBG3) << "xphy stat collection of " << results.size()
+             << " ports took "
+             << duration_cast<milliseconds>(cycleTime).count() << "ms";
+}
+
+void PhyManager::publishXphyStatsCycleTime(
+    steady_clock::duration cycleTime,
+    microseconds maxXphyTime) {
+  fb303::fbData->setCounter(
+      kXphyStatsCycleTimeCounter,
+      duration_cast<milliseconds>(cycleTime).count());
+  fb303::fbData->setCounter(
+      kXphyStatsMaxXphyTimeCounter,
+      duration_cast<milliseconds>(maxXphyTime).count());
 }
 
 const std::string& PhyManager::getPortName(PortID portID) const {
@@ -13,8 +13,12 @@
 #include "fboss/mka_service/if/gen-cpp2/mka_structs_types.h"
 
 #include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/SerialExecutor.h>
 #include <folly/futures/Future.h>
+#include <chrono>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -239,6 +243,18 @@ class PhyManager {
 
   void setupPimEventMultiThreading(PimID pimID);
 
+  /*
+   * Executor to collect the stats of one xphy. It's a SerialExecutor on top
+   * of a thread pool shared by all xphys, so each xphy is accessed by one
+   * stats job at a time while different xphys are collected in parallel.
+   */
+  folly::Executor::KeepAlive<> getXphyStatsExecutor(GlobalXphyID xphyID);
+
+  // Export the duration of a stats cycle and of its slowest xphy to fb303
+  static void publishXphyStatsCycleTime(
+      std::chrono::steady_clock::duration cycleTime,
+      std::chrono::microseconds maxXphyTime);
+
   template <typename LockedPtr>
   phy::ExternalPhy* getExternalPhyLocked(const LockedPtr& lockedCache) {
     return getExternalPhy(lockedCache->xphyID);
@@ -301,10 +317,30 @@ class PhyManager {
       const phy::PhyIDInfo& phyIDInfo,
       MultiPimPlatformPimContainer* pimContainer) = 0;
 
-  // Update PortCacheInfo::stats
-  void updateStatsLocked(
-      const PortCacheWLockedPtr& wLockedCache,
-      PortID portID);
+  // Stats of one port collected during a stats cycle. The lanes are the ones
+  // the port had when the cycle started.
+  struct XphyPortStatsResult {
+    PortID portID;
+    std::vector<LaneID> systemLanes;
+    std::vector<LaneID> lineLanes;
+    bool collectStats{false};
+    bool collectPrbsStats{false};
+    std::optional<phy::PhyInfo> phyInfo;
+    std::optional<phy::ExternalPhyPortStats> stats;
+    std::optional<phy::ExternalPhyPortStats> prbsStats;
+  };
+
+  // Collect the stats of all the given ports of one xphy, holding the read
+  // lock of each port cache while accessing the xphy
+  std::chrono::microseconds collectXphyStats(
+      phy::ExternalPhy* xphy,
+      std::vector<XphyPortStatsResult>& results);
+
+  // Update PortCacheInfo::stats of all ports with the stats of a cycle
+  void publishXphyStats(
+      std::vector<XphyPortStatsResult> results,
+      std::chrono::steady_clock::duration cycleTime,
+      std::chrono::microseconds maxXphyTime);
 
   virtual std::unique_ptr<ExternalPhyPortStatsUtils> createExternalPhyPortStats(
       PortID portID) = 0;
@@ -329,6 +365,15 @@ class PhyManager {
   std::unordered_map<PimID, std::unique_ptr<PimEventMultiThreading>>
       pimToThread_;
 
+  // Stats of all xphys are collected in cycles: updateAllXphyPortsStats()
+  // doesn't start a new cycle until all xphys of the previous one are done
+  // and their stats are published.
+  std::mutex xphyStatsExecutorsLock_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> xphyStatsThreadPool_;
+  std::map<GlobalXphyID, folly::Executor::KeepAlive<folly::SerialExecutor>>
+      xphyStatsExecutors_;
+  std::optional<folly::Future<folly::Unit>> ongoingStatsCycle_;
+
   // In the constructor function, we create this portToCacheInfo_ based on the
   // PlatformMapping, which should have all xphy ports. But their default
   // PortCacheInfo has empty `systemLanes` and `lineLanes` as they're not
@@ -20,6 +20,7 @@
 #include "fboss/lib/phy/NullPortStats.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 
+#include <folly/futures/FutureSplitter.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
 namespace {
@@ -62,7 +63,14 @@ void SaiPhyManager::PlatformInfo::applyUpdate(
   }
 }
 
-SaiPhyManager::~SaiPhyManager() {}
+SaiPhyManager::~SaiPhyManager() {
+  // Stats collections use the SaiSwitches, wait for them to be done
+  for (auto& xphyAndStatsCollection : xphy2OngoingStatsCollection_) {
+    if (auto& statsCollection = xphyAndStatsCollection.second) {
+      statsCollection->wait();
+    }
+  }
+}
 
 SaiPhyManager::PlatformInfo::PlatformInfo(
     std::unique_ptr<SaiHwPlatform> platform)
@@ -106,37 +114,57 @@ SaiSwitch* SaiPhyManager::getSaiSwitch(PortID portID) {
 }
 
 void SaiPhyManager::updateAllXphyPortsStats() {
+  // Each xphy has its own SaiSwitch, so collect them all in parallel
+  steady_clock::time_point begin = steady_clock::now();
+  std::vector<folly::Future<microseconds>> xphyJobs;
   for (auto& pimAndXphyToPlatforms : saiPlatforms_) {
-    auto pimId = pimAndXphyToPlatforms.first;
-    auto& ongoingStatsCollection = pim2OngoingStatsCollection_[pimId];
-    if (ongoingStatsCollection && !ongoingStatsCollection->isReady()) {
-      XLOG(DBG4) << " Sai stats collection for PIM : " << pimId
-                 << "is still ongoing";
-    } else {
-      pim2OngoingStatsCollection_[pimId] =
-          folly::via(getPimEventBase(pimId)).thenValue([this, pimId](auto&&) {
-            steady_clock::time_point begin = steady_clock::now();
-            auto& xphyToPlatform = saiPlatforms_.find(pimId)->second;
-            for (auto& [xphy, platformInfo] : xphyToPlatform) {
-              try {
-                static SwitchStats unused;
-                platformInfo->getHwSwitch()->updateStats(&unused);
-              } catch (const std::exception& e) {
-                XLOG(INFO) << "Stats collection failed on : "
-                           << "switch: "
-                           << platformInfo->getHwSwitch()->getSwitchId()
-                           << " xphy: " << xphy << " error: " << e.what();
-              }
-            }
-            XLOG(DBG3) << "Pim " << static_cast<int>(pimId) << ": all "
-                       << xphyToPlatform.size() << " xphy stat collection took "
-                       << duration_cast<milliseconds>(
-                              steady_clock::now() - begin)
-                              .count()
-                       << "ms";
-          });
+    for (auto& [xphy, platformInfo] : pimAndXphyToPlatforms.second) {
+      auto& ongoingStatsCollection = xphy2OngoingStatsCollection_[xphy];
+      if (ongoingStatsCollection && !ongoingStatsCollection->isReady()) {
+        XLOG(DBG4) << " Sai stats collection for xphy : " << xphy
+                   << "is still ongoing";
+        continue;
+      }
+      auto xphyJob = folly::splitFuture(
+          folly::via(getXphyStatsExecutor(xphy))
+              .thenValue([xphy = xphy,
+                          hwSwitch = platformInfo->getHwSwitch()](auto&&) {
+                steady_clock::time_point xphyBegin = steady_clock::now();
+                try {
+                  static thread_local SwitchStats unused;
+                  hwSwitch->updateStats(&unused);
+                } catch (const std::exception& e) {
+                  XLOG(INFO) << "Stats collection failed on : "
+                             << "switch: " << hwSwitch->getSwitchId()
+                             << " xphy: " << xphy << " error: " << e.what();
+                }
+                auto xphyTime = duration_cast<microseconds>(
+                    steady_clock::now() - xphyBegin);
+                XLOG(DBG3) << "Xphy " << xphy << ": stat collection took "
+                           << duration_cast<milliseconds>(xphyTime).count()
+                           << "ms";
+                return xphyTime;
+              }));
+      ongoingStatsCollection = xphyJob.getFuture().unit();
+      xphyJobs.push_back(xphyJob.getFuture());
     }
   }
+  if (xphyJobs.empty()) {
+    return;
+  }
+
+  // A cycle ends when all the xphys it started are done. Xphys still busy
+  // with a previous cycle are skipped above, so they are not accounted here
+  folly::collectAll(std::move(xphyJobs))
+      .thenValue([begin](auto&& xphyTimes) {
+        microseconds maxXphyTime{0};
+        for (auto& xphyTime : xphyTimes) {
+          if (xphyTime.hasValue()) {
+            maxXphyTime = std::max(maxXphyTime, xphyTime.value());
+          }
+        }
+        publishXphyStatsCycleTime(steady_clock::now() - begin, maxXphyTime);
+      });
 }
 
 void SaiPhyManager::addSaiPlatform(
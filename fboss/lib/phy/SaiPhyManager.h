@@ -171,8 +171,8 @@ class SaiPhyManager : public PhyManager {
   const folly::MacAddress localMac_;
   std::map<PimID, std::map<GlobalXphyID, std::unique_ptr<PlatformInfo>>>
       saiPlatforms_;
-  std::map<PimID, std::optional<folly::Future<folly::Unit>>>
-      pim2OngoingStatsCollection_;
+  std::map<GlobalXphyID, std::optional<folly::Future<folly::Unit>>>
+      xphy2OngoingStatsCollection_;
 };
 
 using namespace std::chrono;
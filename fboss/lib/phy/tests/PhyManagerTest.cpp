@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/platforms/common/yamp/YampPlatformMapping.h"
+#include "fboss/lib/phy/NullPortStats.h"
+#include "fboss/lib/phy/PhyManager.h"
+
+#include <fb303/ServiceData.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kGetPortStatsTime = std::chrono::milliseconds(10);
+const auto kPim = PimID(2);
+
+// Tracks how many getPortStats() calls are in flight, over all xphys
+std::atomic<int> inFlightAllXphys{0};
+std::atomic<int> maxInFlightAllXphys{0};
+
+void updateMax(std::atomic<int>& max, int value) {
+  auto current = max.load();
+  while (value > current && !max.compare_exchange_weak(current, value)) {
+  }
+}
+
+class FakeExternalPhy : public phy::ExternalPhy {
+ public:
+  phy::PhyFwVersion fwVersion() override {
+    return phy::PhyFwVersion();
+  }
+  void programOnePort(phy::PhyPortConfig /* config */) override {}
+  bool isSupported(Feature feature) const override {
+    return feature == Feature::PORT_STATS;
+  }
+  phy::PhyPortConfig getConfigOnePort(
+      const std::vector<LaneID>& /* sysLanes */,
+      const std::vector<LaneID>& /* lineLanes */) override {
+    return phy::PhyPortConfig();
+  }
+  phy::Loopback getLoopback(phy::Side /* side */) override {
+    return phy::Loopback::OFF;
+  }
+  void setLoopback(phy::Side /* side */, phy::Loopback /* loopback */)
+      override {}
+  void setPortPrbs(
+      phy::Side /* side */,
+      const std::vector<LaneID>& /* lanes */,
+      const phy::PortPrbsState& /* prbs */) override {}
+  phy::PortPrbsState getPortPrbs(
+      phy::Side /* side */,
+      const std::vector<LaneID>& /* lanes */) override {
+    return phy::PortPrbsState();
+  }
+  phy::ExternalPhyPortStats getPortStats(
+      const std::vector<LaneID>& /* sysLanes */,
+      const std::vector<LaneID>& /* lineLanes */) override {
+    updateMax(maxInFlight_, ++inFlight_);
+    updateMax(maxInFlightAllXphys, ++inFlightAllXphys);
+    /* sleep override */
+    std::this_thread::sleep_for(kGetPortStatsTime);
+    --inFlightAllXphys;
+    --inFlight_;
+    return phy::ExternalPhyPortStats();
+  }
+  phy::ExternalPhyPortStats getPortPrbsStats(
+      const std::vector<LaneID>& /* sysLanes */,
+      const std::vector<LaneID>& /* lineLanes */) override {
+    return phy::ExternalPhyPortStats();
+  }
+  void reset() override {}
+
+  int getMaxInFlight() const {
+    return maxInFlight_;
+  }
+
+ private:
+  std::atomic<int> inFlight_{0};
+  std::atomic<int> maxInFlight_{0};
+};
+
+class FakePortStats : public NullPortStats {
+ public:
+  explicit FakePortStats(std::string prefix) : NullPortStats(prefix) {}
+
+  void updateXphyStats(
+      const phy::ExternalPhyPortStats& /* stats */,
+      std::optional<std::chrono::seconds> /* now */) override {
+    numUpdates_++;
+  }
+
+  int getNumUpdates() const {
+    return numUpdates_;
+  }
+
+ private:
+  std::atomic<int> numUpdates_{0};
+};
+
+// All the xphys of the platform mapping are on the same pim, so the pim
+// thread can't be what makes the collection parallel
+class FakePhyManager : public PhyManager {
+ public:
+  explicit FakePhyManager(const PlatformMapping* platformMapping)
+      : PhyManager(platformMapping) {
+    for (auto portID : getXphyPorts()) {
+      auto xphyID = getGlobalXphyIDbyPortID(portID);
+      auto& xphy = xphyMap_[kPim][xphyID];
+      if (!xphy) {
+        xphy = std::make_unique<FakeExternalPhy>();
+      }
+    }
+  }
+
+  phy::PhyIDInfo getPhyIDInfo(GlobalXphyID xphyID) const override {
+    return {kPim, MdioControllerID(xphyID / 256), PhyAddr(xphyID % 256)};
+  }
+  GlobalXphyID getGlobalXphyID(
+      const phy::PhyIDInfo& phyIDInfo) const override {
+    return GlobalXphyID(phyIDInfo.controllerID * 256 + phyIDInfo.phyAddr);
+  }
+  bool initExternalPhyMap() override {
+    return true;
+  }
+  void initializeSlotPhys(PimID /* pimID */, bool /* warmboot */) override {}
+  MultiPimPlatformSystemContainer* getSystemContainer() override {
+    return nullptr;
+  }
+
+  // Cache the port as programmed, without going through the xphy
+  void setPortProgrammed(PortID portID) {
+    const auto& wLockedCache = getWLockedCache(portID);
+    wLockedCache->systemLanes = {LaneID(0)};
+    wLockedCache->lineLanes = {LaneID(0)};
+    wLockedCache->speed = cfg::PortSpeed::HUNDREDG;
+    setPortToExternalPhyPortStatsLocked(
+        wLockedCache, createExternalPhyPortStats(portID));
+  }
+
+  int getNumStatsUpdates(PortID portID) const {
+    return static_cast<const FakePortStats*>(
+               getRLockedCache(portID)->stats.get())
+        ->getNumUpdates();
+  }
+
+  const FakeExternalPhy* getFakeXphy(GlobalXphyID xphyID) const {
+    return static_cast<const FakeExternalPhy*>(
+        xphyMap_.at(kPim).at(xphyID).get());
+  }
+
+ private:
+  void createExternalPhy(
+      const phy::PhyIDInfo& /* phyIDInfo */,
+      MultiPimPlatformPimContainer* /* pimContainer */) override {}
+
+  std::unique_ptr<ExternalPhyPortStatsUtils> createExternalPhyPortStats(
+      PortID portID) override {
+    return std::make_unique<FakePortStats>(getPortName(portID));
+  }
+};
+
+class PhyManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    platformMapping_ = std::make_unique<YampPlatformMapping>();
+    phyManager_ = std::make_unique<FakePhyManager>(platformMapping_.get());
+    ports_ = phyManager_->getXphyPorts();
+    for (auto portID : ports_) {
+      phyManager_->setPortProgrammed(portID);
+    }
+    inFlightAllXphys = 0;
+    maxInFlightAllXphys = 0;
+  }
+
+  void waitForStatsCycle() {
+    for (auto portID : ports_) {
+      while (!phyManager_->isXphyStatsCollectionDone(portID)) {
+        /* sleep override */
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  std::unique_ptr<PlatformMapping> platformMapping_;
+  std::unique_ptr<FakePhyManager> phyManager_;
+  std::vector<PortID> ports_;
+};
+} // namespace
+
+TEST_F(PhyManagerTest, updateAllXphyPortsStats) {
+  ASSERT_FALSE(ports_.empty());
+  phyManager_->updateAllXphyPortsStats();
+  // A new cycle doesn't start while the previous one is still underway
+  phyManager_->updateAllXphyPortsStats();
+  waitForStatsCycle();
+
+  std::set<GlobalXphyID> xphys;
+  for (auto portID : ports_) {
+    EXPECT_EQ(phyManager_->getNumStatsUpdates(portID), 1);
+    xphys.insert(phyManager_->getGlobalXphyIDbyPortID(portID));
+  }
+  // Each xphy is only accessed by one job at a time, but different xphys
+  // are collected in parallel
+  for (auto xphyID : xphys) {
+    EXPECT_EQ(phyManager_->getFakeXphy(xphyID)->getMaxInFlight(), 1);
+  }
+  if (xphys.size() > 1) {
+    EXPECT_GT(maxInFlightAllXphys, 1);
+  }
+  EXPECT_TRUE(fb303::fbData->hasCounter("xphy.stats.cycle_time_ms"));
+  EXPECT_TRUE(fb303::fbData->hasCounter("xphy.stats.max_xphy_time_ms"));
+
+  phyManager_->updateAllXphyPortsStats();
+  waitForStatsCycle();
+  for (auto portID : ports_) {
+    EXPECT_EQ(phyManager_->getNumStatsUpdates(portID), 2);
+  }
+}
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/FunctionCallTimeReporter.h"
+
+#include <fb303/ServiceData.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+DECLARE_int32(update_breakdown_history);
+
+using namespace facebook::fboss;
+
+namespace {
+void runPhases(int calls) {
+  for (int i = 0; i < calls; i++) {
+    TIME_PHASE("test_inner");
+  }
+  TIME_PHASE("test_outer");
+}
+} // namespace
+
+TEST(FunctionCallTimeReporter, registerPhase) {
+  auto phase = FunctionCallTimeReporter::registerPhase("test_register");
+  EXPECT_EQ(phase, FunctionCallTimeReporter::registerPhase("test_register"));
+  EXPECT_NE(phase, FunctionCallTimeReporter::registerPhase("test_register2"));
+}
+
+TEST(FunctionCallTimeReporter, updateBreakdown) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_phase_timing = true;
+  {
+    ScopedUpdateTimer update("update");
+    runPhases(3);
+    // Part of the outer update
+    ScopedUpdateTimer nested("nested");
+    runPhases(1);
+  }
+  // Outside of any update
+  runPhases(1);
+
+  auto breakdowns = FunctionCallTimeReporter::getRecentUpdateBreakdowns(1);
+  ASSERT_EQ(breakdowns.size(), 1);
+  const auto& breakdown = breakdowns.front();
+  EXPECT_EQ(breakdown.name, "update");
+  ASSERT_EQ(breakdown.phases.size(), 2);
+  EXPECT_EQ(breakdown.phases[0].phase, "test_inner");
+  EXPECT_EQ(breakdown.phases[0].calls, 4);
+  EXPECT_EQ(breakdown.phases[1].phase, "test_outer");
+  EXPECT_EQ(breakdown.phases[1].calls, 2);
+  EXPECT_LE(breakdown.phases[0].duration, breakdown.duration);
+  FunctionCallTimeReporter::publishPhaseStats();
+}
+
+TEST(FunctionCallTimeReporter, breakdownHistory) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_phase_timing = true;
+  FLAGS_update_breakdown_history = 2;
+  for (auto name : {"first", "second", "third"}) {
+    ScopedUpdateTimer update(name);
+    runPhases(1);
+  }
+  auto breakdowns = FunctionCallTimeReporter::getRecentUpdateBreakdowns(10);
+  ASSERT_EQ(breakdowns.size(), 2);
+  EXPECT_EQ(breakdowns[0].name, "second");
+  EXPECT_EQ(breakdowns[1].name, "third");
+
+  // No breakdowns or phases while disabled
+  FLAGS_enable_phase_timing = false;
+  {
+    ScopedUpdateTimer update("disabled");
+    runPhases(1);
+  }
+  EXPECT_EQ(
+      FunctionCallTimeReporter::getRecentUpdateBreakdowns(1).front().name,
+      "third");
+}
+
+TEST(FunctionCallTimeReporter, lazyUpdateName) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_phase_timing = true;
+  int nameCalls = 0;
+  {
+    ScopedUpdateTimer update([&nameCalls] {
+      nameCalls++;
+      return std::string("lazy");
+    });
+    runPhases(1);
+  }
+  EXPECT_EQ(nameCalls, 0);
+  EXPECT_EQ(
+      FunctionCallTimeReporter::getRecentUpdateBreakdowns(1).front().name,
+      "lazy");
+  EXPECT_EQ(nameCalls, 1);
+}
+
+TEST(FunctionCallTimeReporter, publishPhaseStats) {
+  using std::chrono::microseconds;
+  auto phase = FunctionCallTimeReporter::registerPhase("test_publish");
+  // 10us falls in [8, 16), 1000us in [512, 1024)
+  for (int i = 0; i < 97; i++) {
+    FunctionCallTimeReporter::recordPhase(phase, microseconds(10));
+  }
+  for (int i = 0; i < 2; i++) {
+    FunctionCallTimeReporter::recordPhase(phase, microseconds(1000));
+  }
+  // Recorded by a thread which exits before the publish
+  std::thread([phase] {
+    FunctionCallTimeReporter::recordPhase(phase, microseconds(10));
+  }).join();
+
+  FunctionCallTimeReporter::publishPhaseStats();
+  EXPECT_EQ(fb303::fbData->getCounter("phase.test_publish.calls"), 100);
+  EXPECT_EQ(fb303::fbData->getCounter("phase.test_publish.p50_us"), 16);
+  EXPECT_EQ(fb303::fbData->getCounter("phase.test_publish.p99_us"), 1024);
+
+  // The window covers the calls since the first publish it has
+  FunctionCallTimeReporter::recordPhase(phase, microseconds(10));
+  FunctionCallTimeReporter::publishPhaseStats();
+  EXPECT_EQ(fb303::fbData->getCounter("phase.test_publish.calls"), 101);
+}
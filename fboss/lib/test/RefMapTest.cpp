@@ -180,6 +180,22 @@ TEST(RefMap, reinsertExpired) {
   EXPECT_TRUE(ins);
 }
 
+TEST(RefMap, rekey) {
+  FlatRefMap<int, A> identityMap;
+  auto a1 = identityMap.refOrEmplace(42, 42).first;
+  auto a2 = identityMap.refOrEmplace(43, 43).first;
+  EXPECT_FALSE(identityMap.rekey(42, 43));
+  EXPECT_FALSE(identityMap.rekey(44, 45));
+  EXPECT_TRUE(identityMap.rekey(42, 44));
+  EXPECT_EQ(identityMap.get(42), nullptr);
+  EXPECT_EQ(identityMap.get(44), a1.get());
+  EXPECT_EQ(identityMap.size(), 2);
+  // The last reference removes the entry under its new key
+  a1.reset();
+  EXPECT_EQ(identityMap.get(44), nullptr);
+  EXPECT_EQ(identityMap.size(), 1);
+}
+
 TEST(RefMap, IteratorTest) {
   UnorderedRefMap<int, A> unOrderedRedMap;
   FlatRefMap<int, A> flatRefMap;
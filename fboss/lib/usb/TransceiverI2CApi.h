@@ -11,11 +11,14 @@
 
 #include <folly/io/async/EventBase.h>
 #include "fboss/lib/i2c/gen-cpp2/i2c_controller_stats_types.h"
+#include "fboss/lib/usb/TransceiverReadTransaction.h"
 
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace facebook::fboss {
 enum class ModulePresence { PRESENT, ABSENT, UNKNOWN };
@@ -57,6 +60,35 @@ class TransceiverI2CApi {
       int len,
       const uint8_t* buf) = 0;
 
+  /*
+   * Issue all the reads of a transaction to the module as one sequence.
+   * Platforms override this to hold the bus for the whole sequence instead of
+   * locking it for every single read and page select. pageSelectDelay is
+   * waited after each page select, for modules that need time after a write.
+   */
+  virtual void moduleReadTransaction(
+      unsigned int module,
+      uint8_t i2cAddress,
+      const TransceiverReadTransaction& txn,
+      std::chrono::microseconds pageSelectDelay) {
+    txn.execute(
+        [&](uint8_t page) {
+          moduleWrite(
+              module,
+              i2cAddress,
+              TransceiverReadTransaction::kPageSelectReg,
+              sizeof(page),
+              &page);
+          if (pageSelectDelay.count()) {
+            /* sleep override */
+            std::this_thread::sleep_for(pageSelectDelay);
+          }
+        },
+        [&](int offset, int len, uint8_t* buf) {
+          moduleRead(module, i2cAddress, offset, len, buf);
+        });
+  }
+
   virtual void verifyBus(bool autoReset) = 0;
 
   virtual bool isPresent(unsigned int module) = 0;
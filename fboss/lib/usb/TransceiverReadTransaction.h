@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * A set of reads from the paged memory map of a transceiver module, to be
+ * issued as a single sequence of bus transactions.
+ *
+ * Reads from the same page that overlap or are adjacent are coalesced into
+ * one bus read of at most kMaxReadLength bytes, and each page is selected
+ * only once. Reads from the page that is already selected are issued first
+ * so that they don't need a page select at all.
+ */
+class TransceiverReadTransaction {
+ public:
+  // Page of the reads that don't need a page select: the lower page, and the
+  // upper page of flat memory modules
+  static constexpr int kNoPageSelect = -1;
+  static constexpr int kPageSelectReg = 127;
+  static constexpr int kMaxReadLength = 128;
+
+  using SelectPageFn = std::function<void(uint8_t page)>;
+  using ReadFn = std::function<void(int offset, int len, uint8_t* buf)>;
+
+  /*
+   * Read len bytes at offset (0-255, as in the module memory map) of the page
+   * into buf. buf must stay valid until the transaction is executed.
+   */
+  void addRead(int page, int offset, int len, uint8_t* buf) {
+    reads_.push_back({page, offset, len, buf});
+  }
+
+  /*
+   * Let the transaction know which page is currently selected on the module,
+   * for example from byte 127 of a lower page that was just read.
+   */
+  void setSelectedPage(int page) {
+    selectedPage_ = page;
+  }
+
+  bool empty() const {
+    return reads_.empty();
+  }
+
+  /*
+   * Issue the transaction with the given bus primitives. Returns the page
+   * which is selected when the transaction is done, if known.
+   */
+  std::optional<int> execute(
+      const SelectPageFn& selectPage,
+      const ReadFn& read) const {
+    auto selectedPage = selectedPage_;
+    std::array<uint8_t, kMaxReadLength> buf;
+    for (const auto& busRead : coalesce()) {
+      if (busRead.page != kNoPageSelect && busRead.page != selectedPage) {
+        selectPage(busRead.page);
+        selectedPage = busRead.page;
+      }
+      if (busRead.reads.size() == 1) {
+        read(busRead.offset, busRead.len, reads_[busRead.reads[0]].buf);
+        continue;
+      }
+      read(busRead.offset, busRead.len, buf.data());
+      for (auto idx : busRead.reads) {
+        const auto& r = reads_[idx];
+        std::memcpy(r.buf, buf.data() + r.offset - busRead.offset, r.len);
+      }
+    }
+    return selectedPage;
+  }
+
+  /*
+   * Number of bus transactions, page selects included, execute() will issue
+   */
+  int numBusTransactions() const {
+    int num = 0;
+    auto selectedPage = selectedPage_;
+    for (const auto& busRead : coalesce()) {
+      if (busRead.page != kNoPageSelect && busRead.page != selectedPage) {
+        ++num;
+        selectedPage = busRead.page;
+      }
+      ++num;
+    }
+    return num;
+  }
+
+ private:
+  struct Read {
+    int page;
+    int offset;
+    int len;
+    uint8_t* buf;
+  };
+
+  struct BusRead {
+    int page;
+    int offset;
+    int len;
+    // Indices into reads_ served by this bus read
+    std::vector<size_t> reads;
+  };
+
+  // Order in which pages are visited: no page select first, then the
+  // selected page, then the others in the order they were first added
+  int pageRank(int page, const std::vector<int>& pageOrder) const {
+    if (page == kNoPageSelect) {
+      return -2;
+    }
+    if (selectedPage_ && page == *selectedPage_) {
+      return -1;
+    }
+    return std::find(pageOrder.begin(), pageOrder.end(), page) -
+        pageOrder.begin();
+  }
+
+  std::vector<BusRead> coalesce() const {
+    std::vector<int> pageOrder;
+    for (const auto& r : reads_) {
+      if (std::find(pageOrder.begin(), pageOrder.end(), r.page) ==
+          pageOrder.end()) {
+        pageOrder.push_back(r.page);
+      }
+    }
+
+    std::vector<size_t> sorted(reads_.size());
+    for (size_t i = 0; i < sorted.size(); i++) {
+      sorted[i] = i;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+      auto rankA = pageRank(reads_[a].page, pageOrder);
+      auto rankB = pageRank(reads_[b].page, pageOrder);
+      if (rankA != rankB) {
+        return rankA < rankB;
+      }
+      return reads_[a].offset < reads_[b].offset;
+    });
+
+    std::vector<BusRead> busReads;
+    for (auto idx : sorted) {
+      const auto& r = reads_[idx];
+      if (!busReads.empty()) {
+        auto& last = busReads.back();
+        auto end = std::max(last.offset + last.len, r.offset + r.len);
+        if (last.page == r.page && r.offset <= last.offset + last.len &&
+            end - last.offset <= kMaxReadLength) {
+          last.len = end - last.offset;
+          last.reads.push_back(idx);
+          continue;
+        }
+      }
+      busReads.push_back({r.page, r.offset, r.len, {idx}});
+    }
+    return busReads;
+  }
+
+  std::vector<Read> reads_;
+  std::optional<int> selectedPage_;
+};
+
+} // namespace facebook::fboss
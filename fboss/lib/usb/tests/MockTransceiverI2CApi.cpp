@@ -38,8 +38,9 @@ void MockTransceiverI2CApi::moduleRead(
 
 void MockTransceiverI2CApi::scanPresence(
     std::map<int32_t, ModulePresence>& presences) {
+  // presences is indexed by 0 based module id, while isPresent() takes 1 based
   for (auto& presence : presences) {
-    if (isPresent(presence.first)) {
+    if (isPresent(presence.first + 1)) {
       presence.second = ModulePresence::PRESENT;
     } else {
       presence.second = ModulePresence::ABSENT;
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/TransceiverReadTransaction.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+// Fake paged memory map which logs every bus transaction
+class FakePagedMemory {
+ public:
+  FakePagedMemory() {
+    for (int i = 0; i < 256; i++) {
+      lower_[i] = i;
+    }
+  }
+
+  void selectPage(uint8_t page) {
+    log_.push_back("select " + std::to_string(page));
+    page_ = page;
+  }
+
+  void read(int offset, int len, uint8_t* buf) {
+    log_.push_back(
+        "read " + std::to_string(offset) + " " + std::to_string(len));
+    for (int i = 0; i < len; i++) {
+      auto pos = offset + i;
+      buf[i] = pos < 128 ? lower_[pos] : page_ * 16 + (pos - 128);
+    }
+  }
+
+  std::optional<int> execute(const TransceiverReadTransaction& txn) {
+    return txn.execute(
+        [this](uint8_t page) { selectPage(page); },
+        [this](int offset, int len, uint8_t* buf) { read(offset, len, buf); });
+  }
+
+  std::vector<std::string> log_;
+  uint8_t lower_[256];
+  uint8_t page_{0};
+};
+
+} // namespace
+
+TEST(TransceiverReadTransactionTest, coalesceAdjacentReads) {
+  FakePagedMemory mem;
+  uint8_t pre[4], post[4], mainAmp[4];
+  TransceiverReadTransaction txn;
+  txn.addRead(0x11, 231, 4, mainAmp);
+  txn.addRead(0x11, 223, 4, pre);
+  txn.addRead(0x11, 227, 4, post);
+  EXPECT_EQ(txn.numBusTransactions(), 2);
+
+  EXPECT_EQ(mem.execute(txn), 0x11);
+  EXPECT_EQ(mem.log_, (std::vector<std::string>{"select 17", "read 223 12"}));
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(pre[i], (uint8_t)(0x11 * 16 + 95 + i));
+    EXPECT_EQ(post[i], (uint8_t)(0x11 * 16 + 99 + i));
+    EXPECT_EQ(mainAmp[i], (uint8_t)(0x11 * 16 + 103 + i));
+  }
+}
+
+TEST(TransceiverReadTransactionTest, selectedPageFirst) {
+  FakePagedMemory mem;
+  uint8_t page0[128], page1[128], page3[128];
+  TransceiverReadTransaction txn;
+  txn.setSelectedPage(3);
+  txn.addRead(0, 128, sizeof(page0), page0);
+  txn.addRead(1, 128, sizeof(page1), page1);
+  txn.addRead(3, 128, sizeof(page3), page3);
+  EXPECT_EQ(txn.numBusTransactions(), 5);
+
+  mem.page_ = 3;
+  EXPECT_EQ(mem.execute(txn), 1);
+  EXPECT_EQ(
+      mem.log_,
+      (std::vector<std::string>{
+          "read 128 128",
+          "select 0",
+          "read 128 128",
+          "select 1",
+          "read 128 128"}));
+  EXPECT_EQ(page3[0], (uint8_t)(3 * 16));
+  EXPECT_EQ(page0[5], 5);
+  EXPECT_EQ(page1[0], 16);
+}
+
+TEST(TransceiverReadTransactionTest, noMergeAcrossPagesOrPastMaxLength) {
+  FakePagedMemory mem;
+  uint8_t lower[128], upper[128], a[4], b[4];
+  TransceiverReadTransaction txn;
+  // The lower page and page 00h are contiguous in the memory map, but a
+  // single read can't be longer than kMaxReadLength
+  txn.addRead(TransceiverReadTransaction::kNoPageSelect, 0, 128, lower);
+  txn.addRead(0, 128, sizeof(upper), upper);
+  // Same offsets on different pages
+  txn.addRead(2, 200, sizeof(a), a);
+  txn.addRead(4, 204, sizeof(b), b);
+  txn.setSelectedPage(0);
+
+  mem.execute(txn);
+  EXPECT_EQ(
+      mem.log_,
+      (std::vector<std::string>{
+          "read 0 128",
+          "read 128 128",
+          "select 2",
+          "read 200 4",
+          "select 4",
+          "read 204 4"}));
+}
@@ -98,6 +98,27 @@ void QsfpServiceHandler::syncPorts(
   manager_->syncPorts(info, std::move(ports));
 }
 
+apache::thrift::ServerStream<TransceiverInfoUpdate>
+QsfpServiceHandler::subscribeTransceiverInfo() {
+  auto log = LOG_THRIFT_CALL(INFO);
+  return manager_->getTransceiverInfoPublisher()->subscribe();
+}
+
+void QsfpServiceHandler::getTransceiverMonitorHistory(
+    TransceiverMonitorHistory& history,
+    int32_t idx,
+    int64_t start,
+    int64_t end) {
+  auto log = LOG_THRIFT_CALL(INFO);
+  history = manager_->getTransceiverHistory().getHistory(idx, start, end);
+}
+
+void QsfpServiceHandler::getRecentThreadStalls(
+    std::vector<ThreadStallInfo>& stalls) {
+  auto log = LOG_THRIFT_CALL(INFO);
+  stalls = manager_->getRecentThreadStalls();
+}
+
 void QsfpServiceHandler::pauseRemediation(int32_t timeout) {
   auto log = LOG_THRIFT_CALL(INFO);
   manager_->setPauseRemediation(timeout);
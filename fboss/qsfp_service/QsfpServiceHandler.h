@@ -59,6 +59,21 @@ class QsfpServiceHandler
       std::map<int32_t, TransceiverInfo>& info,
       std::unique_ptr<std::map<int32_t, PortStatus>> ports) override;
 
+  /*
+   * Stream of transceiver info changes, starting with a full sync.
+   */
+  apache::thrift::ServerStream<TransceiverInfoUpdate> subscribeTransceiverInfo()
+      override;
+
+  /*
+   * History of the DOM and VDM monitors of a transceiver
+   */
+  void getTransceiverMonitorHistory(
+      TransceiverMonitorHistory& history,
+      int32_t idx,
+      int64_t start,
+      int64_t end) override;
+
   /*
    * Customise the transceiver based on the speed at which it has
    * been configured to operate at
@@ -72,6 +87,11 @@ class QsfpServiceHandler
     return manager_.get();
   }
 
+  /*
+   * Stack traces of the update thread from its recent missed heartbeats
+   */
+  void getRecentThreadStalls(std::vector<ThreadStallInfo>& stalls) override;
+
   void pauseRemediation(int32_t timeout) override;
 
   int32_t getRemediationUntilTime() override;
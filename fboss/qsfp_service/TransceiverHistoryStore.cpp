@@ -0,0 +1,286 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverHistoryStore.h"
+
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+// Bucket time of the buckets which never had a sample
+constexpr int64_t kEmptyBucket = -1;
+// Value of the monitors in the buckets without a sample of their clock, and
+// of the VDM monitors before the first capture
+constexpr float kNoSample = std::numeric_limits<float>::quiet_NaN();
+} // namespace
+
+namespace facebook::fboss {
+
+TransceiverHistoryStore::TransceiverHistoryStore(std::vector<Tier> tiers)
+    : tiers_(std::move(tiers)) {
+  CHECK(!tiers_.empty());
+  for (const auto& tier : tiers_) {
+    CHECK_GT(tier.interval.count(), 0);
+    CHECK_GT(tier.numBuckets, 0);
+  }
+}
+
+void TransceiverHistoryStore::addSample(
+    int32_t id,
+    const TransceiverInfo& info) {
+  if (!*info.present_ref()) {
+    return;
+  }
+  int64_t time = info.timeCollected_ref().has_value()
+      ? *info.timeCollected_ref()
+      : std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+  int64_t laneTime = info.channelsTimeCollected_ref().value_or(time);
+  int64_t vdmTime = info.vdmDiagsStats_ref().has_value()
+      ? info.vdmTimeCollected_ref().value_or(0)
+      : 0;
+  std::vector<float> values;
+  getMonitors(info, values, nullptr);
+
+  auto lockedTransceivers = transceivers_.wlock();
+  auto it = lockedTransceivers->find(id);
+  if (it == lockedTransceivers->end() ||
+      it->second.monitors.size() != values.size()) {
+    // First sample, or a different kind of module was plugged in
+    std::vector<float> ignored;
+    std::vector<Monitor> monitors;
+    getMonitors(info, ignored, &monitors);
+    XLOG(DBG2) << "Transceiver=" << id << " history started with "
+               << monitors.size() << " monitors";
+    it = lockedTransceivers
+             ->insert_or_assign(id, newTransceiverBuckets(std::move(monitors)))
+             .first;
+  }
+
+  auto& buckets = it->second;
+  if (time <= buckets.lastSampleTime) {
+    return;
+  }
+  buckets.lastSampleTime = time;
+  std::array<bool, static_cast<size_t>(Clock::NUM_CLOCKS)> sampleClock;
+  sampleClock[static_cast<size_t>(Clock::MODULE)] = true;
+  sampleClock[static_cast<size_t>(Clock::CHANNELS)] =
+      laneTime > buckets.lastLaneSampleTime;
+  sampleClock[static_cast<size_t>(Clock::VDM)] =
+      vdmTime > buckets.lastVdmSampleTime;
+  buckets.lastLaneSampleTime = std::max(buckets.lastLaneSampleTime, laneTime);
+  buckets.lastVdmSampleTime = std::max(buckets.lastVdmSampleTime, vdmTime);
+
+  for (size_t i = 0; i < tiers_.size(); i++) {
+    auto interval = tiers_[i].interval.count();
+    auto numBuckets = tiers_[i].numBuckets;
+    auto& tier = buckets.tiers[i];
+
+    // The bucket of the slot is older than this sample, since samples only
+    // move forward
+    int64_t bucketTime = time - time % interval;
+    size_t slot = (time / interval) % numBuckets;
+    if (tier.times[slot] != bucketTime) {
+      tier.times[slot] = bucketTime;
+      for (auto& counts : tier.counts) {
+        counts[slot] = 0;
+      }
+    }
+
+    for (size_t monitor = 0; monitor < values.size(); monitor++) {
+      auto clock = static_cast<size_t>(buckets.monitors[monitor].clock);
+      if (!sampleClock[clock]) {
+        continue;
+      }
+      auto count = tier.counts[clock][slot];
+      auto idx = monitor * numBuckets + slot;
+      auto value = values[monitor];
+      if (count == 0) {
+        tier.mins[idx] = tier.maxs[idx] = tier.avgs[idx] = value;
+      } else {
+        tier.mins[idx] = std::min(tier.mins[idx], value);
+        tier.maxs[idx] = std::max(tier.maxs[idx], value);
+        tier.avgs[idx] += (value - tier.avgs[idx]) / (count + 1);
+      }
+    }
+    for (size_t clock = 0; clock < tier.counts.size(); clock++) {
+      if (sampleClock[clock] &&
+          tier.counts[clock][slot] < std::numeric_limits<uint16_t>::max()) {
+        tier.counts[clock][slot]++;
+      }
+    }
+  }
+}
+
+TransceiverMonitorHistory TransceiverHistoryStore::getHistory(
+    int32_t id,
+    int64_t start,
+    int64_t end) const {
+  TransceiverMonitorHistory history;
+  history.transceiver_ref() = id;
+
+  auto lockedTransceivers = transceivers_.rlock();
+  auto it = lockedTransceivers->find(id);
+  if (it == lockedTransceivers->end()) {
+    return history;
+  }
+  const auto& buckets = it->second;
+
+  // Use the finest tier which goes back to start, or the coarsest one
+  size_t tierIdx = tiers_.size() - 1;
+  int64_t lastBucket = 0;
+  int64_t oldestBucket = 0;
+  for (size_t i = 0; i < tiers_.size(); i++) {
+    auto interval = tiers_[i].interval.count();
+    lastBucket = buckets.lastSampleTime - buckets.lastSampleTime % interval;
+    oldestBucket = lastBucket -
+        static_cast<int64_t>(tiers_[i].numBuckets - 1) * interval;
+    if (start >= oldestBucket) {
+      tierIdx = i;
+      break;
+    }
+  }
+  auto interval = tiers_[tierIdx].interval.count();
+  auto numBuckets = tiers_[tierIdx].numBuckets;
+  const auto& tier = buckets.tiers[tierIdx];
+  history.interval_ref() = interval;
+
+  std::vector<MonitorHistory> monitors(buckets.monitors.size());
+  for (size_t monitor = 0; monitor < monitors.size(); monitor++) {
+    monitors[monitor].name_ref() = buckets.monitors[monitor].name;
+    if (auto lane = buckets.monitors[monitor].lane) {
+      monitors[monitor].lane_ref() = *lane;
+    }
+  }
+
+  int64_t first = std::max(start - start % interval, oldestBucket);
+  for (int64_t bucketTime = first;
+       bucketTime <= std::min(end, lastBucket);
+       bucketTime += interval) {
+    size_t slot = (bucketTime / interval) % numBuckets;
+    const auto& moduleCounts = tier.counts[static_cast<size_t>(Clock::MODULE)];
+    if (tier.times[slot] != bucketTime || moduleCounts[slot] == 0) {
+      continue;
+    }
+    history.bucketTimes_ref()->push_back(bucketTime);
+    for (size_t monitor = 0; monitor < monitors.size(); monitor++) {
+      auto clock = static_cast<size_t>(buckets.monitors[monitor].clock);
+      if (tier.counts[clock][slot] == 0) {
+        monitors[monitor].min_ref()->push_back(kNoSample);
+        monitors[monitor].max_ref()->push_back(kNoSample);
+        monitors[monitor].avg_ref()->push_back(kNoSample);
+        continue;
+      }
+      auto idx = monitor * numBuckets + slot;
+      monitors[monitor].min_ref()->push_back(tier.mins[idx]);
+      monitors[monitor].max_ref()->push_back(tier.maxs[idx]);
+      monitors[monitor].avg_ref()->push_back(tier.avgs[idx]);
+    }
+  }
+  history.monitors_ref() = std::move(monitors);
+  return history;
+}
+
+size_t TransceiverHistoryStore::getMemoryUsage() const {
+  size_t bytes = 0;
+  for (const auto& [id, buckets] : *transceivers_.rlock()) {
+    for (const auto& tier : buckets.tiers) {
+      bytes += tier.times.capacity() * sizeof(int64_t) +
+          (tier.mins.capacity() + tier.maxs.capacity() +
+           tier.avgs.capacity()) *
+              sizeof(float);
+      for (const auto& counts : tier.counts) {
+        bytes += counts.capacity() * sizeof(uint16_t);
+      }
+    }
+  }
+  return bytes;
+}
+
+// static
+void TransceiverHistoryStore::getMonitors(
+    const TransceiverInfo& info,
+    std::vector<float>& values,
+    std::vector<Monitor>* monitors) {
+  auto add = [&](double value,
+                 const char* name,
+                 std::optional<int32_t> lane,
+                 Clock clock) {
+    values.push_back(value);
+    if (monitors) {
+      monitors->push_back({name, lane, clock});
+    }
+  };
+
+  if (info.sensor_ref().has_value()) {
+    add(*info.sensor_ref()->temp_ref()->value_ref(),
+        "temp",
+        std::nullopt,
+        Clock::MODULE);
+    add(*info.sensor_ref()->vcc_ref()->value_ref(),
+        "vcc",
+        std::nullopt,
+        Clock::MODULE);
+  }
+  for (const auto& channel : *info.channels_ref()) {
+    auto lane = *channel.channel_ref();
+    const auto& sensors = *channel.sensors_ref();
+    add(*sensors.rxPwr_ref()->value_ref(), "rxPwr", lane, Clock::CHANNELS);
+    add(*sensors.txPwr_ref()->value_ref(), "txPwr", lane, Clock::CHANNELS);
+    add(*sensors.txBias_ref()->value_ref(), "txBias", lane, Clock::CHANNELS);
+  }
+  // The VDM monitors don't depend on whether the pages were captured yet
+  if (info.vdmTimeCollected_ref().has_value()) {
+    auto vdm = info.vdmDiagsStats_ref();
+    add(vdm ? *vdm->preFecBerMediaCur_ref() : kNoSample,
+        "preFecBerMedia",
+        std::nullopt,
+        Clock::VDM);
+    add(vdm ? *vdm->preFecBerHostCur_ref() : kNoSample,
+        "preFecBerHost",
+        std::nullopt,
+        Clock::VDM);
+    for (const auto& channel : *info.channels_ref()) {
+      auto lane = *channel.channel_ref();
+      double eSnr = kNoSample;
+      if (vdm) {
+        auto it = vdm->eSnrMediaChannel_ref()->find(lane);
+        if (it != vdm->eSnrMediaChannel_ref()->end()) {
+          eSnr = it->second;
+        }
+      }
+      add(eSnr, "eSnrMedia", lane, Clock::VDM);
+    }
+  }
+}
+
+TransceiverHistoryStore::TransceiverBuckets
+TransceiverHistoryStore::newTransceiverBuckets(
+    std::vector<Monitor> monitors) const {
+  TransceiverBuckets buckets;
+  auto numValues = monitors.size();
+  buckets.monitors = std::move(monitors);
+  for (const auto& tier : tiers_) {
+    TierBuckets tierBuckets;
+    tierBuckets.times.assign(tier.numBuckets, kEmptyBucket);
+    for (auto& counts : tierBuckets.counts) {
+      counts.assign(tier.numBuckets, 0);
+    }
+    tierBuckets.mins.assign(numValues * tier.numBuckets, 0);
+    tierBuckets.maxs.assign(numValues * tier.numBuckets, 0);
+    tierBuckets.avgs.assign(numValues * tier.numBuckets, 0);
+    buckets.tiers.push_back(std::move(tierBuckets));
+  }
+  return buckets;
+}
+
+} // namespace facebook::fboss
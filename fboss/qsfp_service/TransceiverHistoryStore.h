@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/qsfp_service/if/gen-cpp2/qsfp_types.h"
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+#include <folly/Synchronized.h>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Fixed memory history of the DOM and VDM monitors of the transceivers, so
+ * that marginal optics can be debugged without scraping qsfp_service.
+ *
+ * Like TimeSeriesWithMinMax, the samples are recorded in buckets which keep
+ * the min, max and average of a monitor over their interval. There are
+ * several tiers of buckets, each one a ring with a coarser interval than the
+ * previous one, e.g. 5s buckets for 10 minutes and 5 minute buckets for 24
+ * hours. Every sample is added to all tiers, so no downsampling pass is
+ * needed.
+ *
+ * The lane monitors can be read less often than the rest of the module, e.g.
+ * every cmis_dom_refresh_interval on CMIS modules. They are only sampled when
+ * channelsTimeCollected moved, so that a bucket doesn't average the same
+ * cached value several times. Likewise the VDM monitors are only sampled when
+ * vdmTimeCollected moved, as the VDM pages are only read when a capture is
+ * triggered. Their buckets without a sample are NaN. Modules which support
+ * VDM always have the VDM monitors, so that the first capture doesn't change
+ * the monitors and drop the history.
+ *
+ * The buckets are stored in columns: every tier of a transceiver has one
+ * array of bucket times and sample counts, and one contiguous array per
+ * monitor for each of min, max and average. The memory of a transceiver is
+ * allocated when it's first seen present, and doesn't grow after that.
+ */
+class TransceiverHistoryStore {
+ public:
+  struct Tier {
+    std::chrono::seconds interval;
+    size_t numBuckets;
+  };
+
+  explicit TransceiverHistoryStore(std::vector<Tier> tiers);
+
+  // Record the monitors of a transceiver, at its timeCollected. Absent
+  // transceivers and samples which aren't newer than the last one are ignored,
+  // and so are lane and VDM monitors which weren't read since the last sample.
+  void addSample(int32_t id, const TransceiverInfo& info);
+
+  // The buckets of the transceiver between start and end (seconds since
+  // epoch), from the finest tier which still goes back to start
+  TransceiverMonitorHistory
+  getHistory(int32_t id, int64_t start, int64_t end) const;
+
+  // Bytes allocated for the buckets of all transceivers
+  size_t getMemoryUsage() const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TransceiverHistoryStore(TransceiverHistoryStore const&) = delete;
+  TransceiverHistoryStore& operator=(TransceiverHistoryStore const&) = delete;
+
+  // Which collection time of TransceiverInfo a monitor is sampled at
+  enum class Clock { MODULE, CHANNELS, VDM, NUM_CLOCKS };
+
+  struct Monitor {
+    std::string name;
+    std::optional<int32_t> lane;
+    Clock clock;
+  };
+
+  struct TierBuckets {
+    // Start time of every bucket, and the number of samples in it for the
+    // monitors of each clock
+    std::vector<int64_t> times;
+    std::array<std::vector<uint16_t>, static_cast<size_t>(Clock::NUM_CLOCKS)>
+        counts;
+    // numMonitors * numBuckets, one contiguous run of buckets per monitor
+    std::vector<float> mins;
+    std::vector<float> maxs;
+    std::vector<float> avgs;
+  };
+
+  struct TransceiverBuckets {
+    std::vector<Monitor> monitors;
+    std::vector<TierBuckets> tiers;
+    int64_t lastSampleTime{0};
+    int64_t lastLaneSampleTime{0};
+    int64_t lastVdmSampleTime{0};
+  };
+
+  // The values of the monitors of info, and their names when monitors is set
+  static void getMonitors(
+      const TransceiverInfo& info,
+      std::vector<float>& values,
+      std::vector<Monitor>* monitors);
+
+  TransceiverBuckets newTransceiverBuckets(std::vector<Monitor> monitors) const;
+
+  const std::vector<Tier> tiers_;
+  folly::Synchronized<std::map<int32_t, TransceiverBuckets>> transceivers_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverInfoPublisher.h"
+
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <cmath>
+
+DEFINE_double(
+    tcvr_info_push_temp_delta,
+    1.0,
+    "Push a transceiver when its temperature moved by more than this (C)");
+DEFINE_double(
+    tcvr_info_push_vcc_delta,
+    0.05,
+    "Push a transceiver when its supply voltage moved by more than this (V)");
+DEFINE_double(
+    tcvr_info_push_power_delta_db,
+    0.5,
+    "Push a transceiver when the Rx or Tx power of a channel moved by more "
+    "than this (dB)");
+DEFINE_double(
+    tcvr_info_push_bias_delta,
+    1.0,
+    "Push a transceiver when the Tx bias of a channel moved by more than "
+    "this (mA)");
+
+namespace {
+using namespace facebook::fboss;
+
+// Same conversion as the dBm fields of ChannelSensors
+double mwToDb(double mw) {
+  return mw < 0.01 ? -40.0 : 10 * std::log10(mw);
+}
+
+bool sensorChanged(
+    const Sensor& oldSensor,
+    const Sensor& newSensor,
+    double delta) {
+  return std::abs(*newSensor.value_ref() - *oldSensor.value_ref()) > delta ||
+      oldSensor.flags_ref() != newSensor.flags_ref();
+}
+
+bool powerChanged(const Sensor& oldSensor, const Sensor& newSensor) {
+  return std::abs(
+             mwToDb(*newSensor.value_ref()) - mwToDb(*oldSensor.value_ref())) >
+      FLAGS_tcvr_info_push_power_delta_db ||
+      oldSensor.flags_ref() != newSensor.flags_ref();
+}
+
+// Whether the fields which don't change on every refresh are the same. The
+// monitors (sensor, channels, stats, vdm stats and their collection times)
+// are compared with thresholds instead, any new field has to be added here.
+bool staticFieldsEqual(
+    const TransceiverInfo& oldInfo,
+    const TransceiverInfo& newInfo) {
+  return oldInfo.present_ref() == newInfo.present_ref() &&
+      oldInfo.transceiver_ref() == newInfo.transceiver_ref() &&
+      oldInfo.port_ref() == newInfo.port_ref() &&
+      oldInfo.thresholds_ref() == newInfo.thresholds_ref() &&
+      oldInfo.vendor_ref() == newInfo.vendor_ref() &&
+      oldInfo.cable_ref() == newInfo.cable_ref() &&
+      oldInfo.settings_ref() == newInfo.settings_ref() &&
+      oldInfo.signalFlag_ref() == newInfo.signalFlag_ref() &&
+      oldInfo.extendedSpecificationComplianceCode_ref() ==
+      newInfo.extendedSpecificationComplianceCode_ref() &&
+      oldInfo.transceiverManagementInterface_ref() ==
+      newInfo.transceiverManagementInterface_ref() &&
+      oldInfo.identifier_ref() == newInfo.identifier_ref() &&
+      oldInfo.status_ref() == newInfo.status_ref() &&
+      oldInfo.mediaLaneSignals_ref() == newInfo.mediaLaneSignals_ref() &&
+      oldInfo.hostLaneSignals_ref() == newInfo.hostLaneSignals_ref() &&
+      oldInfo.remediationCounter_ref() == newInfo.remediationCounter_ref() &&
+      oldInfo.eepromCsumValid_ref() == newInfo.eepromCsumValid_ref() &&
+      oldInfo.moduleMediaInterface_ref() ==
+      newInfo.moduleMediaInterface_ref() &&
+      oldInfo.stateMachineState_ref() == newInfo.stateMachineState_ref();
+}
+} // namespace
+
+namespace facebook::fboss {
+
+TransceiverInfoPublisher::~TransceiverInfoPublisher() {
+  std::map<uint64_t, std::unique_ptr<Publisher>> subscribers;
+  state_->withWLock(
+      [&subscribers](auto& state) { subscribers.swap(state.subscribers); });
+  for (auto& [id, publisher] : subscribers) {
+    std::move(*publisher).complete();
+  }
+}
+
+apache::thrift::ServerStream<TransceiverInfoUpdate>
+TransceiverInfoPublisher::subscribe() {
+  auto lockedState = state_->wlock();
+  auto subscriberID = lockedState->nextSubscriberID++;
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<TransceiverInfoUpdate>::createPublisher(
+          [state = std::weak_ptr(state_), subscriberID] {
+            XLOG(INFO) << "TransceiverInfo subscriber " << subscriberID
+                       << " disconnected";
+            if (auto sharedState = state.lock()) {
+              sharedState->wlock()->subscribers.erase(subscriberID);
+            }
+          });
+
+  // Start with a full sync while holding the lock, so that the subscriber
+  // can't miss a publish() in between. A stale snapshot is only synced by the
+  // next publish()
+  if (!lockedState->snapshotStale) {
+    TransceiverInfoUpdate fullSync;
+    fullSync.generation_ref() = lockedState->generation;
+    fullSync.fullSync_ref() = true;
+    fullSync.transceivers_ref() = lockedState->snapshot;
+    streamAndPublisher.second.next(std::move(fullSync));
+  }
+
+  lockedState->subscribers.emplace(
+      subscriberID,
+      std::make_unique<Publisher>(std::move(streamAndPublisher.second)));
+  XLOG(INFO) << "TransceiverInfo subscriber " << subscriberID
+             << " connected at generation " << lockedState->generation;
+  return std::move(streamAndPublisher.first);
+}
+
+void TransceiverInfoPublisher::publish(const TcvrInfoMap& infos) {
+  auto lockedState = state_->wlock();
+  if (lockedState->subscribers.empty()) {
+    lockedState->snapshotStale = true;
+    return;
+  }
+  if (lockedState->snapshotStale) {
+    // All the subscribers came after the snapshot went stale and are waiting
+    // for their full sync
+    lockedState->snapshot = infos;
+    lockedState->snapshotStale = false;
+    TransceiverInfoUpdate fullSync;
+    fullSync.generation_ref() = ++lockedState->generation;
+    fullSync.fullSync_ref() = true;
+    fullSync.transceivers_ref() = infos;
+    XLOG(DBG3) << "Publishing a full sync of " << infos.size()
+               << " transceivers at generation " << *fullSync.generation_ref()
+               << " to " << lockedState->subscribers.size() << " subscribers";
+    for (const auto& [subscriberID, publisher] : lockedState->subscribers) {
+      publisher->next(fullSync);
+    }
+    return;
+  }
+
+  TransceiverInfoUpdate update;
+  update.fullSync_ref() = false;
+  for (const auto& [id, info] : infos) {
+    auto it = lockedState->snapshot.find(id);
+    if (it != lockedState->snapshot.end() && !hasChanged(it->second, info)) {
+      continue;
+    }
+    lockedState->snapshot[id] = info;
+    update.transceivers_ref()->emplace(id, info);
+  }
+  if (update.transceivers_ref()->empty()) {
+    return;
+  }
+
+  update.generation_ref() = ++lockedState->generation;
+  XLOG(DBG3) << "Publishing " << update.transceivers_ref()->size()
+             << " changed transceivers at generation "
+             << *update.generation_ref() << " to "
+             << lockedState->subscribers.size() << " subscribers";
+  for (const auto& [subscriberID, publisher] : lockedState->subscribers) {
+    publisher->next(update);
+  }
+}
+
+void TransceiverInfoPublisher::skipPublish() {
+  state_->wlock()->snapshotStale = true;
+}
+
+int64_t TransceiverInfoPublisher::getGeneration() const {
+  return state_->rlock()->generation;
+}
+
+size_t TransceiverInfoPublisher::numSubscribers() const {
+  return state_->rlock()->subscribers.size();
+}
+
+// static
+bool TransceiverInfoPublisher::hasChanged(
+    const TransceiverInfo& oldInfo,
+    const TransceiverInfo& newInfo) {
+  // Presence, state and everything read from the static pages has to match
+  // exactly
+  if (!staticFieldsEqual(oldInfo, newInfo)) {
+    return true;
+  }
+
+  if (oldInfo.sensor_ref().has_value() != newInfo.sensor_ref().has_value()) {
+    return true;
+  }
+  if (oldInfo.sensor_ref().has_value()) {
+    const auto& oldSensor = *oldInfo.sensor_ref();
+    const auto& newSensor = *newInfo.sensor_ref();
+    if (sensorChanged(
+            *oldSensor.temp_ref(),
+            *newSensor.temp_ref(),
+            FLAGS_tcvr_info_push_temp_delta) ||
+        sensorChanged(
+            *oldSensor.vcc_ref(),
+            *newSensor.vcc_ref(),
+            FLAGS_tcvr_info_push_vcc_delta)) {
+      return true;
+    }
+  }
+
+  const auto& oldChannels = *oldInfo.channels_ref();
+  const auto& newChannels = *newInfo.channels_ref();
+  if (oldChannels.size() != newChannels.size()) {
+    return true;
+  }
+  for (size_t i = 0; i < oldChannels.size(); i++) {
+    if (*oldChannels[i].channel_ref() != *newChannels[i].channel_ref()) {
+      return true;
+    }
+    const auto& oldSensors = *oldChannels[i].sensors_ref();
+    const auto& newSensors = *newChannels[i].sensors_ref();
+    if (powerChanged(*oldSensors.rxPwr_ref(), *newSensors.rxPwr_ref()) ||
+        powerChanged(*oldSensors.txPwr_ref(), *newSensors.txPwr_ref()) ||
+        sensorChanged(
+            *oldSensors.txBias_ref(),
+            *newSensors.txBias_ref(),
+            FLAGS_tcvr_info_push_bias_delta)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace facebook::fboss
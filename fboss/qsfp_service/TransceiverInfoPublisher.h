@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/qsfp_service/if/gen-cpp2/qsfp_types.h"
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+#include <folly/Synchronized.h>
+#include <thrift/lib/cpp2/async/ServerStream.h>
+
+#include <map>
+#include <memory>
+
+namespace facebook::fboss {
+
+/*
+ * Pushes TransceiverInfo changes to the subscribers of the
+ * subscribeTransceiverInfo() stream.
+ *
+ * TransceiverManager publishes the info of all transceivers after every
+ * refresh. The publisher compares it with the last published snapshot and only
+ * pushes the transceivers which changed, so that a subscriber like the agent
+ * gets presence and state changes as soon as they are detected instead of
+ * polling qsfp_service for all transceivers. Changes of the monitors (DOM
+ * sensors) are only pushed when they move by more than a threshold.
+ *
+ * Every published update carries a generation which is incremented by one.
+ * A new subscriber first gets a full sync of the snapshot with the current
+ * generation, and is expected to resubscribe if it ever sees a gap.
+ *
+ * Nothing is compared while there is no subscriber. The snapshot is then
+ * stale, so the next subscriber gets its full sync at the following publish.
+ */
+class TransceiverInfoPublisher {
+ public:
+  using TcvrInfoMap = std::map<int32_t, TransceiverInfo>;
+
+  TransceiverInfoPublisher() = default;
+  ~TransceiverInfoPublisher();
+
+  apache::thrift::ServerStream<TransceiverInfoUpdate> subscribe();
+
+  // Push the transceivers of infos which changed since the last publish
+  void publish(const TcvrInfoMap& infos);
+  // Called instead of publish() when there is no subscriber to publish to
+  void skipPublish();
+
+  int64_t getGeneration() const;
+  size_t numSubscribers() const;
+
+  // Whether newInfo differs enough from oldInfo to be pushed
+  static bool hasChanged(
+      const TransceiverInfo& oldInfo,
+      const TransceiverInfo& newInfo);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TransceiverInfoPublisher(TransceiverInfoPublisher const&) = delete;
+  TransceiverInfoPublisher& operator=(TransceiverInfoPublisher const&) = delete;
+
+  using Publisher =
+      apache::thrift::ServerStreamPublisher<TransceiverInfoUpdate>;
+
+  struct State {
+    int64_t generation{0};
+    // What the subscribers know about each transceiver
+    TcvrInfoMap snapshot;
+    // Whether snapshot missed some publish() while there was no subscriber
+    bool snapshotStale{false};
+    uint64_t nextSubscriberID{0};
+    std::map<uint64_t, std::unique_ptr<Publisher>> subscribers;
+  };
+  // Shared with the stream completion callbacks, which can outlive us
+  std::shared_ptr<folly::Synchronized<State>> state_{
+      std::make_shared<folly::Synchronized<State>>()};
+};
+
+} // namespace facebook::fboss
@@ -11,8 +11,44 @@
 #include "fboss/qsfp_service/TransceiverStateMachineUpdate.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+DEFINE_int32(
+    state_machine_update_threads,
+    0,
+    "Number of threads running TransceiverStateMachine updates. "
+    "0 means one thread per I2C controller");
+DEFINE_int32(
+    tcvr_history_fine_interval_s,
+    5,
+    "Interval (in seconds) of the fine buckets of the transceiver history. "
+    "The module monitors are sampled every loop_interval, but CMIS lane "
+    "monitors only every cmis_dom_refresh_interval");
+DEFINE_int32(
+    tcvr_history_fine_buckets,
+    120,
+    "Number of fine buckets of the transceiver history");
+DEFINE_int32(
+    tcvr_history_coarse_interval_s,
+    300,
+    "Interval (in seconds) of the coarse buckets of the transceiver history");
+DEFINE_int32(
+    tcvr_history_coarse_buckets,
+    288,
+    "Number of coarse buckets of the transceiver history");
+DEFINE_int32(
+    update_thread_heartbeat_ms,
+    1000,
+    "Heartbeat interval (ms) of the TransceiverStateMachine update thread");
+
 using namespace std::chrono;
 
+namespace {
+// Used when the platform doesn't report its I2C controllers
+constexpr int kDefaultStateMachineUpdateThreads = 4;
+} // namespace
+
 namespace facebook {
 namespace fboss {
 
@@ -22,7 +58,12 @@ TransceiverManager::TransceiverManager(
     : qsfpPlatApi_(std::move(api)),
       platformMapping_(std::move(platformMapping)),
       stateMachines_(setupTransceiverToStateMachineHelper()),
-      tcvrToPortInfo_(setupTransceiverToPortInfo()) {
+      tcvrToPortInfo_(setupTransceiverToPortInfo()),
+      transceiverHistory_(
+          {{seconds(FLAGS_tcvr_history_fine_interval_s),
+            static_cast<size_t>(FLAGS_tcvr_history_fine_buckets)},
+           {seconds(FLAGS_tcvr_history_coarse_interval_s),
+            static_cast<size_t>(FLAGS_tcvr_history_coarse_buckets)}}) {
   // Cache the static mapping based on platformMapping_
   const auto& platformPorts = platformMapping_->getPlatformPorts();
   const auto& chips = platformMapping_->getChips();
@@ -121,17 +162,31 @@ TransceiverManager::setupTransceiverToPortInfo() {
 
 void TransceiverManager::startThreads() {
   if (FLAGS_use_new_state_machine) {
-    // Setup all TransceiverStateMachineHelper thread
-    for (auto& stateMachineHelper : stateMachines_) {
-      stateMachineHelper.second->startThread();
-    }
-
     XLOG(DBG2) << "Started TransceiverStateMachineUpdateThread";
     updateEventBase_ = std::make_unique<folly::EventBase>();
     updateThread_.reset(new std::thread([=] {
       this->threadLoop(
           "TransceiverStateMachineUpdateThread", updateEventBase_.get());
     }));
+
+    updateThreadHeartbeat_ = std::make_shared<ThreadHeartbeat>(
+        updateEventBase_.get(),
+        "TransceiverStateMachineUpdateThread",
+        FLAGS_update_thread_heartbeat_ms,
+        [](int delay, int backlog) {
+          fb303::fbData->addStatValue(
+              "qsfp.update_thread.heartbeat_delay_ms", delay, fb303::AVG);
+          fb303::fbData->addStatValue(
+              "qsfp.update_thread.event_backlog", backlog, fb303::AVG);
+        });
+    heartbeatWatchdog_ = std::make_unique<ThreadHeartbeatWatchdog>(
+        milliseconds(FLAGS_update_thread_heartbeat_ms * 10), []() {
+          fb303::fbData->addStatValue(
+              "qsfp.thread_heartbeat_miss", 1, fb303::SUM);
+        });
+    heartbeatWatchdog_->enableStallCapture(FLAGS_thread_stall_history);
+    heartbeatWatchdog_->startMonitoringHeartbeat(updateThreadHeartbeat_);
+    heartbeatWatchdog_->start();
   }
 }
 
@@ -139,6 +194,11 @@ void TransceiverManager::stopThreads() {
   // We use runInEventBaseThread() to terminateLoopSoon() rather than calling it
   // directly here.  This ensures that any events already scheduled via
   // runInEventBaseThread() will have a chance to run.
+  if (heartbeatWatchdog_) {
+    heartbeatWatchdog_->stop();
+    heartbeatWatchdog_.reset();
+    updateThreadHeartbeat_.reset();
+  }
   if (updateThread_) {
     updateEventBase_->runInEventBaseThread(
         [this] { updateEventBase_->terminateLoopSoon(); });
@@ -154,12 +214,37 @@ void TransceiverManager::stopThreads() {
       updatesDrained = pendingUpdates_.empty();
     }
   } while (!updatesDrained);
-  // And finally stop all TransceiverStateMachineHelper thread
+  // And finally stop all TransceiverStateMachineHelper executors
   for (auto& stateMachineHelper : stateMachines_) {
-    stateMachineHelper.second->stopThread();
+    stateMachineHelper.second->stopExecutor();
+  }
+  if (stateMachineThreadPool_) {
+    stateMachineThreadPool_->join();
+    stateMachineThreadPool_.reset();
   }
 }
 
+void TransceiverManager::startStateMachineExecutors() {
+  auto numThreads = FLAGS_state_machine_update_threads;
+  // Once exiting, the platform specific part might be gone already
+  if (numThreads <= 0 && !isExiting_) {
+    numThreads = getI2cControllerStats().size();
+  }
+  if (numThreads <= 0) {
+    numThreads = kDefaultStateMachineUpdateThreads;
+  }
+  stateMachineThreadPool_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+      numThreads,
+      std::make_shared<folly::NamedThreadFactory>(
+          "TransceiverStateMachineUpdate"));
+  for (auto& stateMachineHelper : stateMachines_) {
+    stateMachineHelper.second->startExecutor(
+        folly::getKeepAliveToken(stateMachineThreadPool_.get()));
+  }
+  XLOG(INFO) << "Started " << numThreads
+             << " threads for TransceiverStateMachine updates";
+}
+
 void TransceiverManager::threadLoop(
     folly::StringPiece name,
     folly::EventBase* eventBase) {
@@ -252,6 +337,10 @@ void TransceiverManager::handlePendingUpdates() {
     return;
   }
 
+  if (!stateMachineThreadPool_) {
+    startStateMachineExecutors();
+  }
+
   XLOG(DBG2) << "About to update " << updates.size()
              << " TransceiverStateMachine";
   // To expedite all these different transceivers state update, use Future
@@ -270,7 +359,7 @@ void TransceiverManager::handlePendingUpdates() {
     }
 
     stateUpdateTasks.push_back(
-        folly::via(stateMachineItr->second->getEventBase())
+        folly::via(stateMachineItr->second->getExecutor())
             .thenValue([update, stateMachineItr](auto&&) {
               XLOG(INFO) << "Preparing TransceiverStateMachine update for "
                          << update->getName();
@@ -296,6 +385,16 @@ void TransceiverManager::handlePendingUpdates() {
   }
 }
 
+std::set<TransceiverID>
+TransceiverManager::getTransceiversWithPendingUpdates() {
+  std::set<TransceiverID> tcvrIDs;
+  std::unique_lock guard(pendingUpdatesLock_);
+  for (const auto& update : pendingUpdates_) {
+    tcvrIDs.insert(update.getTransceiverID());
+  }
+  return tcvrIDs;
+}
+
 TransceiverStateMachineState TransceiverManager::getCurrentState(
     TransceiverID id) const {
   auto stateMachineItr = stateMachines_.find(id);
@@ -779,6 +878,31 @@ void TransceiverManager::refreshStateMachines() {
     }
     triggerRemediateEvents(stableTcvrs);
   }
+
+  // Step6: Push what changed in this refresh to the subscribers
+  publishTransceiverInfo();
+}
+
+void TransceiverManager::publishTransceiverInfo() {
+  // Only keep the infos around when somebody is subscribed to them
+  bool hasSubscribers = transceiverInfoPublisher_.numSubscribers() > 0;
+  TransceiverInfoPublisher::TcvrInfoMap infos;
+  for (int i = 0; i < getNumQsfpModules(); i++) {
+    auto tcvrID = TransceiverID(i);
+    auto info = getTransceiverInfo(tcvrID);
+    if (FLAGS_use_new_state_machine) {
+      info.stateMachineState_ref() = getCurrentState(tcvrID);
+    }
+    transceiverHistory_.addSample(i, info);
+    if (hasSubscribers) {
+      infos.emplace(i, std::move(info));
+    }
+  }
+  if (hasSubscribers) {
+    transceiverInfoPublisher_.publish(infos);
+  } else {
+    transceiverInfoPublisher_.skipPublish();
+  }
 }
 
 void TransceiverManager::triggerAgentConfigChangeEvent(
@@ -913,17 +1037,13 @@ TransceiverManager::TransceiverStateMachineHelper::
   lockedStateMachine->get_attribute(needResetDataPath) = false;
 }
 
-void TransceiverManager::TransceiverStateMachineHelper::startThread() {
-  updateEventBase_ = std::make_unique<folly::EventBase>();
-  updateThread_.reset(
-      new std::thread([this] { updateEventBase_->loopForever(); }));
+void TransceiverManager::TransceiverStateMachineHelper::startExecutor(
+    folly::Executor::KeepAlive<> threadPool) {
+  executor_ = folly::SerialExecutor::create(std::move(threadPool));
 }
 
-void TransceiverManager::TransceiverStateMachineHelper::stopThread() {
-  if (updateThread_) {
-    updateEventBase_->terminateLoopSoon();
-    updateThread_->join();
-  }
+void TransceiverManager::TransceiverStateMachineHelper::stopExecutor() {
+  executor_.reset();
 }
 
 void TransceiverManager::waitForAllBlockingStateUpdateDone(
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "fboss/agent/ThreadHeartbeat.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/platforms/common/PlatformMapping.h"
@@ -19,12 +20,16 @@
 #include "fboss/lib/platforms/PlatformMode.h"
 #include "fboss/lib/usb/TransceiverPlatformApi.h"
 #include "fboss/qsfp_service/QsfpConfig.h"
+#include "fboss/qsfp_service/TransceiverHistoryStore.h"
+#include "fboss/qsfp_service/TransceiverInfoPublisher.h"
 #include "fboss/qsfp_service/TransceiverStateMachineUpdate.h"
 #include "fboss/qsfp_service/module/Transceiver.h"
 
 #include <folly/IntrusiveList.h>
 #include <folly/SpinLock.h>
 #include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/SerialExecutor.h>
 #include <map>
 #include <vector>
 
@@ -186,6 +191,9 @@ class TransceiverManager {
 
   TransceiverStateMachineState getCurrentState(TransceiverID id) const;
 
+  // Transceivers which still have state machine updates waiting to be handled
+  std::set<TransceiverID> getTransceiversWithPendingUpdates();
+
   bool getNeedResetDataPath(TransceiverID id) const;
 
   // ========== Public functions for TransceiverStateMachine ==========
@@ -231,6 +239,20 @@ class TransceiverManager {
   // with present filed is false.
   TransceiverInfo getTransceiverInfo(TransceiverID id);
 
+  TransceiverInfoPublisher* getTransceiverInfoPublisher() {
+    return &transceiverInfoPublisher_;
+  }
+
+  const TransceiverHistoryStore& getTransceiverHistory() const {
+    return transceiverHistory_;
+  }
+
+  // Stack traces of the update thread from its recent missed heartbeats
+  std::vector<ThreadStallInfo> getRecentThreadStalls() const {
+    return heartbeatWatchdog_ ? heartbeatWatchdog_->getRecentStalls()
+                              : std::vector<ThreadStallInfo>();
+  }
+
   // Function to convert port name string to software port id
   std::optional<PortID> getPortIDByPortName(const std::string& portName);
 
@@ -313,9 +335,9 @@ class TransceiverManager {
    * This is the private class to capture all information a
    * TransceiverStateMachine needs
    * A Synchronized state_machine to keep track of the state
-   * thread and EventBase so that we can operate multiple different transceivers
-   * StateMachine update at the same time and also better starting and
-   * terminating these threads.
+   * A SerialExecutor on top of the shared state machine thread pool, so that
+   * we can operate multiple different transceivers StateMachine update at the
+   * same time while the updates of one transceiver still run in order.
    */
   class TransceiverStateMachineHelper {
    public:
@@ -323,10 +345,10 @@ class TransceiverManager {
         TransceiverManager* tcvrMgrPtr,
         TransceiverID tcvrID);
 
-    void startThread();
-    void stopThread();
-    folly::EventBase* getEventBase() const {
-      return updateEventBase_.get();
+    void startExecutor(folly::Executor::KeepAlive<> threadPool);
+    void stopExecutor();
+    folly::Executor::KeepAlive<> getExecutor() const {
+      return executor_.copy();
     }
     folly::Synchronized<state_machine<TransceiverStateMachine>>&
     getStateMachine() {
@@ -336,10 +358,7 @@ class TransceiverManager {
    private:
     TransceiverID tcvrID_;
     folly::Synchronized<state_machine<TransceiverStateMachine>> stateMachine_;
-    // Can't use ScopedEventBaseThread as it won't work well with
-    // handcrafted HeaderClientChannel client instead of servicerouter client
-    std::unique_ptr<std::thread> updateThread_;
-    std::unique_ptr<folly::EventBase> updateEventBase_;
+    folly::Executor::KeepAlive<folly::SerialExecutor> executor_;
   };
 
   using TransceiverToStateMachineHelper = std::unordered_map<
@@ -357,6 +376,11 @@ class TransceiverManager {
   void stopThreads();
   void threadLoop(folly::StringPiece name, folly::EventBase* eventBase);
 
+  // Create the shared state machine thread pool and the per transceiver
+  // executors on top of it. This needs the platform I2C controllers, so it
+  // happens on the first update rather than in the constructor.
+  void startStateMachineExecutors();
+
   /**
    * Schedule an update to the switch state.
    *
@@ -392,6 +416,10 @@ class TransceiverManager {
   // the remediation events to remediate such transceivers.
   void triggerRemediateEvents(const std::vector<TransceiverID>& stableTcvrs);
 
+  // Push the transceivers which changed to subscribeTransceiverInfo(), and
+  // record their monitors in the history
+  void publishTransceiverInfo();
+
   // TEST ONLY
   // This private map is an override of agent getPortStatus()
   std::map<int32_t, PortStatus> overrideAgentPortStatusForTesting_;
@@ -413,7 +441,19 @@ class TransceiverManager {
   std::unique_ptr<std::thread> updateThread_;
   std::unique_ptr<folly::EventBase> updateEventBase_;
 
-  // TODO(joseph5wu) Will add heartbeat watchdog later
+  /*
+   * Threads shared by all TransceiverStateMachine updates. By default there
+   * is one thread per I2C controller, since transceivers behind the same
+   * controller can't be accessed in parallel anyway.
+   */
+  std::unique_ptr<folly::CPUThreadPoolExecutor> stateMachineThreadPool_;
+
+  /*
+   * Heartbeat of the update thread, and the watchdog capturing its stack
+   * when it stalls.
+   */
+  std::shared_ptr<ThreadHeartbeat> updateThreadHeartbeat_;
+  std::unique_ptr<ThreadHeartbeatWatchdog> heartbeatWatchdog_;
 
   // A global flag to indicate whether the service is exiting.
   // If it is, we should not accept any state update
@@ -445,6 +485,10 @@ class TransceiverManager {
    * iphy to xphy to tcvr.
    */
   ConfigAppliedInfo configAppliedInfo_;
+
+  TransceiverInfoPublisher transceiverInfoPublisher_;
+
+  TransceiverHistoryStore transceiverHistory_;
 };
 } // namespace fboss
 } // namespace facebook
@@ -13,6 +13,46 @@ include "fboss/mka_service/if/mka_structs.thrift"
 include "fboss/agent/hw/hardware_stats.thrift"
 include "fboss/lib/phy/phy.thrift"
 
+/*
+ * One update pushed by subscribeTransceiverInfo(). The first update of every
+ * subscription is a full sync of all transceivers, later ones only carry the
+ * transceivers which changed. generation is incremented by one for every
+ * update qsfp_service publishes, so a gap means the subscriber missed one and
+ * has to resubscribe.
+ */
+struct TransceiverInfoUpdate {
+  1: i64 generation;
+  2: bool fullSync;
+  3: map<i32, transceiver.TransceiverInfo> transceivers;
+}
+
+/*
+ * The buckets of one DOM or VDM monitor of a transceiver, parallel to
+ * TransceiverMonitorHistory.bucketTimes. lane is set for the monitors of a
+ * channel. The lanes can be read less often than the module, their buckets
+ * without a sample are NaN.
+ */
+struct MonitorHistory {
+  1: string name;
+  2: optional i32 lane;
+  3: list<float> min;
+  4: list<float> max;
+  5: list<float> avg;
+}
+
+/*
+ * History of the monitors of a transceiver, returned by
+ * getTransceiverMonitorHistory(). bucketTimes are the start of every bucket
+ * in seconds since epoch, and every bucket covers interval seconds. Buckets
+ * without samples are left out.
+ */
+struct TransceiverMonitorHistory {
+  1: i32 transceiver;
+  2: i64 interval;
+  3: list<i64> bucketTimes;
+  4: list<MonitorHistory> monitors;
+}
+
 service QsfpService extends phy.FbossCommonPhyCtrl {
   transceiver.TransceiverType getType(1: i32 idx);
 
@@ -52,6 +92,34 @@ service QsfpService extends phy.FbossCommonPhyCtrl {
     1: map<i32, ctrl.PortStatus> ports,
   ) throws (1: fboss.FbossBaseError error);
 
+  /*
+   * Subscribe to TransceiverInfo changes. Only transceivers whose presence,
+   * state or configuration changed, or whose monitors moved by more than the
+   * configured thresholds, are pushed.
+   */
+  stream<TransceiverInfoUpdate> subscribeTransceiverInfo() throws (
+    1: fboss.FbossBaseError error,
+  );
+
+  /*
+   * History of the DOM and VDM monitors of a transceiver between start and
+   * end (seconds since epoch). The finest granularity which still goes back
+   * to start is returned.
+   */
+  TransceiverMonitorHistory getTransceiverMonitorHistory(
+    1: i32 idx,
+    2: i64 start,
+    3: i64 end,
+  ) throws (1: fboss.FbossBaseError error);
+
+  /*
+   * Stack traces of the update thread from its recent missed heartbeats, see
+   * --thread_stall_history
+   */
+  list<ctrl.ThreadStallInfo> getRecentThreadStalls() throws (
+    1: fboss.FbossBaseError error,
+  );
+
   /*
    * Qsfp service has an internal remediation loop and may potentially perform
    * interruptive operation to modules that carry no active(up) link. However
@@ -361,6 +361,12 @@ struct TransceiverInfo {
   26: optional MediaInterfaceCode moduleMediaInterface;
   27: optional TransceiverStateMachineState stateMachineState;
   28: optional VdmDiagsStats vdmDiagsStatsForOds;
+  // When the channel monitors were read, modules may read them less often
+  // than timeCollected
+  29: optional i64 channelsTimeCollected;
+  // When the VDM pages were last latched and read, 0 before the first
+  // capture. Only set on modules which support VDM.
+  30: optional i64 vdmTimeCollected;
 }
 
 typedef binary (cpp2.type = "folly::IOBuf") IOBuf
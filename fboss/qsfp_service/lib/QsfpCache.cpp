@@ -16,6 +16,11 @@
 #include <folly/logging/xlog.h>
 #include <chrono>
 
+DEFINE_bool(
+    qsfp_cache_subscribe_tcvr_info,
+    true,
+    "Subscribe to transceiver info changes pushed by qsfp_service");
+
 namespace facebook {
 namespace fboss {
 
@@ -41,6 +46,16 @@ void QsfpCache::init(folly::EventBase* evb, const PortMapThrift& ports) {
 
   attachEventBase(evb);
   scheduleTimeout(kLivenessCheckInterval);
+
+  if (FLAGS_qsfp_cache_subscribe_tcvr_info) {
+    evb_->runInEventBaseThread([this]() { subscribe(); });
+  }
+}
+
+QsfpCache::~QsfpCache() {
+  if (evb_) {
+    unsubscribe();
+  }
 }
 
 void QsfpCache::init(folly::EventBase* evb) {
@@ -149,9 +164,10 @@ folly::Future<folly::Unit> QsfpCache::doSync(PortMapThrift&& toSync) {
 
   auto onSuccess = [this,
                     gen = incrementGen(),
+                    streamGen = streamGen_,
                     oldAliveSince = remoteAliveSince_](auto&& tcvrs) {
     XLOG(DBG1) << "Got " << tcvrs.size() << " transceivers from qsfp_service";
-    updateCache(tcvrs);
+    updateCache(tcvrs, streamGen);
     if (remoteAliveSince_ == oldAliveSince || oldAliveSince < 0) {
       // no restart occurred in middle of request, store gen
       remoteGen_ = gen;
@@ -182,10 +198,32 @@ folly::Future<folly::Unit> QsfpCache::doSync(PortMapThrift&& toSync) {
       });
 }
 
-void QsfpCache::updateCache(const TcvrMapThrift& tcvrs) {
-  tcvrs_.withWLock([&tcvrs](auto& lockedTcvrs) {
+void QsfpCache::updateCache(const TcvrMapThrift& tcvrs, uint64_t streamGen) {
+  CHECK(evb_->isInEventBaseThread());
+
+  tcvrs_.withWLock([this, &tcvrs, streamGen](auto& lockedTcvrs) {
+    for (const auto& item : tcvrs) {
+      auto tcvrID = TransceiverID(item.first);
+      auto it = tcvrStreamGen_.find(tcvrID);
+      if (it != tcvrStreamGen_.end() && it->second > streamGen) {
+        XLOG(DBG3) << "Transceiver " << tcvrID
+                   << " streamed during syncPorts, skip its older reply";
+        continue;
+      }
+      lockedTcvrs[tcvrID] = item.second;
+    }
+  });
+}
+
+void QsfpCache::updateCacheFromStream(const TcvrMapThrift& tcvrs) {
+  CHECK(evb_->isInEventBaseThread());
+
+  auto gen = ++streamGen_;
+  tcvrs_.withWLock([this, &tcvrs, gen](auto& lockedTcvrs) {
     for (const auto& item : tcvrs) {
-      lockedTcvrs[TransceiverID(item.first)] = item.second;
+      auto tcvrID = TransceiverID(item.first);
+      lockedTcvrs[tcvrID] = item.second;
+      tcvrStreamGen_[tcvrID] = gen;
     }
   });
 }
@@ -240,9 +278,103 @@ QsfpCache::getAllTransceivers() const {
 
 void QsfpCache::timeoutExpired() noexcept {
   confirmAlive().then(&QsfpCache::maybeSync, this);
+  if (FLAGS_qsfp_cache_subscribe_tcvr_info && !streamClient_) {
+    subscribe();
+  }
   scheduleTimeout(kLivenessCheckInterval);
 }
 
+void QsfpCache::subscribe() {
+  CHECK(evb_->isInEventBaseThread());
+
+  unsubscribe();
+  auto id = subscriptionID_;
+  QsfpClient::createStreamingClient(evb_)
+      .thenValue([this, id](std::unique_ptr<QsfpServiceAsyncClient> client) {
+        auto options = QsfpClient::getRpcOptions();
+        auto stream = client->semifuture_subscribeTransceiverInfo(options);
+        if (id == subscriptionID_) {
+          streamClient_ = std::move(client);
+        }
+        return std::move(stream).via(evb_);
+      })
+      .thenValue([this, id](auto&& stream) {
+        if (id != subscriptionID_) {
+          // Superseded by a newer subscription while connecting
+          return;
+        }
+        XLOG(INFO) << "Subscribed to transceiver info from qsfp_service";
+        subscription_ = std::move(stream).subscribeExTry(
+            evb_, [this, id](auto&& update) {
+              handleUpdate(id, std::move(update));
+            });
+      })
+      .thenError(
+          folly::tag_t<std::exception>{}, [this, id](const std::exception& e) {
+            XLOG(ERR) << "Failed to subscribe to transceiver info from "
+                      << "qsfp_service: " << e.what();
+            if (id == subscriptionID_) {
+              // Will retry on the next liveness check
+              unsubscribe();
+            }
+          });
+}
+
+void QsfpCache::unsubscribe() {
+  ++subscriptionID_;
+  remoteTcvrGen_.reset();
+  if (subscription_) {
+    subscription_->cancel();
+    std::move(*subscription_).detach();
+    subscription_.reset();
+  }
+  if (streamClient_) {
+    // The channel has to be destroyed in the evb thread
+    evb_->runInEventBaseThread([client = std::move(streamClient_)]() {});
+  }
+}
+
+void QsfpCache::handleUpdate(
+    uint64_t subscriptionID,
+    folly::Try<TransceiverInfoUpdate>&& update) {
+  if (subscriptionID != subscriptionID_) {
+    return;
+  }
+  if (!update.hasValue()) {
+    if (update.hasException()) {
+      XLOG(ERR) << "Transceiver info stream from qsfp_service failed: "
+                << folly::exceptionStr(update.exception());
+    } else {
+      XLOG(WARN) << "Transceiver info stream from qsfp_service completed";
+    }
+    // Can't tear the stream down from its own callback
+    evb_->runInEventBaseThread([this, subscriptionID]() {
+      if (subscriptionID == subscriptionID_) {
+        unsubscribe();
+      }
+    });
+    return;
+  }
+
+  auto gen = *update->generation_ref();
+  if (!*update->fullSync_ref() &&
+      (!remoteTcvrGen_ || gen != *remoteTcvrGen_ + 1)) {
+    XLOG(WARN) << "Missed transceiver info updates from qsfp_service, "
+               << "generation " << (remoteTcvrGen_ ? *remoteTcvrGen_ : -1)
+               << " -> " << gen << ". Resubscribing";
+    evb_->runInEventBaseThread([this, subscriptionID]() {
+      if (subscriptionID == subscriptionID_) {
+        subscribe();
+      }
+    });
+    return;
+  }
+  remoteTcvrGen_ = gen;
+  XLOG(DBG3) << "Got " << update->transceivers_ref()->size()
+             << " transceivers at generation " << gen << " from qsfp_service";
+  updateCacheFromStream(*update->transceivers_ref());
+}
+
 void QsfpCache::dump() {
   // for now just dumps presence info. We should expand later
   auto lockedTcvrs = tcvrs_.rlock();
@@ -292,7 +424,10 @@ AutoInitQsfpCache::AutoInitQsfpCache() {
 
 AutoInitQsfpCache::~AutoInitQsfpCache() {
   if (thread_) {
-    evb_.runInEventBaseThread([this] { evb_.terminateLoopSoon(); });
+    evb_.runInEventBaseThread([this] {
+      unsubscribe();
+      evb_.terminateLoopSoon();
+    });
     thread_->join();
   }
 }
@@ -20,9 +20,12 @@
 #include <folly/futures/SharedPromise.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
+#include <thrift/lib/cpp2/async/ClientBufferedStream.h>
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/types.h"
+#include "fboss/qsfp_service/if/gen-cpp2/QsfpService.h"
+#include "fboss/qsfp_service/if/gen-cpp2/qsfp_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 /*
@@ -60,6 +63,20 @@
  * and store the last aliveSince. If this changes, we reset remoteGen_
  * back to zero so we will re-sync all ports.
  *
+ * Transceiver updates
+ * -------------------
+ * Besides the transceivers returned by syncPorts, the cache subscribes to
+ * subscribeTransceiverInfo() so that qsfp_service pushes every transceiver
+ * which changes (presence, state, or monitors moving past a threshold) as
+ * soon as it is refreshed. The subscription starts with a full sync, and
+ * every update carries a generation. If a generation is skipped we
+ * resubscribe to get a new full sync. If the stream fails, e.g. because
+ * qsfp_service restarted, we resubscribe on the next liveness check.
+ *
+ * A syncPorts reply can be older than what was streamed while the request was
+ * in flight, so the transceivers streamed since the request was sent are not
+ * overwritten by its reply.
+ *
  * Threading model
  * ---------------
  * All thrift calls to qsfp_service are done on evb_. No guarantee for
@@ -78,6 +95,7 @@ class QsfpCache : private folly::AsyncTimeout {
   using TcvrMapThrift = std::map<int32_t, TransceiverInfo>;
 
   QsfpCache() = default;
+  ~QsfpCache() override;
 
   /* Initializers. Sets the Eventbase and optionally the initial port
    * map to sync to qsfp_service.
@@ -132,15 +150,24 @@ class QsfpCache : private folly::AsyncTimeout {
   folly::Future<folly::Unit> confirmAlive();
 
   /* Called after successful sync to update transceivers in to our
-   * cache.
+   * cache. Transceivers streamed after streamGen are newer than the reply and
+   * are skipped.
    */
-  void updateCache(const TcvrMapThrift& tcvrs);
+  void updateCache(const TcvrMapThrift& tcvrs, uint64_t streamGen);
+  void updateCacheFromStream(const TcvrMapThrift& tcvrs);
 
   // gets a new unique generation number
   uint32_t incrementGen();
 
   void syncAllPresentTransceivers();
 
+  // (Re)subscribes to transceiver info updates from qsfp_service
+  void subscribe();
+  void unsubscribe();
+  void handleUpdate(
+      uint64_t subscriptionID,
+      folly::Try<TransceiverInfoUpdate>&& update);
+
   struct PortCacheValue {
     PortStatus port;
     uint32_t generation{0};
@@ -161,6 +188,20 @@ class QsfpCache : private folly::AsyncTimeout {
   // last aliveSince from qsfp_service
   int64_t remoteAliveSince_{-1};
 
+  std::unique_ptr<QsfpServiceAsyncClient> streamClient_;
+  std::optional<
+      apache::thrift::ClientBufferedStream<TransceiverInfoUpdate>::Subscription>
+      subscription_;
+  // Identifies the current subscription, so that the callbacks of a
+  // cancelled one are ignored
+  uint64_t subscriptionID_{0};
+  // generation of the last update received on the current subscription
+  std::optional<int64_t> remoteTcvrGen_;
+  // Number of stream updates applied to the cache, and the last one which
+  // updated each transceiver. Only accessed in the evb thread
+  uint64_t streamGen_{0};
+  std::unordered_map<TransceiverID, uint64_t> tcvrStreamGen_;
+
   std::atomic_bool initialized_{false};
 };
 
@@ -39,6 +39,10 @@ class QsfpClient {
   static folly::Future<std::unique_ptr<QsfpServiceAsyncClient>> createClient(
       folly::EventBase* eb);
 
+  // Client over a rocket channel, needed for the streaming apis
+  static folly::Future<std::unique_ptr<QsfpServiceAsyncClient>>
+  createStreamingClient(folly::EventBase* eb);
+
   static apache::thrift::RpcOptions getRpcOptions();
 };
 
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/lib/QsfpCache.h"
+
+#include "common/fb303/cpp/FacebookBase2.h"
+#include "fboss/lib/CommonUtils.h"
+#include "fboss/qsfp_service/if/gen-cpp2/QsfpService.h"
+
+#include <folly/Synchronized.h>
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+
+#include <atomic>
+
+DECLARE_string(qsfp_service_host);
+DECLARE_int32(qsfp_service_port);
+
+using namespace facebook::fboss;
+
+namespace {
+using TcvrMap = std::map<int32_t, TransceiverInfo>;
+
+TransceiverInfo makeInfo(int32_t id, const std::string& vendorName) {
+  TransceiverInfo info;
+  info.present_ref() = true;
+  info.port_ref() = id;
+  Vendor vendor;
+  vendor.name_ref() = vendorName;
+  info.vendor_ref() = vendor;
+  return info;
+}
+
+// qsfp_service whose transceiver info stream is driven by the test
+class FakeQsfpService
+    : public QsfpServiceSvIf,
+      public ::facebook::fb303::FacebookBase2DeprecationMigration {
+ public:
+  FakeQsfpService()
+      : ::facebook::fb303::FacebookBase2DeprecationMigration(
+            "FakeQsfpService") {}
+  ~FakeQsfpService() override {
+    for (auto& publisher : *publishers_.wlock()) {
+      std::move(*publisher).complete();
+    }
+  }
+
+  void getTransceiverInfo(
+      TcvrMap& /* info */,
+      std::unique_ptr<std::vector<int32_t>> /* ids */) override {}
+
+  void syncPorts(
+      TcvrMap& info,
+      std::unique_ptr<std::map<int32_t, PortStatus>> /* ports */) override {
+    numSyncPorts++;
+    if (blockSyncPorts) {
+      syncPortsBaton.wait();
+    }
+    info = *syncPortsReply.rlock();
+  }
+
+  apache::thrift::ServerStream<TransceiverInfoUpdate> subscribeTransceiverInfo()
+      override {
+    auto streamAndPublisher =
+        apache::thrift::ServerStream<TransceiverInfoUpdate>::createPublisher(
+            [] {});
+    publishers_.wlock()->push_back(std::make_unique<Publisher>(
+        std::move(streamAndPublisher.second)));
+    return std::move(streamAndPublisher.first);
+  }
+
+  size_t numSubscriptions() const {
+    return publishers_.rlock()->size();
+  }
+
+  // Push an update on the latest subscription
+  void push(int64_t generation, bool fullSync, const TcvrMap& tcvrs) {
+    TransceiverInfoUpdate update;
+    update.generation_ref() = generation;
+    update.fullSync_ref() = fullSync;
+    update.transceivers_ref() = tcvrs;
+    publishers_.rlock()->back()->next(std::move(update));
+  }
+
+  std::atomic<int> numSyncPorts{0};
+  std::atomic<bool> blockSyncPorts{false};
+  folly::Baton<> syncPortsBaton;
+  folly::Synchronized<TcvrMap> syncPortsReply;
+
+ private:
+  using Publisher =
+      apache::thrift::ServerStreamPublisher<TransceiverInfoUpdate>;
+  folly::Synchronized<std::vector<std::unique_ptr<Publisher>>> publishers_;
+};
+} // namespace
+
+class QsfpCacheTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    service_ = std::make_shared<FakeQsfpService>();
+    server_ =
+        std::make_unique<apache::thrift::ScopedServerInterfaceThread>(service_);
+    FLAGS_qsfp_service_host = "::1";
+    FLAGS_qsfp_service_port = server_->getPort();
+  }
+
+  void TearDown() override {
+    // Let a blocked syncPorts return, so that the server can stop
+    if (!service_->syncPortsBaton.ready()) {
+      service_->syncPortsBaton.post();
+    }
+    cache_.reset();
+    server_.reset();
+  }
+
+  std::string vendorName(int32_t id) {
+    auto info = cache_->getIf(TransceiverID(id));
+    return info ? *info->vendor_ref()->name_ref() : "";
+  }
+
+  void waitFor(std::function<bool()> condition) {
+    checkWithRetry(condition, 50, std::chrono::milliseconds(100));
+  }
+
+ protected:
+  gflags::FlagSaver flagSaver_;
+  std::shared_ptr<FakeQsfpService> service_;
+  std::unique_ptr<apache::thrift::ScopedServerInterfaceThread> server_;
+  std::unique_ptr<AutoInitQsfpCache> cache_;
+};
+
+TEST_F(QsfpCacheTest, subscribeAndResubscribeOnGap) {
+  cache_ = std::make_unique<AutoInitQsfpCache>();
+  waitFor([this] { return service_->numSubscriptions() == 1; });
+
+  service_->push(5, true, {{1, makeInfo(1, "fullSync")}});
+  waitFor([this] { return vendorName(1) == "fullSync"; });
+  service_->push(6, false, {{1, makeInfo(1, "update")}});
+  waitFor([this] { return vendorName(1) == "update"; });
+
+  // Generation 7 is missed, the cache drops 8 and resubscribes
+  service_->push(8, false, {{1, makeInfo(1, "afterGap")}});
+  waitFor([this] { return service_->numSubscriptions() == 2; });
+  EXPECT_EQ(vendorName(1), "update");
+
+  service_->push(20, true, {{1, makeInfo(1, "resynced")}});
+  waitFor([this] { return vendorName(1) == "resynced"; });
+}
+
+TEST_F(QsfpCacheTest, lateSyncPortsReply) {
+  service_->blockSyncPorts = true;
+  *service_->syncPortsReply.wlock() = {
+      {1, makeInfo(1, "syncPorts")}, {2, makeInfo(2, "syncPorts")}};
+  cache_ = std::make_unique<AutoInitQsfpCache>();
+  waitFor([this] { return service_->numSubscriptions() == 1; });
+
+  cache_->portChanged(1, PortStatus());
+  waitFor([this] { return service_->numSyncPorts == 1; });
+
+  // Transceiver 1 is streamed while syncPorts is in flight
+  service_->push(1, true, {{1, makeInfo(1, "streamed")}});
+  waitFor([this] { return vendorName(1) == "streamed"; });
+
+  // futureGet of an unknown transceiver completes once the reply is handled
+  auto replyHandled = cache_->futureGet(TransceiverID(3));
+  service_->syncPortsBaton.post();
+  EXPECT_THROW(std::move(replyHandled).get(), std::runtime_error);
+
+  // The older reply doesn't overwrite the streamed transceiver
+  EXPECT_EQ(vendorName(1), "streamed");
+  EXPECT_EQ(vendorName(2), "syncPorts");
+}
@@ -262,6 +262,7 @@ void QsfpModule::updateCachedTransceiverInfoLocked(ModuleStatus moduleStatus) {
     // latch, read data (page 24 and 25), release latch
     if (captureVdmStats_) {
       latchAndReadVdmDataLocked();
+      lastVdmRefreshTime_ = std::time(nullptr);
     }
 
     if (auto vdmStats = getVdmDiagsStatsInfo()) {
@@ -283,6 +284,10 @@ void QsfpModule::updateCachedTransceiverInfoLocked(ModuleStatus moduleStatus) {
     }
 
     info.timeCollected_ref() = lastRefreshTime_;
+    info.channelsTimeCollected_ref() = getChannelsRefreshTime();
+    if (isVdmSupported()) {
+      info.vdmTimeCollected_ref() = lastVdmRefreshTime_;
+    }
     info.remediationCounter_ref() = numRemediation_;
     info.eepromCsumValid_ref() = verifyEepromChecksums();
 
@@ -447,6 +452,15 @@ void QsfpModule::transceiverPortsChanged(
       ports_[it.first] = std::move(it.second);
     }
 
+    bool hasDownPorts = false;
+    for (const auto& port : ports_) {
+      if (*port.second.enabled_ref() && !*port.second.up_ref()) {
+        hasDownPorts = true;
+        break;
+      }
+    }
+    hasDownPorts_ = hasDownPorts;
+
     if (anyStateChanged) {
       publishSnapshots();
     }
@@ -506,34 +520,15 @@ void QsfpModule::transceiverPortsChanged(
   }
 }
 
+folly::EventBase* QsfpModule::getI2cEventBase() {
+  return qsfpImpl_->getI2cEventBase();
+}
+
 void QsfpModule::refresh() {
   lock_guard<std::mutex> g(qsfpModuleMutex_);
   refreshLocked();
 }
 
-folly::Future<folly::Unit> QsfpModule::futureRefresh() {
-  // Always use i2cEvb to program transceivers if there's an i2cEvb
-  auto i2cEvb = qsfpImpl_->getI2cEventBase();
-  if (!i2cEvb) {
-    try {
-      refresh();
-    } catch (const std::exception& ex) {
-      XLOG(DBG2) << "Transceiver " << static_cast<int>(this->getID())
-                 << ": Error calling refresh(): " << ex.what();
-    }
-    return folly::makeFuture();
-  }
-
-  return via(i2cEvb).thenValue([&](auto&&) mutable {
-    try {
-      this->refresh();
-    } catch (const std::exception& ex) {
-      XLOG(DBG2) << "Transceiver " << static_cast<int>(this->getID())
-                 << ": Error calling refresh(): " << ex.what();
-    }
-  });
-}
-
 void QsfpModule::refreshLocked() {
   ModuleStatus moduleStatus;
   detectPresenceLocked();
@@ -84,7 +84,6 @@ class QsfpModule : public Transceiver {
   bool detectPresenceLocked();
 
   virtual void refresh() override;
-  folly::Future<folly::Unit> futureRefresh() override;
 
   /*
    * Customize QSPF fields as necessary
@@ -275,6 +274,12 @@ class QsfpModule : public Transceiver {
     return lastDownTime_;
   }
 
+  folly::EventBase* getI2cEventBase() override;
+
+  bool hasDownPorts() const override {
+    return hasDownPorts_;
+  }
+
   virtual bool setPortPrbs(
       phy::Side /* side */,
       const phy::PortPrbsState& /* prbs */) {
@@ -413,6 +418,13 @@ class QsfpModule : public Transceiver {
    * Gather per-channel information for thrift queries
    */
   virtual bool getSensorsPerChanInfo(std::vector<Channel>& channels) = 0;
+  /*
+   * When the per-channel monitors were last read from the module. By default
+   * they are read with every refresh.
+   */
+  virtual time_t getChannelsRefreshTime() const {
+    return lastRefreshTime_;
+  }
   /*
    * Gather per-media-lane signal information for thrift queries
    */
@@ -579,7 +591,7 @@ class QsfpModule : public Transceiver {
    * enabled.
    */
   virtual void ensureRxOutputSquelchEnabled(
-      const std::vector<HostLaneSettings>& /*hostLaneSettings*/) const {}
+      const std::vector<HostLaneSettings>& /*hostLaneSettings*/) {}
 
   virtual std::optional<VdmDiagsStats> getVdmDiagsStatsInfo() {
     return std::nullopt;
@@ -600,6 +612,12 @@ class QsfpModule : public Transceiver {
   ModuleStatus moduleStatusCache_;
 
   std::atomic_bool captureVdmStats_{false};
+  // When the VDM pages were last latched and read
+  time_t lastVdmRefreshTime_{0};
+
+  // Cached from ports_ on every port sync so that the refresh scheduler can
+  // read it without taking qsfpModuleMutex_
+  std::atomic_bool hasDownPorts_{false};
 
  private:
   // no copy or assignment
@@ -15,6 +15,7 @@
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 #include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
 
 namespace facebook {
 namespace fboss {
@@ -51,7 +52,6 @@ class Transceiver {
    * Check if the transceiver is present or not and refresh data.
    */
   virtual void refresh() = 0;
-  virtual folly::Future<folly::Unit> futureRefresh() = 0;
 
   /*
    * Return all of the transceiver information
@@ -157,6 +157,19 @@ class Transceiver {
 
   virtual time_t getLastDownTime() const = 0;
 
+  /*
+   * Return the EventBase of the i2c controller this transceiver is behind, or
+   * nullptr if the platform can't run transactions on different controllers
+   * in parallel. Transceivers sharing an EventBase share the same bus.
+   */
+  virtual folly::EventBase* getI2cEventBase() = 0;
+
+  /*
+   * Return true if agent reported any enabled port of this transceiver as
+   * down in the last port sync.
+   */
+  virtual bool hasDownPorts() const = 0;
+
  protected:
   virtual void latchAndReadVdmDataLocked() = 0;
 
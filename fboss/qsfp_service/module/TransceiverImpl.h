@@ -15,6 +15,7 @@
 #include <optional>
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/types.h"
+#include "fboss/lib/usb/TransceiverReadTransaction.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 namespace facebook {
@@ -42,6 +43,26 @@ class TransceiverImpl {
       int len,
       uint8_t* fieldValue) = 0;
 
+  /*
+   * Issue all the reads of a transaction, coalesced, as one sequence. By
+   * default this goes through readTransceiver() and writeTransceiver().
+   */
+  virtual void readTransceiverTransaction(
+      int dataAddress,
+      const TransceiverReadTransaction& txn) {
+    txn.execute(
+        [&](uint8_t page) {
+          writeTransceiver(
+              dataAddress,
+              TransceiverReadTransaction::kPageSelectReg,
+              sizeof(page),
+              &page);
+        },
+        [&](int offset, int len, uint8_t* buf) {
+          readTransceiver(dataAddress, offset, len, buf);
+        });
+  }
+
   /*
    * This function will check if the transceiver is present or not
    */
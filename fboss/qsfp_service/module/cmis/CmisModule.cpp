@@ -30,6 +30,12 @@ using std::memcpy;
 using std::mutex;
 using namespace apache::thrift;
 
+DEFINE_int32(
+    cmis_dom_refresh_interval,
+    30,
+    "Seconds between reads of the CMIS lane status and monitor pages when "
+    "the module does not report any lane flag");
+
 namespace {
 
 constexpr int kUsecBetweenPowerModeFlap = 100000;
@@ -1392,6 +1398,30 @@ void CmisModule::getFieldValueLocked(CmisField fieldName, uint8_t* fieldValue)
   getQsfpValue(dataAddress, offset, length, fieldValue);
 }
 
+void CmisModule::readSnrPageLocked(bool selectPage) {
+  uint8_t page = 0x14;
+  auto diagFeature = (uint8_t)DiagnosticFeatureEncoding::SNR;
+  if (selectPage) {
+    qsfpImpl_->writeTransceiver(
+        TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+  }
+  qsfpImpl_->writeTransceiver(
+      TransceiverI2CApi::ADDR_QSFP, 128, sizeof(diagFeature), &diagFeature);
+  qsfpImpl_->readTransceiver(
+      TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page14_), page14_);
+}
+
+bool CmisModule::domRefreshNeeded() const {
+  // Lane flags on page 11h are summarized in the lower page, and a module
+  // state change usually comes with data path state changes on page 11h.
+  // Either means the lane status is stale, otherwise the monitors are only
+  // sampled every cmis_dom_refresh_interval seconds.
+  return getSettingsValue(CmisField::BANK0_FLAGS) ||
+      getSettingsValue(CmisField::MODULE_FLAG, MODULE_STATE_CHANGED_MASK) ||
+      std::time(nullptr) - lastDomRefreshTime_ >=
+      FLAGS_cmis_dom_refresh_interval;
+}
+
 void CmisModule::updateQsfpData(bool allPages) {
   // expects the lock to be held
   if (!present_) {
@@ -1413,93 +1443,75 @@ void CmisModule::updateQsfpData(bool allPages) {
       setLegacyModuleStateMachineCmisModuleReady(false);
     }
 
-    // If we have flat memory, we don't have to set the page
-    if (!flatMem_) {
-      uint8_t page = 0x00;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+    // All the upper pages are read in one transaction, which skips the page
+    // select for the page the module already has selected (byte 127 of the
+    // lower page we just read) and coalesces the page selects.
+    TransceiverReadTransaction txn;
+    txn.setSelectedPage(lowerPage_[127]);
+
+    if (allPages) {
+      // The information on page 00h is static, so we only need to read it
+      // when we first retrieve the data from this module.
+      // If we have flat memory, we don't have to set the page
+      txn.addRead(
+          flatMem_ ? TransceiverReadTransaction::kNoPageSelect : 0x00,
+          128,
+          sizeof(page0_),
+          page0_);
+      laneControlPageStale_ = true;
+      vdmPagesStale_ = true;
+    }
+    if (flatMem_) {
+      qsfpImpl_->readTransceiverTransaction(TransceiverI2CApi::ADDR_QSFP, txn);
+      return;
     }
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page0_), page0_);
-    if (!flatMem_) {
-      uint8_t page = 0x10;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page10_), page10_);
 
-      page = 0x11;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page11_), page11_);
-
-      if (getLegacyModuleStateMachineCmisModuleReady()) {
-        page = 0x14;
-        auto diagFeature = (uint8_t)DiagnosticFeatureEncoding::SNR;
-        qsfpImpl_->writeTransceiver(
-            TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-        qsfpImpl_->writeTransceiver(
-            TransceiverI2CApi::ADDR_QSFP,
-            128,
-            sizeof(diagFeature),
-            &diagFeature);
-        qsfpImpl_->readTransceiver(
-            TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page14_), page14_);
-
-        if (isVdmSupported()) {
-          page = 0x20;
-          qsfpImpl_->writeTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-          qsfpImpl_->readTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page20_), page20_);
-
-          page = 0x21;
-          qsfpImpl_->writeTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-          qsfpImpl_->readTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page21_), page21_);
-
-          page = 0x24;
-          qsfpImpl_->writeTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-          qsfpImpl_->readTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page24_), page24_);
-
-          page = 0x25;
-          qsfpImpl_->writeTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-          qsfpImpl_->readTransceiver(
-              TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page25_), page25_);
-        }
-      }
+    // Page 10h only holds lane controls, which change when we write them.
+    // The active controls reported on page 11h follow such writes.
+    bool laneControlChanged = laneControlPageStale_;
+    if (laneControlChanged) {
+      txn.addRead(0x10, 128, sizeof(page10_), page10_);
+      laneControlPageStale_ = false;
     }
 
-    if (!allPages) {
-      // The information on the following pages are static. Thus no need to
-      // fetch them every time. We just need to do it when we first retriving
-      // the data from this module.
-      return;
+    // Pages 11h and 14h hold lane status, flags and monitors
+    bool readSnrPage = false;
+    if (allPages || laneControlChanged || domRefreshNeeded()) {
+      txn.addRead(0x11, 128, sizeof(page11_), page11_);
+      lastDomRefreshTime_ = lastRefreshTime_;
+      readSnrPage = getLegacyModuleStateMachineCmisModuleReady();
     }
 
-    if (!flatMem_) {
-      uint8_t page = 0x01;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page01_), page01_);
+    // VDM pages are read once the module is ready, after that the samples
+    // on pages 24h and 25h are only refreshed when a capture is requested,
+    // see latchAndReadVdmDataLocked().
+    if (vdmPagesStale_ && getLegacyModuleStateMachineCmisModuleReady() &&
+        isVdmSupported()) {
+      txn.addRead(0x20, 128, sizeof(page20_), page20_);
+      txn.addRead(0x21, 128, sizeof(page21_), page21_);
+      txn.addRead(0x24, 128, sizeof(page24_), page24_);
+      txn.addRead(0x25, 128, sizeof(page25_), page25_);
+      vdmPagesStale_ = false;
+    }
 
-      page = 0x02;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page02_), page02_);
+    // The information on the following pages are static. Thus no need to
+    // fetch them every time. We just need to do it when we first retriving
+    // the data from this module.
+    if (allPages) {
+      txn.addRead(0x01, 128, sizeof(page01_), page01_);
+      txn.addRead(0x02, 128, sizeof(page02_), page02_);
+      txn.addRead(0x13, 128, sizeof(page13_), page13_);
+    }
 
-      page = 0x13;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page13_), page13_);
+    // Page 14h needs the diag feature selected before it's read, so it can't
+    // be part of the transaction. Read it first if it's already selected.
+    bool snrPageSelected = lowerPage_[127] == 0x14;
+    if (readSnrPage && snrPageSelected) {
+      readSnrPageLocked(false);
+    }
+    qsfpImpl_->readTransceiverTransaction(TransceiverI2CApi::ADDR_QSFP, txn);
+    if (readSnrPage && !snrPageSelected) {
+      readSnrPageLocked(true);
     }
   } catch (const std::exception& ex) {
     // No matter what kind of exception throws, we need to set the dirty_ flag
@@ -1579,6 +1591,7 @@ void CmisModule::setApplicationCode(cfg::PortSpeed speed) {
     uint8_t page = 0x10;
     qsfpImpl_->writeTransceiver(
         TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+    laneControlPageStale_ = true;
 
     // In 400G-FR4 case we will have 8 host lanes instead of 4. Further more,
     // we need to deactivate all the lanes when we switch to an application with
@@ -1799,7 +1812,7 @@ void CmisModule::setPowerOverrideIfSupported(PowerControlState currentState) {
 }
 
 void CmisModule::ensureRxOutputSquelchEnabled(
-    const std::vector<HostLaneSettings>& hostLanesSettings) const {
+    const std::vector<HostLaneSettings>& hostLanesSettings) {
   bool allLanesRxOutputSquelchEnabled = true;
   for (auto& hostLaneSettings : hostLanesSettings) {
     if (hostLaneSettings.rxSquelch_ref().has_value() &&
@@ -1819,6 +1832,7 @@ void CmisModule::ensureRxOutputSquelchEnabled(
     uint8_t page = 0x10;
     qsfpImpl_->writeTransceiver(
         TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+    laneControlPageStale_ = true;
 
     getQsfpFieldAddress(
         CmisField::RX_SQUELCH_DISABLE, dataAddress, offset, length);
@@ -1959,11 +1973,6 @@ void CmisModule::setModuleRxEqualizerLocked(RxEqualizerSettings rxEqualizer) {
         (*rxEqualizer.mainAmplitude_ref() & 0xf);
   }
 
-  // Flip to page 0x11 to read current values
-  uint8_t page = 0x11;
-  qsfpImpl_->writeTransceiver(
-      TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-
   auto compareSettings = [numLanes](
                              uint8_t currSettings[],
                              uint8_t desiredSettings[],
@@ -1980,32 +1989,32 @@ void CmisModule::setModuleRxEqualizerLocked(RxEqualizerSettings rxEqualizer) {
     }
   };
 
-  // Compare current Pre cursor value to see if the change is needed
+  // Read the current values from page 0x11. The pre/post/main cursor fields
+  // are adjacent, so this is a single page select and read.
+  int preLength, postLength, mainLength;
+  TransceiverReadTransaction txn;
   getQsfpFieldAddress(
-      CmisField::RX_OUT_PRE_CURSOR, dataAddress, offset, length);
-  qsfpImpl_->readTransceiver(
-      TransceiverI2CApi::ADDR_QSFP, offset, length, currPre);
-  compareSettings(currPre, desiredPre, length, changePre);
-
-  // Compare current Post cursor value to see if the change is needed
+      CmisField::RX_OUT_PRE_CURSOR, dataAddress, offset, preLength);
+  txn.addRead(0x11, offset, preLength, currPre);
   getQsfpFieldAddress(
-      CmisField::RX_OUT_POST_CURSOR, dataAddress, offset, length);
-  qsfpImpl_->readTransceiver(
-      TransceiverI2CApi::ADDR_QSFP, offset, length, currPost);
-  compareSettings(currPost, desiredPost, length, changePost);
+      CmisField::RX_OUT_POST_CURSOR, dataAddress, offset, postLength);
+  txn.addRead(0x11, offset, postLength, currPost);
+  getQsfpFieldAddress(CmisField::RX_OUT_MAIN, dataAddress, offset, mainLength);
+  txn.addRead(0x11, offset, mainLength, currMain);
+  qsfpImpl_->readTransceiverTransaction(TransceiverI2CApi::ADDR_QSFP, txn);
 
-  // Compare current Rx Main value to see if the change is needed
-  getQsfpFieldAddress(CmisField::RX_OUT_MAIN, dataAddress, offset, length);
-  qsfpImpl_->readTransceiver(
-      TransceiverI2CApi::ADDR_QSFP, offset, length, currMain);
-  compareSettings(currMain, desiredMain, length, changeMain);
+  // Compare current values to see if the change is needed
+  compareSettings(currPre, desiredPre, preLength, changePre);
+  compareSettings(currPost, desiredPost, postLength, changePost);
+  compareSettings(currMain, desiredMain, mainLength, changeMain);
 
   // If anything is changed then apply the change and trigger it
   if (changePre || changePost || changeMain) {
     // Flip to page 0x10 to change the values
-    page = 0x10;
+    uint8_t page = 0x10;
     qsfpImpl_->writeTransceiver(
         TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
+    laneControlPageStale_ = true;
 
     // Apply the change for pre/post/main if needed
     if (changePre) {
@@ -2129,29 +2138,12 @@ void CmisModule::moduleDiagsCapabilitySet() {
 
   // If VDM capability has been identified then update VDM cache
   if (diagsCapability_.has_value() && *diagsCapability_.value().vdm_ref()) {
-    uint8_t page = 0x20;
-    qsfpImpl_->writeTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page20_), page20_);
-
-    page = 0x21;
-    qsfpImpl_->writeTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page21_), page21_);
-
-    page = 0x24;
-    qsfpImpl_->writeTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page24_), page24_);
-
-    page = 0x25;
-    qsfpImpl_->writeTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page25_), page25_);
+    TransceiverReadTransaction txn;
+    txn.addRead(0x20, 128, sizeof(page20_), page20_);
+    txn.addRead(0x21, 128, sizeof(page21_), page21_);
+    txn.addRead(0x24, 128, sizeof(page24_), page24_);
+    txn.addRead(0x25, 128, sizeof(page25_), page25_);
+    qsfpImpl_->readTransceiverTransaction(TransceiverI2CApi::ADDR_QSFP, txn);
   }
 }
 
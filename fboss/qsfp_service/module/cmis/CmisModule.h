@@ -92,6 +92,15 @@ class CmisModule : public QsfpModule {
   uint8_t page24_[MAX_QSFP_PAGE_SIZE];
   uint8_t page25_[MAX_QSFP_PAGE_SIZE];
 
+  /*
+   * Partial refreshes skip the upper pages which can't have changed since
+   * they were last read, see updateQsfpData().
+   */
+  // Set whenever we write lane controls on page 10h
+  bool laneControlPageStale_{true};
+  bool vdmPagesStale_{true};
+  time_t lastDomRefreshTime_{0};
+
   /*
    * This function returns a pointer to the value in the static cached
    * data after checking the length fits. The thread needs to have the lock
@@ -167,6 +176,13 @@ class CmisModule : public QsfpModule {
    * Gather per-channel information for thrift queries
    */
   bool getSensorsPerChanInfo(std::vector<Channel>& channels) override;
+  /*
+   * The lane monitors on page 11h are only read every
+   * cmis_dom_refresh_interval seconds, see domRefreshNeeded()
+   */
+  time_t getChannelsRefreshTime() const override {
+    return lastDomRefreshTime_;
+  }
   /*
    * Gather per-media-lane signal information for thrift queries
    */
@@ -313,6 +329,18 @@ class CmisModule : public QsfpModule {
   CmisModule& operator=(CmisModule const&) = delete;
 
   void getFieldValueLocked(CmisField fieldName, uint8_t* fieldValue) const;
+
+  /*
+   * Select the SNR diagnostic feature and read page 14h. selectPage is false
+   * when page 14h is already selected.
+   */
+  void readSnrPageLocked(bool selectPage);
+
+  /*
+   * Whether the lane status and monitor pages need to be read during a
+   * partial refresh, based on the flags in the lower page just read.
+   */
+  bool domRefreshNeeded() const;
   /*
    * Helpers to parse DOM data for DAC cables. These incorporate some
    * extra fields that FB has vendors put in the 'Vendor specific'
@@ -331,7 +359,7 @@ class CmisModule : public QsfpModule {
    * This function is to ensure that Rx output squelch is always enabled.
    */
   void ensureRxOutputSquelchEnabled(
-      const std::vector<HostLaneSettings>& hostLaneSettings) const override;
+      const std::vector<HostLaneSettings>& hostLaneSettings) override;
 
   /*
    * Check if the module has accepted the lane configuration specified by
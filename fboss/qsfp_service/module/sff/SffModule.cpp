@@ -865,21 +865,20 @@ void SffModule::updateQsfpData(bool allPages) {
       return;
     }
 
+    // Byte 127 of the lower page we just read is the page the module has
+    // selected, so the transaction can skip selecting it again.
     // If we have flat memory, we don't have to set the page
+    TransceiverReadTransaction txn;
+    txn.setSelectedPage(lowerPage_[127]);
+    txn.addRead(
+        flatMem_ ? TransceiverReadTransaction::kNoPageSelect : 0,
+        128,
+        sizeof(page0_),
+        page0_);
     if (!flatMem_) {
-      uint8_t page = 0;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-    }
-    qsfpImpl_->readTransceiver(
-        TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page0_), page0_);
-    if (!flatMem_) {
-      uint8_t page = 3;
-      qsfpImpl_->writeTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 127, sizeof(page), &page);
-      qsfpImpl_->readTransceiver(
-          TransceiverI2CApi::ADDR_QSFP, 128, sizeof(page3_), page3_);
+      txn.addRead(3, 128, sizeof(page3_), page3_);
     }
+    qsfpImpl_->readTransceiverTransaction(TransceiverI2CApi::ADDR_QSFP, txn);
   } catch (const std::exception& ex) {
     // No matter what kind of exception throws, we need to set the dirty_ flag
     // to true.
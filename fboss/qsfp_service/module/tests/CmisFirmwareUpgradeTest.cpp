@@ -0,0 +1,186 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/firmware_storage/FbossFirmware.h"
+#include "fboss/lib/i2c/FirmwareUpgradeOrchestrator.h"
+#include "fboss/lib/i2c/FirmwareUpgrader.h"
+#include "fboss/qsfp_service/module/tests/FakeTransceiverImpl.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <mutex>
+
+DECLARE_int32(cdb_fw_run_wait_ms);
+DECLARE_int32(cdb_fw_commit_wait_ms);
+
+namespace facebook::fboss {
+
+namespace {
+constexpr uint8_t kHeaderLen = 16;
+constexpr int kBusyReads = 3;
+
+// An I2C bus with the fake CDB modules behind it, which tracks how many
+// modules of each controller are busy with a CDB command at the same time
+class FakeCdbI2CApi : public TransceiverI2CApi {
+ public:
+  void addModule(int controller, std::unique_ptr<CmisCdbTransceiver> tcvr) {
+    controllers_[tcvr->getNum()] = controller;
+    modules_[tcvr->getNum()] = std::move(tcvr);
+  }
+  CmisCdbTransceiver* getModule(unsigned int module) {
+    return modules_.at(module).get();
+  }
+  int getMaxBusy(int controller) {
+    std::lock_guard<std::mutex> g(mutex_);
+    return maxBusy_[controller];
+  }
+
+  void open() override {}
+  void close() override {}
+  void verifyBus(bool /* autoReset */) override {}
+  bool isPresent(unsigned int module) override {
+    return modules_.find(module) != modules_.end();
+  }
+  void scanPresence(std::map<int32_t, ModulePresence>& /* presences */)
+      override {}
+
+  void moduleRead(
+      unsigned int module,
+      uint8_t i2cAddress,
+      int offset,
+      int len,
+      uint8_t* buf) override {
+    std::lock_guard<std::mutex> g(mutex_);
+    getModule(module)->readTransceiver(i2cAddress, offset, len, buf);
+    updateMaxBusy(module);
+  }
+  void moduleWrite(
+      unsigned int module,
+      uint8_t i2cAddress,
+      int offset,
+      int len,
+      const uint8_t* buf) override {
+    std::lock_guard<std::mutex> g(mutex_);
+    getModule(module)->writeTransceiver(
+        i2cAddress, offset, len, const_cast<uint8_t*>(buf));
+    updateMaxBusy(module);
+  }
+
+ private:
+  void updateMaxBusy(unsigned int module) {
+    int controller = controllers_[module];
+    int busy = 0;
+    for (const auto& [id, tcvr] : modules_) {
+      if (controllers_[id] == controller && tcvr->isBusy()) {
+        busy++;
+      }
+    }
+    maxBusy_[controller] = std::max(maxBusy_[controller], busy);
+  }
+
+  std::mutex mutex_;
+  std::map<unsigned int, std::unique_ptr<CmisCdbTransceiver>> modules_;
+  std::map<unsigned int, int> controllers_;
+  std::map<int, int> maxBusy_;
+};
+
+class CmisFirmwareUpgradeTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    FLAGS_cdb_fw_run_wait_ms = 0;
+    FLAGS_cdb_fw_commit_wait_ms = 0;
+
+    // Bigger than one EPL chunk and not a multiple of the LPL chunks
+    for (int i = 0; i < 5000; i++) {
+      image_.push_back(i * 7 % 251);
+    }
+    folly::writeFull(imageFile_.fd(), image_.data(), image_.size());
+  }
+
+  std::unique_ptr<CmisFirmwareUpgrader> makeUpgrader(unsigned int module) {
+    FbossFirmware::FwAttributes firmwareAttr;
+    firmwareAttr.filename = imageFile_.path().string();
+    firmwareAttr.properties["msa_password"] = "0";
+    firmwareAttr.properties["header_length"] =
+        folly::to<std::string>(kHeaderLen);
+    firmwareAttr.properties["image_type"] = "application";
+    return std::make_unique<CmisFirmwareUpgrader>(
+        &bus_, module, std::make_unique<FbossFirmware>(firmwareAttr));
+  }
+
+  void addModule(unsigned int module, int controller, bool eplSupported) {
+    bus_.addModule(
+        controller,
+        std::make_unique<CmisCdbTransceiver>(
+            module, kHeaderLen, eplSupported, kBusyReads));
+    orchestrator_.addModule(controller, makeUpgrader(module));
+  }
+
+  gflags::FlagSaver flagSaver_;
+  folly::test::TemporaryFile imageFile_;
+  std::vector<uint8_t> image_;
+  FakeCdbI2CApi bus_;
+  CmisFirmwareUpgradeOrchestrator orchestrator_;
+};
+} // namespace
+
+TEST_F(CmisFirmwareUpgradeTest, upgradeAllControllers) {
+  addModule(1, 0, true);
+  addModule(2, 0, false);
+  addModule(3, 1, true);
+  addModule(4, 1, false);
+
+  auto results = orchestrator_.run();
+  ASSERT_EQ(results.size(), 4);
+  for (const auto& [module, result] : results) {
+    EXPECT_TRUE(result);
+    auto tcvr = bus_.getModule(module);
+    EXPECT_EQ(tcvr->getDownloadedImage(), image_);
+    EXPECT_TRUE(tcvr->isDownloadComplete());
+    EXPECT_TRUE(tcvr->isCommitted());
+  }
+
+  for (const auto& progress : orchestrator_.getProgress()) {
+    EXPECT_EQ(progress.stage, CmisFirmwareUpgrader::Stage::DONE);
+    EXPECT_EQ(progress.bytesDownloaded, static_cast<int>(image_.size()));
+    EXPECT_EQ(progress.imageLen, static_cast<int>(image_.size()));
+  }
+
+  // The commands of the modules behind one controller were interleaved
+  EXPECT_EQ(bus_.getMaxBusy(0), 2);
+  EXPECT_EQ(bus_.getMaxBusy(1), 2);
+}
+
+TEST_F(CmisFirmwareUpgradeTest, upgradeFailure) {
+  addModule(1, 0, true);
+  addModule(2, 0, true);
+  // Download image with EPL
+  bus_.getModule(2)->setFailedCommand(0x0104);
+
+  auto results = orchestrator_.run();
+  EXPECT_TRUE(results[1]);
+  EXPECT_FALSE(results[2]);
+  EXPECT_EQ(bus_.getModule(1)->getDownloadedImage(), image_);
+  EXPECT_FALSE(bus_.getModule(2)->isDownloadComplete());
+
+  for (const auto& progress : orchestrator_.getProgress()) {
+    EXPECT_EQ(
+        progress.stage,
+        progress.moduleId == 1 ? CmisFirmwareUpgrader::Stage::DONE
+                               : CmisFirmwareUpgrader::Stage::FAILED);
+  }
+}
+
+TEST(CmisFirmwareUpgraderTest, stepWithoutImage) {
+  FakeCdbI2CApi bus;
+  bus.addModule(
+      0, std::make_unique<CmisCdbTransceiver>(1, kHeaderLen, true, 0));
+  CmisFirmwareUpgrader upgrader(&bus, 1, nullptr);
+  upgrader.step();
+  EXPECT_TRUE(upgrader.isDone());
+  EXPECT_FALSE(upgrader.succeeded());
+}
+
+} // namespace facebook::fboss
@@ -13,6 +13,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <cstdint>
+#include "fboss/lib/usb/TransceiverI2CApi.h"
 #include "fboss/qsfp_service/module/QsfpModule.h"
 #include "fboss/qsfp_service/module/cmis/CmisModule.h"
 #include "fboss/qsfp_service/module/tests/FakeTransceiverImpl.h"
@@ -20,11 +21,19 @@
 
 #include <gtest/gtest.h>
 
+DECLARE_int32(cmis_dom_refresh_interval);
+
 using namespace facebook::fboss;
 using std::make_unique;
 
 namespace {
 
+class CmisModuleUnderTest : public CmisModule {
+ public:
+  using CmisModule::CmisModule;
+  using CmisModule::updateQsfpData;
+};
+
 // Tests that the transceiverInfo object is correctly populated
 TEST(CmisTest, transceiverInfoTest) {
   int idx = 1;
@@ -456,4 +465,59 @@ TEST(CmisFlatMemTest, transceiverInfoTest) {
   EXPECT_EQ(xcvr->numMediaLanes(), 0);
 }
 
+// Partial refreshes should only touch the pages which may have changed
+TEST(CmisTest, partialRefreshI2CTransactions) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_cmis_dom_refresh_interval = 3600;
+
+  int idx = 1;
+  std::unique_ptr<Cmis200GTransceiver> qsfpImpl =
+      std::make_unique<Cmis200GTransceiver>(idx);
+  auto fakeImpl = qsfpImpl.get();
+  auto xcvr = std::make_unique<CmisModuleUnderTest>(
+      nullptr, std::move(qsfpImpl), 4);
+  // Full refresh of a newly inserted module. Refresh may also write lane
+  // controls, so do one more partial refresh to pick those up.
+  xcvr->refresh();
+  xcvr->updateQsfpData(false);
+
+  auto i2cTransactions = [fakeImpl]() {
+    return fakeImpl->getNumReads() + fakeImpl->getNumWrites();
+  };
+
+  // No lane flag set: only the lower page is read
+  auto before = i2cTransactions();
+  xcvr->updateQsfpData(false);
+  EXPECT_EQ(i2cTransactions() - before, 1);
+
+  // The lane flag summary pulls in the lane status page 11h and the SNR
+  // page 14h. Page 14h needs the page select and the diag feature select.
+  // Start with page 00h selected.
+  uint8_t page = 0x00;
+  fakeImpl->writeTransceiver(TransceiverI2CApi::ADDR_QSFP, 127, 1, &page);
+  uint8_t laneFlagSummary = 0x01;
+  fakeImpl->writeTransceiver(
+      TransceiverI2CApi::ADDR_QSFP, 4, 1, &laneFlagSummary);
+  before = i2cTransactions();
+  xcvr->updateQsfpData(false);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 2 + 3);
+
+  // Same once the DOM refresh interval is up, even without any flag. Page
+  // 14h is still selected, so it's read first without a page select.
+  laneFlagSummary = 0x00;
+  fakeImpl->writeTransceiver(
+      TransceiverI2CApi::ADDR_QSFP, 4, 1, &laneFlagSummary);
+  FLAGS_cmis_dom_refresh_interval = 0;
+  before = i2cTransactions();
+  xcvr->updateQsfpData(false);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 2 + 2);
+
+  // A full refresh reads every page again: lower page, pages 00h, 10h, 11h,
+  // 01h, 02h, 13h and 14h. Page 11h is still selected, so it's read first
+  // without a page select.
+  before = i2cTransactions();
+  xcvr->updateQsfpData(true);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 1 + 2 + 2 + 2 + 2 + 2 + 3);
+}
+
 } // namespace
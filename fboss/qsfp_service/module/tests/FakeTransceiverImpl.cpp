@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 namespace {
 // Create a copy of the lower page that's passed in, and set the module ID byte
 template <typename ArrayT, size_t MemberCount = std::extent<ArrayT>::value>
@@ -29,6 +31,7 @@ int FakeTransceiverImpl::readTransceiver(
     uint8_t* fieldValue) {
   int read = 0;
   EXPECT_TRUE(dataAddress == 0x50 || dataAddress == 0x51);
+  numReads_++;
 
   if (offset < QsfpModule::MAX_QSFP_PAGE_SIZE) {
     read = len;
@@ -61,6 +64,7 @@ int FakeTransceiverImpl::writeTransceiver(
     int offset,
     int len,
     uint8_t* fieldValue) {
+  numWrites_++;
   if (offset == 127) {
     page_ = *fieldValue;
   }
@@ -624,5 +628,135 @@ CmisFlatMemTransceiver::CmisFlatMemTransceiver(int module)
 
 Sfp10GTransceiver::Sfp10GTransceiver(int module)
     : FakeTransceiverImpl(module, kSfpLowerPages, kSfpUpperPages) {}
+
+namespace {
+// CDB page, command and status registers
+constexpr uint8_t kCdbPage = 0x9f;
+constexpr uint8_t kEplFirstPage = 0xa0;
+constexpr uint8_t kEplLastPage = 0xaf;
+constexpr int kCdbStatusReg = 37;
+constexpr int kCdbCommandLsbReg = 129;
+constexpr uint16_t kCdbCommandRun = 0x0109;
+constexpr uint8_t kCdbStatusSuccess = 0x01;
+constexpr uint8_t kCdbStatusBusy = 0x83;
+constexpr uint8_t kCdbStatusFailed = 0x45;
+
+uint32_t readBe32(const uint8_t* buf) {
+  return (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+}
+} // namespace
+
+CmisCdbTransceiver::CmisCdbTransceiver(
+    int module,
+    uint8_t headerLen,
+    bool eplSupported,
+    int busyReads)
+    : Cmis200GTransceiver(module),
+      headerLen_(headerLen),
+      eplSupported_(eplSupported),
+      busyReads_(busyReads) {
+  upperPages_[TransceiverI2CApi::ADDR_QSFP][kCdbPage] = {};
+  for (int page = kEplFirstPage; page <= kEplLastPage; page++) {
+    upperPages_[TransceiverI2CApi::ADDR_QSFP][page] = {};
+  }
+}
+
+int CmisCdbTransceiver::readTransceiver(
+    int dataAddress,
+    int offset,
+    int len,
+    uint8_t* fieldValue) {
+  if (offset == kCdbStatusReg && busyReadsLeft_ > 0 && --busyReadsLeft_ == 0) {
+    finishCommand();
+  }
+  return FakeTransceiverImpl::readTransceiver(
+      dataAddress, offset, len, fieldValue);
+}
+
+int CmisCdbTransceiver::writeTransceiver(
+    int dataAddress,
+    int offset,
+    int len,
+    uint8_t* fieldValue) {
+  auto ret = FakeTransceiverImpl::writeTransceiver(
+      dataAddress, offset, len, fieldValue);
+  if (page_ == kCdbPage && offset <= kCdbCommandLsbReg &&
+      offset + len > kCdbCommandLsbReg) {
+    startCommand();
+  }
+  return ret;
+}
+
+void CmisCdbTransceiver::startCommand() {
+  // The module can't take a new command while the previous one is running
+  EXPECT_FALSE(isBusy());
+  lowerPages_[TransceiverI2CApi::ADDR_QSFP][kCdbStatusReg] = kCdbStatusBusy;
+  // The RUN command resets the module, nobody checks its status
+  auto& cdb = upperPages_[TransceiverI2CApi::ADDR_QSFP][kCdbPage];
+  busyReadsLeft_ = ((cdb[0] << 8) | cdb[1]) == kCdbCommandRun ? 0 : busyReads_;
+  if (busyReadsLeft_ == 0) {
+    finishCommand();
+  }
+}
+
+void CmisCdbTransceiver::finishCommand() {
+  auto& cdb = upperPages_[TransceiverI2CApi::ADDR_QSFP][kCdbPage];
+  uint16_t command = (cdb[0] << 8) | cdb[1];
+  uint16_t eplLen = (cdb[2] << 8) | cdb[3];
+  uint8_t lplLen = cdb[4];
+  uint8_t* rlplLen = &cdb[6];
+  uint8_t* lpl = &cdb[8];
+
+  auto& status = lowerPages_[TransceiverI2CApi::ADDR_QSFP][kCdbStatusReg];
+  if (failedCommand_ == command) {
+    status = kCdbStatusFailed;
+    return;
+  }
+  status = kCdbStatusSuccess;
+  switch (command) {
+    case 0x0000:
+      // Module query: firmware download is not locked
+      *rlplLen = 3;
+      lpl[2] = 1;
+      break;
+    case 0x0041:
+      // Firmware update features: header size and EPL support
+      *rlplLen = 6;
+      lpl[2] = headerLen_;
+      lpl[5] = eplSupported_ ? 0x11 : 0x01;
+      break;
+    case 0x0101:
+      // Download start with the image size and header
+      image_.assign(lpl + 8, lpl + lplLen);
+      image_.reserve(readBe32(lpl));
+      downloadComplete_ = false;
+      break;
+    case 0x0103:
+    case 0x0104: {
+      // Download image from LPL or EPL, at an address after the header
+      size_t address = headerLen_ + readBe32(lpl);
+      std::vector<uint8_t> chunk;
+      if (command == 0x0103) {
+        chunk.assign(lpl + 4, lpl + lplLen);
+      } else {
+        for (int i = 0; i < eplLen; i++) {
+          chunk.push_back(upperPages_[TransceiverI2CApi::ADDR_QSFP]
+                                     [kEplFirstPage + i / 128][i % 128]);
+        }
+      }
+      image_.resize(std::max(image_.size(), address + chunk.size()));
+      std::copy(chunk.begin(), chunk.end(), image_.begin() + address);
+      break;
+    }
+    case 0x0107:
+      downloadComplete_ = true;
+      break;
+    case 0x010a:
+      committed_ = true;
+      break;
+    default:
+      break;
+  }
+}
 } // namespace fboss
 } // namespace facebook
@@ -4,6 +4,9 @@
 
 #include "fboss/qsfp_service/module/TransceiverImpl.h"
 
+#include <optional>
+#include <vector>
+
 namespace facebook {
 namespace fboss {
 
@@ -36,8 +39,18 @@ class FakeTransceiverImpl : public TransceiverImpl {
   folly::StringPiece getName() override;
   int getNum() const override;
 
- private:
+  /* Number of I2C read and write transactions issued to the module so far */
+  int getNumReads() const {
+    return numReads_;
+  }
+  int getNumWrites() const {
+    return numWrites_;
+  }
+
+ protected:
   int module_{0};
+  int numReads_{0};
+  int numWrites_{0};
   std::string moduleName_;
   int page_{0};
   std::map<uint8_t, std::map<int, std::array<uint8_t, 128>>> upperPages_;
@@ -79,6 +92,56 @@ class Cmis200GTransceiver : public FakeTransceiverImpl {
   explicit Cmis200GTransceiver(int module);
 };
 
+// A CMIS module which also runs the CDB firmware download commands. A
+// command starts with the write to the command LSB register of the CDB page
+// and stays busy for busyReads reads of the CDB status register. The image
+// written by the download commands is reassembled for the test to check.
+class CmisCdbTransceiver : public Cmis200GTransceiver {
+ public:
+  CmisCdbTransceiver(
+      int module,
+      uint8_t headerLen,
+      bool eplSupported,
+      int busyReads);
+  int readTransceiver(int dataAddress, int offset, int len, uint8_t* fieldValue)
+      override;
+  int writeTransceiver(
+      int dataAddress,
+      int offset,
+      int len,
+      uint8_t* fieldValue) override;
+
+  // Fail the given CDB command instead of running it
+  void setFailedCommand(uint16_t command) {
+    failedCommand_ = command;
+  }
+  bool isBusy() const {
+    return busyReadsLeft_ > 0;
+  }
+  const std::vector<uint8_t>& getDownloadedImage() const {
+    return image_;
+  }
+  bool isDownloadComplete() const {
+    return downloadComplete_;
+  }
+  bool isCommitted() const {
+    return committed_;
+  }
+
+ private:
+  void startCommand();
+  void finishCommand();
+
+  uint8_t headerLen_;
+  bool eplSupported_;
+  int busyReads_;
+  int busyReadsLeft_{0};
+  std::optional<uint16_t> failedCommand_;
+  std::vector<uint8_t> image_;
+  bool downloadComplete_{false};
+  bool committed_{false};
+};
+
 class Cmis400GLr4Transceiver : public FakeTransceiverImpl {
  public:
   explicit Cmis400GLr4Transceiver(int module);
@@ -13,6 +13,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <cstdint>
+#include "fboss/lib/usb/TransceiverI2CApi.h"
 #include "fboss/qsfp_service/module/QsfpModule.h"
 #include "fboss/qsfp_service/module/sff/Sff8472Module.h"
 #include "fboss/qsfp_service/module/sff/SffModule.h"
@@ -26,6 +27,12 @@ using std::make_unique;
 
 namespace {
 
+class SffModuleUnderTest : public SffModule {
+ public:
+  using SffModule::SffModule;
+  using SffModule::updateQsfpData;
+};
+
 // Tests that the transceiverInfo object is correctly populated
 TEST(SffTest, transceiverInfoTest) {
   int idx = 1;
@@ -288,4 +295,53 @@ TEST(SfpTest, transceiverInfoTest) {
   EXPECT_EQ(info.moduleMediaInterface_ref(), MediaInterfaceCode::LR_10G);
 }
 
+// A full refresh reads pages 00h and 03h in one transaction, which skips the
+// select of the page the module already has selected
+TEST(SffTest, fullRefreshI2CTransactions) {
+  int idx = 1;
+  std::unique_ptr<SffCwdm4Transceiver> qsfpImpl =
+      std::make_unique<SffCwdm4Transceiver>(idx);
+  auto fakeImpl = qsfpImpl.get();
+  auto qsfp =
+      std::make_unique<SffModuleUnderTest>(nullptr, std::move(qsfpImpl), 4);
+  qsfp->refresh();
+
+  auto i2cTransactions = [fakeImpl]() {
+    return fakeImpl->getNumReads() + fakeImpl->getNumWrites();
+  };
+
+  // Partial refreshes only read the lower page
+  auto before = i2cTransactions();
+  qsfp->updateQsfpData(false);
+  EXPECT_EQ(i2cTransactions() - before, 1);
+
+  // With page 00h selected: the lower page, page 00h without a page select,
+  // then page 03h with one. Selecting each page, as before transactions,
+  // took 1 + 2 + 2.
+  uint8_t page = 0x00;
+  fakeImpl->writeTransceiver(TransceiverI2CApi::ADDR_QSFP, 127, 1, &page);
+  before = i2cTransactions();
+  qsfp->updateQsfpData(true);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 1 + 2);
+
+  // Page 03h is still selected, so it's read first without a page select
+  before = i2cTransactions();
+  qsfp->updateQsfpData(true);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 1 + 2);
+
+  // With any other page selected both pages need a page select, which is no
+  // worse than before
+  page = 0x02;
+  fakeImpl->writeTransceiver(TransceiverI2CApi::ADDR_QSFP, 127, 1, &page);
+  before = i2cTransactions();
+  qsfp->updateQsfpData(true);
+  EXPECT_EQ(i2cTransactions() - before, 1 + 2 + 2);
+
+  // The pages still land in their own caches
+  TransceiverInfo info = qsfp->getTransceiverInfo();
+  TransceiverTestsHelper tests(info);
+  tests.verifyVendorName("FACETEST");
+  tests.verifyTemp(31.015625);
+}
+
 } // namespace
@@ -12,6 +12,9 @@
 
 #include "fboss/qsfp_service/StatsPublisher.h"
 
+#include <optional>
+#include <thread>
+
 using folly::MutableByteRange;
 using std::lock_guard;
 
@@ -67,6 +70,40 @@ void WedgeI2CBusLock::moduleWrite(
   wedgeI2CBus_->moduleWrite(module, address, offset, len, buf);
 }
 
+void WedgeI2CBusLock::moduleReadTransaction(
+    unsigned int module,
+    uint8_t address,
+    const TransceiverReadTransaction& txn,
+    std::chrono::microseconds pageSelectDelay) {
+  // Hold the bus for each page select and the reads behind it, but not
+  // across the delay after a page select, so that other modules can use the
+  // bus in the meantime
+  std::optional<BusGuard> g;
+  txn.execute(
+      [&](uint8_t page) {
+        if (!g) {
+          g.emplace(this);
+        }
+        wedgeI2CBus_->moduleWrite(
+            module,
+            address,
+            TransceiverReadTransaction::kPageSelectReg,
+            sizeof(page),
+            &page);
+        if (pageSelectDelay.count()) {
+          g.reset();
+          /* sleep override */
+          std::this_thread::sleep_for(pageSelectDelay);
+        }
+      },
+      [&](int offset, int len, uint8_t* buf) {
+        if (!g) {
+          g.emplace(this);
+        }
+        wedgeI2CBus_->moduleRead(module, address, offset, len, buf);
+      });
+}
+
 void WedgeI2CBusLock::read(uint8_t address, int offset, int len, uint8_t* buf) {
   BusGuard g(this);
   wedgeI2CBus_->read(address, offset, len, buf);
@@ -24,7 +24,10 @@
 #include <folly/json.h>
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
+#include <algorithm>
 #include <chrono>
+#include <numeric>
+#include <optional>
 
 // allow us to configure the qsfp_service dir so that the qsfp cold boot test
 // can run concurrently with itself
@@ -43,6 +46,19 @@ DEFINE_bool(
     false,
     "Override wedge_agent programInternalPhyPorts(). For test only");
 
+DEFINE_bool(
+    presence_scan_fast_path,
+    true,
+    "Only detect the transceivers whose presence changed since the last scan, "
+    "instead of reading the identifier of every transceiver on each refresh");
+
+DEFINE_int32(
+    presence_scan_full_interval,
+    30,
+    "With the presence scan fast path, still detect all the transceivers "
+    "every this many scans, so that a module swapped between two scans is "
+    "eventually picked up");
+
 namespace {
 
 constexpr int kSecAfterModuleOutOfReset = 2;
@@ -442,7 +458,7 @@ void WedgeManager::syncPorts(
 }
 
 // NOTE: this may refresh transceivers multiple times if they're newly plugged
-//  in, as refresh() is called both via updateTransceiverMap and futureRefresh
+//  in, as refresh() is called both via updateTransceiverMap and below
 std::vector<TransceiverID> WedgeManager::refreshTransceivers() {
   std::vector<TransceiverID> transceiverIds;
   try {
@@ -458,25 +474,109 @@ std::vector<TransceiverID> WedgeManager::refreshTransceivers() {
   // transceiver mapping and type here.
   updateTransceiverMap();
 
+  // Transceivers that have pending state machine updates or down ports are
+  // refreshed first on their controller, so that a link coming up doesn't
+  // wait behind a full pass over healthy modules.
+  const auto tcvrsWithPendingUpdates = getTransceiversWithPendingUpdates();
+
   // Use block to set the scope of the rlock of transceivers_
   {
-    std::vector<folly::Future<folly::Unit>> futs;
     XLOG(INFO) << "Start refreshing all transceivers...";
+    const auto cycleStart = std::chrono::steady_clock::now();
 
     auto lockedTransceivers = transceivers_.rlock();
+    // Transceivers behind the same i2c controller share its EventBase, so
+    // only one of them can have a transaction in flight at a time. Refresh
+    // each controller's transceivers back to back on its own EventBase and
+    // run the different controllers in parallel. Platforms without an i2c
+    // EventBase have a single shared bus, which we refresh inline.
+    std::map<folly::EventBase*, std::vector<Transceiver*>> controllerToTcvrs;
     for (const auto& transceiver : *lockedTransceivers) {
-      XLOG(DBG3) << "Fired to refresh transceiver "
-                 << transceiver.second->getID();
-      transceiverIds.push_back(TransceiverID(transceiver.second->getID()));
-      futs.push_back(transceiver.second->futureRefresh());
+      controllerToTcvrs[transceiver.second->getI2cEventBase()].push_back(
+          transceiver.second.get());
     }
 
-    folly::collectAll(futs.begin(), futs.end()).wait();
+    std::vector<TransceiverID> controllerFirstTcvrs;
+    std::vector<folly::Future<std::chrono::microseconds>> futs;
+    std::optional<size_t> inlineIdx;
+    for (auto& [evb, tcvrs] : controllerToTcvrs) {
+      controllerFirstTcvrs.push_back(tcvrs.front()->getID());
+      std::stable_partition(
+          tcvrs.begin(), tcvrs.end(), [&](Transceiver* tcvr) {
+            return tcvr->hasDownPorts() ||
+                tcvrsWithPendingUpdates.count(tcvr->getID());
+          });
+      for (auto tcvr : tcvrs) {
+        XLOG(DBG3) << "Fired to refresh transceiver " << tcvr->getID();
+        transceiverIds.push_back(tcvr->getID());
+      }
+      if (!evb) {
+        // Refresh the shared bus after firing all the other controllers
+        inlineIdx = futs.size();
+        futs.push_back(folly::makeFuture(std::chrono::microseconds(0)));
+        continue;
+      }
+      futs.push_back(via(evb).thenValue([&tcvrs = tcvrs](auto&&) {
+        return refreshTransceiversInOrder(tcvrs);
+      }));
+    }
+    if (inlineIdx) {
+      futs[*inlineIdx] = folly::makeFuture(
+          refreshTransceiversInOrder(controllerToTcvrs[nullptr]));
+    }
+
+    auto busyTimes = folly::collectAll(futs.begin(), futs.end()).get();
+    publishRefreshStats(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - cycleStart),
+        controllerFirstTcvrs,
+        busyTimes);
     XLOG(INFO) << "Finished refreshing all transceivers";
   }
   return transceiverIds;
 }
 
+std::chrono::microseconds WedgeManager::refreshTransceiversInOrder(
+    const std::vector<Transceiver*>& tcvrs) {
+  const auto start = std::chrono::steady_clock::now();
+  for (auto tcvr : tcvrs) {
+    try {
+      tcvr->refresh();
+    } catch (const std::exception& ex) {
+      XLOG(DBG2) << "Transceiver " << static_cast<int>(tcvr->getID())
+                 << ": Error calling refresh(): " << ex.what();
+    }
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+void WedgeManager::publishRefreshStats(
+    std::chrono::microseconds cycleTime,
+    const std::vector<TransceiverID>& controllerFirstTcvrs,
+    const std::vector<folly::Try<std::chrono::microseconds>>& busyTimes) {
+  tcData().setCounter(
+      "qsfp.refresh.cycle_time_ms",
+      std::chrono::duration_cast<std::chrono::milliseconds>(cycleTime)
+          .count());
+  if (cycleTime.count() == 0) {
+    return;
+  }
+  // Controllers are named after the lowest transceiver id behind them, which
+  // stays stable as long as that transceiver is present.
+  for (size_t i = 0; i < controllerFirstTcvrs.size(); i++) {
+    if (!busyTimes[i].hasValue()) {
+      continue;
+    }
+    tcData().setCounter(
+        folly::to<std::string>(
+            "qsfp.refresh.controller_",
+            static_cast<int>(controllerFirstTcvrs[i]),
+            ".utilization_pct"),
+        busyTimes[i].value().count() * 100 / cycleTime.count());
+  }
+}
+
 int WedgeManager::scanTransceiverPresence(
     std::unique_ptr<std::vector<int32_t>> ids) {
   // If the id list is empty, we default to scan the presence of all the
@@ -530,23 +630,81 @@ std::unique_ptr<TransceiverI2CApi> WedgeManager::getI2CBus() {
   return std::make_unique<WedgeI2CBusLock>(std::make_unique<WedgeI2CBus>());
 }
 
+std::vector<int> WedgeManager::getTransceiversToDetect() {
+  auto numModules = getNumQsfpModules();
+  std::vector<int> allModules(numModules);
+  std::iota(allModules.begin(), allModules.end(), 0);
+
+  auto lockedLastPresence = lastPresence_.wlock();
+  if (!FLAGS_presence_scan_fast_path) {
+    lockedLastPresence->clear();
+    return allModules;
+  }
+  // The full rescan still records the presence, so that the next scan only
+  // detects what changed since
+  bool fullScan =
+      ++presenceScans_ % std::max(FLAGS_presence_scan_full_interval, 1) == 0;
+
+  // One scan reads the presence of a whole group of modules at once on the
+  // platforms which have a presence register, instead of an identifier read
+  // from each module.
+  std::map<int32_t, ModulePresence> presences;
+  for (auto idx : allModules) {
+    presences[idx] = ModulePresence::UNKNOWN;
+  }
+  try {
+    wedgeI2cBus_->scanPresence(presences);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Error calling scanPresence(): " << ex.what();
+    lockedLastPresence->clear();
+    return allModules;
+  }
+
+  if (fullScan) {
+    *lockedLastPresence = std::move(presences);
+    return allModules;
+  }
+
+  std::vector<int> toDetect;
+  auto lockedTransceivers = transceivers_.rlock();
+  for (const auto& [idx, presence] : presences) {
+    auto lastIt = lockedLastPresence->find(idx);
+    bool known = lockedTransceivers->find(TransceiverID(idx)) !=
+        lockedTransceivers->end();
+    if (presence == ModulePresence::UNKNOWN ||
+        lastIt == lockedLastPresence->end() || lastIt->second != presence ||
+        (presence == ModulePresence::PRESENT) != known) {
+      toDetect.push_back(idx);
+    }
+  }
+  *lockedLastPresence = std::move(presences);
+  XLOG(DBG3) << "Presence scan found " << toDetect.size()
+             << " transceivers to detect";
+  return toDetect;
+}
+
+void WedgeManager::forgetTransceiverPresence(int idx) {
+  lastPresence_.wlock()->erase(idx);
+}
+
 void WedgeManager::updateTransceiverMap() {
+  const auto toDetect = getTransceiversToDetect();
   std::vector<folly::Future<TransceiverManagementInterface>> futInterfaces;
   std::vector<std::unique_ptr<WedgeQsfp>> qsfpImpls;
-  for (int idx = 0; idx < getNumQsfpModules(); idx++) {
+  for (auto idx : toDetect) {
     qsfpImpls.push_back(std::make_unique<WedgeQsfp>(idx, wedgeI2cBus_.get()));
     futInterfaces.push_back(
-        qsfpImpls[idx]->futureGetTransceiverManagementInterface());
+        qsfpImpls.back()->futureGetTransceiverManagementInterface());
   }
   folly::collectAllUnsafe(futInterfaces.begin(), futInterfaces.end()).wait();
   // After we have collected all transceivers, get the write lock on
   // transceivers_ before updating it
   auto lockedTransceivers = transceivers_.wlock();
   auto lockedPorts = ports_.rlock();
-  auto numModules = getNumQsfpModules();
-  CHECK_EQ(qsfpImpls.size(), numModules);
-  for (int idx = 0; idx < numModules; idx++) {
-    if (!futInterfaces[idx].isReady()) {
+  CHECK_EQ(qsfpImpls.size(), toDetect.size());
+  for (size_t i = 0; i < toDetect.size(); i++) {
+    int idx = toDetect[i];
+    if (!futInterfaces[i].isReady()) {
       XLOG(ERR) << "failed getting TransceiverManagementInterface at " << idx;
       continue;
     }
@@ -554,7 +712,7 @@ void WedgeManager::updateTransceiverMap() {
     if (it != lockedTransceivers->end()) {
       // In the case where we already have a transceiver recorded, try to check
       // whether they match the transceiver type.
-      if (it->second->managementInterface() == futInterfaces[idx].value()) {
+      if (it->second->managementInterface() == futInterfaces[i].value()) {
         // The management interface matches. Nothing needs to be done.
         continue;
       } else {
@@ -569,32 +727,32 @@ void WedgeManager::updateTransceiverMap() {
     int portsPerTransceiver =
         (portGroupMap_.size() == 0 ? numPortsPerTransceiver()
                                    : portGroupMap_[idx].size());
-    if (futInterfaces[idx].value() == TransceiverManagementInterface::CMIS) {
+    if (futInterfaces[i].value() == TransceiverManagementInterface::CMIS) {
       XLOG(INFO) << "making CMIS QSFP for " << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
           std::make_unique<CmisModule>(
-              this, std::move(qsfpImpls[idx]), portsPerTransceiver));
+              this, std::move(qsfpImpls[i]), portsPerTransceiver));
     } else if (
-        futInterfaces[idx].value() == TransceiverManagementInterface::SFF) {
+        futInterfaces[i].value() == TransceiverManagementInterface::SFF) {
       XLOG(INFO) << "making Sff QSFP for " << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
           std::make_unique<SffModule>(
-              this, std::move(qsfpImpls[idx]), portsPerTransceiver));
+              this, std::move(qsfpImpls[i]), portsPerTransceiver));
     } else if (
-        futInterfaces[idx].value() == TransceiverManagementInterface::SFF8472) {
+        futInterfaces[i].value() == TransceiverManagementInterface::SFF8472) {
       XLOG(INFO) << "making Sff8472 module for " << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
-          std::make_unique<Sff8472Module>(this, std::move(qsfpImpls[idx]), 1));
+          std::make_unique<Sff8472Module>(this, std::move(qsfpImpls[i]), 1));
     } else {
       XLOG(ERR) << "Unknown Transceiver interface: "
-                << static_cast<int>(futInterfaces[idx].value()) << " at idx "
+                << static_cast<int>(futInterfaces[i].value()) << " at idx "
                 << idx;
 
       try {
-        if (!qsfpImpls[idx]->detectTransceiver()) {
+        if (!qsfpImpls[i]->detectTransceiver()) {
           XLOG(DBG3) << "Transceiver is not present at idx " << idx;
           continue;
         }
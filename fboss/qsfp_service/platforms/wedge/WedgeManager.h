@@ -13,6 +13,9 @@
 #include "fboss/qsfp_service/TransceiverManager.h"
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 
+#include <folly/Try.h>
+#include <chrono>
+
 DECLARE_string(qsfp_service_volatile_dir);
 DECLARE_bool(init_pim_xphys);
 DECLARE_bool(override_program_iphy_ports_for_test);
@@ -172,6 +175,16 @@ class WedgeManager : public TransceiverManager {
   virtual std::unique_ptr<TransceiverI2CApi> getI2CBus();
   void updateTransceiverMap();
 
+  // Forget the last scanned presence of a transceiver, so that the next
+  // updateTransceiverMap() detects it again even if it stays present
+  void forgetTransceiverPresence(int idx);
+
+  // The transceivers updateTransceiverMap() needs to detect: all of them
+  // without the presence scan fast path or on a full rescan, otherwise only
+  // those whose presence changed since the last scan or doesn't match
+  // transceivers_
+  std::vector<int> getTransceiversToDetect();
+
   virtual bool shouldInitializePimXphy() const;
 
   // thread safe handle to access bus
@@ -191,6 +204,17 @@ class WedgeManager : public TransceiverManager {
 
   void loadConfig() override;
 
+  // Refresh the transceivers one after another and return the time spent
+  static std::chrono::microseconds refreshTransceiversInOrder(
+      const std::vector<Transceiver*>& tcvrs);
+
+  // Publish the refresh cycle time and how busy each i2c controller was
+  // during the cycle
+  void publishRefreshStats(
+      std::chrono::microseconds cycleTime,
+      const std::vector<TransceiverID>& controllerFirstTcvrs,
+      const std::vector<folly::Try<std::chrono::microseconds>>& busyTimes);
+
   void setOverrideTcvrToPortAndProfileForTest() override;
 
   using LockedTransceiversPtr = folly::Synchronized<
@@ -201,5 +225,8 @@ class WedgeManager : public TransceiverManager {
 
   bool forceColdBoot_{false};
   folly::dynamic qsfpServiceState_;
+
+  folly::Synchronized<std::map<int32_t, ModulePresence>> lastPresence_;
+  uint64_t presenceScans_{0};
 };
 } // namespace facebook::fboss
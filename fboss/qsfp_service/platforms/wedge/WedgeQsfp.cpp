@@ -29,6 +29,9 @@ constexpr uint8_t kCmisModulePartNoReg = 148;
 constexpr uint8_t kSffModulePartNoReg = 168;
 constexpr uint8_t kCommonModuleFwVerReg = 39;
 
+// Intel transceivers require some delay after every write
+constexpr auto kPostWriteDelayUs = 20000;
+
 constexpr auto kNumInterfaceDetectionRetries = 5;
 constexpr auto kInterfaceDetectionRetryMillis = 10;
 } // namespace
@@ -100,7 +103,7 @@ int WedgeQsfp::writeTransceiver(
     // Intel transceiver require some delay for every write.
     // So in the case of writing succeeded, we wait for 20ms.
     // Also this works because we do not write more than 1 byte for now.
-    usleep(20000);
+    usleep(kPostWriteDelayUs);
   } catch (const std::exception& ex) {
     XLOG(ERR) << "Write to transceiver " << module_ << " at offset " << offset
               << " with length " << len
@@ -110,6 +113,32 @@ int WedgeQsfp::writeTransceiver(
   return len;
 }
 
+void WedgeQsfp::readTransceiverTransaction(
+    int dataAddress,
+    const TransceiverReadTransaction& txn) {
+  try {
+    SCOPE_EXIT {
+      wedgeQsfpstats_.updateReadDownTime();
+    };
+    SCOPE_FAIL {
+      StatsPublisher::bumpReadFailure();
+    };
+    SCOPE_SUCCESS {
+      wedgeQsfpstats_.recordReadSuccess();
+    };
+    // Page selects are writes, so keep the same delay as writeTransceiver()
+    threadSafeI2CBus_->moduleReadTransaction(
+        module_ + 1,
+        dataAddress,
+        txn,
+        std::chrono::microseconds(kPostWriteDelayUs));
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Read transaction from transceiver " << module_
+              << " failed: " << ex.what();
+    throw;
+  }
+}
+
 folly::StringPiece WedgeQsfp::getName() {
   return moduleName_;
 }
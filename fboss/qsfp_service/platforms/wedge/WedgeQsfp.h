@@ -85,6 +85,11 @@ class WedgeQsfp : public TransceiverImpl {
       int len,
       uint8_t* fieldValue) override;
 
+  /* Issue the transaction while holding the bus for the whole sequence */
+  void readTransceiverTransaction(
+      int dataAddress,
+      const TransceiverReadTransaction& txn) override;
+
   /* This function detects if a SFP is present on the particular port */
   bool detectTransceiver() override;
 
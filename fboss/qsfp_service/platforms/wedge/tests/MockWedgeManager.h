@@ -44,6 +44,13 @@ class MockWedgeManager : public WedgeManager {
     MockTransceiverI2CApi* mockApi =
         dynamic_cast<MockTransceiverI2CApi*>(wedgeI2cBus_.get());
     mockApi->overrideMgmtInterface(id, mgmt);
+    // A module with another interface is a new module, which the presence
+    // scan wouldn't notice without going through an absent scan
+    forgetTransceiverPresence(id - 1);
+  }
+
+  std::vector<int> transceiversToDetect() {
+    return getTransceiversToDetect();
   }
 
   std::map<TransceiverID, TransceiverManagementInterface> mgmtInterfaces() {
@@ -68,6 +75,12 @@ class MockWedgeManager : public WedgeManager {
     return numPortsPerModule_;
   }
 
+  void overrideProgrammedIphyPortsForTest(
+      TransceiverID id,
+      std::unordered_map<PortID, cfg::PortProfileID> portToProfile) {
+    overrideTcvrToPortAndProfileForTest_[id] = std::move(portToProfile);
+  }
+
   void setReadException(
       bool throwReadExceptionForMgmtInterface,
       bool throwReadExceptionForDomQuery) {
@@ -12,10 +12,15 @@
 
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+#include "fboss/qsfp_service/module/sff/SffModule.h"
 #include "fboss/qsfp_service/module/tests/MockTransceiverImpl.h"
 #include "fboss/qsfp_service/test/FakeConfigsHelper.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
 #include <folly/Memory.h>
+#include <folly/Synchronized.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -23,10 +28,50 @@
 #include <common/files/FileUtil.h>
 #include <folly/experimental/TestUtil.h>
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <set>
+
+DECLARE_bool(presence_scan_fast_path);
+DECLARE_int32(presence_scan_full_interval);
+
 using namespace facebook::fboss;
 using namespace ::testing;
 namespace {
 
+// An SFF module behind the i2c controller running the given EventBase, which
+// reports its refreshes instead of reading the module
+class ControllerSffModule : public SffModule {
+ public:
+  ControllerSffModule(
+      TransceiverManager* transceiverManager,
+      std::unique_ptr<TransceiverImpl> qsfpImpl,
+      folly::EventBase* i2cEvb,
+      bool hasDownPorts,
+      std::function<void(Transceiver*)> onRefresh)
+      : SffModule(transceiverManager, std::move(qsfpImpl), 4),
+        i2cEvb_(i2cEvb),
+        hasDownPorts_(hasDownPorts),
+        onRefresh_(std::move(onRefresh)) {}
+
+  folly::EventBase* getI2cEventBase() override {
+    return i2cEvb_;
+  }
+  bool hasDownPorts() const override {
+    return hasDownPorts_;
+  }
+  void refresh() override {
+    onRefresh_(this);
+  }
+
+ private:
+  folly::EventBase* i2cEvb_;
+  bool hasDownPorts_;
+  std::function<void(Transceiver*)> onRefresh_;
+};
+
 class WedgeManagerTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -226,6 +271,42 @@ TEST_F(WedgeManagerTest, moduleNotPresentTest) {
   }
 }
 
+TEST_F(WedgeManagerTest, presenceScanFastPath) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_presence_scan_fast_path = true;
+  FLAGS_presence_scan_full_interval = 6;
+  std::vector<int> allModules(16);
+  std::iota(allModules.begin(), allModules.end(), 0);
+
+  // Record the presence of all modules, then start right after a full rescan
+  wedgeManager_->transceiversToDetect();
+  std::vector<int> toDetect;
+  for (int scan = 0; scan < 6 && toDetect != allModules; scan++) {
+    toDetect = wedgeManager_->transceiversToDetect();
+  }
+  ASSERT_EQ(toDetect, allModules);
+
+  // No change
+  EXPECT_TRUE(wedgeManager_->transceiversToDetect().empty());
+
+  // Removal, id is 1 based in overridePresence()
+  wedgeManager_->overridePresence(3, false);
+  EXPECT_EQ(wedgeManager_->transceiversToDetect(), std::vector<int>{2});
+  // The removed module is still known, so the refresh detects it again and
+  // drops it
+  wedgeManager_->refreshTransceivers();
+  EXPECT_EQ(wedgeManager_->mgmtInterfaces().size(), 15);
+  EXPECT_TRUE(wedgeManager_->transceiversToDetect().empty());
+
+  // Insertion
+  wedgeManager_->overridePresence(3, true);
+  EXPECT_EQ(wedgeManager_->transceiversToDetect(), std::vector<int>{2});
+
+  // Every presence_scan_full_interval scans all the modules are detected
+  EXPECT_EQ(wedgeManager_->transceiversToDetect(), allModules);
+  EXPECT_TRUE(wedgeManager_->transceiversToDetect().empty());
+}
+
 TEST_F(WedgeManagerTest, mgmtInterfaceChangedTest) {
   // Simulate the case where a SFF module is swapped with a CMIS module
   wedgeManager_->overridePresence(1, false);
@@ -300,6 +381,112 @@ TEST_F(WedgeManagerTest, syncPorts) {
   }
 }
 
+TEST_F(WedgeManagerTest, refreshTransceiversWithDownPortsFirst) {
+  // Transceivers with down ports should be refreshed ahead of the others
+  // on the same bus, and every transceiver should still be refreshed once
+  std::map<int32_t, TransceiverInfo> info;
+  std::map<int32_t, PortStatus> portMap = {};
+  std::map<int32_t, bool> transceiverToPortUp = {
+      {1, true}, {3, false}, {7, false}};
+  for (const auto& [tcvrID, up] : transceiverToPortUp) {
+    PortStatus portStatus;
+    TransceiverIdxThrift idx;
+    idx.transceiverId_ref() = tcvrID;
+    portStatus.transceiverIdx_ref() = idx;
+    portStatus.enabled_ref() = true;
+    portStatus.up_ref() = up;
+    portMap[tcvrID * 4 + 1] = portStatus;
+  }
+  wedgeManager_->syncPorts(
+      info, std::make_unique<std::map<int32_t, PortStatus>>(portMap));
+
+  auto refreshedIds = wedgeManager_->refreshTransceivers();
+  ASSERT_EQ(refreshedIds.size(), 16);
+  EXPECT_EQ(refreshedIds[0], TransceiverID(3));
+  EXPECT_EQ(refreshedIds[1], TransceiverID(7));
+  std::set<TransceiverID> uniqueIds(refreshedIds.begin(), refreshedIds.end());
+  EXPECT_EQ(uniqueIds.size(), 16);
+}
+
+TEST_F(WedgeManagerTest, refreshTransceiversPerController) {
+  // Put the transceivers behind two i2c controllers, alternating between
+  // them, and give every other transceiver of a controller down ports
+  constexpr int kNumControllers = 2;
+  std::array<folly::ScopedEventBaseThread, kNumControllers> controllers;
+  folly::Synchronized<std::map<folly::EventBase*, std::vector<TransceiverID>>>
+      refreshOrder;
+  std::atomic<int> controllersStarted{0};
+  std::atomic<bool> refreshedInParallel{true};
+  auto onRefresh = [&](Transceiver* tcvr) {
+    auto evb = tcvr->getI2cEventBase();
+    EXPECT_TRUE(evb->isInEventBaseThread());
+    bool firstOnController;
+    {
+      auto lockedRefreshOrder = refreshOrder.wlock();
+      firstOnController = (*lockedRefreshOrder)[evb].empty();
+      (*lockedRefreshOrder)[evb].push_back(tcvr->getID());
+    }
+    if (!firstOnController) {
+      return;
+    }
+    // Hold the controller until all the others are refreshing too, which
+    // only happens if the controllers are refreshed in parallel
+    ++controllersStarted;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (controllersStarted < kNumControllers &&
+           std::chrono::steady_clock::now() < deadline) {
+      /* sleep override */
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (controllersStarted < kNumControllers) {
+      refreshedInParallel = false;
+    }
+  };
+
+  std::map<folly::EventBase*, std::vector<TransceiverID>> expectedOrder;
+  {
+    std::map<folly::EventBase*, std::vector<TransceiverID>> upTcvrs;
+    auto lockedTransceivers =
+        wedgeManager_->getSynchronizedTransceivers().wlock();
+    ASSERT_EQ(lockedTransceivers->size(), 16);
+    for (auto& [id, tcvr] : *lockedTransceivers) {
+      int idx = static_cast<int>(id);
+      auto evb = controllers[idx % kNumControllers].getEventBase();
+      bool hasDownPorts = (idx / kNumControllers) % 2;
+      auto qsfpImpl = std::make_unique<NiceMock<MockTransceiverImpl>>();
+      ON_CALL(*qsfpImpl, getNum()).WillByDefault(Return(idx));
+      tcvr = std::make_unique<ControllerSffModule>(
+          wedgeManager_.get(),
+          std::move(qsfpImpl),
+          evb,
+          hasDownPorts,
+          onRefresh);
+      (hasDownPorts ? expectedOrder : upTcvrs)[evb].push_back(id);
+    }
+    for (auto& [evb, ids] : upTcvrs) {
+      auto& order = expectedOrder[evb];
+      order.insert(order.end(), ids.begin(), ids.end());
+    }
+  }
+
+  auto refreshedIds = wedgeManager_->refreshTransceivers();
+  EXPECT_EQ(refreshedIds.size(), 16);
+  EXPECT_TRUE(refreshedInParallel);
+  // Each controller refreshes its transceivers with down ports first
+  EXPECT_EQ(*refreshOrder.rlock(), expectedOrder);
+  // Controllers are named after the lowest transceiver behind them
+  for (auto controller : {"controller_0", "controller_1"}) {
+    auto counter = folly::to<std::string>(
+        "qsfp.refresh.", controller, ".utilization_pct");
+    ASSERT_TRUE(fb303::fbData->hasCounter(counter));
+    EXPECT_GT(fb303::fbData->getCounter(counter), 0);
+    EXPECT_LE(fb303::fbData->getCounter(counter), 100);
+  }
+
+  // The transceivers must not outlive the controllers they refer to
+  wedgeManager_->getSynchronizedTransceivers().wlock()->clear();
+}
+
 TEST_F(WedgeManagerTest, coldBootTest) {
   auto qsfpSvcDir = folly::test::TemporaryDirectory();
   FLAGS_qsfp_service_volatile_dir = qsfpSvcDir.path().string();
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverHistoryStore.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <iostream>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+namespace {
+constexpr int kNumModules = 128;
+constexpr int kNumLanes = 8;
+
+// The default tiers of qsfp_service: 5s for 10 minutes, 5 min for 24 hours
+const std::vector<TransceiverHistoryStore::Tier> kTiers = {
+    {seconds(5), 120},
+    {seconds(300), 288}};
+
+TransceiverInfo makeInfo(int module) {
+  TransceiverInfo info;
+  info.present_ref() = true;
+  GlobalSensors sensor;
+  sensor.temp_ref()->value_ref() = 40.0 + module % 10;
+  sensor.vcc_ref()->value_ref() = 3.3;
+  info.sensor_ref() = sensor;
+  VdmDiagsStats vdm;
+  vdm.preFecBerMediaCur_ref() = 1e-6;
+  vdm.preFecBerHostCur_ref() = 1e-8;
+  for (int lane = 0; lane < kNumLanes; lane++) {
+    Channel channel;
+    channel.channel_ref() = lane;
+    channel.sensors_ref()->rxPwr_ref()->value_ref() = 1.0 + lane * 0.01;
+    channel.sensors_ref()->txPwr_ref()->value_ref() = 1.0;
+    channel.sensors_ref()->txBias_ref()->value_ref() = 40.0;
+    info.channels_ref()->push_back(channel);
+    (*vdm.eSnrMediaChannel_ref())[lane] = 20.0;
+  }
+  info.vdmDiagsStats_ref() = vdm;
+  info.vdmTimeCollected_ref() = 0;
+  return info;
+}
+
+std::vector<TransceiverInfo> makeInfos() {
+  std::vector<TransceiverInfo> infos;
+  for (int module = 0; module < kNumModules; module++) {
+    infos.push_back(makeInfo(module));
+  }
+  return infos;
+}
+} // namespace
+
+/*
+ * One iteration is a refresh of all modules, i.e. kNumModules inserts
+ */
+BENCHMARK(TransceiverHistoryInsert, n) {
+  std::unique_ptr<TransceiverHistoryStore> store;
+  std::vector<TransceiverInfo> infos;
+  BENCHMARK_SUSPEND {
+    store = std::make_unique<TransceiverHistoryStore>(kTiers);
+    infos = makeInfos();
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    for (int module = 0; module < kNumModules; module++) {
+      auto& info = infos[module];
+      info.timeCollected_ref() = 1000000 + i * 5;
+      // Worst case, a VDM capture on every refresh
+      info.vdmTimeCollected_ref() = *info.timeCollected_ref();
+      store->addSample(module, info);
+    }
+  }
+
+  BENCHMARK_SUSPEND {
+    store.reset();
+  }
+}
+
+/*
+ * Query the fine tier and the coarse tier of one module
+ */
+BENCHMARK(TransceiverHistoryQuery, n) {
+  std::unique_ptr<TransceiverHistoryStore> store;
+  BENCHMARK_SUSPEND {
+    store = std::make_unique<TransceiverHistoryStore>(kTiers);
+    auto info = makeInfo(0);
+    for (int time = 0; time < 86400; time += 5) {
+      info.timeCollected_ref() = time;
+      info.vdmTimeCollected_ref() = time - time % 300;
+      store->addSample(0, info);
+    }
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    folly::doNotOptimizeAway(store->getHistory(0, 86400 - 600, 86400));
+    folly::doNotOptimizeAway(store->getHistory(0, 0, 86400));
+  }
+
+  BENCHMARK_SUSPEND {
+    store.reset();
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+
+  TransceiverHistoryStore store(kTiers);
+  auto infos = makeInfos();
+  for (int module = 0; module < kNumModules; module++) {
+    infos[module].timeCollected_ref() = 1000000;
+    store.addSample(module, infos[module]);
+  }
+  std::cout << "Memory for " << kNumModules << " modules x " << kNumLanes
+            << " lanes: " << store.getMemoryUsage() / 1024 << " KB"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverHistoryStore.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace std::chrono;
+
+namespace facebook::fboss {
+
+namespace {
+TransceiverInfo makeInfo(int64_t time, double temp, double rxPwr) {
+  TransceiverInfo info;
+  info.present_ref() = true;
+  info.timeCollected_ref() = time;
+  GlobalSensors sensor;
+  sensor.temp_ref()->value_ref() = temp;
+  sensor.vcc_ref()->value_ref() = 3.3;
+  info.sensor_ref() = sensor;
+  for (int lane = 0; lane < 4; lane++) {
+    Channel channel;
+    channel.channel_ref() = lane;
+    channel.sensors_ref()->rxPwr_ref()->value_ref() = rxPwr;
+    channel.sensors_ref()->txPwr_ref()->value_ref() = 1.0;
+    channel.sensors_ref()->txBias_ref()->value_ref() = 40.0;
+    info.channels_ref()->push_back(channel);
+  }
+  return info;
+}
+
+const MonitorHistory& getMonitor(
+    const TransceiverMonitorHistory& history,
+    const std::string& name,
+    std::optional<int32_t> lane) {
+  for (const auto& monitor : *history.monitors_ref()) {
+    auto monitorLane = monitor.lane_ref().has_value()
+        ? std::optional<int32_t>(*monitor.lane_ref())
+        : std::nullopt;
+    if (*monitor.name_ref() == name && monitorLane == lane) {
+      return monitor;
+    }
+  }
+  throw std::runtime_error("No monitor " + name);
+}
+} // namespace
+
+TEST(TransceiverHistoryStoreTest, tiers) {
+  // 10s buckets for 1 minute, 60s buckets for 10 minutes
+  TransceiverHistoryStore store({{seconds(10), 6}, {seconds(60), 10}});
+  for (int64_t time = 1000; time < 1600; time += 5) {
+    store.addSample(0, makeInfo(time, time / 10, 1.0));
+  }
+
+  // The last minute comes from the fine buckets
+  auto history = store.getHistory(0, 1550, 1600);
+  EXPECT_EQ(*history.transceiver_ref(), 0);
+  EXPECT_EQ(*history.interval_ref(), 10);
+  EXPECT_EQ(
+      *history.bucketTimes_ref(),
+      (std::vector<int64_t>{1550, 1560, 1570, 1580, 1590}));
+  // 2 global monitors and 3 for each of the 4 lanes
+  EXPECT_EQ(history.monitors_ref()->size(), 14);
+  const auto& temp = getMonitor(history, "temp", std::nullopt);
+  EXPECT_EQ(temp.min_ref()->front(), 155);
+  EXPECT_EQ(temp.max_ref()->front(), 155);
+  EXPECT_FLOAT_EQ(temp.avg_ref()->front(), 155);
+
+  // Going further back needs the coarse buckets
+  history = store.getHistory(0, 1000, 1600);
+  EXPECT_EQ(*history.interval_ref(), 60);
+  EXPECT_EQ(history.bucketTimes_ref()->size(), 10);
+  EXPECT_EQ(history.bucketTimes_ref()->front(), 1020);
+  const auto& coarseTemp = getMonitor(history, "temp", std::nullopt);
+  // Samples from 1560 to 1595
+  EXPECT_EQ(history.bucketTimes_ref()->back(), 1560);
+  EXPECT_EQ(coarseTemp.min_ref()->back(), 156);
+  EXPECT_EQ(coarseTemp.max_ref()->back(), 159);
+  EXPECT_FLOAT_EQ(coarseTemp.avg_ref()->back(), 157.5);
+}
+
+TEST(TransceiverHistoryStoreTest, ignoreStaleSamples) {
+  TransceiverHistoryStore store({{seconds(10), 6}});
+  store.addSample(1, makeInfo(100, 40, 1.0));
+  // Same refresh seen again, and an absent transceiver
+  store.addSample(1, makeInfo(100, 50, 1.0));
+  TransceiverInfo absent;
+  absent.present_ref() = false;
+  store.addSample(1, absent);
+  store.addSample(2, absent);
+
+  auto history = store.getHistory(1, 0, 200);
+  ASSERT_EQ(history.bucketTimes_ref()->size(), 1);
+  const auto& rxPwr = getMonitor(history, "rxPwr", 3);
+  EXPECT_EQ(rxPwr.max_ref()->front(), 1.0);
+  EXPECT_EQ(getMonitor(history, "temp", std::nullopt).max_ref()->front(), 40);
+  EXPECT_TRUE(store.getHistory(2, 0, 200).monitors_ref()->empty());
+}
+
+TEST(TransceiverHistoryStoreTest, laneMonitorsReadLessOften) {
+  TransceiverHistoryStore store({{seconds(10), 6}});
+  // The module is refreshed every 5s, but its lanes only every 20s
+  for (int64_t time = 100; time < 140; time += 5) {
+    auto laneTime = time - time % 20;
+    auto info = makeInfo(time, time, laneTime);
+    info.channelsTimeCollected_ref() = laneTime;
+    store.addSample(0, info);
+  }
+
+  auto history = store.getHistory(0, 100, 140);
+  EXPECT_EQ(
+      *history.bucketTimes_ref(), (std::vector<int64_t>{100, 110, 120, 130}));
+  const auto& temp = getMonitor(history, "temp", std::nullopt);
+  EXPECT_EQ(*temp.min_ref(), (std::vector<float>{100, 110, 120, 130}));
+  EXPECT_EQ(*temp.max_ref(), (std::vector<float>{105, 115, 125, 135}));
+
+  // The cached lane values aren't sampled again
+  const auto& rxPwr = getMonitor(history, "rxPwr", 0);
+  EXPECT_EQ((*rxPwr.avg_ref())[0], 100);
+  EXPECT_TRUE(std::isnan((*rxPwr.avg_ref())[1]));
+  EXPECT_EQ((*rxPwr.avg_ref())[2], 120);
+  EXPECT_TRUE(std::isnan((*rxPwr.min_ref())[3]));
+}
+
+TEST(TransceiverHistoryStoreTest, vdmMonitorsOnlySampledOnCapture) {
+  TransceiverHistoryStore store({{seconds(10), 6}});
+  // VDM is captured at 110 and 125, the stats are stale in between
+  for (int64_t time = 100; time < 140; time += 5) {
+    auto info = makeInfo(time, time, 1.0);
+    int64_t vdmTime = time < 110 ? 0 : (time < 125 ? 110 : 125);
+    info.vdmTimeCollected_ref() = vdmTime;
+    if (vdmTime) {
+      VdmDiagsStats vdm;
+      vdm.preFecBerMediaCur_ref() = vdmTime;
+      vdm.preFecBerHostCur_ref() = 1e-8;
+      for (int lane = 0; lane < 4; lane++) {
+        (*vdm.eSnrMediaChannel_ref())[lane] = vdmTime / 10;
+      }
+      info.vdmDiagsStats_ref() = vdm;
+    }
+    store.addSample(0, info);
+  }
+
+  // The first capture doesn't drop the history
+  auto history = store.getHistory(0, 100, 140);
+  EXPECT_EQ(
+      *history.bucketTimes_ref(), (std::vector<int64_t>{100, 110, 120, 130}));
+  // 14 DOM monitors, 2 VDM BER monitors and the eSNR of the 4 lanes
+  EXPECT_EQ(history.monitors_ref()->size(), 20);
+
+  const auto& ber = getMonitor(history, "preFecBerMedia", std::nullopt);
+  EXPECT_TRUE(std::isnan((*ber.avg_ref())[0]));
+  EXPECT_EQ((*ber.avg_ref())[1], 110);
+  EXPECT_EQ((*ber.min_ref())[2], 125);
+  EXPECT_EQ((*ber.max_ref())[2], 125);
+  EXPECT_TRUE(std::isnan((*ber.avg_ref())[3]));
+  const auto& eSnr = getMonitor(history, "eSnrMedia", 2);
+  EXPECT_TRUE(std::isnan((*eSnr.max_ref())[0]));
+  EXPECT_EQ((*eSnr.max_ref())[1], 11);
+  EXPECT_EQ((*eSnr.avg_ref())[2], 12);
+}
+
+TEST(TransceiverHistoryStoreTest, moduleChange) {
+  TransceiverHistoryStore store({{seconds(10), 6}});
+  store.addSample(0, makeInfo(100, 40, 1.0));
+  auto memory = store.getMemoryUsage();
+
+  // A module with other monitors starts a new history
+  auto info = makeInfo(110, 40, 1.0);
+  info.channels_ref()->resize(1);
+  store.addSample(0, info);
+  auto history = store.getHistory(0, 0, 200);
+  EXPECT_EQ(*history.bucketTimes_ref(), std::vector<int64_t>{110});
+  EXPECT_EQ(history.monitors_ref()->size(), 5);
+  EXPECT_LT(store.getMemoryUsage(), memory);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverInfoPublisher.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+DECLARE_double(tcvr_info_push_temp_delta);
+DECLARE_double(tcvr_info_push_power_delta_db);
+
+namespace facebook::fboss {
+
+namespace {
+TransceiverInfo makeInfo(int32_t id, bool present) {
+  TransceiverInfo info;
+  info.present_ref() = present;
+  info.port_ref() = id;
+  if (!present) {
+    return info;
+  }
+  GlobalSensors sensor;
+  sensor.temp_ref()->value_ref() = 40.0;
+  sensor.vcc_ref()->value_ref() = 3.3;
+  info.sensor_ref() = sensor;
+  for (int lane = 0; lane < 4; lane++) {
+    Channel channel;
+    channel.channel_ref() = lane;
+    channel.sensors_ref()->rxPwr_ref()->value_ref() = 1.0;
+    channel.sensors_ref()->txPwr_ref()->value_ref() = 1.0;
+    channel.sensors_ref()->txBias_ref()->value_ref() = 40.0;
+    info.channels_ref()->push_back(channel);
+  }
+  info.timeCollected_ref() = 100;
+  return info;
+}
+} // namespace
+
+TEST(TransceiverInfoPublisherTest, monitorThresholds) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_tcvr_info_push_temp_delta = 1.0;
+  FLAGS_tcvr_info_push_power_delta_db = 0.5;
+
+  auto oldInfo = makeInfo(0, true);
+  auto newInfo = oldInfo;
+  newInfo.timeCollected_ref() = 200;
+  newInfo.sensor_ref()->temp_ref()->value_ref() = 40.5;
+  // 1.0mW -> 1.1mW is ~0.41dB
+  (*newInfo.channels_ref())[2].sensors_ref()->rxPwr_ref()->value_ref() = 1.1;
+  EXPECT_FALSE(TransceiverInfoPublisher::hasChanged(oldInfo, newInfo));
+
+  auto hotter = newInfo;
+  hotter.sensor_ref()->temp_ref()->value_ref() = 41.5;
+  EXPECT_TRUE(TransceiverInfoPublisher::hasChanged(oldInfo, hotter));
+
+  // 1.0mW -> 1.2mW is ~0.79dB
+  auto brighter = newInfo;
+  (*brighter.channels_ref())[2].sensors_ref()->rxPwr_ref()->value_ref() = 1.2;
+  EXPECT_TRUE(TransceiverInfoPublisher::hasChanged(oldInfo, brighter));
+
+  auto flagged = newInfo;
+  FlagLevels flags;
+  flags.alarm_ref()->high_ref() = true;
+  auto& txBias = *(*flagged.channels_ref())[0].sensors_ref()->txBias_ref();
+  txBias.flags_ref() = flags;
+  EXPECT_TRUE(TransceiverInfoPublisher::hasChanged(oldInfo, flagged));
+}
+
+TEST(TransceiverInfoPublisherTest, stateChanges) {
+  auto oldInfo = makeInfo(0, true);
+
+  EXPECT_TRUE(
+      TransceiverInfoPublisher::hasChanged(oldInfo, makeInfo(0, false)));
+
+  auto newState = oldInfo;
+  newState.stateMachineState_ref() = TransceiverStateMachineState::ACTIVE;
+  EXPECT_TRUE(TransceiverInfoPublisher::hasChanged(oldInfo, newState));
+
+  auto remediated = oldInfo;
+  remediated.remediationCounter_ref() = 1;
+  EXPECT_TRUE(TransceiverInfoPublisher::hasChanged(oldInfo, remediated));
+}
+
+TEST(TransceiverInfoPublisherTest, publishOnlyChanges) {
+  TransceiverInfoPublisher publisher;
+  auto stream = publisher.subscribe();
+  TransceiverInfoPublisher::TcvrInfoMap infos;
+  for (int i = 0; i < 4; i++) {
+    infos[i] = makeInfo(i, i % 2 == 0);
+  }
+
+  publisher.publish(infos);
+  EXPECT_EQ(publisher.getGeneration(), 1);
+
+  // Nothing changed beyond the thresholds
+  for (auto& [id, info] : infos) {
+    info.timeCollected_ref() = 200;
+  }
+  publisher.publish(infos);
+  EXPECT_EQ(publisher.getGeneration(), 1);
+
+  infos[1] = makeInfo(1, true);
+  publisher.publish(infos);
+  EXPECT_EQ(publisher.getGeneration(), 2);
+}
+
+TEST(TransceiverInfoPublisherTest, noSubscribers) {
+  TransceiverInfoPublisher publisher;
+  TransceiverInfoPublisher::TcvrInfoMap infos;
+  infos[0] = makeInfo(0, true);
+
+  // Nothing is published without subscribers
+  publisher.publish(infos);
+  publisher.skipPublish();
+  EXPECT_EQ(publisher.getGeneration(), 0);
+
+  // The new subscriber gets a full sync at the next publish, even if nothing
+  // changed
+  auto stream = publisher.subscribe();
+  EXPECT_EQ(publisher.numSubscribers(), 1);
+  publisher.publish(infos);
+  EXPECT_EQ(publisher.getGeneration(), 1);
+  publisher.publish(infos);
+  EXPECT_EQ(publisher.getGeneration(), 1);
+}
+
+} // namespace facebook::fboss
@@ -5,8 +5,11 @@
 #include "fboss/qsfp_service/platforms/wedge/tests/MockWedgeManager.h"
 
 #include <folly/Singleton.h>
+#include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 using namespace facebook::fboss;
 
 namespace facebook {
@@ -30,5 +33,63 @@ TEST_F(TransceiverManagerTest, getPortNameToModuleMap) {
       std::out_of_range);
 }
 
+class TransceiverStateMachineUpdateTest : public TransceiverManagerTest {
+ public:
+  void SetUp() override {
+    // The state machines are only created with the new state machine logic
+    FLAGS_use_new_state_machine = true;
+    TransceiverManagerTest::SetUp();
+    // Program no iphy ports so that the state machines can go through all
+    // the programming events without a running wedge_agent
+    auto mockWedgeManager =
+        static_cast<MockWedgeManager*>(transceiverManager_.get());
+    for (int i = 0; i < numModules; i++) {
+      mockWedgeManager->overrideProgrammedIphyPortsForTest(
+          TransceiverID(i), {});
+    }
+  }
+
+ private:
+  gflags::FlagSaver flagSaver_;
+};
+
+TEST_F(TransceiverStateMachineUpdateTest, updatesKeepPerTransceiverOrder) {
+  const std::vector<TransceiverStateMachineEvent> programmingEvents = {
+      TransceiverStateMachineEvent::DETECT_TRANSCEIVER,
+      TransceiverStateMachineEvent::READ_EEPROM,
+      TransceiverStateMachineEvent::PROGRAM_IPHY,
+      TransceiverStateMachineEvent::PROGRAM_XPHY,
+      TransceiverStateMachineEvent::PROGRAM_TRANSCEIVER,
+  };
+
+  // Queue all the events of every transceiver before waiting for any of
+  // them, like a cold start. A transceiver only reaches
+  // TRANSCEIVER_PROGRAMMED if its events are applied in order.
+  auto startTime = std::chrono::steady_clock::now();
+  std::vector<std::shared_ptr<BlockingTransceiverStateMachineUpdateResult>>
+      results;
+  for (auto event : programmingEvents) {
+    for (int i = 0; i < numModules; i++) {
+      auto result = transceiverManager_->updateStateBlockingWithoutWait(
+          TransceiverID(i), event);
+      ASSERT_NE(result, nullptr);
+      results.push_back(std::move(result));
+    }
+  }
+  for (const auto& result : results) {
+    result->wait();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - startTime);
+  XLOG(INFO) << "Programmed " << numModules << " transceivers in "
+             << elapsed.count() << "us";
+
+  for (int i = 0; i < numModules; i++) {
+    EXPECT_EQ(
+        transceiverManager_->getCurrentState(TransceiverID(i)),
+        TransceiverStateMachineState::TRANSCEIVER_PROGRAMMED);
+  }
+}
+
 } // namespace fboss
 } // namespace facebook
@@ -1,6 +1,7 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 #include "fboss/util/wedge_qsfp_util.h"
 
+#include "fboss/lib/i2c/FirmwareUpgradeOrchestrator.h"
 #include "fboss/lib/usb/GalaxyI2CBus.h"
 #include "fboss/lib/usb/Wedge100I2CBus.h"
 #include "fboss/lib/usb/WedgeI2CBus.h"
@@ -314,12 +315,6 @@ std::vector<unsigned int> getUpgradeModList(
     std::string moduleType,
     std::string fwVer);
 
-void fwUpgradeThreadHandler(
-    TransceiverI2CApi* bus,
-    std::vector<unsigned int> modlist,
-    std::string firmwareFilename,
-    uint32_t imageHdrLen);
-
 std::ostream& operator<<(std::ostream& os, const FlagCommand& cmd) {
   gflags::CommandLineFlagInfo flagInfo;
 
@@ -2396,19 +2391,16 @@ bool cliModulefirmwareUpgrade(
  * This is multi-threaded version of the module upgrade trigger function.
  * This multi-threaded overloaded function gets the list of optics on which
  * the upgrade needs to be performed. It calls the function bucketize to create
- * separate buckets of optics for upgrade. Then the threads are created for
- * each bucket and each thread takes care of upgrading the optics in that
- * bucket. The idea here is that one thread will take care of upgrading the
- * optics belonging to one controller so that two ports of the same controller
- * can't upgrade at the same time whereas multiple ports belonging to different
- * controller can upgrade at the same time. This function waits for all
- * threads to finish.
+ * separate buckets of optics for upgrade, one per controller. The buckets are
+ * handed to CmisFirmwareUpgradeOrchestrator which upgrades the optics of
+ * different controllers in parallel, and interleaves the CDB commands of the
+ * optics belonging to the same controller. This function waits for all
+ * upgrades to finish.
  */
 bool cliModulefirmwareUpgrade(
     TransceiverI2CApi* bus,
     std::string portRangeStr,
     std::string firmwareFilename) {
-  std::vector<std::thread> threadList;
   std::vector<std::vector<unsigned int>> bucket;
 
   // Check if the filename is specified
@@ -2431,7 +2423,7 @@ bool cliModulefirmwareUpgrade(
   bucketize(finalModlist, modsPerController, bucket);
 
   printf("The modules will be upgraded in these %ld buckets\n", bucket.size());
-  printf("Each bucket will be assigned a separate thread\n");
+  printf("Each bucket will be upgraded in parallel\n");
 
   for (auto& bucketrow : bucket) {
     printf("Bucket: ");
@@ -2474,77 +2466,65 @@ bool cliModulefirmwareUpgrade(
     }
   }
 
-  // Create threads one for each bucket row and do the upgrade there
-  for (auto& bucketrow : bucket) {
-    std::thread tHandler(
-        fwUpgradeThreadHandler, bus, bucketrow, firmwareFilename, imageHdrLen);
-    threadList.push_back(std::move(tHandler));
-  }
+  CmisFirmwareUpgradeOrchestrator orchestrator;
+  for (int controller = 0; controller < bucket.size(); controller++) {
+    for (auto module : bucket[controller]) {
+      // Create FbossFirmware object using firmware filename and msa password,
+      // header length as properties
+      FbossFirmware::FwAttributes firmwareAttr;
+      firmwareAttr.filename = firmwareFilename;
+      firmwareAttr.properties["msa_password"] =
+          folly::to<std::string>(FLAGS_msa_password);
+      firmwareAttr.properties["header_length"] =
+          folly::to<std::string>(imageHdrLen);
+      firmwareAttr.properties["image_type"] =
+          FLAGS_dsp_image ? "dsp" : "application";
+      auto fbossFwObj = std::make_unique<FbossFirmware>(firmwareAttr);
 
-  // Wait for all threads to finish
-  for (auto& tHandler : threadList) {
-    tHandler.join();
+      orchestrator.addModule(
+          controller,
+          std::make_unique<CmisFirmwareUpgrader>(
+              bus, module, std::move(fbossFwObj)));
+    }
   }
 
-  printf("Firmware upgrade done on some of the modules");
-  printf(
-      "Check the status using: wedge_qsfp_util --get_module_fw_info <portA> <portB>\n");
-  printf("Pl reload the chassis to finish the firmware upgrade last step\n");
-  return true;
-}
-
-/*
- * fwUpgradeThreadHandler
- *
- * This is Entry function for the thread which will do the firmware upgrade
- * operation. This function gets the list of optics as an argument. It will do
- * fw upgrade on all these modules one by one in this thread context.
- */
-void fwUpgradeThreadHandler(
-    TransceiverI2CApi* bus,
-    std::vector<unsigned int> modlist,
-    std::string firmwareFilename,
-    uint32_t imageHdrLen) {
-  std::array<uint8_t, 2> versionNumber;
-
-  for (auto module : modlist) {
-    // Create FbossFirmware object using firmware filename and msa password,
-    // header length as properties
-    FbossFirmware::FwAttributes firmwareAttr;
-    firmwareAttr.filename = firmwareFilename;
-    firmwareAttr.properties["msa_password"] =
-        folly::to<std::string>(FLAGS_msa_password);
-    firmwareAttr.properties["header_length"] =
-        folly::to<std::string>(imageHdrLen);
-    firmwareAttr.properties["image_type"] =
-        FLAGS_dsp_image ? "dsp" : "application";
-    auto fbossFwObj = std::make_unique<FbossFirmware>(firmwareAttr);
-
-    auto fwUpgradeObj = std::make_unique<CmisFirmwareUpgrader>(
-        bus, module, std::move(fbossFwObj));
-
-    // Do the upgrade in this thread
-    bool ret = fwUpgradeObj->cmisModuleFirmwareUpgrade();
-
-    if (ret) {
+  auto results = orchestrator.run();
+  for (const auto& progress : orchestrator.getProgress()) {
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         progress.elapsed)
+                         .count();
+    if (results[progress.moduleId]) {
       printf(
-          "Firmware download successful for module %d, the module is running desired firmware\n",
-          module);
+          "Firmware download successful for module %d in %lds, the module is running desired firmware\n",
+          progress.moduleId,
+          elapsedMs / 1000);
     } else {
       printf(
-          "Firmware upgrade failed for module %d, you may retry the same command\n",
-          module);
+          "Firmware upgrade failed for module %d in stage %s, you may retry the same command\n",
+          progress.moduleId,
+          CmisFirmwareUpgrader::getStageName(progress.stage));
     }
 
     // Find out the current version running on module
+    std::array<uint8_t, 2> versionNumber;
     bus->moduleRead(
-        module, TransceiverI2CApi::ADDR_QSFP, 39, 2, versionNumber.data());
+        progress.moduleId,
+        TransceiverI2CApi::ADDR_QSFP,
+        39,
+        2,
+        versionNumber.data());
     printf(
         "cmisModuleFirmwareUpgrade: Mod%d: Module Active Firmware Revision now: %d.%d\n",
-        module,
+        progress.moduleId,
         versionNumber[0],
         versionNumber[1]);
   }
+
+  printf("Firmware upgrade done on some of the modules");
+  printf(
+      "Check the status using: wedge_qsfp_util --get_module_fw_info <portA> <portB>\n");
+  printf("Pl reload the chassis to finish the firmware upgrade last step\n");
+  return true;
 }
 
 /*